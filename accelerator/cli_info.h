@@ -35,6 +35,7 @@ typedef enum ta_cli_arg_value_e {
   /** MQTT */
   MQTT_HOST_CLI,
   MQTT_ROOT_CLI,
+  MAM_WATCH_PERIOD_CLI,
 
   /** REDIS */
   REDIS_HOST_CLI,
@@ -47,6 +48,12 @@ typedef enum ta_cli_arg_value_e {
   MILESTONE_DEPTH_CLI,
   MWM_CLI,
   SEED_CLI,
+  MAM_SNAPSHOT_PERIOD_CLI,
+  MSS_CACHE_CAPACITY_CLI,
+  MSS_CACHE_DIR_CLI,
+  MAM_RECV_THREADS_CLI,
+  MAM_RECV_CACHE_TTL_CLI,
+  MAM_SEND_WORKERS_CLI,
   CACHE,
   CONF_CLI,
   PROXY_API,
@@ -54,8 +61,22 @@ typedef enum ta_cli_arg_value_e {
   NO_GTTA,
   BUFFER_LIST,
   COMPLETE_LIST,
+  DEAD_LIST,
   HTTP_THREADS_CLI,
+  HTTP_MAX_REQUEST_LEN_CLI,
+  HTTP_BULK_MAX_REQUEST_LEN_CLI,
+  HTTP_COMPRESS_LEVEL_CLI,
+  HTTP_COMPRESS_MIN_SIZE_CLI,
   CACHE_CAPACITY,
+  CACHE_LOW_WATER,
+  CACHE_COMPLETE_TTL,
+  SPOOL_DIR_CLI,
+  SPOOL_SEGMENT_SIZE_CLI,
+  SPOOL_SYNC_CLI,
+  BUFFER_DEDUP_WINDOW_CLI,
+  BUFFER_DEDUP_CAPACITY_CLI,
+  CACHE_TXN_JSON_TTL_CLI,
+  CACHE_TXN_TTL_CLI,
   IPC,
 
   /** LOGGER */
@@ -77,11 +98,21 @@ static struct ta_cli_argument_s {
     {"ta_port", required_argument, NULL, TA_PORT_CLI, "TA listening port"},
     {"http_threads", required_argument, NULL, HTTP_THREADS_CLI,
      "Determine thread pool size to process HTTP connections."},
+    {"http_max_request_len", required_argument, NULL, HTTP_MAX_REQUEST_LEN_CLI,
+     "Maximum size in bytes of the body of an HTTP request"},
+    {"http_bulk_max_request_len", required_argument, NULL, HTTP_BULK_MAX_REQUEST_LEN_CLI,
+     "Maximum size in bytes of the body of a request to `/transaction/object/bulk`"},
+    {"http_compress_level", required_argument, NULL, HTTP_COMPRESS_LEVEL_CLI,
+     "Level from 1 to 9 to compress HTTP responses with gzip or Brotli. Set 0 to disable compression"},
+    {"http_compress_min_size", required_argument, NULL, HTTP_COMPRESS_MIN_SIZE_CLI,
+     "HTTP responses smaller than this size in bytes are not compressed"},
     {"node_host", required_argument, NULL, NODE_HOST_CLI, "IOTA full node listening host"},
     {"node_port", required_argument, NULL, NODE_PORT_CLI, "IOTA full node listening port"},
     {"CA_PEM", required_argument, NULL, CA_PEM, "The path to CA PEM file"},
     {"mqtt_host", required_argument, NULL, MQTT_HOST_CLI, "MQTT listening host"},
     {"mqtt_root", required_argument, NULL, MQTT_ROOT_CLI, "MQTT listening topic root"},
+    {"mam_watch_period", required_argument, NULL, MAM_WATCH_PERIOD_CLI,
+     "Milliseconds between two polls of the MAM channels subscribed over MQTT"},
     {"node_address", required_argument, NULL, NODE_ADDRESS_CLI, " List of IOTA full node listening URL"},
     {"redis_host", required_argument, NULL, REDIS_HOST_CLI, "Redis server listening host"},
     {"redis_port", required_argument, NULL, REDIS_PORT_CLI, "Redis server listening port"},
@@ -89,6 +120,18 @@ static struct ta_cli_argument_s {
     {"milestone_depth", optional_argument, NULL, MILESTONE_DEPTH_CLI, "IOTA full node milestone depth"},
     {"mwm", optional_argument, NULL, MWM_CLI, "minimum weight magnitude"},
     {"seed", optional_argument, NULL, SEED_CLI, "IOTA seed"},
+    {"mam_snapshot_period", required_argument, NULL, MAM_SNAPSHOT_PERIOD_CLI,
+     "Milliseconds between snapshots of the local MAM state. Set 0 to save it on every request"},
+    {"mss_cache_capacity", required_argument, NULL, MSS_CACHE_CAPACITY_CLI,
+     "Number of MAM channels with generated MSS trees kept in memory. Set 0 to disable the in-memory cache"},
+    {"mss_cache_dir", required_argument, NULL, MSS_CACHE_DIR_CLI,
+     "Directory to store generated MSS trees across restarts. It holds the seed, so keep it private"},
+    {"mam_recv_threads", required_argument, NULL, MAM_RECV_THREADS_CLI,
+     "Number of threads decoding the bundles of a MAM receiving request. Set 1 to decode them sequentially"},
+    {"mam_recv_cache_ttl", required_argument, NULL, MAM_RECV_CACHE_TTL_CLI,
+     "Seconds to keep decoded MAM payloads in cache server. Set 0 to disable the payload cache"},
+    {"mam_send_workers", required_argument, NULL, MAM_SEND_WORKERS_CLI,
+     "Number of threads sending buffered MAM requests right away. Set 0 to send them in health tracking"},
     {"cache", required_argument, NULL, CACHE, "Enable/Disable cache server. It defaults to off"},
     {"ipc", required_argument, NULL, IPC, "Set the socket name of initializing notification"},
     {"config", required_argument, NULL, CONF_CLI, "Read configuration file"},
@@ -98,7 +141,26 @@ static struct ta_cli_argument_s {
     {"no-gtta", no_argument, NULL, NO_GTTA, "Disable getTransactionToConfirm (gTTA) when sending transaction"},
     {"buffer_list", required_argument, NULL, BUFFER_LIST, "Set the value of `buffer_list_name`"},
     {"complete_list", required_argument, NULL, COMPLETE_LIST, "Set the value of `complete_list_name`"},
+    {"dead_list", required_argument, NULL, DEAD_LIST, "Set the value of `dead_list_name`"},
     {"cache_capacity", required_argument, NULL, CACHE_CAPACITY, "Set the maximum capacity of caching server"},
+    {"cache_low_water", required_argument, NULL, CACHE_LOW_WATER,
+     "Percentage of cache capacity where evicting completed requests stops"},
+    {"cache_complete_ttl", required_argument, NULL, CACHE_COMPLETE_TTL,
+     "Seconds to keep completed requests in caching server. Set 0 to keep them until evicted"},
+    {"spool_dir", required_argument, NULL, SPOOL_DIR_CLI,
+     "Directory to buffer requests locally while caching server is unavailable"},
+    {"spool_segment_size", required_argument, NULL, SPOOL_SEGMENT_SIZE_CLI,
+     "Size in bytes of each segment file of the local spool"},
+    {"spool_sync", required_argument, NULL, SPOOL_SYNC_CLI,
+     "Flushing policy of the local spool: `none`, `batch` (every 64 records or 200 ms) or `always`"},
+    {"buffer_dedup_window", required_argument, NULL, BUFFER_DEDUP_WINDOW_CLI,
+     "Seconds to return the existing UUID for a transfer buffered again. Set 0 to disable deduplication"},
+    {"buffer_dedup_capacity", required_argument, NULL, BUFFER_DEDUP_CAPACITY_CLI,
+     "Expected number of distinct transfers buffered in a dedup window"},
+    {"cache_txn_json_ttl", required_argument, NULL, CACHE_TXN_JSON_TTL_CLI,
+     "Seconds to keep pre-serialized transaction objects in caching server. Set 0 to serialize them every time"},
+    {"cache_txn_ttl", required_argument, NULL, CACHE_TXN_TTL_CLI,
+     "Seconds to keep transactions fetched from IOTA full node in caching server. Set 0 to fetch them every time"},
     {"quiet", no_argument, NULL, QUIET, "Disable logger"},
     {"runtime_cli", no_argument, NULL, RUNTIME_CLI, "Enable runtime command line"},
     {NULL, 0, NULL, 0, NULL}};
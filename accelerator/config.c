@@ -12,6 +12,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include "accelerator/core/mam_state.h"
 #include "utils/macros.h"
 #include "yaml.h"
 
@@ -154,6 +155,38 @@ status_t cli_core_set(ta_core_t* const core, int key, char* const value) {
         ta_log_error("Malformed input\n");
       }
       break;
+    case HTTP_MAX_REQUEST_LEN_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= INT_MAX) {
+        ta_conf->http_max_request_len = (size_t)strtol_temp;
+      } else {
+        ta_log_error("The maximum size of HTTP requests should be greater than 0.\n");
+      }
+      break;
+    case HTTP_BULK_MAX_REQUEST_LEN_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= INT_MAX) {
+        ta_conf->http_bulk_max_request_len = (size_t)strtol_temp;
+      } else {
+        ta_log_error("The maximum size of bulk requests should be greater than 0.\n");
+      }
+      break;
+    case HTTP_COMPRESS_LEVEL_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 0 && strtol_temp <= MAX_HTTP_COMPRESS_LEVEL) {
+        ta_conf->http_compress_level = (uint8_t)strtol_temp;
+      } else {
+        ta_log_error("The compression level of HTTP responses should be from 0 to %d.\n", MAX_HTTP_COMPRESS_LEVEL);
+      }
+      break;
+    case HTTP_COMPRESS_MIN_SIZE_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 0 && strtol_temp <= INT_MAX) {
+        ta_conf->http_compress_min_size = (size_t)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
 
     // IOTA full node configuration
     case NODE_HOST_CLI:
@@ -210,6 +243,14 @@ status_t cli_core_set(ta_core_t* const core, int key, char* const value) {
     case MQTT_ROOT_CLI:
       ta_conf->mqtt_topic_root = value;
       break;
+    case MAM_WATCH_PERIOD_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= INT_MAX) {
+        ta_conf->mam_watch_period = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
 #endif
 
     // Cache configuration
@@ -236,6 +277,76 @@ status_t cli_core_set(ta_core_t* const core, int key, char* const value) {
         ta_log_error("Malformed input\n");
       }
       break;
+    case CACHE_LOW_WATER:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= 100) {
+        cache->low_water_percent = (uint8_t)strtol_temp;
+      } else {
+        ta_log_error("The low-water mark of caching service should be a percentage between 1 and 100.\n");
+      }
+      break;
+    case CACHE_COMPLETE_TTL:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+        cache->complete_ttl = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case SPOOL_DIR_CLI:
+      cache->spool_dir = value;
+      break;
+    case SPOOL_SEGMENT_SIZE_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= INT_MAX) {
+        cache->spool_segment_size = (size_t)strtol_temp;
+      } else {
+        ta_log_error("The segment size of local spool should be greater than 0.\n");
+      }
+      break;
+    case SPOOL_SYNC_CLI:
+      if (!strcmp(value, "none")) {
+        cache->spool_sync = SPOOL_SYNC_NONE;
+      } else if (!strcmp(value, "batch")) {
+        cache->spool_sync = SPOOL_SYNC_BATCH;
+      } else if (!strcmp(value, "always")) {
+        cache->spool_sync = SPOOL_SYNC_ALWAYS;
+      } else {
+        ta_log_error("The flushing policy of local spool should be `none`, `batch` or `always`.\n");
+      }
+      break;
+    case BUFFER_DEDUP_WINDOW_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+        cache->dedup_window = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case BUFFER_DEDUP_CAPACITY_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp > 0 && strtol_temp <= INT_MAX) {
+        cache->dedup_capacity = (size_t)strtol_temp;
+      } else {
+        ta_log_error("The dedup capacity should be greater than 0.\n");
+      }
+      break;
+    case CACHE_TXN_JSON_TTL_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+        cache->txn_json_ttl = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case CACHE_TXN_TTL_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+        cache->txn_ttl = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
 
 #ifdef DB_ENABLE
     // DB configuration
@@ -265,12 +376,64 @@ status_t cli_core_set(ta_core_t* const core, int key, char* const value) {
     case SEED_CLI:
       iota_conf->seed = value;
       break;
+    case MAM_SNAPSHOT_PERIOD_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+        iota_conf->mam_snapshot_period = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case MSS_CACHE_CAPACITY_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 0 && strtol_temp <= INT_MAX) {
+        iota_conf->mss_cache_capacity = (size_t)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case MAM_RECV_THREADS_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 1 && strtol_temp <= UINT8_MAX) {
+        if (strtol_temp > get_nprocs_conf()) {
+          ta_log_warning("Requiring thread number %ld exceed limitation. Set it to the maximum allowed number: %d\n",
+                         strtol_temp, get_nprocs_conf());
+          iota_conf->mam_recv_threads = (uint8_t)get_nprocs_conf();
+        } else {
+          iota_conf->mam_recv_threads = (uint8_t)strtol_temp;
+        }
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case MAM_RECV_CACHE_TTL_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 0 && strtol_temp <= INT_MAX) {
+        iota_conf->mam_recv_cache_ttl = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case MAM_SEND_WORKERS_CLI:
+      strtol_temp = strtol(value, &strtol_p, 10);
+      if (strtol_p != value && errno != ERANGE && strtol_temp >= 0 && strtol_temp <= UINT8_MAX) {
+        iota_conf->mam_send_workers = (int)strtol_temp;
+      } else {
+        ta_log_error("Malformed input\n");
+      }
+      break;
+    case MSS_CACHE_DIR_CLI:
+      iota_conf->mss_cache_dir = value;
+      break;
     case BUFFER_LIST:
       cache->buffer_list_name = value;
       break;
     case COMPLETE_LIST:
       cache->complete_list_name = value;
       break;
+    case DEAD_LIST:
+      cache->dead_list_name = value;
+      break;
 
     // Command line options configuration
     case QUIET:
@@ -336,11 +499,16 @@ status_t ta_core_default_init(ta_core_t* const core) {
     ta_conf->iota_port_list[i] = NODE_PORT;
   }
   ta_conf->http_tpool_size = DEFAULT_HTTP_TPOOL_SIZE;
+  ta_conf->http_max_request_len = HTTP_MAX_REQUEST_LEN;
+  ta_conf->http_bulk_max_request_len = HTTP_BULK_MAX_REQUEST_LEN;
+  ta_conf->http_compress_level = HTTP_COMPRESS_LEVEL;
+  ta_conf->http_compress_min_size = HTTP_COMPRESS_MIN_SIZE;
   ta_conf->health_track_period = HEALTH_TRACK_PERIOD;
   ta_conf->socket = DOMAIN_SOCKET;
 #ifdef MQTT_ENABLE
   ta_conf->mqtt_host = MQTT_HOST;
   ta_conf->mqtt_topic_root = TOPIC_ROOT;
+  ta_conf->mam_watch_period = MAM_WATCH_PERIOD;
 #endif
   ta_log_info("Initializing Redis information\n");
   cache->host = REDIS_HOST;
@@ -348,9 +516,20 @@ status_t ta_core_default_init(ta_core_t* const core) {
   cache->state = false;
   cache->buffer_list_name = BUFFER_LIST_NAME;
   cache->complete_list_name = COMPLETE_LIST_NAME;
+  cache->dead_list_name = DEAD_LIST_NAME;
   cache->mam_buffer_list_name = MAM_BUFFER_LIST_NAME;
   cache->mam_complete_list_name = MAM_COMPLETE_LIST_NAME;
   cache->capacity = CACHE_MAX_CAPACITY;
+  cache->low_water_percent = CACHE_LOW_WATER_PERCENT;
+  cache->complete_ttl = CACHE_COMPLETE_TTL;
+  cache->spool_dir = NULL;
+  cache->spool_segment_size = SPOOL_SEGMENT_SIZE;
+  cache->spool_sync = SPOOL_SYNC;
+  cache->spool = NULL;
+  cache->dedup_window = CACHE_DEDUP_WINDOW;
+  cache->dedup_capacity = CACHE_DEDUP_CAPACITY;
+  cache->txn_json_ttl = CACHE_TXN_JSON_TTL;
+  cache->txn_ttl = CACHE_TXN_TTL;
 
   ta_log_info("Initializing IOTA full node configuration\n");
   iota_conf->milestone_depth = MILESTONE_DEPTH;
@@ -359,6 +538,12 @@ status_t ta_core_default_init(ta_core_t* const core) {
   char mam_file_path[] = MAM_FILE_PREFIX;
   mkstemp(mam_file_path);
   iota_conf->mam_file_path = strdup(mam_file_path);
+  iota_conf->mam_snapshot_period = MAM_SNAPSHOT_PERIOD;
+  iota_conf->mss_cache_capacity = MSS_CACHE_CAPACITY;
+  iota_conf->mss_cache_dir = NULL;
+  iota_conf->mam_recv_threads = MAM_RECV_THREADS;
+  iota_conf->mam_recv_cache_ttl = MAM_RECV_CACHE_TTL;
+  iota_conf->mam_send_workers = MAM_SEND_WORKERS;
 
   ta_log_info("Initializing IOTA full node connection\n");
   strncpy(iota_service->http.path, "/", CONTENT_TYPE_MAX_LEN);
@@ -545,6 +730,42 @@ status_t ta_core_set(ta_core_t* core) {
   ta_log_info("Initializing PoW implementation context\n");
   pow_init();
 
+  if (core->cache.spool_dir) {
+    ta_log_info("Initializing local spool\n");
+    if (spool_open(&core->cache.spool, core->cache.spool_dir, core->cache.spool_segment_size,
+                   core->cache.spool_sync) != SC_OK) {
+      ta_log_error("Initializing local spool in %s failed. Requests would be lost while caching service is down.\n",
+                   core->cache.spool_dir);
+    }
+  }
+
+  ta_log_info("Initializing MAM state manager\n");
+  if (mam_state_manager_init(core->iota_conf.mam_snapshot_period) != SC_OK) {
+    ta_log_error("Initializing MAM state manager failed\n");
+  }
+
+  ta_log_info("Initializing MSS cache\n");
+  if (mss_cache_init(core->iota_conf.mss_cache_capacity, core->iota_conf.mss_cache_dir) != SC_OK) {
+    ta_log_error("Initializing MSS cache failed. MSS trees of MAM channels would be kept in memory only.\n");
+  }
+
+  if (core->cache.state) {
+    ta_log_info("Reading occupied space of cache server\n");
+    cache_eviction_reconcile();
+  }
+
+  if (core->cache.dedup_window > 0) {
+    ta_log_info("Initializing dedup filter of buffered transfers\n");
+    if (cache_dedup_init(core->cache.dedup_capacity) != SC_OK) {
+      ta_log_error("Initializing dedup filter failed. Every buffered transfer would be looked up in cache server.\n");
+    }
+  }
+
+  if (core->cache.txn_json_ttl > 0 || core->cache.txn_ttl > 0) {
+    ta_log_info("Enabling pre-serialized and packed transaction objects in cache server\n");
+    cache_fragment_init(core->cache.txn_json_ttl, core->cache.txn_ttl);
+  }
+
 #ifdef DB_ENABLE
   ta_log_info("Initializing db client service\n");
   if ((ret = db_client_service_init(db_service, DB_USAGE_REATTACH)) != SC_OK) {
@@ -563,6 +784,11 @@ void ta_core_destroy(ta_core_t* const core) {
   db_client_service_free(&core->db_service);
 #endif
   pow_destroy();
+  mam_state_manager_destroy();
+  mss_cache_destroy();
+  cache_eviction_clear();
+  spool_close(&core->cache.spool);
+  cache_dedup_destroy();
   cache_stop(&core->cache.rwlock);
   logger_helper_release(logger_id);
   logger_destroy_client_core();
@@ -583,6 +809,8 @@ void ta_logger_switch(bool quiet, bool init, ta_config_t* ta_conf) {
       mqtt_callback_logger_init();
       mqtt_pub_logger_init();
       mqtt_sub_logger_init();
+      mqtt_mam_push_logger_init();
+      mw_logger_init();
 #else
       http_logger_init();
 #endif
@@ -593,6 +821,12 @@ void ta_logger_switch(bool quiet, bool init, ta_config_t* ta_conf) {
       pow_logger_init();
       timer_logger_init();
       br_logger_init();
+      ce_logger_init();
+      sp_logger_init();
+      cd_logger_init();
+      ms_logger_init();
+      mss_logger_init();
+      mam_sender_logger_init();
       ta_conf->cli_options &= ~CLI_QUIET_MODE;
     } else {
 #ifdef MQTT_ENABLE
@@ -601,6 +835,8 @@ void ta_logger_switch(bool quiet, bool init, ta_config_t* ta_conf) {
       mqtt_callback_logger_release();
       mqtt_pub_logger_release();
       mqtt_sub_logger_release();
+      mqtt_mam_push_logger_release();
+      mw_logger_release();
 #else
       http_logger_release();
 #endif
@@ -611,6 +847,12 @@ void ta_logger_switch(bool quiet, bool init, ta_config_t* ta_conf) {
       pow_logger_release();
       timer_logger_release();
       br_logger_release();
+      ce_logger_release();
+      sp_logger_release();
+      cd_logger_release();
+      ms_logger_release();
+      mss_logger_release();
+      mam_sender_logger_release();
       ta_conf->cli_options |= CLI_QUIET_MODE;
     }
   }
@@ -13,6 +13,7 @@
 #include <getopt.h>
 
 #include "accelerator/cli_info.h"
+#include "accelerator/core/mss_cache.h"
 #include "accelerator/core/pow.h"
 #include "cclient/api/core/core_api.h"
 #include "cclient/api/extended/extended_api.h"
@@ -24,7 +25,11 @@
 #include "cclient/serialization/json/json_serializer.h"
 #include "common/logger.h"
 #include "utils/cache/cache.h"
+#include "utils/cache/dedup.h"
+#include "utils/cache/fragment.h"
+#include "utils/cache/eviction.h"
 #include "utils/handles/lock.h"
+#include "utils/spool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,17 +73,37 @@ extern "C" {
 #define DEFAULT_HTTP_TPOOL_SIZE 4 /**< Thread number of MHD thread pool */
 #define MAX_HTTP_TPOOL_SIZE \
   (get_nprocs_conf() - get_nthds_per_phys_proc()) /**< Preserve at least one physical processor */
+#define HTTP_MAX_REQUEST_LEN 65536        /**< Maximum size in bytes of the body of an HTTP request */
+#define HTTP_BULK_MAX_REQUEST_LEN 4194304 /**< Maximum size in bytes of the body of a bulk request */
+#define HTTP_COMPRESS_LEVEL 5             /**< Compression level of HTTP responses. Zero disables compression */
+#define MAX_HTTP_COMPRESS_LEVEL 9         /**< Maximum compression level of HTTP responses */
+#define HTTP_COMPRESS_MIN_SIZE 1024       /**< HTTP responses smaller than this size in bytes are not compressed */
 #define DB_HOST "localhost"
 #define MAM_FILE_PREFIX "/tmp/mam_bin_XXXXXX"
+#define MAM_SNAPSHOT_PERIOD 1000 /**< Write a snapshot of the modified MAM state every second */
+#define MAM_RECV_THREADS 4       /**< Thread number decoding the bundles of a MAM receiving request */
+#define MAM_RECV_CACHE_TTL 3600  /**< Seconds to keep decoded MAM payloads. Zero disables the payload cache */
+#define MAM_WATCH_PERIOD 5000    /**< Milliseconds between two polls of the watched MAM channels */
+#define MAM_SEND_WORKERS 0       /**< Threads sending buffered MAM requests. Zero sends them in health tracking */
 #define BUFFER_LIST_NAME "txn_buff_list"
 #define COMPLETE_LIST_NAME "complete_txn_buff_list"
+#define DEAD_LIST_NAME "dead_txn_buff_list"
 #define MAM_BUFFER_LIST_NAME "mam_buff_list"
 #define MAM_COMPLETE_LIST_NAME "complete_mam_buff_list"
 #define CACHE_MAX_CAPACITY \
   170 * 1024 * 1024              /**< Default cache server maximum capacity. It is set to 170MB by default. */
-#define HEALTH_TRACK_PERIOD 1800 /**< Check every half hour in default */
+#define CACHE_LOW_WATER_PERCENT \
+  80 /**< Eviction stops once the usage drops to this percentage of the cache server capacity */
+#define CACHE_COMPLETE_TTL 0        /**< Seconds to keep completed requests. Zero keeps them until evicted */
+#define SPOOL_SYNC SPOOL_SYNC_BATCH /**< Flush the local spool in batches of records or every 200 ms */
+#define CACHE_DEDUP_WINDOW 10       /**< Seconds to deduplicate buffered transfers. Zero disables deduplication */
+#define CACHE_DEDUP_CAPACITY 100000 /**< Expected number of distinct transfers buffered in a dedup window */
+#define CACHE_TXN_JSON_TTL 0        /**< Seconds to keep pre-serialized transaction objects. Zero disables them */
+#define CACHE_TXN_TTL 3600          /**< Seconds to keep fetched transactions in packed trits. Zero disables them */
+#define HEALTH_TRACK_PERIOD 1800    /**< Check every half hour in default */
 #define RESULT_SET_LIMIT \
   100 /**< The maximun returned transaction object number when querying transaction object by tag */
+#define BULK_BATCH_SIZE 100 /**< Transaction objects fetched and streamed at a time by a bulk request */
 #define FILE_PATH_SIZE 128
 #define DOMAIN_SOCKET "/tmp/tangle-accelerator-socket"
 
@@ -93,10 +118,15 @@ typedef struct ta_config_s {
 #ifdef MQTT_ENABLE
   char* mqtt_host;       /**< Address of MQTT broker host */
   char* mqtt_topic_root; /**< The topic root of MQTT topic */
+  int mam_watch_period;  /**< Milliseconds between two polls of the MAM channels subscribed over MQTT */
 #endif
-  uint8_t http_tpool_size; /**< Thread count of tangle-accelerator instance */
-  uint32_t cli_options;    /**< Command line options */
-  char* socket;            /**< UNIX domain socket for notify initialization */
+  uint8_t http_tpool_size;          /**< Thread count of tangle-accelerator instance */
+  size_t http_max_request_len;      /**< Maximum size in bytes of the body of an HTTP request */
+  size_t http_bulk_max_request_len; /**< Maximum size in bytes of the body of a bulk request */
+  uint8_t http_compress_level;      /**< Compression level of HTTP responses from 1 to 9, or 0 to disable it */
+  size_t http_compress_min_size;    /**< HTTP responses smaller than this size in bytes are not compressed */
+  uint32_t cli_options;             /**< Command line options */
+  char* socket;                     /**< UNIX domain socket for notify initialization */
 } ta_config_t;
 
 /** Command line options */
@@ -113,6 +143,12 @@ typedef struct iota_config_s {
   uint8_t mwm;               /**< Minimum weight magnitude of API argument */
   const char* seed;          /**< Seed to generate address. This does not do any signature yet. */
   const char* mam_file_path; /**< The MAM file which records the mam config */
+  int mam_snapshot_period;   /**< Milliseconds between snapshots of the MAM state. Zero saves it on every request */
+  size_t mss_cache_capacity; /**< Number of MAM channels with generated MSS trees kept in memory */
+  char* mss_cache_dir;       /**< Directory to store generated MSS trees. NULL keeps them in memory only */
+  uint8_t mam_recv_threads;  /**< Thread number decoding the bundles of a MAM receiving request */
+  int mam_recv_cache_ttl;    /**< Seconds to keep decoded MAM payloads in cache server. Zero disables the cache */
+  int mam_send_workers;      /**< Threads sending buffered MAM requests. Zero sends them in health tracking */
 } iota_config_t;
 
 /** struct type of accelerator cache */
@@ -121,12 +157,23 @@ typedef struct ta_cache_s {
   uint64_t timeout;             /**< Timeout for keys in cache server */
   char* buffer_list_name;       /**< Name of the list to buffer transactions */
   char* complete_list_name;     /**< Name of the list to store successfully broadcast transactions from buffer */
+  char* dead_list_name;         /**< Name of the list to store buffered transactions which can't be decoded */
   char* mam_buffer_list_name;   /**< Name of the list to buffer MAM requests UUID */
   char* mam_complete_list_name; /**< Name of the list to successfullay published MAM requests */
   uint16_t port;                /**< Binding port of redis server */
   bool state;                   /**< Set it true to turn on cache server */
   long int capacity;            /**< The maximum capacity of cache server */
+  uint8_t low_water_percent;    /**< Percentage of `capacity` where eviction stops */
+  int complete_ttl;             /**< Seconds to keep completed requests. Zero or negative value disables TTL */
   pthread_rwlock_t* rwlock;     /**< Read/Write lock to avoid data racing in buffering */
+  char* spool_dir;              /**< Directory of the local spool. NULL disables the local spool. */
+  size_t spool_segment_size;    /**< Size of a segment file of the local spool in bytes */
+  spool_sync_t spool_sync;      /**< Policy of flushing the local spool to storage */
+  spool_t* spool;               /**< Local spool where requests are buffered while the cache server is unavailable */
+  int dedup_window;             /**< Seconds to deduplicate buffered transfers. Zero or negative value disables it */
+  size_t dedup_capacity;        /**< Expected number of distinct transfers buffered in a dedup window */
+  int txn_json_ttl;             /**< Seconds to keep serialized transaction objects. Zero or negative disables them */
+  int txn_ttl;                  /**< Seconds to keep fetched transactions in packed trits. Zero or negative disables */
 } ta_cache_t;
 
 /** struct type of accelerator core */
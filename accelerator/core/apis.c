@@ -10,6 +10,10 @@
 #include <sys/time.h>
 #include <uuid/uuid.h>
 #include "mam_core.h"
+#include "mam_sender.h"
+#include "utils/buffer_pool.h"
+#include "utils/cache/fragment.h"
+#include "utils/tryte_simd.h"
 
 #define APIS_LOGGER "apis"
 
@@ -22,15 +26,162 @@ int apis_logger_release() {
   return 0;
 }
 
+static inline void set_result_len(const status_t ret, char** result, size_t* result_len) {
+  if (ret == SC_OK && result_len) {
+    *result_len = strlen(*result);
+  }
+}
+
+static status_t serialize_transaction_objects(const transaction_array_t* const res, const ta_res_format_t format,
+                                              char** result, size_t* result_len) {
+  if (format == TA_RES_CBOR) {
+    return ta_find_transaction_objects_res_serialize_cbor(res, result, result_len);
+  }
+
+  status_t ret = ta_find_transaction_objects_res_serialize(res, result);
+  set_result_len(ret, result, result_len);
+  return ret;
+}
+
+static void free_fragments(char** fragments, const size_t num) {
+  if (fragments == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < num; i++) {
+    free(fragments[i]);
+  }
+  free(fragments);
+}
+
+/**
+ * @brief Serialize the transaction objects of `req` into JSON objects in the order of `req`
+ *
+ * If the fragment tier is enabled, fragments are looked up by transaction hash first, and missing transactions are
+ * cached once they are serialized. Missing transactions are fetched with `ta_find_transaction_objects()`.
+ *
+ * @param[out] fragments JSON objects, one for each hash of `req`. They should be freed by the caller, even on error.
+ */
+static status_t find_transaction_fragments(const iota_client_service_t* const service,
+                                           const ta_find_transaction_objects_req_t* const req, char** fragments) {
+  status_t ret = SC_OK;
+  const size_t num = hash243_queue_count(req->hashes);
+  const bool use_cache = cache_fragment_enabled();
+  char txn_hash[NUM_TRYTES_HASH + 1] = {0};
+  ta_find_transaction_objects_req_t* missing_req = ta_find_transaction_objects_req_new();
+  transaction_array_t* missing = transaction_array_new();
+  iota_transaction_t* txn = NULL;
+  char* fragment = NULL;
+  size_t fragment_len = 0, i = 0;
+  hash243_queue_entry_t* q_iter = NULL;
+  if (missing_req == NULL || missing == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  CDL_FOREACH(req->hashes, q_iter) {
+    flex_trits_to_trytes_simd((tryte_t*)txn_hash, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+    if (!use_cache || cache_fragment_get(txn_hash, &fragments[i], &fragment_len) != SC_OK) {
+      fragments[i] = NULL;
+      if (hash243_queue_push(&missing_req->hashes, q_iter->hash) != RC_OK) {
+        ret = SC_CCLIENT_HASH;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+    }
+    i++;
+  }
+
+  if (missing_req->hashes != NULL) {
+    ret = ta_find_transaction_objects(service, missing_req, missing);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+
+  TX_OBJS_FOREACH(missing, txn) {
+    // The same hash could be requested more than once, so every empty slot of it is filled
+    bool wanted = false;
+    i = 0;
+    CDL_FOREACH(req->hashes, q_iter) {
+      if (fragments[i] == NULL && memcmp(q_iter->hash, transaction_hash(txn), FLEX_TRIT_SIZE_243) == 0) {
+        if (fragment == NULL) {
+          ret = ta_transaction_object_serialize(txn, &fragment);
+          if (ret) {
+            goto done;
+          }
+        }
+        fragments[i] = strdup(fragment);
+        if (fragments[i] == NULL) {
+          ret = SC_OOM;
+          ta_log_error("%s\n", ta_error_to_string(ret));
+          goto done;
+        }
+        wanted = true;
+      }
+      i++;
+    }
+
+    if (wanted && use_cache) {
+      flex_trits_to_trytes_simd((tryte_t*)txn_hash, NUM_TRYTES_HASH, transaction_hash(txn), NUM_TRITS_HASH,
+                                NUM_TRITS_HASH);
+      // A failure of caching only costs serializing the transaction again
+      cache_fragment_set(txn_hash, fragment, strlen(fragment));
+    }
+    free(fragment);
+    fragment = NULL;
+  }
+
+  for (i = 0; i < num; i++) {
+    if (fragments[i] == NULL) {
+      ret = SC_CCLIENT_NOT_FOUND;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+
+done:
+  free(fragment);
+  ta_find_transaction_objects_req_free(&missing_req);
+  transaction_array_free(missing);
+  return ret;
+}
+
+/**
+ * @brief Serialize the transaction objects of `req` into a JSON array assembled from their fragments
+ */
+static status_t find_transaction_objects_by_fragments(const iota_client_service_t* const service,
+                                                      const ta_find_transaction_objects_req_t* const req,
+                                                      char** result, size_t* result_len) {
+  const size_t num = hash243_queue_count(req->hashes);
+  char** fragments = (char**)calloc(num + 1, sizeof(char*));
+  if (fragments == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+
+  status_t ret = find_transaction_fragments(service, req, fragments);
+  if (ret == SC_OK) {
+    ret = ta_transaction_fragments_serialize(fragments, num, result);
+    set_result_len(ret, result, result_len);
+  }
+  free_fragments(fragments, num);
+  return ret;
+}
+
 status_t api_get_ta_info(ta_config_t* const info, iota_config_t* const tangle, ta_cache_t* const cache,
                          char** json_result) {
   return ta_get_info_serialize(json_result, info, tangle, cache);
 }
 
 status_t api_find_transaction_object_single(const iota_client_service_t* const service, const char* const obj,
-                                            char** json_result) {
+                                            const ta_res_format_t format, char** result, size_t* result_len) {
   status_t ret = SC_OK;
   flex_trit_t txn_hash[NUM_FLEX_TRITS_HASH];
+  char hash_trytes[NUM_TRYTES_HASH + 1] = {0};
+  size_t fragment_len = 0;
+  const bool use_fragment = (format == TA_RES_JSON && cache_fragment_enabled());
   ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
   transaction_array_t* res = transaction_array_new();
   if (req == NULL || res == NULL) {
@@ -39,6 +190,15 @@ status_t api_find_transaction_object_single(const iota_client_service_t* const s
     goto done;
   }
 
+  if (use_fragment) {
+    // The response of a single transaction is its fragment
+    strncpy(hash_trytes, obj, NUM_TRYTES_HASH);
+    if (cache_fragment_get(hash_trytes, result, &fragment_len) == SC_OK) {
+      set_result_len(ret, result, result_len);
+      goto done;
+    }
+  }
+
   flex_trits_from_trytes(txn_hash, NUM_TRITS_HASH, (const tryte_t*)obj, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
   hash243_queue_push(&req->hashes, txn_hash);
 
@@ -48,7 +208,15 @@ status_t api_find_transaction_object_single(const iota_client_service_t* const s
     goto done;
   }
 
-  ret = ta_find_transaction_object_single_res_serialize(res, json_result);
+  if (format == TA_RES_CBOR) {
+    ret = ta_find_transaction_object_single_res_serialize_cbor(res, result, result_len);
+  } else {
+    ret = ta_find_transaction_object_single_res_serialize(res, result);
+    set_result_len(ret, result, result_len);
+    if (ret == SC_OK && use_fragment) {
+      cache_fragment_set(hash_trytes, *result, strlen(*result));
+    }
+  }
 
 done:
   ta_find_transaction_objects_req_free(&req);
@@ -57,7 +225,7 @@ done:
 }
 
 status_t api_find_transaction_objects(const iota_client_service_t* const service, const char* const obj,
-                                      char** json_result) {
+                                      const ta_res_format_t format, char** result, size_t* result_len) {
   status_t ret = SC_OK;
   ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
   transaction_array_t* res = transaction_array_new();
@@ -78,13 +246,18 @@ status_t api_find_transaction_objects(const iota_client_service_t* const service
     hash243_queue_pop(&req->hashes);
   }
 
+  if (format == TA_RES_JSON && cache_fragment_enabled()) {
+    ret = find_transaction_objects_by_fragments(service, req, result, result_len);
+    goto done;
+  }
+
   ret = ta_find_transaction_objects(service, req, res);
   if (ret) {
     ta_log_error("%d\n", ret);
     goto done;
   }
 
-  ret = ta_find_transaction_objects_res_serialize(res, json_result);
+  ret = serialize_transaction_objects(res, format, result, result_len);
 
 done:
   ta_find_transaction_objects_req_free(&req);
@@ -92,6 +265,101 @@ done:
   return ret;
 }
 
+status_t api_find_transaction_objects_bulk_init(const char* const obj, ta_find_transaction_objects_req_t** req) {
+  status_t ret = SC_OK;
+  if (req == NULL) {
+    ret = SC_NULL;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  *req = ta_find_transaction_objects_req_new();
+  if (*req == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  ret = ta_find_transaction_objects_req_deserialize(obj, *req);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    ta_find_transaction_objects_req_free(req);
+  }
+  return ret;
+}
+
+status_t api_find_transaction_objects_bulk_next(const iota_client_service_t* const service,
+                                                ta_find_transaction_objects_req_t* const req, char** lines,
+                                                size_t* lines_len) {
+  status_t ret = SC_OK;
+  size_t num = 0, len = 0;
+  char** fragments = NULL;
+  char* out = NULL;
+  ta_find_transaction_objects_req_t* batch = NULL;
+  if (req == NULL || lines == NULL || lines_len == NULL) {
+    ret = SC_NULL;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  *lines = NULL;
+  *lines_len = 0;
+  if (req->hashes == NULL) {
+    return SC_OK;
+  }
+
+  batch = ta_find_transaction_objects_req_new();
+  fragments = (char**)calloc(BULK_BATCH_SIZE, sizeof(char*));
+  if (batch == NULL || fragments == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Hashes are moved to the batch, so the request shrinks as it is streamed
+  while (num < BULK_BATCH_SIZE && req->hashes != NULL) {
+    hash243_queue_entry_t* entry = hash243_queue_pop(&req->hashes);
+    const retcode_t push_ret = hash243_queue_push(&batch->hashes, entry->hash);
+    free(entry);
+    if (push_ret != RC_OK) {
+      ret = SC_CCLIENT_HASH;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    num++;
+  }
+
+  ret = find_transaction_fragments(service, batch, fragments);
+  if (ret) {
+    goto done;
+  }
+
+  for (size_t i = 0; i < num; i++) {
+    len += strlen(fragments[i]) + 1;
+  }
+  out = buffer_pool_alloc(len + 1, NULL);
+  if (out == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  len = 0;
+  for (size_t i = 0; i < num; i++) {
+    const size_t fragment_len = strlen(fragments[i]);
+    memcpy(out + len, fragments[i], fragment_len);
+    len += fragment_len;
+    out[len++] = '\n';
+  }
+  out[len] = '\0';
+  *lines = out;
+  *lines_len = len;
+
+done:
+  free_fragments(fragments, num);
+  ta_find_transaction_objects_req_free(&batch);
+  return ret;
+}
+
 status_t api_find_transactions_by_tag(const iota_client_service_t* const service, const char* const obj,
                                       char** json_result) {
   status_t ret = SC_OK;
@@ -137,7 +405,7 @@ done:
 }
 
 status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const service, const char* const obj,
-                                          char** json_result) {
+                                          const ta_res_format_t format, char** result, size_t* result_len) {
   status_t ret = SC_OK;
   flex_trit_t tag_trits[NUM_FLEX_TRITS_TAG];
   find_transactions_req_t* req = find_transactions_req_new();
@@ -172,7 +440,7 @@ status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const ser
     goto done;
   }
 
-  ret = ta_find_transaction_objects_res_serialize(res, json_result);
+  ret = serialize_transaction_objects(res, format, result, result_len);
 
 done:
   find_transactions_req_free(&req);
@@ -181,7 +449,8 @@ done:
 }
 
 status_t api_recv_mam_message(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                              const char* const obj, char** json_result) {
+                              const char* const obj, const ta_res_format_t format, char** result,
+                              size_t* result_len) {
   status_t ret = SC_OK;
   ta_recv_mam_req_t* req = recv_mam_req_new();
   ta_recv_mam_res_t* res = recv_mam_res_new();
@@ -203,7 +472,12 @@ status_t api_recv_mam_message(const iota_config_t* const iconf, const iota_clien
     goto done;
   }
 
-  ret = recv_mam_message_res_serialize(res, json_result);
+  if (format == TA_RES_CBOR) {
+    ret = recv_mam_message_res_serialize_cbor(res, result, result_len);
+  } else {
+    ret = recv_mam_message_res_serialize(res, result);
+    set_result_len(ret, result, result_len);
+  }
   if (ret) {
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
@@ -237,17 +511,15 @@ status_t api_send_mam_message(const ta_cache_t* const cache, char const* const o
   // TODO Generate the address that TA can quickly generate from the SEED with given parameters.
 
   // Buffer send_mam_req_t object for publishing it later
-  ret = cache_set(uuid, UUID_STR_LEN - 1, obj, strlen(obj), cache->timeout);
+  ret = ta_buffer_request(cache, SPOOL_RECORD_MAM, uuid, obj, strlen(obj), true);
   if (ret != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
 
-  // Buffer the UUID to the list
-  ret = cache_list_push(cache->mam_buffer_list_name, strlen(cache->mam_buffer_list_name), uuid, UUID_STR_LEN - 1);
-  if (ret != SC_OK) {
-    ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
+  // Send it right away if the MAM sender runs. Otherwise it is sent in the next health tracking period.
+  if (mam_sender_submit(uuid, ((send_mam_data_mam_v1_t*)req->data)->seed) != SC_OK) {
+    ta_log_warning("Buffered MAM request %s is left to the next health tracking period\n", uuid);
   }
 
   ret = send_mam_message_res_serialize(NULL, uuid, json_result);
@@ -49,14 +49,17 @@ status_t api_get_ta_info(ta_config_t* const info, iota_config_t* const tangle, t
  * @param[in] iconf IOTA API parameter configurations
  * @param[in] service IOTA node service
  * @param[in] obj Input data in JSON
- * @param[out] json_result Fetched MAM message in JSON format
+ * @param[in] format Format of the result
+ * @param[out] result Fetched MAM message in the given format
+ * @param[out] result_len Length of the result, which is needed for CBOR. It can be NULL for JSON.
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_recv_mam_message(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                              const char* const obj, char** json_result);
+                              const char* const obj, const ta_res_format_t format, char** result,
+                              size_t* result_len);
 
 /**
  * @brief Send a MAM message with given Payload.
@@ -104,14 +107,16 @@ status_t api_send_transfer(const ta_core_t* const core, const iota_client_servic
  *
  * @param[in] service IOTA node service
  * @param[in] obj transaction hash in trytes
- * @param[out] json_result Result containing the only one transaction object in json format
+ * @param[in] format Format of the result
+ * @param[out] result Result containing the only one transaction object in the given format
+ * @param[out] result_len Length of the result, which is needed for CBOR. It can be NULL for JSON.
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transaction_object_single(const iota_client_service_t* const service, const char* const obj,
-                                            char** json_result);
+                                            const ta_res_format_t format, char** result, size_t* result_len);
 
 /**
  * @brief Return transaction object with given transaction hash.
@@ -121,14 +126,50 @@ status_t api_find_transaction_object_single(const iota_client_service_t* const s
  *
  * @param[in] service IOTA node service
  * @param[in] obj transaction hash in trytes
- * @param[out] json_result Result containing transaction objects in json format
+ * @param[in] format Format of the result
+ * @param[out] result Result containing transaction objects in the given format
+ * @param[out] result_len Length of the result, which is needed for CBOR. It can be NULL for JSON.
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transaction_objects(const iota_client_service_t* const service, const char* const obj,
-                                      char** json_result);
+                                      const ta_res_format_t format, char** result, size_t* result_len);
+
+/**
+ * @brief Start streaming transaction objects of a bulk request
+ *
+ * The request is the same as the one of `api_find_transaction_objects()`, but the number of hashes is not limited.
+ * Transaction objects are then taken `BULK_BATCH_SIZE` at a time with `api_find_transaction_objects_bulk_next()`.
+ *
+ * @param[in] obj List of transaction hashes in JSON
+ * @param[out] req Hashes which are not streamed yet. It should be freed with `ta_find_transaction_objects_req_free()`.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t api_find_transaction_objects_bulk_init(const char* const obj, ta_find_transaction_objects_req_t** req);
+
+/**
+ * @brief Take the next batch of transaction objects of a bulk request in newline-delimited JSON
+ *
+ * Transaction objects are in the order of the request, one JSON object per line.
+ *
+ * @param[in] service IOTA node service
+ * @param[in,out] req Hashes which are not streamed yet. The hashes of the batch are removed from it.
+ * @param[out] lines Transaction objects of the batch, or NULL if every hash is streamed. It should be released with
+ * `buffer_pool_release()`.
+ * @param[out] lines_len Length of `lines`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t api_find_transaction_objects_bulk_next(const iota_client_service_t* const service,
+                                                ta_find_transaction_objects_req_t* const req, char** lines,
+                                                size_t* lines_len);
 
 /**
  * @brief Return list of transaction hash with given tag.
@@ -156,15 +197,16 @@ status_t api_find_transactions_by_tag(const iota_client_service_t* const service
  *
  * @param[in] service IOTA node service
  * @param[in] obj tag in trytes
- * @param[out] json_result Result containing list of transaction objects in json
- * format
+ * @param[in] format Format of the result
+ * @param[out] result Result containing list of transaction objects in the given format
+ * @param[out] result_len Length of the result, which is needed for CBOR. It can be NULL for JSON.
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const service, const char* const obj,
-                                          char** json_result);
+                                          const ta_res_format_t format, char** result, size_t* result_len);
 
 /**
  * @brief Attach trytes to Tangle and return transaction hashes
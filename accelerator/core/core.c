@@ -8,6 +8,8 @@
 
 #include "core.h"
 #include <sys/time.h>
+#include "common/helpers/digest.h"
+#include "utils/tryte_simd.h"
 
 #define CC_LOGGER "core"
 
@@ -174,7 +176,7 @@ status_t ta_send_transfer(const ta_config_t* const info, const iota_config_t* co
   if (ret) {
     ta_log_error("Error in ta_send_trytes. Push transaction trytes to buffer.\n");
     res->uuid = (char*)malloc(sizeof(char) * UUID_STR_LEN);
-    push_txn_to_buffer(cache, raw_tx, res->uuid);
+    push_txn_to_buffer(cache, raw_tx, iconf->mwm, res->uuid);
 
     txn = (iota_transaction_t*)utarray_front(out_bundle);
     res->address = (tryte_t*)malloc(sizeof(char) * NUM_TRYTES_ADDRESS);
@@ -282,6 +284,34 @@ done:
   return ret;
 }
 
+/**
+ * @brief Convert a cached transaction object into flex_trit_t
+ *
+ * A cached transaction object is either packed trits prefixed with `TRIT_PACK_VERSION`, or trytes in ASCII.
+ *
+ * @param[in] value Cached value
+ * @param[in] value_len Length of the cached value
+ * @param[out] tx_trits Transaction object in flex_trit_t
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+static status_t cached_txn_to_flex_trits(const char* const value, const size_t value_len, flex_trit_t* tx_trits) {
+  if (value_len == 1 + TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION) && value[0] == TRIT_PACK_VERSION) {
+    return flex_trits_unpack((const uint8_t*)value + 1, NUM_TRITS_SERIALIZED_TRANSACTION, tx_trits);
+  }
+
+  if (value_len == NUM_TRYTES_SERIALIZED_TRANSACTION) {
+    flex_trits_from_trytes_simd(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)value,
+                                NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+    return SC_OK;
+  }
+
+  ta_log_error("Unknown format of cached transaction object\n");
+  return SC_UTILS_TRIT_PACK_INVALID;
+}
+
 status_t ta_find_transaction_objects(const iota_client_service_t* const service,
                                      const ta_find_transaction_objects_req_t* const req, transaction_array_t* res) {
   status_t ret = SC_OK;
@@ -297,19 +327,20 @@ status_t ta_find_transaction_objects(const iota_client_service_t* const service,
   }
   char txn_hash[NUM_TRYTES_HASH + 1] = {0};
   char* cache_value = NULL;
+  size_t cache_value_len = 0;
   txn_hash[NUM_TRYTES_HASH] = '\0';
 
   // append transaction object which is already cached to transaction_array_t
   // if not, append uncached to request object of `iota_client_find_transaction_objects`
   hash243_queue_entry_t* q_iter = NULL;
   CDL_FOREACH(req->hashes, q_iter) {
-    flex_trits_to_trytes((tryte_t*)txn_hash, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+    flex_trits_to_trytes_simd((tryte_t*)txn_hash, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
 
-    ret = cache_get(txn_hash, &cache_value);
+    ret = cache_get_blob(txn_hash, &cache_value, &cache_value_len);
+    if (ret == SC_OK) {
+      ret = cached_txn_to_flex_trits(cache_value, cache_value_len, tx_trits);
+    }
     if (ret == SC_OK) {
-      flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)cache_value,
-                             NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
-
       // deserialize raw data to transaction object
       temp = transaction_deserialize(tx_trits, true);
       if (temp == NULL) {
@@ -324,6 +355,8 @@ status_t ta_find_transaction_objects(const iota_client_service_t* const service,
       free(cache_value);
       cache_value = NULL;
     } else {
+      free(cache_value);
+      cache_value = NULL;
       if (hash243_queue_push(&req_get_trytes->hashes, q_iter->hash) != RC_OK) {
         ret = SC_CCLIENT_HASH;
         ta_log_error("%s\n", ta_error_to_string(ret));
@@ -357,7 +390,15 @@ status_t ta_find_transaction_objects(const iota_client_service_t* const service,
   TX_OBJS_FOREACH(uncached_txn_array, temp) {
     temp_txn_trits = transaction_serialize(temp);
     if (!flex_trits_are_null(temp_txn_trits, FLEX_TRIT_SIZE_8019)) {
-      // TODO Save fetched transaction object in a set.
+      // Transactions are immutable, so the fetched one is cached in packed trits
+      if (cache_fragment_packed_enabled()) {
+        uint8_t packed[1 + TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION)];
+        packed[0] = TRIT_PACK_VERSION;
+        flex_trits_pack(temp_txn_trits, NUM_TRITS_SERIALIZED_TRANSACTION, packed + 1);
+        flex_trits_to_trytes_simd((tryte_t*)txn_hash, NUM_TRYTES_HASH, transaction_hash(temp), NUM_TRITS_HASH,
+                                  NUM_TRITS_HASH);
+        cache_fragment_set_packed(txn_hash, packed, sizeof(packed));
+      }
 
       iota_transaction_t* append_txn = transaction_deserialize(temp_txn_trits, true);
       transaction_array_push_back(res, append_txn);
@@ -466,10 +507,181 @@ status_t ta_send_bundle(const ta_config_t* const info, const iota_config_t* cons
   return SC_OK;
 }
 
-status_t ta_get_bundles_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
-                                bundle_array_t* bundle_array) {
+static void* bundle_pipeline_pow(void* arg) {
+  ta_bundle_pipeline_t* const pipeline = (ta_bundle_pipeline_t*)arg;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+
+  pthread_mutex_lock(&pipeline->lock);
+  for (;;) {
+    while (pipeline->attached_num == bundle_array_size(pipeline->bundles) && !pipeline->closed) {
+      pthread_cond_wait(&pipeline->cond, &pipeline->lock);
+    }
+    if (pipeline->cancelled || pipeline->attached_num == bundle_array_size(pipeline->bundles)) {
+      break;
+    }
+    // The capacity of the bundle array is reserved at start, so the bundle is not moved by the following pushes
+    bundle_transactions_t* bundle = bundle_array_at(pipeline->bundles, pipeline->attached_num);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    status_t ret = ta_pow(bundle, pipeline->trunk, pipeline->branch, pipeline->mwm);
+    if (ret == SC_OK) {
+      // The next bundle approves the tail of this bundle
+      transaction_serialize_on_flex_trits((iota_transaction_t*)utarray_front(bundle), tx_trits);
+      flex_trit_t* tail_hash = iota_flex_digest(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION);
+      if (tail_hash) {
+        memcpy(pipeline->trunk, tail_hash, FLEX_TRIT_SIZE_243);
+        free(tail_hash);
+      } else {
+        ret = SC_OOM;
+      }
+    }
+
+    pthread_mutex_lock(&pipeline->lock);
+    if (ret) {
+      pipeline->ret = ret;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      break;
+    }
+    iota_transaction_t* tx = NULL;
+    BUNDLE_FOREACH(bundle, tx) {
+      transaction_serialize_on_flex_trits(tx, tx_trits);
+      hash_array_push(pipeline->attached->trytes, tx_trits);
+    }
+    pipeline->attached_num++;
+  }
+  pthread_mutex_unlock(&pipeline->lock);
+  return NULL;
+}
+
+status_t ta_bundle_pipeline_start(ta_bundle_pipeline_t* const pipeline, const ta_config_t* const info,
+                                  const iota_config_t* const iconf, const iota_client_service_t* const service,
+                                  const size_t capacity) {
   status_t ret = SC_OK;
-  tryte_t bundle_hash[NUM_TRYTES_BUNDLE + 1] = {0};
+  if (pipeline == NULL || capacity == 0) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  memset(pipeline, 0, sizeof(ta_bundle_pipeline_t));
+  get_transactions_to_approve_req_t* tx_approve_req = get_transactions_to_approve_req_new();
+  get_transactions_to_approve_res_t* tx_approve_res = get_transactions_to_approve_res_new();
+  pipeline->attached = attach_to_tangle_res_new();
+  bundle_array_new(&pipeline->bundles);
+  if (!tx_approve_req || !tx_approve_res || !pipeline->attached || !pipeline->bundles) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  if (is_option_enabled(info, CLI_GTTA)) {
+    get_transactions_to_approve_req_set_depth(tx_approve_req, iconf->milestone_depth);
+    if (iota_client_get_transactions_to_approve(service, tx_approve_req, tx_approve_res)) {
+      ret = SC_CCLIENT_FAILED_RESPONSE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+  memcpy(pipeline->trunk, get_transactions_to_approve_res_trunk(tx_approve_res), FLEX_TRIT_SIZE_243);
+  memcpy(pipeline->branch, get_transactions_to_approve_res_branch(tx_approve_res), FLEX_TRIT_SIZE_243);
+
+  pipeline->service = service;
+  pipeline->mwm = iconf->mwm;
+  pipeline->capacity = capacity;
+  utarray_reserve(pipeline->bundles, capacity);
+  pthread_mutex_init(&pipeline->lock, NULL);
+  pthread_cond_init(&pipeline->cond, NULL);
+  if (pthread_create(&pipeline->thread, NULL, bundle_pipeline_pow, pipeline)) {
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->cond);
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+done:
+  if (ret) {
+    attach_to_tangle_res_free(&pipeline->attached);
+    if (pipeline->bundles) {
+      bundle_array_free(&pipeline->bundles);
+    }
+  }
+  get_transactions_to_approve_req_free(&tx_approve_req);
+  get_transactions_to_approve_res_free(&tx_approve_res);
+  return ret;
+}
+
+status_t ta_bundle_pipeline_push(ta_bundle_pipeline_t* const pipeline, bundle_transactions_t* const bundle) {
+  status_t ret = SC_OK;
+  Kerl kerl;
+  kerl_init(&kerl);
+  bundle_finalize(bundle, &kerl);
+
+  pthread_mutex_lock(&pipeline->lock);
+  if (pipeline->ret) {
+    ret = pipeline->ret;
+  } else if (bundle_array_size(pipeline->bundles) == pipeline->capacity) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  } else {
+    bundle_array_add(pipeline->bundles, bundle);
+    pthread_cond_signal(&pipeline->cond);
+  }
+  pthread_mutex_unlock(&pipeline->lock);
+  return ret;
+}
+
+static void bundle_pipeline_close(ta_bundle_pipeline_t* const pipeline, const bool cancel) {
+  pthread_mutex_lock(&pipeline->lock);
+  pipeline->closed = true;
+  pipeline->cancelled = cancel;
+  pthread_cond_signal(&pipeline->cond);
+  pthread_mutex_unlock(&pipeline->lock);
+  pthread_join(pipeline->thread, NULL);
+  pthread_mutex_destroy(&pipeline->lock);
+  pthread_cond_destroy(&pipeline->cond);
+}
+
+status_t ta_bundle_pipeline_finish(ta_bundle_pipeline_t* const pipeline) {
+  bundle_pipeline_close(pipeline, false);
+
+  status_t ret = pipeline->ret;
+  if (ret == SC_OK && hash_array_len(pipeline->attached->trytes) > 0 &&
+      iota_client_store_and_broadcast(pipeline->service, (store_transactions_req_t*)pipeline->attached) != RC_OK) {
+    ret = SC_CCLIENT_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  attach_to_tangle_res_free(&pipeline->attached);
+  bundle_array_free(&pipeline->bundles);
+  return ret;
+}
+
+void ta_bundle_pipeline_cancel(ta_bundle_pipeline_t* const pipeline) {
+  bundle_pipeline_close(pipeline, true);
+  attach_to_tangle_res_free(&pipeline->attached);
+  bundle_array_free(&pipeline->bundles);
+}
+
+/** A transaction at the searched address, used to sort bundles by their attachment time */
+typedef struct addr_txn_s {
+  flex_trit_t bundle[FLEX_TRIT_SIZE_243]; /**< Bundle hash of the transaction */
+  tryte_t tag[NUM_TRYTES_TAG];           /**< Tag of the transaction */
+  uint64_t timestamp;                     /**< Attachment time in milliseconds */
+} addr_txn_t;
+
+static int addr_txn_cmp(const void* a, const void* b) {
+  addr_txn_t const* const txn_a = (addr_txn_t const*)a;
+  addr_txn_t const* const txn_b = (addr_txn_t const*)b;
+  if (txn_a->timestamp != txn_b->timestamp) {
+    return txn_a->timestamp < txn_b->timestamp ? -1 : 1;
+  }
+  return memcmp(txn_a->bundle, txn_b->bundle, FLEX_TRIT_SIZE_243);
+}
+
+status_t ta_get_bundle_hashes_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
+                                      tryte_t const* const since, hash243_queue_t* const bundle_hashes) {
+  status_t ret = SC_OK;
+  addr_txn_t* txns = NULL;
+  size_t txn_num = 0;
+  hash243_set_t bundle_hash_set = NULL;
   find_transactions_req_t* txn_req = find_transactions_req_new();
   find_transactions_res_t* txn_res = find_transactions_res_new();
   ta_find_transaction_objects_req_t* obj_req = ta_find_transaction_objects_req_new();
@@ -506,29 +718,60 @@ status_t ta_get_bundles_by_addr(const iota_client_service_t* const service, tryt
     goto done;
   }
 
+  txns = (addr_txn_t*)malloc(sizeof(addr_txn_t) * (utarray_len(obj_res) + 1));
+  if (txns == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
   iota_transaction_t* curr_tx = NULL;
-  bundle_transactions_t* bundle = NULL;
-  hash243_set_t bundle_hash_set = NULL;
   TX_OBJS_FOREACH(obj_res, curr_tx) {
-    if (!hash243_set_contains(bundle_hash_set, transaction_bundle(curr_tx))) {
-      bundle_transactions_new(&bundle);
-      flex_trits_to_trytes(bundle_hash, NUM_TRYTES_BUNDLE, transaction_bundle(curr_tx), NUM_TRITS_BUNDLE,
-                           NUM_TRITS_BUNDLE);
-      ret = ta_get_bundle(service, bundle_hash, bundle);
-      if (ret != SC_OK) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        bundle_transactions_free(&bundle);
-        goto done;
+    memcpy(txns[txn_num].bundle, transaction_bundle(curr_tx), FLEX_TRIT_SIZE_243);
+    flex_trits_to_trytes(txns[txn_num].tag, NUM_TRYTES_TAG, transaction_tag(curr_tx), NUM_TRITS_TAG, NUM_TRITS_TAG);
+    txns[txn_num].timestamp = transaction_attachment_timestamp(curr_tx)
+                                  ? (uint64_t)transaction_attachment_timestamp(curr_tx)
+                                  : (uint64_t)transaction_timestamp(curr_tx) * 1000;
+    txn_num++;
+  }
+  qsort(txns, txn_num, sizeof(addr_txn_t), addr_txn_cmp);
+
+  // Keep the first transaction of each bundle, so bundles are ordered by the earliest attachment time
+  size_t bundle_num = 0;
+  for (size_t i = 0; i < txn_num; i++) {
+    if (!hash243_set_contains(bundle_hash_set, txns[i].bundle)) {
+      hash243_set_add(&bundle_hash_set, txns[i].bundle);
+      txns[bundle_num++] = txns[i];
+    }
+  }
+
+  // Skip the bundles up to the one matching `since`. Every bundle is returned if it is not found.
+  size_t first = 0;
+  if (since) {
+    const size_t since_len = strnlen((char const*)since, NUM_TRYTES_HASH);
+    flex_trit_t since_trits[FLEX_TRIT_SIZE_243];
+    if (since_len == NUM_TRYTES_HASH) {
+      flex_trits_from_trytes(since_trits, NUM_TRITS_HASH, since, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    }
+    for (size_t i = 0; i < bundle_num && since_len > 0; i++) {
+      // A MAM message ID is stored at the beginning of the tag
+      if ((since_len == NUM_TRYTES_HASH && !memcmp(txns[i].bundle, since_trits, FLEX_TRIT_SIZE_243)) ||
+          (since_len <= NUM_TRYTES_TAG && !memcmp(txns[i].tag, since, since_len))) {
+        first = i + 1;
       }
+    }
+  }
 
-      bundle_array_add(bundle_array, bundle);
-      hash243_set_add(&bundle_hash_set, transaction_bundle(curr_tx));
-      bundle_transactions_free(&bundle);
+  for (size_t i = first; i < bundle_num; i++) {
+    if (hash243_queue_push(bundle_hashes, txns[i].bundle) != RC_OK) {
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
     }
   }
-  hash243_set_free(&bundle_hash_set);
 
 done:
+  free(txns);
+  hash243_set_free(&bundle_hash_set);
   find_transactions_req_free(&txn_req);
   find_transactions_res_free(&txn_res);
   ta_find_transaction_objects_req_free(&obj_req);
@@ -536,6 +779,37 @@ done:
   return ret;
 }
 
+status_t ta_get_bundles_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
+                                bundle_array_t* bundle_array) {
+  tryte_t bundle_hash[NUM_TRYTES_BUNDLE + 1] = {0};
+  hash243_queue_t bundle_hashes = NULL;
+  hash243_queue_entry_t* entry = NULL;
+  status_t ret = ta_get_bundle_hashes_by_addr(service, addr, NULL, &bundle_hashes);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  CDL_FOREACH(bundle_hashes, entry) {
+    bundle_transactions_t* bundle = NULL;
+    bundle_transactions_new(&bundle);
+    flex_trits_to_trytes(bundle_hash, NUM_TRYTES_BUNDLE, entry->hash, NUM_TRITS_BUNDLE, NUM_TRITS_BUNDLE);
+    ret = ta_get_bundle(service, bundle_hash, bundle);
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      bundle_transactions_free(&bundle);
+      goto done;
+    }
+
+    bundle_array_add(bundle_array, bundle);
+    bundle_transactions_free(&bundle);
+  }
+
+done:
+  hash243_queue_free(&bundle_hashes);
+  return ret;
+}
+
 status_t ta_get_node_status(const iota_client_service_t* const service) {
   status_t ret = SC_OK;
   char const* const getnodeinfo = "{\"command\": \"getNodeInfo\"}";
@@ -575,8 +849,105 @@ done:
   return ret;
 }
 
-status_t push_txn_to_buffer(const ta_cache_t* const cache, hash8019_array_p raw_txn_flex_trit_array, char* uuid) {
+status_t ta_buffer_request(const ta_cache_t* const cache, const spool_record_type_t type, const char* const uuid,
+                           const void* const value, const size_t value_len, const bool spool_fallback) {
+  status_t ret = SC_OK;
+  if (cache == NULL || uuid == NULL || value == NULL) {
+    ret = SC_NULL;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  const char* const list_name = (type == SPOOL_RECORD_MAM) ? cache->mam_buffer_list_name : cache->buffer_list_name;
+  const int timeout = (type == SPOOL_RECORD_MAM) ? cache->timeout : 0;
+
+  ret = cache_set(uuid, UUID_STR_LEN - 1, value, value_len, timeout);
+  if (ret == SC_OK) {
+    ret = cache_list_push(list_name, strlen(list_name), uuid, UUID_STR_LEN - 1);
+    if (ret) {
+      // Remove the orphaned value, so the request can be buffered again with the same UUID
+      cache_del(uuid);
+    }
+  }
+  if (ret == SC_OK) {
+    // The UUID is written twice, one as the key of the request and the other as the element of buffer list
+    ret = cache_eviction_track(uuid, value_len + 2 * (UUID_STR_LEN - 1));
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+    }
+    return ret;
+  }
+
+  if (!spool_fallback || cache->spool == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  ta_log_warning("Caching service is unavailable. Buffer request %s in local spool.\n", uuid);
+  ret = spool_append(cache->spool, type, uuid, value, value_len);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
+
+#define DIGEST_CURRENT_INDEX_OFFSET \
+  (NUM_TRITS_SIGNATURE + NUM_TRITS_ADDRESS + NUM_TRITS_VALUE + NUM_TRITS_OBSOLETE_TAG + NUM_TRITS_TIMESTAMP)
+#define DIGEST_TAG_OFFSET \
+  (DIGEST_CURRENT_INDEX_OFFSET + NUM_TRITS_CURRENT_INDEX + NUM_TRITS_LAST_INDEX + 3 * NUM_TRITS_HASH)
+
+/**
+ * @brief Compute the digest of the content a client decides in a bundle, i.e. messages, addresses, values, indexes and
+ * tags. Timestamps, obsolete tags and bundle hashes are excluded, since they differ every time the same transfer is
+ * prepared.
+ *
+ * Kerl ignores the last trit of every 243-trit chunk, so only 242 trits of the content are absorbed in each chunk.
+ */
+static void bundle_content_digest(hash8019_array_p txn_array, char* digest) {
+  static const size_t fields[][2] = {
+      {0, NUM_TRITS_SIGNATURE + NUM_TRITS_ADDRESS + NUM_TRITS_VALUE},
+      {DIGEST_CURRENT_INDEX_OFFSET, NUM_TRITS_CURRENT_INDEX + NUM_TRITS_LAST_INDEX},
+      {DIGEST_TAG_OFFSET, NUM_TRITS_TAG},
+  };
+  trit_t txn_trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  trit_t chunk[NUM_TRITS_HASH] = {0};
+  trit_t hash[NUM_TRITS_HASH];
+  flex_trit_t* elt = NULL;
+  Kerl kerl;
+  kerl_init(&kerl);
+
+  HASH_ARRAY_FOREACH(txn_array, elt) {
+    size_t used = 0;
+    flex_trits_to_trits_simd(txn_trits, NUM_TRITS_SERIALIZED_TRANSACTION, elt, NUM_TRITS_SERIALIZED_TRANSACTION,
+                             NUM_TRITS_SERIALIZED_TRANSACTION);
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+      for (size_t j = fields[i][0]; j < fields[i][0] + fields[i][1]; j++) {
+        chunk[used++] = txn_trits[j];
+        if (used == NUM_TRITS_HASH - 1) {
+          kerl_absorb(&kerl, chunk, NUM_TRITS_HASH);
+          used = 0;
+        }
+      }
+    }
+    // Pad the last chunk, so chunks never straddle two transactions
+    if (used) {
+      memset(chunk + used, 0, sizeof(trit_t) * (NUM_TRITS_HASH - used));
+      kerl_absorb(&kerl, chunk, NUM_TRITS_HASH);
+    }
+  }
+
+  kerl_squeeze(&kerl, hash, NUM_TRITS_HASH);
+  trits_to_trytes(hash, (tryte_t*)digest, NUM_TRITS_HASH);
+  digest[NUM_TRYTES_HASH] = '\0';
+}
+
+status_t push_txn_to_buffer(const ta_cache_t* const cache, hash8019_array_p raw_txn_flex_trit_array, const uint8_t mwm,
+                            char* uuid) {
   status_t ret = SC_OK;
+  char* blob = NULL;
+  size_t blob_len = 0;
+  char digest[NUM_TRYTES_HASH + 1];
+  bool claimed = false;
   if (!uuid) {
     ret = SC_NULL;
     ta_log_error("%s\n", ta_error_to_string(ret));
@@ -591,31 +962,140 @@ status_t push_txn_to_buffer(const ta_cache_t* const cache, hash8019_array_p raw_
     goto done;
   }
 
-  const int len = hash_array_len(raw_txn_flex_trit_array);
+  if (cache->dedup_window > 0) {
+    char existing_uuid[UUID_STR_LEN];
+    bool duplicated = false;
+    bundle_content_digest(raw_txn_flex_trit_array, digest);
+    if (cache_dedup_claim(digest, uuid, cache->buffer_list_name, cache->dedup_window, existing_uuid, &duplicated) ==
+        SC_OK) {
+      if (duplicated) {
+        ta_log_info("Transfer has been buffered as %s\n", existing_uuid);
+        strncpy(uuid, existing_uuid, UUID_STR_LEN);
+        goto done;
+      }
+      claimed = true;
+    }
+  }
+
   // We assume all the transactions in a single hash_array would be in the same bundle, since we buffer transaction only
   // when 'ta_send_trytes()' fails, it implies 'ta_send_trytes()' can send only one bundle
   // each time.
-  for (int i = 0; i < len; ++i) {
-    ret = cache_list_push(uuid, UUID_STR_LEN - 1, hash_array_at(raw_txn_flex_trit_array, i),
-                          NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
-    if (ret) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+  bundle_blob_header_t header = {.mwm = mwm, .buffered_timestamp = current_timestamp_ms(), .broadcast_timestamp = 0};
+  ret = bundle_blob_encode(&header, raw_txn_flex_trit_array, &blob, &blob_len);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = ta_buffer_request(cache, SPOOL_RECORD_BUNDLE, uuid, blob, blob_len, true);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+done:
+  if (ret && claimed) {
+    cache_dedup_release(digest);
+  }
+  free(blob);
+  return ret;
+}
+
+status_t upgrade_buffered_txn(const char* const uuid, const uint8_t mwm, const bool sent) {
+  status_t ret = SC_OK;
+  bool is_list = false;
+  char* txns = NULL;
+  int txn_num = 0;
+  char* blob = NULL;
+  size_t blob_len = 0;
+  hash8019_array_p txn_array = NULL;
+
+  ret = cache_is_list(uuid, &is_list);
+  if (ret || !is_list) {
+    goto done;
+  }
+
+  ret = cache_list_range(uuid, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION, &txns, &txn_num);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
   }
 
-  ret = cache_list_push(cache->buffer_list_name, strlen(cache->buffer_list_name), uuid, UUID_STR_LEN - 1);
+  // Transactions are kept in the order previous versions read them
+  txn_array = hash8019_array_new();
+  for (int i = 0; i < txn_num; ++i) {
+    hash_array_push(txn_array, txns + i * NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+  }
+  const uint64_t now = current_timestamp_ms();
+  bundle_blob_header_t header = {.mwm = mwm, .buffered_timestamp = now, .broadcast_timestamp = sent ? now : 0};
+  ret = bundle_blob_encode(&header, txn_array, &blob, &blob_len);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // The list is replaced at once, so readers never find the request missing
+  ret = cache_set_overwrite(uuid, UUID_STR_LEN - 1, blob, blob_len, 0);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  ta_log_info("Upgraded buffered request %s\n", uuid);
+
+  cache_eviction_untrack(uuid);
+  ret = cache_eviction_track(uuid, blob_len + 2 * (UUID_STR_LEN - 1));
   if (ret) {
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
 
 done:
+  free(txns);
+  free(blob);
+  hash_array_free(txn_array);
+  return ret;
+}
+
+/**
+ * @brief Convert a sent bundle buffered by a previous version into a bundle blob
+ *
+ * The bundle is rewritten, so the conversion takes the write lock, which other requests and the periodical task are
+ * excluded with. It is called without holding the lock.
+ *
+ * @param[in] cache Cache configuration holding the lock
+ * @param[in] uuid UUID of the buffered request
+ *
+ * @return
+ * - SC_OK on success, with the read lock held
+ * - non-zero on error, without holding the lock
+ */
+static status_t upgrade_sent_txn(const ta_cache_t* const cache, const char* const uuid) {
+  status_t ret = SC_OK;
+  if (pthread_rwlock_trywrlock(cache->rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  ret = upgrade_buffered_txn(uuid, 0, true);
+  if (pthread_rwlock_unlock(cache->rwlock)) {
+    ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
+  }
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  if (pthread_rwlock_tryrdlock(cache->rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
   return ret;
 }
 
 status_t ta_fetch_txn_with_uuid(const ta_cache_t* const cache, const char* const uuid,
                                 ta_fetch_buffered_request_status_res_t* res) {
   status_t ret = SC_OK;
+  char* blob = NULL;
+  size_t blob_len = 0;
+  hash8019_array_p txn_array = NULL;
   if (pthread_rwlock_tryrdlock(cache->rwlock)) {
     ret = SC_CACHE_LOCK_FAILURE;
     ta_log_error("%s\n", ta_error_to_string(ret));
@@ -647,24 +1127,41 @@ status_t ta_fetch_txn_with_uuid(const ta_cache_t* const cache, const char* const
   if (exist) {
     res->status = MAM_BUFREQ_SENT;
 
-    int len = 0;
-    ret = cache_list_size(uuid, &len);
+    bool is_list = false;
+    ret = cache_is_list(uuid, &is_list);
+    if (ret == SC_OK && is_list) {
+      if (pthread_rwlock_unlock(cache->rwlock)) {
+        ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
+      }
+      ret = upgrade_sent_txn(cache, uuid);
+      if (ret) {
+        goto done;
+      }
+    }
+    if (ret == SC_OK) {
+      ret = cache_get_blob(uuid, &blob, &blob_len);
+    }
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
+      if (pthread_rwlock_unlock(cache->rwlock)) {
+        ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
+      }
       goto done;
     }
     if (pthread_rwlock_unlock(cache->rwlock)) {
       ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
     }
 
-    for (int i = 0; i < len; ++i) {
-      flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION + 1];
-      ret = cache_list_at(uuid, i, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION, (char*)txn_flex_trits);
-      if (ret) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
-      iota_transaction_t* txn = transaction_deserialize(txn_flex_trits, false);
+    bundle_blob_header_t header;
+    txn_array = hash8019_array_new();
+    ret = bundle_blob_decode(blob, blob_len, &header, txn_array);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+
+    for (int i = 0; i < header.txn_num; ++i) {
+      iota_transaction_t* txn = transaction_deserialize(hash_array_at(txn_array, i), false);
 
       if (bundle_transactions_add(res->bundle, txn) != RC_OK) {
         ret = SC_NULL;
@@ -680,6 +1177,7 @@ status_t ta_fetch_txn_with_uuid(const ta_cache_t* const cache, const char* const
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+    cache_eviction_untrack(uuid);
 
     char pop_uuid[UUID_STR_LEN];
     ret = cache_list_pop(cache->complete_list_name, pop_uuid);
@@ -694,6 +1192,8 @@ status_t ta_fetch_txn_with_uuid(const ta_cache_t* const cache, const char* const
   }
 
 done:
+  free(blob);
+  hash_array_free(txn_array);
   return ret;
 }
 
@@ -749,6 +1249,7 @@ status_t ta_fetch_mam_with_uuid(const ta_cache_t* const cache, const char* const
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+    cache_eviction_untrack(uuid);
 
     char pop_uuid[UUID_STR_LEN];
     ret = cache_list_pop(cache->mam_complete_list_name, pop_uuid);
@@ -13,13 +13,17 @@
 #include "accelerator/core/request/request.h"
 #include "accelerator/core/response/response.h"
 #include "accelerator/core/serializer/serializer.h"
+#include "common/crypto/kerl/kerl.h"
 #include "common/debug.h"
 #include "common/model/transfer.h"
+#include "common/trinary/trit_tryte.h"
 #include "utils/bundle_array.h"
+#include "utils/bundle_blob.h"
 #include "utils/char_buffer_str.h"
 #include "utils/containers/hash/hash243_set.h"
 #include "utils/time.h"
 #include "utils/timer.h"
+#include "utils/trit_pack.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -185,6 +189,75 @@ status_t ta_get_bundle(const iota_client_service_t* const service, tryte_t const
 status_t ta_send_bundle(const ta_config_t* const info, const iota_config_t* const iconf,
                         const iota_client_service_t* const service, bundle_transactions_t* const bundle);
 
+/**
+ * A pipeline sending a series of bundles. PoW of the bundles pushed into it is done in a background thread while the
+ * caller builds the next bundle. Every bundle approves the one pushed before it, so the bundles share one
+ * `getTransactionsToApprove` call, and they are broadcast together after the last one is done.
+ */
+typedef struct ta_bundle_pipeline_s {
+  const iota_client_service_t* service;
+  uint8_t mwm;
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];  /**< Trunk of the next bundle, the tail of the last bundle done PoW */
+  flex_trit_t branch[FLEX_TRIT_SIZE_243]; /**< Branch of every bundle */
+  bundle_array_t* bundles;                /**< Bundles pushed into the pipeline */
+  size_t capacity;                        /**< Maximum number of bundles pushed into the pipeline */
+  size_t attached_num;                    /**< Number of bundles done PoW */
+  attach_to_tangle_res_t* attached;       /**< Trytes of the bundles done PoW */
+  bool closed;                            /**< Whether no more bundle will be pushed */
+  bool cancelled;                         /**< Whether the bundles not done PoW are dropped */
+  status_t ret;                           /**< Result of PoW */
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+} ta_bundle_pipeline_t;
+
+/**
+ * @brief Get the tips and start the PoW thread of a bundle pipeline
+ *
+ * @param[out] pipeline The bundle pipeline
+ * @param[in] info Tangle-accelerator configuration variables
+ * @param[in] iconf IOTA API parameter configurations
+ * @param[in] service IOTA full node end point service
+ * @param[in] capacity Maximum number of bundles to be pushed
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_bundle_pipeline_start(ta_bundle_pipeline_t* const pipeline, const ta_config_t* const info,
+                                  const iota_config_t* const iconf, const iota_client_service_t* const service,
+                                  const size_t capacity);
+
+/**
+ * @brief Finalize a bundle and push it into a bundle pipeline. The bundle is copied, so it can be reused by the caller.
+ *
+ * @param[in] pipeline The bundle pipeline
+ * @param[in,out] bundle The bundle to be sent. Its bundle hash is set after pushed.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error, including the failure of PoW of the bundles pushed before
+ */
+status_t ta_bundle_pipeline_push(ta_bundle_pipeline_t* const pipeline, bundle_transactions_t* const bundle);
+
+/**
+ * @brief Wait for PoW of the pushed bundles, broadcast them and release the pipeline
+ *
+ * @param[in] pipeline The bundle pipeline
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_bundle_pipeline_finish(ta_bundle_pipeline_t* const pipeline);
+
+/**
+ * @brief Drop the pushed bundles without broadcasting any of them, and release the pipeline
+ *
+ * @param[in] pipeline The bundle pipeline
+ */
+void ta_bundle_pipeline_cancel(ta_bundle_pipeline_t* const pipeline);
+
 /**
  * @brief Get the bundle that contains assigned address
  *
@@ -202,6 +275,25 @@ status_t ta_send_bundle(const ta_config_t* const info, const iota_config_t* cons
 status_t ta_get_bundles_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
                                 bundle_array_t* bundle_array);
 
+/**
+ * @brief Get the hashes of the bundles containing assigned address, ordered by their attachment time
+ *
+ * A MAM channel is read by following the bundles on its Channel ID, so a client polling a channel can pass the last
+ * bundle it has read as `since` and only get the bundles attached after it.
+ *
+ * @param[in] service IOTA full node end point service
+ * @param[in] addr searched address in tryte_t
+ * @param[in] since Bundle hash or the beginning of tag (MAM message ID) of the last bundle read. NULL returns every
+ * bundle, and so does a `since` not found at the address.
+ * @param[out] bundle_hashes Bundle hashes attached after `since`, from the oldest one
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_get_bundle_hashes_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
+                                      tryte_t const* const since, hash243_queue_t* const bundle_hashes);
+
 /**
  * @brief Get current connection status. The status will be responded with return value.
  *
@@ -219,22 +311,62 @@ status_t ta_get_bundles_by_addr(const iota_client_service_t* const service, tryt
  */
 status_t ta_get_node_status(const iota_client_service_t* const service);
 
+/**
+ * @brief Buffer a request in the cache server, or in the local spool if the cache server is unavailable
+ *
+ * The request is stored under its UUID, and the UUID is pushed to the buffer list of its type. If the cache server
+ * fails and `spool_fallback` is set, the request is appended to `cache->spool` instead, and would be moved to the
+ * cache server by `replay_spooled_requests()`.
+ *
+ * @param[in] cache Redis configuration variables
+ * @param[in] type Type of the request, which decides the buffer list
+ * @param[in] uuid UUID of the request
+ * @param[in] value Buffered request
+ * @param[in] value_len Length of the buffered request
+ * @param[in] spool_fallback Whether to fall back to the local spool
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_buffer_request(const ta_cache_t* const cache, const spool_record_type_t type, const char* const uuid,
+                           const void* const value, const size_t value_len, const bool spool_fallback);
+
 /**
  * @brief Push failed transactions in raw trytes into transaction buffer
  *
  * Given raw trytes array would be pushed into buffer. An UUID will be returned for client to fetch the information of
- * their request. The UUIDs are stored in a list, so once reaching the capacity of the buffer, buffered transactions can
- * be popped from the buffer.
+ * their request. The whole bundle is stored as a single blob under the UUID. The UUIDs are stored in a list, so once
+ * reaching the capacity of the buffer, buffered transactions can be popped from the buffer. If the cache server is
+ * unavailable, the blob is buffered in the local spool.
  *
  * @param[in] cache Redis configuration variables
  * @param[in] raw_txn_flex_trit_array Raw transaction trytes array in flex_trit_t type
+ * @param[in] mwm Minimum weight magnitude the bundle would be attached with
  * @param[out] uuid Returned UUID for fetching transaction status and information
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t push_txn_to_buffer(const ta_cache_t* const cache, hash8019_array_p raw_txn_flex_trit_array, char* uuid);
+status_t push_txn_to_buffer(const ta_cache_t* const cache, hash8019_array_p raw_txn_flex_trit_array, const uint8_t mwm,
+                            char* uuid);
+
+/**
+ * @brief Convert a bundle buffered by a previous version into a bundle blob
+ *
+ * Previous versions buffered a bundle as a list of transactions in `flex_trit_t` under the UUID. Such a list is
+ * replaced with a bundle blob in place, and a bundle blob is left untouched.
+ *
+ * @param[in] uuid UUID of the buffered request
+ * @param[in] mwm Minimum weight magnitude the bundle would be attached with, which previous versions didn't record
+ * @param[in] sent Whether the bundle has been broadcast
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t upgrade_buffered_txn(const char* const uuid, const uint8_t mwm, const bool sent);
 
 /**
  * @brief Return the transaction object status according to the given UUID
@@ -7,9 +7,10 @@
  */
 
 #include "accelerator/core/mam_core.h"
+#include <pthread.h>
 #include "common/model/transfer.h"
-#include "utils/containers/hash/hash_array.h"
 #include "utils/fill_nines.h"
+#include "utils/tag_set.h"
 #include "utils/tryte_byte_conv.h"
 
 #define MAM_LOGGER "mam_core"
@@ -20,11 +21,45 @@
  */
 #define TIMESTAMP_LEN 20
 
+#define MAM_CURSOR_KEY_PREFIX "mam_cursor:"
+#define MAM_CURSOR_KEY_LEN (sizeof(MAM_CURSOR_KEY_PREFIX) - 1 + NUM_TRYTES_HASH + NUM_TRYTES_ADDRESS + 16)
+#define MAM_CURSOR_VALUE_LEN 24
+
+#define MAM_PAYLOAD_KEY_PREFIX "mam_payload:"
+#define MAM_PAYLOAD_KEY_LEN (sizeof(MAM_PAYLOAD_KEY_PREFIX) - 1 + NUM_TRYTES_BUNDLE + 1 + NUM_TRYTES_HASH + 1)
+#define MAM_KEY_CHUNK_TRYTES 80 /**< Trytes of a key absorbed at once, since Kerl ignores the last trit of a chunk */
+
+/**
+ * @brief Position of the next unused MSS key of a seed and a depth
+ *
+ * Cursors are stored in the cache server, so they are shared by tangle-accelerator instances and kept across restarts.
+ */
+typedef struct mam_cursor_s {
+  int channel_ord; /**< Ordinal of the channel which has unused keys */
+  int key_ord;     /**< Keys with smaller ordinals in the channel are used */
+} mam_cursor_t;
+
 typedef struct channel_info_s {
   int32_t ch_mss_depth;
   tryte_t *chid;
+  bool use_cursor;                         /**< Whether to start from the channel cursor */
+  char cursor_key[MAM_CURSOR_KEY_LEN + 1]; /**< Key of the channel cursor */
+  mam_cursor_t cursor;                     /**< Position after the key used by the written message */
 } channel_info_t;
 
+/** Bundles shared by the workers decoding them */
+typedef struct mam_recv_work_s {
+  mam_api_t const *api;         /**< API object cloned by each worker. It is only read while workers run. */
+  tryte_t const *seed;          /**< Seed of `api` */
+  bundle_array_t *bundle_array; /**< Bundles to be decoded */
+  size_t bundle_num;            /**< Number of bundles */
+  size_t next;                  /**< Index of the next bundle to be decoded */
+  char **payloads;              /**< Decoded payloads in the order of bundles */
+  status_t *rets;               /**< Results of decoding in the order of bundles */
+  mam_pk_t_set_t trusted_ch;    /**< Trusted channels of all the workers, including the announced ones */
+  pthread_mutex_t lock;         /**< Protects `trusted_ch` */
+} mam_recv_work_t;
+
 static logger_id_t logger_id;
 
 void ta_mam_logger_init() { logger_id = logger_helper_enable(MAM_LOGGER, LOGGER_DEBUG, true); }
@@ -85,30 +120,15 @@ static status_t ta_mam_write_packet(mam_api_t *const api, char const *const payl
  * @brief Find whether the tag of the first transaction of the bundle has already existed on Tangle, which means this
  * current Header has been published.
  *
- * @param tag_array[in,out] A tag array contains all the tags under the given Channel ID
- * @param bundle[out] The bundle contains the Header may be used
+ * @param msg_id_set[in] A tag set contains all the tags under the given Channel ID
+ * @param tag[in] The tag of the Header may be used
  *
- * @return Return true is the tags exist in tag array
+ * @return Return true is the tag exists in tag set
  */
-static bool msg_id_exist(hash81_array_p tag_array, flex_trit_t *tag) {
-  bool existed = false;
-  tryte_t tag_tryte[NUM_TRYTES_TAG + 1], tag_cursor_tryte[NUM_TRYTES_TAG + 1];
-  tag_tryte[NUM_TRYTES_TAG] = 0;
-  tag_cursor_tryte[NUM_TRYTES_TAG] = 0;
-
+static bool msg_id_exist(tag_set_t const *const msg_id_set, flex_trit_t const *const tag) {
+  tryte_t tag_tryte[NUM_TRYTES_TAG];
   flex_trits_to_trytes(tag_tryte, NUM_TRYTES_TAG, tag, NUM_FLEX_TRITS_TAG, NUM_FLEX_TRITS_TAG);
-
-  flex_trit_t *tag_cursor = NULL;
-  for (tag_cursor = (flex_trit_t *)utarray_front(tag_array); tag_cursor != NULL;
-       tag_cursor = (flex_trit_t *)utarray_next(tag_array, tag_cursor)) {
-    flex_trits_to_trytes(tag_cursor_tryte, NUM_TRYTES_TAG, tag_cursor, NUM_FLEX_TRITS_TAG, NUM_FLEX_TRITS_TAG);
-    if (!memcmp(tag_cursor_tryte, tag_tryte, NUM_TRYTES_MAM_MSG_ID)) {
-      existed = true;
-      break;
-    }
-  }
-
-  return existed;
+  return tag_set_contains(msg_id_set, tag_tryte);
 }
 
 /**
@@ -247,46 +267,85 @@ static inline void mam_encrypt_key_free(mam_encrypt_key_t *mam_key) {
 }
 
 /**
- * @brief Initialize a 'mam_api_t' object
+ * @brief Name the channel cursor after a Kerl digest of the MAM secret key, so the seed is never revealed to the cache
+ * server. The depth and the starting Channel ID are appended, since both of them change the channels to be walked.
  *
- * @param api[in,out] The MAM API object
- * @param[in] iconf IOTA API parameter configurations
- * @param seed[in] Seed of MAM channels. It is an optional choice
+ * @param[in] api The MAM API object
+ * @param[in,out] channel_info Depth and starting Channel ID. The name is returned in `cursor_key`.
+ */
+static void mam_cursor_key(mam_api_t const *const api, channel_info_t *const channel_info) {
+  trit_t chunk[NUM_TRITS_HASH] = {0};
+  trit_t hash[NUM_TRITS_HASH];
+  tryte_t digest[NUM_TRYTES_HASH];
+  Kerl kerl;
+  kerl_init(&kerl);
+
+  // Kerl ignores the last trit of each chunk, so the last trit of the secret key is absorbed in another chunk
+  memcpy(chunk, api->prng.secret_key, sizeof(trit_t) * (NUM_TRITS_HASH - 1));
+  kerl_absorb(&kerl, chunk, NUM_TRITS_HASH);
+  memset(chunk, 0, sizeof(chunk));
+  chunk[0] = api->prng.secret_key[NUM_TRITS_HASH - 1];
+  kerl_absorb(&kerl, chunk, NUM_TRITS_HASH);
+  kerl_squeeze(&kerl, hash, NUM_TRITS_HASH);
+  trits_to_trytes(hash, digest, NUM_TRITS_HASH);
+
+  snprintf(channel_info->cursor_key, sizeof(channel_info->cursor_key), MAM_CURSOR_KEY_PREFIX "%.*s:%d:%.*s",
+           NUM_TRYTES_HASH, (char *)digest, channel_info->ch_mss_depth, channel_info->chid ? NUM_TRYTES_ADDRESS : 0,
+           channel_info->chid ? (char *)channel_info->chid : "");
+}
+
+/**
+ * @brief Get a channel cursor from the cache server
+ *
+ * @param[in] key Key of the channel cursor
+ * @param[in] channel_depth Depth of channel merkle tree
+ * @param[out] cursor Channel cursor
  *
  * @return
  * - SC_OK on success
+ * - SC_MAM_NOT_FOUND if the cursor is malformed
  * - non-zero on error
  */
-static status_t ta_mam_init(mam_api_t *const api, const iota_config_t *const iconf, tryte_t const *const seed) {
-  if (!api || (!iconf && !seed)) {
-    return SC_NULL;
+static status_t mam_cursor_get(char const *const key, const size_t channel_depth, mam_cursor_t *const cursor) {
+  char *value = NULL;
+  status_t ret = cache_get(key, &value);
+  if (ret) {
+    return ret;
   }
 
-  if (seed) {
-    if (mam_api_init(api, seed) != RC_OK) {
-      ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
-      return SC_MAM_FAILED_INIT;
-    }
-  } else {
-    // Use local MAM file on the current machine
-    retcode_t rc = mam_api_load(iconf->mam_file_path, api, NULL, 0);
-    if (rc == RC_UTILS_FAILED_TO_OPEN_FILE) {
-      if (mam_api_init(api, (tryte_t *)iconf->seed) != RC_OK) {
-        ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
-        return SC_MAM_FAILED_INIT;
-      }
-    } else if (rc != RC_OK) {
-      ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
-      return SC_MAM_FAILED_INIT;
-    }
+  if (sscanf(value, "%d:%d", &cursor->channel_ord, &cursor->key_ord) != 2 || cursor->channel_ord < 0 ||
+      cursor->key_ord < 0 || cursor->key_ord >= (1 << channel_depth)) {
+    ret = SC_MAM_NOT_FOUND;
+    ta_log_warning("Ignore malformed MAM channel cursor %s\n", key);
   }
+  free(value);
+  return ret;
+}
 
-  return SC_OK;
+/**
+ * @brief Record a channel cursor in the cache server. Failing to record it only makes the next request find the unused
+ * key on the Tangle.
+ *
+ * @param[in] key Key of the channel cursor
+ * @param[in] channel_depth Depth of channel merkle tree
+ * @param[in] cursor Channel cursor
+ */
+static void mam_cursor_set(char const *const key, const size_t channel_depth, mam_cursor_t cursor) {
+  char value[MAM_CURSOR_VALUE_LEN];
+  if (cursor.key_ord >= (1 << channel_depth)) {
+    cursor.channel_ord++;
+    cursor.key_ord = 0;
+  }
+
+  const int value_len = snprintf(value, sizeof(value), "%d:%d", cursor.channel_ord, cursor.key_ord);
+  if (cache_set_overwrite(key, strlen(key), value, value_len, 0) != SC_OK) {
+    ta_log_debug("Failed to record MAM channel cursor %s\n", key);
+  }
 }
 
 static status_t create_channel_fetch_all_transactions(const iota_client_service_t *const service, mam_api_t *const api,
                                                       const size_t channel_depth, bool first_iter, tryte_t *const chid,
-                                                      hash81_array_p tag_array) {
+                                                      tag_set_t *const msg_id_set) {
   status_t ret = SC_OK;
   find_transactions_req_t *txn_req = find_transactions_req_new();
   transaction_array_t *obj_res = transaction_array_new();
@@ -299,7 +358,7 @@ static status_t create_channel_fetch_all_transactions(const iota_client_service_
   // We have created a channel when we want to get to the given channel at the first loop in
   // `ta_mam_written_msg_to_bundle()`, so we don't need to create a channel once again.
   if (!first_iter) {
-    if (mam_api_channel_create(api, channel_depth, chid) != RC_OK) {
+    if (mss_cache_channel_create(api, channel_depth, chid) != SC_OK) {
       ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
@@ -318,8 +377,12 @@ static status_t create_channel_fetch_all_transactions(const iota_client_service_
 
   iota_transaction_t *tx = NULL;
   TX_OBJS_FOREACH(obj_res, tx) {
-    if (!msg_id_exist(tag_array, transaction_tag(tx))) {
-      hash_array_push(tag_array, transaction_tag(tx));
+    tryte_t tag_tryte[NUM_TRYTES_TAG];
+    flex_trits_to_trytes(tag_tryte, NUM_TRYTES_TAG, transaction_tag(tx), NUM_FLEX_TRITS_TAG, NUM_FLEX_TRITS_TAG);
+    ret = tag_set_add(msg_id_set, tag_tryte);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
     }
   }
 
@@ -339,7 +402,7 @@ static bool is_setting_changed(const iota_client_service_t *const service, mam_a
     goto done;
   }
 
-  if (mam_api_channel_create(api, channel_depth, chid) != RC_OK) {
+  if (mss_cache_channel_create(api, channel_depth, chid) != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_CREATE_OR_GET_ID));
     goto done;
   }
@@ -368,9 +431,14 @@ done:
  * With given channel_depth and endpoint_depth, generate the corresponding Channel ID and Endpoint ID, and write the
  * payload to a bundle. The payload is signed with secret key which has the smallest ordinal number.
  *
+ * If the channel cursor is used and found, the channel it points to is created directly, and the keys before it are
+ * skipped. Only that channel is checked on the Tangle, so the cost does not grow with the history of the channels.
+ * Otherwise, the channels are checked from the first one. The keys before the cursor are treated as used even if their
+ * messages are not found on the Tangle, so a key is never reused.
+ *
  * @param[in] service IOTA node service
  * @param api[in,out] The MAM API object
- * @param channel_depth[in] Depth of channel merkle tree
+ * @param channel_info[in,out] Depth and starting Channel ID. The position after the used key is returned in the cursor.
  * @param mam_key[in] Key object to encrypt MAM mesage
  * @param payload[in] The message that is going to send with MAM
  * @param bundle[out] The bundle contains the Header and Packets of the current Message
@@ -383,7 +451,7 @@ done:
  * - non-zero on error
  */
 static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const service, mam_api_t *const api,
-                                             const channel_info_t *channel_info, mam_encrypt_key_t mam_key,
+                                             channel_info_t *const channel_info, mam_encrypt_key_t mam_key,
                                              char const *const payload, bundle_transactions_t **bundle,
                                              tryte_t *const chid, tryte_t *const msg_id,
                                              mam_send_operation_t *mam_operation) {
@@ -394,11 +462,35 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
     return ret;
   }
   trit_t msg_id_trits[MAM_MSG_ID_SIZE];
-  hash81_array_p tag_array = hash81_array_new();
+  tag_set_t msg_id_set;
+  // Reserve a slot for every key of a channel, so the set never grows
+  ret = tag_set_init(&msg_id_set, 1 << channel_info->ch_mss_depth);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  bool cursor_found = false;
+  int skipped_key_num = 0;
+
+  // Go to the channel of the cursor directly, instead of walking through the channels used before
+  if (channel_info->use_cursor) {
+    mam_cursor_t cursor;
+    mam_cursor_key(api, channel_info);
+    if (mam_cursor_get(channel_info->cursor_key, channel_info->ch_mss_depth, &cursor) == SC_OK) {
+      api->channel_ord = cursor.channel_ord;
+      if (mss_cache_channel_create(api, channel_info->ch_mss_depth, chid) != SC_OK) {
+        ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      cursor_found = true;
+      skipped_key_num = cursor.key_ord;
+    }
+  }
 
   // Get to the assigned beginning channel ID. If the initial setting is different, then tangle-accelerator won't be
   // able to generate same chid.
-  if (channel_info->chid) {
+  if (channel_info->chid && !cursor_found) {
     // The current setting hasn't been used on Tangle, so we should take the normal procedure.
     if (is_setting_changed(service, api, channel_info->ch_mss_depth, chid)) {
       goto end_find_starting_chid;
@@ -406,7 +498,7 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
 
     int cnt = 0;
     while (memcmp(channel_info->chid, chid, NUM_TRYTES_ADDRESS)) {
-      if (mam_api_channel_create(api, channel_info->ch_mss_depth, chid) != RC_OK) {
+      if (mss_cache_channel_create(api, channel_info->ch_mss_depth, chid) != SC_OK) {
         ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
         ta_log_error("%s\n", ta_error_to_string(ret));
         goto done;
@@ -427,13 +519,12 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
   // loop.
   // FIXME: We should figure out a way to avoid passing 'first_iter_with_given_chid' to
   // 'create_channel_fetch_all_transactions()'
-  bool first_iter_with_given_chid = (bool)channel_info->chid;
+  bool first_iter_with_given_chid = cursor_found || channel_info->chid;
   for (;;) {
-    hash_array_free(tag_array);
-    tag_array = hash81_array_new();
+    tag_set_reset(&msg_id_set);
 
     ret = create_channel_fetch_all_transactions(service, api, channel_info->ch_mss_depth, first_iter_with_given_chid,
-                                                chid, tag_array);
+                                                chid, &msg_id_set);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
@@ -450,10 +541,13 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
     // Calculate the smallest available msg_ord
     const int ch_leaf_num = 1 << channel_info->ch_mss_depth;
     int ch_remain_key_num = ch_leaf_num;
-    int used_key_num = hash_array_len(tag_array);
+    bool found = false;
+    for (; skipped_key_num > 0; skipped_key_num--) {
+      mam_mss_next(&mam_api_channel_get(api, chid)->mss);
+      ch_remain_key_num--;
+    }
     do {
       bundle_transactions_renew(bundle);
-      used_key_num--;
       ch_remain_key_num--;
 
       ret = ta_mam_write_header(api, chid, mam_key.psks, mam_key.ntru_pks, *bundle, msg_id_trits);
@@ -462,22 +556,30 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
         goto done;
       }
 
-      if (!msg_id_exist(tag_array, transaction_tag((iota_transaction_t *)utarray_front(*bundle)))) {
+      if (!msg_id_exist(&msg_id_set, transaction_tag((iota_transaction_t *)utarray_front(*bundle)))) {
         ta_log_debug("%s\n", "Found available msg_id");
+        found = true;
         break;
       }
 
       mam_mss_next(&mam_api_channel_get(api, chid)->mss);
     } while (ch_remain_key_num > 0);
 
+    if (!found) {
+      // Check the next channel, since all the mss key are used in current channel
+      continue;
+    }
+    // `chid` is always the latest created channel
+    channel_info->cursor.channel_ord = api->channel_ord - 1;
+    channel_info->cursor.key_ord = ch_leaf_num - ch_remain_key_num;
+    // Generate the channel to be announced before the announcement needs it
+    mss_cache_prefetch(api, channel_info->ch_mss_depth, ch_remain_key_num);
+
     if (ch_remain_key_num == 1) {
       // Publish announcement, when there is only one mss key available.
       ta_log_debug("%s\n", "Publish announcement for the next channel.");
       *mam_operation = ANNOUNCE_CHID;
       break;
-    } else if (ch_remain_key_num == 0 && used_key_num == 0) {
-      // Check the next channel, since all the mss key are used in current channel
-      continue;
     } else {
       *mam_operation = SEND_MESSAGE;
       break;
@@ -494,7 +596,7 @@ static status_t ta_mam_written_msg_to_bundle(const iota_client_service_t *const
   trits_to_trytes(msg_id_trits, msg_id, MAM_MSG_ID_SIZE);
 
 done:
-  hash_array_free(tag_array);
+  tag_set_destroy(&msg_id_set);
   return ret;
 }
 
@@ -519,7 +621,7 @@ static status_t ta_mam_write_announce_to_bundle(mam_api_t *const api, const size
                                                 bundle_transactions_t **bundle) {
   status_t ret = SC_OK;
   trit_t msg_id[MAM_MSG_ID_SIZE];
-  if (mam_api_channel_create(api, channel_depth, chid1) != RC_OK) {
+  if (mss_cache_channel_create(api, channel_depth, chid1) != SC_OK) {
     ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
@@ -575,6 +677,321 @@ done:
   return ret;
 }
 
+/**
+ * @brief Decode bundles with a clone of the MAM API object, until no bundle is left.
+ *
+ * A clone trusts the same channels and holds the same Pre-Shared Keys, which are all a reader needs.
+ */
+static void *mam_recv_worker(void *arg) {
+  mam_recv_work_t *const work = (mam_recv_work_t *)arg;
+  mam_api_t mam;
+  mam_pk_t_set_entry_t *pk_entry = NULL, *pk_tmp = NULL;
+  mam_psk_t_set_entry_t *psk_entry = NULL, *psk_tmp = NULL;
+  if (mam_api_init(&mam, work->seed) != RC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
+    return NULL;
+  }
+
+  HASH_ITER(hh, work->api->trusted_channel_pks, pk_entry, pk_tmp) {
+    if (mam_pk_t_set_add(&mam.trusted_channel_pks, &pk_entry->value) != RC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
+      goto done;
+    }
+  }
+  HASH_ITER(hh, work->api->psks, psk_entry, psk_tmp) {
+    if (mam_api_add_psk(&mam, &psk_entry->value) != RC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
+      goto done;
+    }
+  }
+
+  for (;;) {
+    const size_t idx = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED);
+    if (idx >= work->bundle_num) {
+      break;
+    }
+    work->rets[idx] = ta_mam_api_bundle_read(&mam, bundle_array_at(work->bundle_array, idx), &work->payloads[idx]);
+  }
+
+  pthread_mutex_lock(&work->lock);
+  HASH_ITER(hh, mam.trusted_channel_pks, pk_entry, pk_tmp) {
+    mam_pk_t_set_add(&work->trusted_ch, &pk_entry->value);
+  }
+  pthread_mutex_unlock(&work->lock);
+
+done:
+  mam_api_destroy(&mam);
+  return NULL;
+}
+
+/**
+ * @brief Read the MAM messages from bundles
+ *
+ * Decrypting and verifying the signature of a message are CPU-heavy, so bundles are decoded by `workers` threads, each
+ * with its own clone of `api`. Payloads are returned in the order of bundles, and the channels announced in the bundles
+ * are added to the trusted channels of `api`. Clones do not share announcements, so every bundle should be readable
+ * with the channels trusted beforehand. That holds for the bundles fetched from a single Channel ID or bundle hash.
+ *
+ * @param api[in,out] The MAM API object
+ * @param seed[in] Seed of the MAM API object
+ * @param workers[in] Number of threads. Bundles are decoded in the calling thread if it is less than 2.
+ * @param bundle_array[in] Bundles to be read
+ * @param payload_array[out] Payloads in ascii. A bundle without payload adds NULL.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on the first bundle failed to be read. Payloads before it are still returned.
+ */
+static status_t ta_mam_read_bundles(mam_api_t *const api, tryte_t const *const seed, const int workers,
+                                    bundle_array_t *const bundle_array, UT_array *const payload_array) {
+  status_t ret = SC_OK;
+  const size_t bundle_num = bundle_array_size(bundle_array);
+  if (workers < 2 || bundle_num < 2) {
+    bundle_transactions_t *bundle = NULL;
+    BUNDLE_ARRAY_FOREACH(bundle_array, bundle) {
+      char *payload = NULL;
+      ret = ta_mam_api_bundle_read(api, bundle, &payload);
+      if (ret != SC_OK && ret != SC_MAM_NO_PAYLOAD) {
+        // If we read a bundle which contains MAM announcement, then it will return "SC_MAM_NO_PAYLOAD"
+        return ret;
+      }
+
+      utarray_push_back(payload_array, &payload);
+      free(payload);
+    }
+    return SC_OK;
+  }
+
+  const size_t worker_num = (size_t)workers < bundle_num ? (size_t)workers : bundle_num;
+  size_t spawned = 0;
+  mam_recv_work_t work = {.api = api, .seed = seed, .bundle_array = bundle_array, .bundle_num = bundle_num};
+  mam_pk_t_set_entry_t *pk_entry = NULL, *pk_tmp = NULL;
+  pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * worker_num);
+  work.payloads = (char **)calloc(bundle_num, sizeof(char *));
+  work.rets = (status_t *)malloc(sizeof(status_t) * bundle_num);
+  if (!threads || !work.payloads || !work.rets) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  // Bundles left by workers failing to start are reported as failures
+  for (size_t i = 0; i < bundle_num; i++) {
+    work.rets[i] = SC_MAM_FAILED_INIT;
+  }
+  pthread_mutex_init(&work.lock, NULL);
+
+  for (size_t i = 0; i < worker_num; i++) {
+    if (pthread_create(&threads[spawned], NULL, mam_recv_worker, &work) == 0) {
+      spawned++;
+    }
+  }
+  if (spawned == 0) {
+    mam_recv_worker(&work);
+  }
+  for (size_t i = 0; i < spawned; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&work.lock);
+
+  for (size_t i = 0; i < bundle_num; i++) {
+    if (work.rets[i] != SC_OK && work.rets[i] != SC_MAM_NO_PAYLOAD) {
+      ret = work.rets[i];
+      break;
+    }
+    utarray_push_back(payload_array, &work.payloads[i]);
+  }
+  HASH_ITER(hh, work.trusted_ch, pk_entry, pk_tmp) {
+    mam_pk_t_set_add(&api->trusted_channel_pks, &pk_entry->value);
+  }
+
+done:
+  if (work.payloads) {
+    for (size_t i = 0; i < bundle_num; i++) {
+      free(work.payloads[i]);
+    }
+  }
+  free(work.payloads);
+  free(work.rets);
+  free(threads);
+  mam_pk_t_set_free(&work.trusted_ch);
+  return ret;
+}
+
+/**
+ * @brief Absorb a number into a Kerl sponge as a chunk in balanced ternary
+ */
+static void kerl_absorb_size(Kerl *const kerl, size_t value) {
+  trit_t chunk[NUM_TRITS_HASH] = {0};
+  for (size_t i = 0; value && i < NUM_TRITS_HASH - 1; i++) {
+    int remainder = value % 3;
+    value /= 3;
+    if (remainder == 2) {
+      remainder = -1;
+      value++;
+    }
+    chunk[i] = remainder;
+  }
+  kerl_absorb(kerl, chunk, NUM_TRITS_HASH);
+}
+
+/**
+ * @brief Digest the decryption keys of a receiving request. Payloads read with keys are cached under the digest, so a
+ * client can only get the cached payloads it can decrypt by itself.
+ *
+ * @param[in] key Decryption keys
+ * @param[out] digest Kerl digest of the keys
+ *
+ * @return
+ * - true if any key is given
+ * - false if no key is given
+ */
+static bool mam_recv_keys_digest(recv_mam_key_mam_v1_t const *const key, tryte_t *const digest) {
+  UT_array *const key_arrays[] = {key->psk_array, key->ntru_array};
+  trit_t chunk[NUM_TRITS_HASH];
+  trit_t hash[NUM_TRITS_HASH];
+  Kerl kerl;
+  if (utarray_len(key->psk_array) + utarray_len(key->ntru_array) == 0) {
+    return false;
+  }
+
+  kerl_init(&kerl);
+  for (size_t i = 0; i < sizeof(key_arrays) / sizeof(key_arrays[0]); i++) {
+    // The number of keys and the length of each key are absorbed as well, so different keys never share a digest
+    kerl_absorb_size(&kerl, utarray_len(key_arrays[i]));
+    char **p = NULL;
+    while ((p = (char **)utarray_next(key_arrays[i], p))) {
+      const size_t len = strlen(*p);
+      kerl_absorb_size(&kerl, len);
+      for (size_t offset = 0; offset < len; offset += MAM_KEY_CHUNK_TRYTES) {
+        const size_t chunk_len = len - offset < MAM_KEY_CHUNK_TRYTES ? len - offset : MAM_KEY_CHUNK_TRYTES;
+        memset(chunk, 0, sizeof(chunk));
+        trytes_to_trits((tryte_t *)*p + offset, chunk, chunk_len);
+        kerl_absorb(&kerl, chunk, NUM_TRITS_HASH);
+      }
+    }
+  }
+  kerl_squeeze(&kerl, hash, NUM_TRITS_HASH);
+  trits_to_trytes(hash, digest, NUM_TRITS_HASH);
+  return true;
+}
+
+/**
+ * @brief Name the decoded payload of a bundle in the cache server
+ *
+ * @param[in] bundle_hash Bundle hash
+ * @param[in] keys_digest Digest of the decryption keys. NULL for the bundles read without keys.
+ * @param[out] key Name of the payload
+ */
+static void mam_payload_key(flex_trit_t const *const bundle_hash, tryte_t const *const keys_digest, char *const key) {
+  tryte_t bundle_trytes[NUM_TRYTES_BUNDLE];
+  flex_trits_to_trytes(bundle_trytes, NUM_TRYTES_BUNDLE, bundle_hash, NUM_TRITS_BUNDLE, NUM_TRITS_BUNDLE);
+  snprintf(key, MAM_PAYLOAD_KEY_LEN, MAM_PAYLOAD_KEY_PREFIX "%.*s%s%.*s", NUM_TRYTES_BUNDLE, (char *)bundle_trytes,
+           keys_digest ? ":" : "", keys_digest ? NUM_TRYTES_HASH : 0, keys_digest ? (char *)keys_digest : "");
+}
+
+/**
+ * @brief Get the payloads of bundles, by looking up the decoded payloads in the cache server and reading the rest.
+ *
+ * MAM bundles are immutable, so the payload of a bundle read once is cached with `cache_ttl`. Bundles without payload
+ * are not cached, since reading them is what adds the announced channels to the trusted channels of `api`.
+ *
+ * @param[in] service IOTA full node end point service
+ * @param[in] api The MAM API object
+ * @param[in] iconf IOTA API parameter configurations
+ * @param[in] key Decryption keys of the request
+ * @param[in] bundle_hashes Bundles to be read
+ * @param[out] payload_array Payloads in the order of `bundle_hashes`. A bundle without payload adds NULL.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error. Payloads before the failed bundle are still returned.
+ */
+static status_t ta_mam_recv_payloads(const iota_client_service_t *const service, mam_api_t *const api,
+                                     const iota_config_t *const iconf, recv_mam_key_mam_v1_t const *const key,
+                                     hash243_queue_t const bundle_hashes, UT_array *const payload_array) {
+  status_t ret = SC_OK, read_ret = SC_OK;
+  const size_t bundle_num = hash243_queue_count(bundle_hashes);
+  tryte_t bundle_hash[NUM_TRYTES_BUNDLE + 1] = {0};
+  tryte_t keys_digest[NUM_TRYTES_HASH];
+  const bool has_keys = mam_recv_keys_digest(key, keys_digest);
+  const bool use_cache = iconf->mam_recv_cache_ttl > 0;
+  char cache_key[MAM_PAYLOAD_KEY_LEN];
+  bundle_array_t *bundle_array = NULL;
+  UT_array *decoded = NULL;
+  char **cached = (char **)calloc(bundle_num + 1, sizeof(char *));
+  hash243_queue_entry_t *entry = NULL;
+  bundle_array_new(&bundle_array);
+  utarray_new(decoded, &ut_str_icd);
+  if (!cached) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Only fetch the bundles whose payloads are not cached
+  size_t idx = 0;
+  CDL_FOREACH(bundle_hashes, entry) {
+    if (use_cache) {
+      mam_payload_key(entry->hash, has_keys ? keys_digest : NULL, cache_key);
+      if (cache_get(cache_key, &cached[idx]) == SC_OK) {
+        idx++;
+        continue;
+      }
+      cached[idx] = NULL;
+    }
+
+    bundle_transactions_t *bundle = NULL;
+    bundle_transactions_new(&bundle);
+    flex_trits_to_trytes(bundle_hash, NUM_TRYTES_BUNDLE, entry->hash, NUM_TRITS_BUNDLE, NUM_TRITS_BUNDLE);
+    ret = ta_get_bundle(service, bundle_hash, bundle);
+    if (ret != SC_OK) {
+      bundle_transactions_free(&bundle);
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    bundle_array_add(bundle_array, bundle);
+    bundle_transactions_free(&bundle);
+    idx++;
+  }
+
+  read_ret = ta_mam_read_bundles(api, (tryte_t *)iconf->seed, iconf->mam_recv_threads, bundle_array, decoded);
+
+  // Merge the cached payloads and the decoded ones back into the order of bundles
+  char **payload = NULL;
+  idx = 0;
+  CDL_FOREACH(bundle_hashes, entry) {
+    if (cached[idx]) {
+      utarray_push_back(payload_array, &cached[idx]);
+    } else {
+      payload = (char **)utarray_next(decoded, payload);
+      if (payload == NULL) {
+        // Bundles after the failed one are not read
+        break;
+      }
+      utarray_push_back(payload_array, payload);
+      if (use_cache && *payload) {
+        mam_payload_key(entry->hash, has_keys ? keys_digest : NULL, cache_key);
+        if (cache_set(cache_key, strlen(cache_key), *payload, strlen(*payload), iconf->mam_recv_cache_ttl) != SC_OK) {
+          ta_log_debug("Failed to cache MAM payload %s\n", cache_key);
+        }
+      }
+    }
+    idx++;
+  }
+  ret = read_ret;
+
+done:
+  if (cached) {
+    for (size_t i = 0; i < bundle_num; i++) {
+      free(cached[i]);
+    }
+  }
+  free(cached);
+  utarray_free(decoded);
+  bundle_array_free(&bundle_array);
+  return ret;
+}
+
 /***********************************************************************************************************
  * External functions
  ***********************************************************************************************************/
@@ -583,7 +1000,8 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
                              const iota_client_service_t *const service, ta_send_mam_req_t const *const req,
                              ta_send_mam_res_t *const res) {
   status_t ret = SC_OK;
-  mam_api_t mam;
+  mam_state_t *state = NULL;
+  mam_api_t *mam = NULL;
   tryte_t chid[MAM_CHANNEL_ID_TRYTE_SIZE] = {}, msg_id[NUM_TRYTES_MAM_MSG_ID] = {};
   bundle_transactions_t *bundle = NULL;
   send_mam_data_mam_v1_t *data = (send_mam_data_mam_v1_t *)req->data;
@@ -591,12 +1009,15 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
   mam_encrypt_key_t mam_key = {.psks = NULL, .ntru_pks = NULL, .ntru_sks = NULL};
   bool msg_sent = false;
   char *message = NULL;
-  // Creating MAM API
-  ret = ta_mam_init(&mam, iconf, data->seed);
+  // Requests with a seed find their channels on the Tangle, so a transient state is used. Otherwise the resident state
+  // recorded in the local MAM file is used.
+  ret = mam_state_acquire(data->seed ? data->seed : (tryte_t *)iconf->seed, data->seed ? NULL : iconf->mam_file_path,
+                          &state);
   if (ret) {
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
+  mam = mam_state_api(state);
 
   ret = ta_set_mam_key(&mam_key, key->psk_array, key->ntru_array, NULL);
   if (ret) {
@@ -608,14 +1029,16 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
   mam_send_operation_t mam_operation;
   while (!msg_sent) {
     bundle_transactions_renew(&bundle);
-    struct channel_info_s channel_info = {.ch_mss_depth = data->ch_mss_depth, .chid = data->chid};
+    // Only requests with a seed find the unused key on the Tangle, while the resident state always knows its channels
+    struct channel_info_s channel_info = {
+        .ch_mss_depth = data->ch_mss_depth, .chid = data->chid, .use_cursor = (data->seed != NULL)};
     clock_gettime(CLOCK_MONOTONIC, &t);
 
     message = (char *)malloc(sizeof(char) * (strlen(data->message) + TIMESTAMP_LEN + 1));
     snprintf(message, TIMESTAMP_LEN + strlen(data->message) + 1, "%020ld%s", t.tv_sec, data->message);
 
     // Write both Header and Packet into one single bundle.
-    ret = ta_mam_written_msg_to_bundle(service, &mam, &channel_info, mam_key, message, &bundle, chid, msg_id,
+    ret = ta_mam_written_msg_to_bundle(service, mam, &channel_info, mam_key, message, &bundle, chid, msg_id,
                                        &mam_operation);
     if (ret == SC_OK) {
       msg_sent = true;
@@ -627,12 +1050,17 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
       goto done;
     }
 
-    // Sending bundle
+    // Sending bundle. The state is unlocked during PoW, since the MSS key has been used in the bundle.
+    mam_state_unlock(state, true);
     ret = ta_send_bundle(info, iconf, service, bundle);
+    mam_state_lock(state);
     if (ret != SC_OK) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+    if (channel_info.use_cursor) {
+      mam_cursor_set(channel_info.cursor_key, data->ch_mss_depth, channel_info.cursor);
+    }
 
     ret = send_mam_res_set_msg_result(res, chid, msg_id, bundle);
     if (ret) {
@@ -645,17 +1073,24 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
       bundle_transactions_renew(&bundle);
       // Send announcement for the next endpoint (epid1) or next channel (chid1)
       tryte_t chid1[MAM_CHANNEL_ID_TRYTE_SIZE] = {};
-      ret = ta_mam_write_announce_to_bundle(&mam, data->ch_mss_depth, chid, mam_key, chid1, &bundle);
+      ret = ta_mam_write_announce_to_bundle(mam, data->ch_mss_depth, chid, mam_key, chid1, &bundle);
       if (ret) {
         ta_log_error("%s\n", ta_error_to_string(ret));
         goto done;
       }
 
+      mam_state_unlock(state, true);
       ret = ta_send_bundle(info, iconf, service, bundle);
+      mam_state_lock(state);
       if (ret) {
         ta_log_error("%s\n", ta_error_to_string(ret));
         goto done;
       }
+      if (channel_info.use_cursor) {
+        // The announcement uses the last key, so the next message goes to the announced channel
+        const mam_cursor_t next_cursor = {.channel_ord = channel_info.cursor.channel_ord + 1, .key_ord = 0};
+        mam_cursor_set(channel_info.cursor_key, data->ch_mss_depth, next_cursor);
+      }
 
       ret = send_mam_res_set_announce(res, chid1, bundle);
       if (ret) {
@@ -666,15 +1101,156 @@ status_t ta_send_mam_message(const ta_config_t *const info, const iota_config_t
   }
 
 done:
-  // Destroy MAM API
-  if (ret != SC_MAM_FAILED_INIT) {
-    // If `seed` is not assigned, then the local MAM file will be used. Therefore, we need to close the MAM file.
-    if (!data->seed && mam_api_save(&mam, iconf->mam_file_path, NULL, 0) != RC_OK) {
-      ret = SC_MAM_FILE_SAVE;
+  // Channels may be created even if sending fails, so the state is always saved
+  if (state) {
+    status_t release_ret = mam_state_release(state, true);
+    if (release_ret) {
+      ret = release_ret;
       ta_log_error("%s\n", ta_error_to_string(ret));
     }
-    if (mam_api_destroy(&mam)) {
-      ret = SC_MAM_FAILED_DESTROYED;
+  }
+  bundle_transactions_free(&bundle);
+  mam_encrypt_key_free(&mam_key);
+  free(message);
+  return ret;
+}
+
+status_t ta_send_mam_messages(const ta_config_t *const info, const iota_config_t *const iconf,
+                              const iota_client_service_t *const service, ta_send_mam_req_t const *const req,
+                              UT_array *const res_array) {
+  status_t ret = SC_OK;
+  mam_state_t *state = NULL;
+  mam_api_t *mam = NULL;
+  tryte_t chid[MAM_CHANNEL_ID_TRYTE_SIZE] = {}, msg_id[NUM_TRYTES_MAM_MSG_ID] = {};
+  trit_t msg_id_trits[MAM_MSG_ID_SIZE];
+  bundle_transactions_t *bundle = NULL;
+  send_mam_data_mam_v1_t *data = (send_mam_data_mam_v1_t *)req->data;
+  send_mam_key_mam_v1_t *key = (send_mam_key_mam_v1_t *)req->key;
+  mam_encrypt_key_t mam_key = {.psks = NULL, .ntru_pks = NULL, .ntru_sks = NULL};
+  ta_bundle_pipeline_t pipeline;
+  bool pipeline_started = false;
+  char *message = NULL;
+  if (data->messages == NULL || res_array == NULL) {
+    ret = SC_NULL;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  const size_t msg_num = utarray_len(data->messages);
+  const int ch_leaf_num = 1 << data->ch_mss_depth;
+  struct channel_info_s channel_info = {
+      .ch_mss_depth = data->ch_mss_depth, .chid = data->chid, .use_cursor = (data->seed != NULL)};
+
+  ret = mam_state_acquire(data->seed ? data->seed : (tryte_t *)iconf->seed, data->seed ? NULL : iconf->mam_file_path,
+                          &state);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  mam = mam_state_api(state);
+
+  ret = ta_set_mam_key(&mam_key, key->psk_array, key->ntru_array, NULL);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Each message may be followed by an announcement
+  ret = ta_bundle_pipeline_start(&pipeline, info, iconf, service, 2 * msg_num);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  pipeline_started = true;
+
+  struct timespec t;
+  mam_send_operation_t mam_operation = SEND_MESSAGE;
+  for (size_t i = 0; i < msg_num; i++) {
+    char const *const payload = *(char const **)utarray_eltptr(data->messages, i);
+    ta_send_mam_res_t res;
+    memset(&res, 0, sizeof(ta_send_mam_res_t));
+    bundle_transactions_renew(&bundle);
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    free(message);
+    message = (char *)malloc(sizeof(char) * (strlen(payload) + TIMESTAMP_LEN + 1));
+    snprintf(message, TIMESTAMP_LEN + strlen(payload) + 1, "%020ld%s", t.tv_sec, payload);
+
+    if (i == 0) {
+      // Only the first message looks for the unused key on the Tangle. The keys after it are unused as well.
+      ret = ta_mam_written_msg_to_bundle(service, mam, &channel_info, mam_key, message, &bundle, chid, msg_id,
+                                         &mam_operation);
+    } else {
+      ret = ta_mam_write_header(mam, chid, mam_key.psks, mam_key.ntru_pks, bundle, msg_id_trits);
+      if (ret == SC_OK && ta_mam_write_packet(mam, message, msg_id_trits, bundle)) {
+        ret = SC_MAM_FAILED_WRITE;
+      }
+      if (ret == SC_OK) {
+        trits_to_trytes(msg_id_trits, msg_id, MAM_MSG_ID_SIZE);
+        channel_info.cursor.key_ord++;
+        mss_cache_prefetch(mam, data->ch_mss_depth, ch_leaf_num - channel_info.cursor.key_ord);
+        // The last key of a channel is left for announcing the next channel
+        mam_operation = (ch_leaf_num - channel_info.cursor.key_ord == 1) ? ANNOUNCE_CHID : SEND_MESSAGE;
+      }
+    }
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+
+    ret = ta_bundle_pipeline_push(&pipeline, bundle);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    send_mam_res_set_msg_result(&res, chid, msg_id, bundle);
+
+    if (mam_operation == ANNOUNCE_CHID) {
+      bundle_transactions_renew(&bundle);
+      tryte_t chid1[MAM_CHANNEL_ID_TRYTE_SIZE] = {};
+      ret = ta_mam_write_announce_to_bundle(mam, data->ch_mss_depth, chid, mam_key, chid1, &bundle);
+      if (ret) {
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+
+      ret = ta_bundle_pipeline_push(&pipeline, bundle);
+      if (ret) {
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      send_mam_res_set_announce(&res, chid1, bundle);
+
+      // The following messages are written to the announced channel
+      memcpy(chid, chid1, MAM_CHANNEL_ID_TRYTE_SIZE);
+      channel_info.cursor.channel_ord++;
+      channel_info.cursor.key_ord = 0;
+      mam_operation = SEND_MESSAGE;
+    }
+    utarray_push_back(res_array, &res);
+  }
+
+  // All the bundles have been written, so the state is unlocked while waiting for their PoW
+  pipeline_started = false;
+  mam_state_unlock(state, true);
+  ret = ta_bundle_pipeline_finish(&pipeline);
+  mam_state_lock(state);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  if (channel_info.use_cursor) {
+    mam_cursor_set(channel_info.cursor_key, data->ch_mss_depth, channel_info.cursor);
+  }
+
+done:
+  if (pipeline_started) {
+    ta_bundle_pipeline_cancel(&pipeline);
+  }
+  // Channels may be created even if sending fails, so the state is always saved
+  if (state) {
+    status_t release_ret = mam_state_release(state, true);
+    if (release_ret) {
+      ret = release_ret;
       ta_log_error("%s\n", ta_error_to_string(ret));
     }
   }
@@ -688,8 +1264,7 @@ status_t ta_recv_mam_message(const iota_config_t *const iconf, const iota_client
                              ta_recv_mam_req_t *const req, ta_recv_mam_res_t *const res) {
   status_t ret = SC_OK;
   mam_api_t mam;
-  bundle_array_t *bundle_array = NULL;
-  bundle_array_new(&bundle_array);
+  hash243_queue_t bundle_hashes = NULL;
   mam_pk_t_set_t init_trusted_ch = NULL;
   mam_encrypt_key_t mam_key = {.psks = NULL, .ntru_pks = NULL, .ntru_sks = NULL};
   recv_mam_data_id_mam_v1_t *data_id = (recv_mam_data_id_mam_v1_t *)req->data_id;
@@ -709,18 +1284,16 @@ status_t ta_recv_mam_message(const iota_config_t *const iconf, const iota_client
   }
 
   if (data_id->bundle_hash) {
-    bundle_transactions_t *bundle = NULL;
-    bundle_transactions_new(&bundle);
-    ret = ta_get_bundle(service, (tryte_t *)data_id->bundle_hash, bundle);
-    if (ret != SC_OK) {
-      bundle_transactions_free(&bundle);
-      ta_log_error("%s\n", "Failed to get bundle by bundle hash");
+    flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
+    flex_trits_from_trytes(bundle_hash, NUM_TRITS_BUNDLE, (tryte_t *)data_id->bundle_hash, NUM_TRYTES_BUNDLE,
+                           NUM_TRYTES_BUNDLE);
+    if (hash243_queue_push(&bundle_hashes, bundle_hash) != RC_OK) {
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
-    bundle_array_add(bundle_array, bundle);
-    bundle_transactions_free(&bundle);
   } else if (data_id->chid) {
-    ret = ta_get_bundles_by_addr(service, (tryte_t *)data_id->chid, bundle_array);
+    ret = ta_get_bundle_hashes_by_addr(service, (tryte_t *)data_id->chid, data_id->since, &bundle_hashes);
     if (ret != SC_OK) {
       ta_log_error("%s\n", "Failed to get bundle by chid");
       goto done;
@@ -750,18 +1323,27 @@ status_t ta_recv_mam_message(const iota_config_t *const iconf, const iota_client
     mam_pk_t_set_add(&init_trusted_ch, &(curr_entry->value));
   }
 
-  bundle_transactions_t *bundle = NULL;
-  BUNDLE_ARRAY_FOREACH(bundle_array, bundle) {
-    char *payload = NULL;
-    status_t read_ret = ta_mam_api_bundle_read(&mam, bundle, &payload);
-    if (read_ret != SC_OK && read_ret != SC_MAM_NO_PAYLOAD) {
-      // If we read a bundle which contains MAM announcement, then it will return "SC_MAM_NO_PAYLOAD"
-      ta_log_error("%s\n", ta_error_to_string(read_ret));
-      goto done;
+  const size_t payload_num = utarray_len(res->payload_array);
+  status_t read_ret = ta_mam_recv_payloads(service, &mam, iconf, key, bundle_hashes, res->payload_array);
+
+  // Return the cursor to be passed as `since` in the next request. It points to the last bundle which has been read, so
+  // the bundles after a failed one are returned again. It is kept if no newer bundle is read.
+  if (!data_id->bundle_hash && data_id->chid) {
+    size_t read_num = utarray_len(res->payload_array) - payload_num;
+    if (read_num > 0) {
+      hash243_queue_entry_t *last = bundle_hashes;
+      while (--read_num > 0) {
+        last = last->next;
+      }
+      flex_trits_to_trytes((tryte_t *)res->cursor, NUM_TRYTES_BUNDLE, last->hash, NUM_TRITS_BUNDLE, NUM_TRITS_BUNDLE);
+    } else if (data_id->since) {
+      strncpy(res->cursor, (char *)data_id->since, NUM_TRYTES_HASH);
     }
-
-    utarray_push_back(res->payload_array, &payload);
-    free(payload);
+  }
+  if (read_ret) {
+    ret = read_ret;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
   }
 
   // Find the channel ID which was just added
@@ -772,17 +1354,14 @@ status_t ta_recv_mam_message(const iota_config_t *const iconf, const iota_client
   }
 
 done:
-  // Destroy MAM API
+  // Destroy MAM API. The keys added for reading are only meaningful to this request, so the state is not saved.
   if (ret != SC_MAM_FAILED_INIT) {
-    if (mam_api_save(&mam, iconf->mam_file_path, NULL, 0) != RC_OK) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-    }
     if (mam_api_destroy(&mam) != RC_OK) {
       ret = SC_MAM_FAILED_DESTROYED;
       ta_log_error("%s\n", ta_error_to_string(ret));
     }
   }
-  bundle_array_free(&bundle_array);
+  hash243_queue_free(&bundle_hashes);
   mam_pk_t_set_free(&init_trusted_ch);
   mam_encrypt_key_free(&mam_key);
   return ret;
@@ -10,6 +10,8 @@
 #define CORE_MAM_CORE_H_
 
 #include "accelerator/core/core.h"
+#include "accelerator/core/mam_state.h"
+#include "accelerator/core/mss_cache.h"
 #include "common/macros.h"
 #include "common/trinary/flex_trit.h"
 #include "common/trinary/tryte_ascii.h"
@@ -64,6 +66,28 @@ status_t ta_send_mam_message(const ta_config_t* const info, const iota_config_t*
                              const iota_client_service_t* const service, ta_send_mam_req_t const* const req,
                              ta_send_mam_res_t* const res);
 
+/**
+ * @brief Send a batch of MAM messages to a channel.
+ *
+ * The unused key of the channel is found once for the whole batch, and the following messages are signed with the
+ * keys after it. Each message is still written in its own bundle, and PoW of a bundle is done while the next message
+ * is signed. The bundles are broadcast together after PoW of all of them is done, so none of them is broadcast if the
+ * batch fails.
+ *
+ * @param[in] info Tangle-accelerator configuration variables
+ * @param[in] iconf IOTA API parameter configurations
+ * @param[in] service IOTA node service
+ * @param[in] req Request in 'ta_send_mam_req_t' datatype with `messages`
+ * @param[out] res_array Result of each message in 'ta_send_mam_res_t' datatype, in the order of `messages`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_send_mam_messages(const ta_config_t* const info, const iota_config_t* const iconf,
+                              const iota_client_service_t* const service, ta_send_mam_req_t const* const req,
+                              UT_array* const res_array);
+
 /**
  * @brief Receive MAM messages.
  *
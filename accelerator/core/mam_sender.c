@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "mam_sender.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "accelerator/core/mam_core.h"
+#include "common/logger.h"
+#include "uthash.h"
+#include "utils/cache/eviction.h"
+#include "utils/hash_algo_djb2.h"
+#include "utlist.h"
+#include "uuid/uuid.h"
+
+#define MAM_SENDER_LOGGER "mam_sender"
+
+/** A buffered request queued to a worker. It stays in `pending` until it is sent. */
+typedef struct mam_send_job_s {
+  char uuid[UUID_STR_LEN];
+  struct mam_send_job_s* next;
+  UT_hash_handle hh;
+} mam_send_job_t;
+
+typedef struct mam_send_worker_s {
+  pthread_t thread;
+  pthread_cond_t cond;
+  mam_send_job_t* queue;
+} mam_send_worker_t;
+
+static mam_send_job_t* pending = NULL;
+static mam_send_worker_t* pool = NULL;
+static int pool_size = 0;
+static bool sender_running = false;
+static const ta_core_t* sender_core = NULL;
+static pthread_mutex_t sender_lock = PTHREAD_MUTEX_INITIALIZER;
+static logger_id_t logger_id;
+
+void mam_sender_logger_init() { logger_id = logger_helper_enable(MAM_SENDER_LOGGER, LOGGER_DEBUG, true); }
+
+int mam_sender_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+/**
+ * @brief Send a batch of MAM messages and serialize the result of each message
+ */
+static status_t send_mam_batch(const ta_core_t* const core, ta_send_mam_req_t const* const req, char** json) {
+  UT_array* res_array = NULL;
+  utarray_new(res_array, &send_mam_res_icd);
+
+  status_t ret = ta_send_mam_messages(&core->ta_conf, &core->iota_conf, &core->iota_service, req, res_array);
+  if (ret == SC_OK) {
+    ret = send_mam_message_batch_res_serialize(res_array, json);
+  }
+
+  utarray_free(res_array);
+  return ret;
+}
+
+status_t mam_send_buffered_request(const ta_core_t* const core, char const* const uuid) {
+  status_t ret = SC_OK;
+  char* json = NULL;
+  bool locked = false;
+  ta_send_mam_req_t* req = send_mam_req_new();
+  ta_send_mam_res_t* res = send_mam_res_new();
+  if (!req || !res) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = cache_get(uuid, &json);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = send_mam_message_req_deserialize(json, req);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  free(json);
+  json = NULL;
+
+  if (((send_mam_data_mam_v1_t*)req->data)->messages) {
+    ret = send_mam_batch(core, req, &json);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  } else {
+    ret = ta_send_mam_message(&core->ta_conf, &core->iota_conf, &core->iota_service, req, res);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+
+    ret = send_mam_message_res_serialize(res, NULL, &json);
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+
+  // The message is already sent, so wait for the lock rather than leaving the request to be sent again
+  if (pthread_rwlock_wrlock(core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  locked = true;
+
+  // Replace the request with its result
+  ret = cache_set_overwrite(uuid, UUID_STR_LEN - 1, json, strlen(json), core->cache.timeout);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  cache_eviction_untrack(uuid);
+  ret = cache_eviction_track(uuid, strlen(json) + 2 * (UUID_STR_LEN - 1));
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Requests are sent out of the order of the buffer list by the worker pool, so the UUID is removed by value
+  ret = cache_list_remove(core->cache.mam_buffer_list_name, uuid, UUID_STR_LEN - 1);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Transfer the transaction to another list in where we store all the successfully broadcasted transactions.
+  ret = cache_list_push(core->cache.mam_complete_list_name, strlen(core->cache.mam_complete_list_name), uuid,
+                        UUID_STR_LEN - 1);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  ret = cache_eviction_complete(uuid, core->cache.mam_complete_list_name, core->cache.complete_ttl);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+done:
+  if (locked && pthread_rwlock_unlock(core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  send_mam_req_free(&req);
+  send_mam_res_free(&res);
+  free(json);
+  return ret;
+}
+
+static void* worker_loop(void* arg) {
+  mam_send_worker_t* const worker = (mam_send_worker_t*)arg;
+
+  pthread_mutex_lock(&sender_lock);
+  while (sender_running) {
+    mam_send_job_t* job = worker->queue;
+    if (job == NULL) {
+      pthread_cond_wait(&worker->cond, &sender_lock);
+      continue;
+    }
+    LL_DELETE(worker->queue, job);
+    pthread_mutex_unlock(&sender_lock);
+
+    status_t ret = mam_send_buffered_request(sender_core, job->uuid);
+    if (ret) {
+      ta_log_warning("Failed to send buffered MAM request %s: %s\n", job->uuid, ta_error_to_string(ret));
+    }
+
+    pthread_mutex_lock(&sender_lock);
+    HASH_DEL(pending, job);
+    free(job);
+  }
+  pthread_mutex_unlock(&sender_lock);
+  return NULL;
+}
+
+status_t mam_sender_init(const ta_core_t* const core, const int workers) {
+  int started = 0;
+  if (core == NULL || workers <= 0) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&sender_lock);
+  pool = (mam_send_worker_t*)calloc(workers, sizeof(mam_send_worker_t));
+  if (pool == NULL) {
+    pthread_mutex_unlock(&sender_lock);
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  sender_core = core;
+  sender_running = true;
+  for (; started < workers; started++) {
+    pthread_cond_init(&pool[started].cond, NULL);
+    if (pthread_create(&pool[started].thread, NULL, worker_loop, &pool[started])) {
+      pthread_cond_destroy(&pool[started].cond);
+      break;
+    }
+  }
+  pool_size = started;
+  pthread_mutex_unlock(&sender_lock);
+
+  if (started < workers) {
+    ta_log_error("%s\n", "Failed to start MAM sending workers.");
+    mam_sender_destroy();
+    return SC_MAM_FAILED_INIT;
+  }
+
+  // Requests buffered before starting are sent as well
+  mam_sender_recover();
+  return SC_OK;
+}
+
+void mam_sender_destroy() {
+  mam_send_job_t *job = NULL, *tmp = NULL;
+
+  pthread_mutex_lock(&sender_lock);
+  sender_running = false;
+  for (int i = 0; i < pool_size; i++) {
+    pthread_cond_signal(&pool[i].cond);
+  }
+  pthread_mutex_unlock(&sender_lock);
+  for (int i = 0; i < pool_size; i++) {
+    pthread_join(pool[i].thread, NULL);
+    pthread_cond_destroy(&pool[i].cond);
+  }
+
+  pthread_mutex_lock(&sender_lock);
+  HASH_ITER(hh, pending, job, tmp) {
+    HASH_DEL(pending, job);
+    free(job);
+  }
+  free(pool);
+  pool = NULL;
+  pool_size = 0;
+  pthread_mutex_unlock(&sender_lock);
+}
+
+bool mam_sender_running() {
+  pthread_mutex_lock(&sender_lock);
+  const bool running = sender_running;
+  pthread_mutex_unlock(&sender_lock);
+  return running;
+}
+
+status_t mam_sender_submit(char const* const uuid, tryte_t const* const seed) {
+  status_t ret = SC_OK;
+  mam_send_job_t* job = NULL;
+  if (uuid == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&sender_lock);
+  HASH_FIND_STR(pending, uuid, job);
+  if (!sender_running || job) {
+    goto done;
+  }
+
+  job = (mam_send_job_t*)calloc(1, sizeof(mam_send_job_t));
+  if (job == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  strncpy(job->uuid, uuid, UUID_STR_LEN - 1);
+  HASH_ADD_STR(pending, uuid, job);
+
+  // Requests on the same seed go to the same worker, which sends them in order
+  mam_send_worker_t* const worker = &pool[seed ? hash_algo_djb2((char const*)seed) % pool_size : 0];
+  LL_APPEND(worker->queue, job);
+  pthread_cond_signal(&worker->cond);
+
+done:
+  pthread_mutex_unlock(&sender_lock);
+  return ret;
+}
+
+status_t mam_sender_recover() {
+  status_t ret = SC_OK;
+  int list_len = 0, queued = 0;
+  char *uuids = NULL, *json = NULL;
+  ta_send_mam_req_t* req = NULL;
+  // Nothing is buffered without the cache server, whose lock is only initialized if caching is enabled
+  if (!mam_sender_running() || sender_core->cache.rwlock == NULL) {
+    return SC_OK;
+  }
+
+  // Workers remove sent requests from the buffer list, so it is read at once under the lock instead of by index
+  if (pthread_rwlock_rdlock(sender_core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  ret = cache_list_range(sender_core->cache.mam_buffer_list_name, UUID_STR_LEN - 1, &uuids, &list_len);
+  if (pthread_rwlock_unlock(sender_core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+  }
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  for (int i = 0; i < list_len; i++) {
+    char uuid[UUID_STR_LEN] = {};
+    mam_send_job_t* job = NULL;
+    memcpy(uuid, uuids + i * (UUID_STR_LEN - 1), UUID_STR_LEN - 1);
+
+    pthread_mutex_lock(&sender_lock);
+    HASH_FIND_STR(pending, uuid, job);
+    pthread_mutex_unlock(&sender_lock);
+    if (job) {
+      continue;
+    }
+
+    // The seed decides the worker of the request
+    req = send_mam_req_new();
+    if (req == NULL) {
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    ret = cache_get(uuid, &json);
+    if (ret == SC_OK) {
+      ret = send_mam_message_req_deserialize(json, req);
+    }
+    if (ret == SC_OK) {
+      ret = mam_sender_submit(uuid, ((send_mam_data_mam_v1_t*)req->data)->seed);
+    }
+    if (ret) {
+      ta_log_warning("Failed to queue buffered MAM request %s: %s\n", uuid, ta_error_to_string(ret));
+    } else {
+      queued++;
+    }
+    free(json);
+    json = NULL;
+    send_mam_req_free(&req);
+  }
+  ret = SC_OK;
+
+done:
+  if (queued) {
+    ta_log_info("Queued %d buffered MAM requests\n", queued);
+  }
+  free(uuids);
+  free(json);
+  send_mam_req_free(&req);
+  return ret;
+}
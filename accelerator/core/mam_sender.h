@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef CORE_MAM_SENDER_H_
+#define CORE_MAM_SENDER_H_
+
+#include <stdbool.h>
+#include "accelerator/config.h"
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file accelerator/core/mam_sender.h
+ * @brief Worker pool sending buffered MAM requests
+ *
+ * `/mam/send` acknowledges a request with a UUID once it is buffered in `mam_buff_list`, and the buffered requests used
+ * to be sent by the health tracking thread one by one in every health tracking period. The MAM sender sends them as
+ * soon as they are buffered with a pool of worker threads.
+ *
+ * Requests on the same seed are queued to the same worker, so they are sent in the order they were buffered, while
+ * requests on different seeds are sent in parallel. Requests without a seed share the resident MAM state, so they are
+ * all queued to one worker. The result of a request is fetched with `/fetch/{uuid}` as before.
+ *
+ * A request which fails to be sent stays in `mam_buff_list`, and it is queued again by `mam_sender_recover()` in the
+ * next health tracking period, together with the requests buffered while the pool is not running.
+ */
+
+/**
+ * @brief Send a buffered MAM request, and move its UUID from the MAM buffer list to the MAM complete list
+ *
+ * The buffered request is replaced by its result, which is fetched with `ta_fetch_mam_with_uuid()`.
+ *
+ * @param[in] core Pointer to Tangle-accelerator core configuration structure
+ * @param[in] uuid UUID of the buffered request
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_send_buffered_request(const ta_core_t* const core, char const* const uuid);
+
+/**
+ * @brief Start the worker pool
+ *
+ * The requests already in the MAM buffer list are queued.
+ *
+ * @param[in] core Pointer to Tangle-accelerator core configuration structure. It must live until
+ * `mam_sender_destroy()`.
+ * @param[in] workers Number of worker threads
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_sender_init(const ta_core_t* const core, const int workers);
+
+/**
+ * @brief Stop the worker pool. The requests being sent are finished, and the queued ones stay in the MAM buffer list.
+ */
+void mam_sender_destroy();
+
+/**
+ * @brief Check whether the worker pool is running
+ *
+ * @return
+ * - true if the buffered MAM requests are sent by the worker pool
+ * - false otherwise
+ */
+bool mam_sender_running();
+
+/**
+ * @brief Queue a buffered MAM request. Nothing is done if the pool is not running or the request is already queued.
+ *
+ * @param[in] uuid UUID of the buffered request
+ * @param[in] seed Seed of the request. NULL if the request uses the resident MAM state.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_sender_submit(char const* const uuid, tryte_t const* const seed);
+
+/**
+ * @brief Queue the requests in the MAM buffer list which are not queued yet
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_sender_recover();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CORE_MAM_SENDER_H_
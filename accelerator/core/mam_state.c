@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "mam_state.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "common/logger.h"
+#include "uthash.h"
+
+#define MS_LOGGER "mam_state"
+#define MAM_STATE_SEED_LEN 81
+#define SNAPSHOT_TMP_SUFFIX ".tmp"
+
+typedef struct mam_state_key_s {
+  tryte_t seed[MAM_STATE_SEED_LEN];
+  bool persistent;
+} mam_state_key_t;
+
+struct mam_state_s {
+  mam_state_key_t key;
+  char* file_path; /**< NULL if the state is transient */
+  mam_api_t api;
+  bool initialized;     /**< Whether `api` holds a live object */
+  bool dirty;           /**< Whether `api` is modified after the last snapshot */
+  int refs;             /**< Number of requests holding or waiting for the state */
+  pthread_mutex_t lock; /**< Held by the request using `api` */
+  UT_hash_handle hh;
+};
+
+static mam_state_t* states = NULL;
+static pthread_mutex_t states_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t snapshot_lock = PTHREAD_MUTEX_INITIALIZER; /**< Keeps snapshots of a state written in order */
+static pthread_cond_t snapshot_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t snapshot_thread;
+static bool snapshot_running = false;
+static int snapshot_period = 0;
+static logger_id_t logger_id;
+
+void ms_logger_init() { logger_id = logger_helper_enable(MS_LOGGER, LOGGER_DEBUG, true); }
+
+int ms_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+/**
+ * @brief Load the state from its MAM file, or initialize it from the seed if the MAM file is missing or empty.
+ *
+ * Must be called with `state->lock` held.
+ */
+static status_t state_load(mam_state_t* const state) {
+  struct stat st;
+  retcode_t rc = RC_OK;
+  if (state->file_path && stat(state->file_path, &st) == 0 && st.st_size > 0) {
+    rc = mam_api_load(state->file_path, &state->api, NULL, 0);
+  } else {
+    rc = mam_api_init(&state->api, state->key.seed);
+  }
+  if (rc != RC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
+    return SC_MAM_FAILED_INIT;
+  }
+
+  state->initialized = true;
+  state->dirty = false;
+  return SC_OK;
+}
+
+/**
+ * @brief Serialize the state into trits.
+ *
+ * Must be called with `state->lock` held.
+ */
+static status_t state_serialize(mam_state_t* const state, trit_t** buffer, size_t* size) {
+  *size = mam_api_serialized_size(&state->api);
+  *buffer = (trit_t*)malloc(sizeof(trit_t) * (*size));
+  if (*buffer == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  mam_api_serialize(&state->api, *buffer, NULL, 0);
+  return SC_OK;
+}
+
+/**
+ * @brief Write serialized trits to a temporary file and rename it as the MAM file. The layout is the same as
+ * `mam_api_save()`, so the file can be loaded by `mam_api_load()`.
+ */
+static status_t snapshot_write(char const* const file_path, trit_t const* const buffer, const size_t size) {
+  status_t ret = SC_OK;
+  char tmp_path[FILENAME_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s" SNAPSHOT_TMP_SUFFIX, file_path);
+
+  FILE* file = fopen(tmp_path, "wb");
+  if (file == NULL) {
+    ret = SC_MAM_FILE_SAVE;
+    goto done;
+  }
+  if (fwrite(buffer, sizeof(trit_t), size, file) != size || fflush(file) || fsync(fileno(file))) {
+    ret = SC_MAM_FILE_SAVE;
+    fclose(file);
+    unlink(tmp_path);
+    goto done;
+  }
+  fclose(file);
+
+  if (rename(tmp_path, file_path)) {
+    ret = SC_MAM_FILE_SAVE;
+    unlink(tmp_path);
+  }
+
+done:
+  if (ret) {
+    ta_log_error("Failed to save MAM state to %s: %s\n", file_path, ta_error_to_string(ret));
+  }
+  return ret;
+}
+
+static void state_free(mam_state_t* state) {
+  if (state->initialized && mam_api_destroy(&state->api) != RC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_DESTROYED));
+  }
+  pthread_mutex_destroy(&state->lock);
+  free(state->file_path);
+  free(state);
+}
+
+/**
+ * @brief Drop a reference of the state. A transient state is freed once no request holds it.
+ */
+static void state_unref(mam_state_t* const state) {
+  pthread_mutex_lock(&states_lock);
+  if (--state->refs == 0 && !state->key.persistent) {
+    HASH_DEL(states, state);
+    state_free(state);
+  }
+  pthread_mutex_unlock(&states_lock);
+}
+
+/**
+ * @brief Write a snapshot of every modified persistent state. States held by requests are skipped unless `wait` is
+ * set, and they would be written in the next period.
+ */
+static status_t states_snapshot(const bool wait) {
+  status_t ret = SC_OK;
+  mam_state_t **persistent = NULL, *state = NULL, *tmp = NULL;
+  int num = 0;
+
+  pthread_mutex_lock(&snapshot_lock);
+  // Persistent states are never removed before the manager is destroyed, so they can be used without `states_lock`
+  pthread_mutex_lock(&states_lock);
+  persistent = (mam_state_t**)malloc(sizeof(mam_state_t*) * (HASH_COUNT(states) + 1));
+  if (persistent == NULL) {
+    pthread_mutex_unlock(&states_lock);
+    pthread_mutex_unlock(&snapshot_lock);
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  HASH_ITER(hh, states, state, tmp) {
+    if (state->key.persistent) {
+      persistent[num++] = state;
+    }
+  }
+  pthread_mutex_unlock(&states_lock);
+
+  for (int i = 0; i < num; i++) {
+    trit_t* buffer = NULL;
+    size_t size = 0;
+    state = persistent[i];
+    if (wait) {
+      pthread_mutex_lock(&state->lock);
+    } else if (pthread_mutex_trylock(&state->lock)) {
+      continue;
+    }
+    if (!state->dirty || !state->initialized || state_serialize(state, &buffer, &size) != SC_OK) {
+      pthread_mutex_unlock(&state->lock);
+      continue;
+    }
+    state->dirty = false;
+    pthread_mutex_unlock(&state->lock);
+
+    if (snapshot_write(state->file_path, buffer, size) != SC_OK) {
+      ret = SC_MAM_FILE_SAVE;
+      pthread_mutex_lock(&state->lock);
+      state->dirty = true;
+      pthread_mutex_unlock(&state->lock);
+    }
+    free(buffer);
+  }
+
+  free(persistent);
+  pthread_mutex_unlock(&snapshot_lock);
+  return ret;
+}
+
+static void* snapshot_loop(void* arg) {
+  (void)arg;
+  struct timespec deadline;
+
+  pthread_mutex_lock(&states_lock);
+  while (snapshot_running) {
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += snapshot_period / 1000;
+    deadline.tv_nsec += (snapshot_period % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&snapshot_cond, &states_lock, &deadline);
+    if (!snapshot_running) {
+      break;
+    }
+
+    pthread_mutex_unlock(&states_lock);
+    states_snapshot(false);
+    pthread_mutex_lock(&states_lock);
+  }
+  pthread_mutex_unlock(&states_lock);
+  return NULL;
+}
+
+status_t mam_state_manager_init(const int period) {
+  if (period <= 0) {
+    return SC_OK;
+  }
+
+  pthread_mutex_lock(&states_lock);
+  snapshot_period = period;
+  snapshot_running = true;
+  pthread_mutex_unlock(&states_lock);
+  if (pthread_create(&snapshot_thread, NULL, snapshot_loop, NULL)) {
+    pthread_mutex_lock(&states_lock);
+    snapshot_running = false;
+    pthread_mutex_unlock(&states_lock);
+    ta_log_error("%s\n", "Failed to start writing MAM state snapshots. States would be saved on every request.");
+    return SC_MAM_FAILED_INIT;
+  }
+  return SC_OK;
+}
+
+void mam_state_manager_destroy() {
+  mam_state_t *state = NULL, *tmp = NULL;
+
+  pthread_mutex_lock(&states_lock);
+  const bool running = snapshot_running;
+  snapshot_running = false;
+  pthread_cond_signal(&snapshot_cond);
+  pthread_mutex_unlock(&states_lock);
+  if (running) {
+    pthread_join(snapshot_thread, NULL);
+  }
+
+  states_snapshot(true);
+
+  pthread_mutex_lock(&states_lock);
+  HASH_ITER(hh, states, state, tmp) {
+    HASH_DEL(states, state);
+    state_free(state);
+  }
+  pthread_mutex_unlock(&states_lock);
+}
+
+status_t mam_state_acquire(tryte_t const* const seed, char const* const file_path, mam_state_t** state) {
+  status_t ret = SC_OK;
+  mam_state_key_t key;
+  mam_state_t* entry = NULL;
+  if (seed == NULL || state == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  // Zero the padding, since the whole key is hashed
+  memset(&key, 0, sizeof(key));
+  memcpy(key.seed, seed, MAM_STATE_SEED_LEN);
+  key.persistent = (file_path != NULL);
+
+  pthread_mutex_lock(&states_lock);
+  HASH_FIND(hh, states, &key, sizeof(key), entry);
+  if (entry == NULL) {
+    entry = (mam_state_t*)calloc(1, sizeof(mam_state_t));
+    if (entry == NULL || (file_path && (entry->file_path = strdup(file_path)) == NULL)) {
+      pthread_mutex_unlock(&states_lock);
+      free(entry);
+      ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+      return SC_OOM;
+    }
+    entry->key = key;
+    pthread_mutex_init(&entry->lock, NULL);
+    HASH_ADD(hh, states, key, sizeof(mam_state_key_t), entry);
+  }
+  entry->refs++;
+  pthread_mutex_unlock(&states_lock);
+
+  pthread_mutex_lock(&entry->lock);
+  if (!entry->initialized) {
+    ret = state_load(entry);
+    if (ret) {
+      pthread_mutex_unlock(&entry->lock);
+      state_unref(entry);
+      return ret;
+    }
+  }
+
+  *state = entry;
+  return SC_OK;
+}
+
+mam_api_t* mam_state_api(mam_state_t* const state) { return state ? &state->api : NULL; }
+
+void mam_state_unlock(mam_state_t* const state, const bool modified) {
+  if (modified && state->key.persistent) {
+    state->dirty = true;
+  }
+  pthread_mutex_unlock(&state->lock);
+}
+
+void mam_state_lock(mam_state_t* const state) { pthread_mutex_lock(&state->lock); }
+
+status_t mam_state_release(mam_state_t* const state, const bool modified) {
+  status_t ret = SC_OK;
+  if (state == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  // A transient state may be shared by requests which unlocked it, so the last one destroys it in `state_unref()`
+  if (state->key.persistent && modified) {
+    state->dirty = true;
+    pthread_mutex_lock(&states_lock);
+    const bool running = snapshot_running;
+    pthread_mutex_unlock(&states_lock);
+
+    if (!running) {
+      trit_t* buffer = NULL;
+      size_t size = 0;
+      ret = state_serialize(state, &buffer, &size);
+      if (ret == SC_OK && (ret = snapshot_write(state->file_path, buffer, size)) == SC_OK) {
+        state->dirty = false;
+      }
+      free(buffer);
+    }
+  }
+
+  pthread_mutex_unlock(&state->lock);
+  state_unref(state);
+  return ret;
+}
+
+status_t mam_state_flush() { return states_snapshot(true); }
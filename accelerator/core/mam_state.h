@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef CORE_MAM_STATE_H_
+#define CORE_MAM_STATE_H_
+
+#include <stdbool.h>
+#include "common/ta_errors.h"
+#include "mam/api/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file accelerator/core/mam_state.h
+ * @brief Resident states of MAM API objects
+ *
+ * The MAM state manager keeps a table of live `mam_api_t` objects keyed by seed, so MAM requests do not load and save
+ * the whole MAM state from disk on every request. Requests on the same seed are serialized by a per-seed lock, while
+ * requests on different seeds run in parallel.
+ *
+ * A state backed by a MAM file is loaded once. After requests modify it, a background thread writes a snapshot of it to
+ * the file in every snapshot period, so consecutive modifications are coalesced into a single write. The snapshot is
+ * written to a temporary file and renamed, so the MAM file is never left half-written.
+ *
+ * A state without a MAM file is transient. It is initialized from the seed when it is acquired, and destroyed once no
+ * request holds it.
+ *
+ * A request should unlock its state with `mam_state_unlock()` during lengthy work which doesn't use the MAM API object,
+ * e.g., attaching bundles with PoW, so neither the requests on the same seed nor the snapshots wait for it.
+ */
+
+/** Opaque type of a resident MAM state */
+typedef struct mam_state_s mam_state_t;
+
+/**
+ * @brief Start writing snapshots of modified states in background
+ *
+ * Without starting, a modified state is saved when it is released.
+ *
+ * @param[in] snapshot_period Milliseconds between two snapshots of a modified state. Zero or negative value saves the
+ * state whenever it is released.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_state_manager_init(const int snapshot_period);
+
+/**
+ * @brief Stop writing snapshots, save every modified state and destroy all the states
+ */
+void mam_state_manager_destroy();
+
+/**
+ * @brief Acquire the state of a seed, and hold the lock of it until `mam_state_release()`
+ *
+ * @param[in] seed Seed of MAM channels in 81 trytes
+ * @param[in] file_path MAM file which records the state. NULL for a transient state.
+ * @param[out] state Acquired state
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_FAILED_INIT if the state cannot be loaded or initialized
+ * - non-zero on error
+ */
+status_t mam_state_acquire(tryte_t const* const seed, char const* const file_path, mam_state_t** state);
+
+/**
+ * @brief Get the MAM API object of an acquired state
+ *
+ * @param[in] state Acquired state
+ *
+ * @return MAM API object, which can only be used before the state is released
+ */
+mam_api_t* mam_state_api(mam_state_t* const state);
+
+/**
+ * @brief Unlock an acquired state without releasing it
+ *
+ * The MAM API object of the state can't be used until `mam_state_lock()`, while other requests on the seed may use it.
+ * The state is kept until it is released.
+ *
+ * @param[in] state Acquired state
+ * @param[in] modified Whether the MAM API object is modified, so the state would be written in the next snapshot
+ */
+void mam_state_unlock(mam_state_t* const state, const bool modified);
+
+/**
+ * @brief Lock a state unlocked by `mam_state_unlock()` again
+ *
+ * @param[in] state Unlocked state
+ */
+void mam_state_lock(mam_state_t* const state);
+
+/**
+ * @brief Release an acquired state
+ *
+ * The state should be locked when it is released.
+ *
+ * @param[in] state Acquired state
+ * @param[in] modified Whether the MAM API object is modified, so the state should be saved
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_FILE_SAVE if the state should be saved immediately but it fails
+ * - non-zero on error
+ */
+status_t mam_state_release(mam_state_t* const state, const bool modified);
+
+/**
+ * @brief Save every modified state to its MAM file immediately
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_FILE_SAVE if any state fails to be saved
+ */
+status_t mam_state_flush();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CORE_MAM_STATE_H_
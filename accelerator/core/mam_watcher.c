@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "mam_watcher.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "accelerator/core/mam_core.h"
+#include "accelerator/core/serializer/ser_mam.h"
+#include "common/logger.h"
+#include "uthash.h"
+
+#define MW_LOGGER "mam_watcher"
+
+/** A client subscribing to a watched channel */
+typedef struct mam_watch_sub_s {
+  char client_id[MAM_WATCH_CLIENT_ID_LEN + 1];
+  UT_hash_handle hh;
+} mam_watch_sub_t;
+
+/** A watched channel */
+typedef struct mam_watch_s {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+  char cursor[NUM_TRYTES_HASH + 1]; /**< Last bundle read on the channel. Empty if none is read. */
+  bool primed;                      /**< Whether the messages before watching have been skipped */
+  mam_watch_sub_t* subs;            /**< Clients subscribing to the channel */
+  UT_hash_handle hh;
+} mam_watch_t;
+
+static mam_watch_t* watches = NULL;
+static pthread_mutex_t watches_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t poll_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t watcher_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t watcher_thread;
+static bool watcher_running = false;
+static int watch_period = MAM_WATCH_PERIOD;
+static const iota_config_t* watch_iconf = NULL;
+static iota_client_service_t watch_service;
+static mam_watcher_push_t watch_push = NULL;
+static void* watch_push_arg = NULL;
+static status_t watch_read_node(char const* const chid, char const* const since, const bool skip,
+                                ta_recv_mam_res_t* const res);
+static mam_watcher_read_t watch_read = watch_read_node;
+static logger_id_t logger_id;
+
+void mw_logger_init() { logger_id = logger_helper_enable(MW_LOGGER, LOGGER_DEBUG, true); }
+
+int mw_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+static bool is_valid_chid(char const* const chid) {
+  if (strnlen(chid, NUM_TRYTES_ADDRESS + 1) != NUM_TRYTES_ADDRESS) {
+    return false;
+  }
+  for (int i = 0; i < NUM_TRYTES_ADDRESS; i++) {
+    if ((chid[i] < 'A' || chid[i] > 'Z') && chid[i] != '9') {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool is_valid_client_id(char const* const client_id) {
+  const size_t len = strnlen(client_id, MAM_WATCH_CLIENT_ID_LEN + 1);
+  return len > 0 && len <= MAM_WATCH_CLIENT_ID_LEN;
+}
+
+/**
+ * @brief Free a watched channel with its subscriptions. `watches_lock` must be held.
+ */
+static void watch_free(mam_watch_t* const watch) {
+  mam_watch_sub_t *sub = NULL, *tmp = NULL;
+  HASH_ITER(hh, watch->subs, sub, tmp) {
+    HASH_DEL(watch->subs, sub);
+    free(sub);
+  }
+  free(watch);
+}
+
+/**
+ * @brief Drop a subscription, and stop watching the channel once no subscription is left. `watches_lock` must be held.
+ */
+static void watch_sub_remove(mam_watch_t* const watch, mam_watch_sub_t* const sub) {
+  HASH_DEL(watch->subs, sub);
+  free(sub);
+  if (HASH_COUNT(watch->subs) == 0) {
+    HASH_DEL(watches, watch);
+    ta_log_info("Stop watching MAM channel %s\n", watch->chid);
+    watch_free(watch);
+  }
+}
+
+/**
+ * @brief Read a channel from the IOTA full node
+ */
+static status_t watch_read_node(char const* const chid, char const* const since, const bool skip,
+                                ta_recv_mam_res_t* const res) {
+  status_t ret = SC_OK;
+
+  if (skip) {
+    hash243_queue_t bundle_hashes = NULL;
+    ret = ta_get_bundle_hashes_by_addr(&watch_service, (tryte_t*)chid, NULL, &bundle_hashes);
+    if (ret == SC_OK && bundle_hashes) {
+      flex_trits_to_trytes((tryte_t*)res->cursor, NUM_TRYTES_BUNDLE, bundle_hashes->prev->hash, NUM_TRITS_BUNDLE,
+                           NUM_TRITS_BUNDLE);
+    }
+    hash243_queue_free(&bundle_hashes);
+    return ret;
+  }
+
+  ta_recv_mam_req_t* req = recv_mam_req_new();
+  if (req == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  req->protocol = MAM_V1;
+  ret = recv_mam_req_v1_init(req);
+  if (ret == SC_OK) {
+    ret = recv_mam_set_mam_v1_data_id(req, NULL, (char*)chid, NULL);
+  }
+  if (ret == SC_OK && since) {
+    ret = recv_mam_set_mam_v1_since(req, (char*)since);
+  }
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  } else {
+    ret = ta_recv_mam_message(watch_iconf, &watch_service, req, res);
+  }
+  recv_mam_req_free(&req);
+  return ret;
+}
+
+/**
+ * @brief Subscribe a client to a channel. `watches_lock` must be held.
+ *
+ * @param[in] chid Channel ID in trytes
+ * @param[in] client_id ID of the subscribing client
+ * @param[in] primed Whether the messages already on the channel are pushed, if the channel is not watched yet
+ */
+static status_t watch_sub_add(char const* const chid, char const* const client_id, const bool primed) {
+  mam_watch_t* watch = NULL;
+  mam_watch_sub_t* sub = NULL;
+
+  HASH_FIND_STR(watches, chid, watch);
+  if (watch) {
+    HASH_FIND_STR(watch->subs, client_id, sub);
+    if (sub) {
+      return SC_OK;
+    }
+  } else if (HASH_COUNT(watches) >= MAM_WATCH_MAX) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_WATCH_LIMIT));
+    return SC_MAM_WATCH_LIMIT;
+  }
+
+  sub = (mam_watch_sub_t*)calloc(1, sizeof(mam_watch_sub_t));
+  if (sub == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  strncpy(sub->client_id, client_id, MAM_WATCH_CLIENT_ID_LEN);
+
+  if (watch == NULL) {
+    watch = (mam_watch_t*)calloc(1, sizeof(mam_watch_t));
+    if (watch == NULL) {
+      free(sub);
+      ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+      return SC_OOM;
+    }
+    memcpy(watch->chid, chid, NUM_TRYTES_ADDRESS);
+    watch->primed = primed;
+    HASH_ADD_STR(watches, chid, watch);
+    ta_log_info("Watching MAM channel %s\n", watch->chid);
+  }
+  HASH_ADD_STR(watch->subs, client_id, sub);
+  return SC_OK;
+}
+
+/**
+ * @brief Subscribe the clients of a channel to the channel it announces. `watches_lock` must be held.
+ *
+ * Every message on the announced channel is written after the announcement, so none of them is skipped.
+ */
+static void watch_follow(mam_watch_t* const watch, char const* const next_chid) {
+  mam_watch_sub_t *sub = NULL, *tmp = NULL;
+
+  if (!is_valid_chid(next_chid)) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_INVAID_CHID_OR_EPID));
+    return;
+  }
+  HASH_ITER(hh, watch->subs, sub, tmp) {
+    status_t ret = watch_sub_add(next_chid, sub->client_id, true);
+    if (ret) {
+      ta_log_error("Failed to follow MAM channel %s for %s: %s\n", next_chid, sub->client_id, ta_error_to_string(ret));
+    }
+  }
+}
+
+/**
+ * @brief Skip the messages on a channel before it is watched, by moving the cursor to the last bundle on it.
+ */
+static status_t watch_prime(mam_watch_t* const watch) {
+  ta_recv_mam_res_t* res = recv_mam_res_new();
+  if (res == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  status_t ret = watch_read(watch->chid, NULL, true, res);
+  if (ret == SC_OK && res->cursor[0]) {
+    memcpy(watch->cursor, res->cursor, sizeof(watch->cursor));
+  }
+  recv_mam_res_free(&res);
+
+  // Nothing to skip on an empty channel
+  if (ret == SC_OK || ret == SC_CCLIENT_NOT_FOUND) {
+    watch->primed = true;
+    return SC_OK;
+  }
+  return ret;
+}
+
+/**
+ * @brief Read the messages after the cursor of a channel and push them
+ *
+ * The cursor is only moved if the messages are read, so the ones of a failed poll are read again in the next one.
+ *
+ * @param[in, out] watch The channel to be polled
+ * @param[out] next_chid The channel announced by the messages. Empty if none is announced.
+ */
+static status_t watch_poll(mam_watch_t* const watch, char* const next_chid) {
+  status_t ret = SC_OK;
+  char* json_result = NULL;
+  ta_recv_mam_res_t* res = recv_mam_res_new();
+  if (res == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = watch_read(watch->chid, watch->cursor[0] ? watch->cursor : NULL, false, res);
+  if (ret) {
+    // An empty channel is not an error
+    ret = (ret == SC_CCLIENT_NOT_FOUND) ? SC_OK : ret;
+    goto done;
+  }
+
+  if (utarray_len(res->payload_array) > 0 || res->chid1[0]) {
+    ret = recv_mam_message_res_serialize(res, &json_result);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    watch_push(watch->chid, json_result, watch_push_arg);
+  }
+  if (res->cursor[0]) {
+    strncpy(watch->cursor, res->cursor, NUM_TRYTES_HASH);
+  }
+  if (res->chid1[0]) {
+    strncpy(next_chid, res->chid1, NUM_TRYTES_ADDRESS);
+  }
+
+done:
+  free(json_result);
+  recv_mam_res_free(&res);
+  return ret;
+}
+
+void mam_watcher_poll() {
+  mam_watch_t *watch = NULL, *tmp = NULL, *snapshot = NULL;
+  int num = 0;
+
+  // Polls of the background thread and of the callers are not interleaved, or the same messages could be pushed twice
+  pthread_mutex_lock(&poll_lock);
+  pthread_mutex_lock(&watches_lock);
+  snapshot = (mam_watch_t*)malloc(sizeof(mam_watch_t) * (HASH_COUNT(watches) + 1));
+  if (snapshot == NULL) {
+    pthread_mutex_unlock(&watches_lock);
+    pthread_mutex_unlock(&poll_lock);
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return;
+  }
+  HASH_ITER(hh, watches, watch, tmp) { snapshot[num++] = *watch; }
+  pthread_mutex_unlock(&watches_lock);
+
+  // Channels are polled without holding the lock, so subscribing is never blocked by the full node
+  for (int i = 0; i < num; i++) {
+    char next_chid[NUM_TRYTES_ADDRESS + 1] = {0};
+    status_t ret = snapshot[i].primed ? watch_poll(&snapshot[i], next_chid) : watch_prime(&snapshot[i]);
+    if (ret) {
+      ta_log_debug("Failed to poll MAM channel %s: %s\n", snapshot[i].chid, ta_error_to_string(ret));
+      continue;
+    }
+
+    // The channel may be unwatched while it is polled
+    pthread_mutex_lock(&watches_lock);
+    HASH_FIND_STR(watches, snapshot[i].chid, watch);
+    if (watch) {
+      memcpy(watch->cursor, snapshot[i].cursor, sizeof(watch->cursor));
+      watch->primed = snapshot[i].primed;
+      if (next_chid[0]) {
+        watch_follow(watch, next_chid);
+      }
+    }
+    pthread_mutex_unlock(&watches_lock);
+  }
+  free(snapshot);
+  pthread_mutex_unlock(&poll_lock);
+}
+
+static void* watcher_loop(void* arg) {
+  (void)arg;
+  struct timespec deadline;
+
+  pthread_mutex_lock(&watches_lock);
+  while (watcher_running) {
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += watch_period / 1000;
+    deadline.tv_nsec += (watch_period % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&watcher_cond, &watches_lock, &deadline);
+    if (!watcher_running) {
+      break;
+    }
+
+    pthread_mutex_unlock(&watches_lock);
+    mam_watcher_poll();
+    pthread_mutex_lock(&watches_lock);
+  }
+  pthread_mutex_unlock(&watches_lock);
+  return NULL;
+}
+
+void mam_watcher_set_reader(mam_watcher_read_t read) { watch_read = read ? read : watch_read_node; }
+
+status_t mam_watcher_init(const iota_config_t* const iconf, const iota_client_service_t* const service,
+                          const int period, mam_watcher_push_t push, void* const arg) {
+  if (iconf == NULL || service == NULL || push == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&watches_lock);
+  watch_iconf = iconf;
+  ta_set_iota_client_service(&watch_service, service->http.host, service->http.port, service->http.ca_pem);
+  watch_period = period > 0 ? period : MAM_WATCH_PERIOD;
+  watch_push = push;
+  watch_push_arg = arg;
+  watcher_running = true;
+  pthread_mutex_unlock(&watches_lock);
+  if (pthread_create(&watcher_thread, NULL, watcher_loop, NULL)) {
+    pthread_mutex_lock(&watches_lock);
+    watcher_running = false;
+    pthread_mutex_unlock(&watches_lock);
+    ta_log_error("%s\n", "Failed to start watching MAM channels.");
+    return SC_MAM_FAILED_INIT;
+  }
+  return SC_OK;
+}
+
+void mam_watcher_destroy() {
+  mam_watch_t *watch = NULL, *tmp = NULL;
+
+  pthread_mutex_lock(&watches_lock);
+  const bool running = watcher_running;
+  watcher_running = false;
+  pthread_cond_signal(&watcher_cond);
+  pthread_mutex_unlock(&watches_lock);
+  if (running) {
+    pthread_join(watcher_thread, NULL);
+  }
+
+  pthread_mutex_lock(&watches_lock);
+  HASH_ITER(hh, watches, watch, tmp) {
+    HASH_DEL(watches, watch);
+    watch_free(watch);
+  }
+  pthread_mutex_unlock(&watches_lock);
+}
+
+status_t mam_watcher_watch(char const* const chid, char const* const client_id) {
+  status_t ret = SC_OK;
+  if (chid == NULL || !is_valid_chid(chid)) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_INVAID_CHID_OR_EPID));
+    return SC_MAM_INVAID_CHID_OR_EPID;
+  }
+  if (client_id == NULL || !is_valid_client_id(client_id)) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_INVALID_CLIENT_ID));
+    return SC_MAM_INVALID_CLIENT_ID;
+  }
+
+  pthread_mutex_lock(&watches_lock);
+  if (!watcher_running) {
+    ret = SC_MAM_FAILED_INIT;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  } else {
+    ret = watch_sub_add(chid, client_id, false);
+  }
+  pthread_mutex_unlock(&watches_lock);
+  return ret;
+}
+
+status_t mam_watcher_unwatch(char const* const chid, char const* const client_id) {
+  mam_watch_t* watch = NULL;
+  mam_watch_sub_t* sub = NULL;
+  if (chid == NULL || client_id == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&watches_lock);
+  HASH_FIND_STR(watches, chid, watch);
+  if (watch) {
+    HASH_FIND_STR(watch->subs, client_id, sub);
+  }
+  if (sub == NULL) {
+    pthread_mutex_unlock(&watches_lock);
+    return SC_MAM_NOT_FOUND;
+  }
+  watch_sub_remove(watch, sub);
+  pthread_mutex_unlock(&watches_lock);
+  return SC_OK;
+}
+
+status_t mam_watcher_release(char const* const client_id) {
+  mam_watch_t *watch = NULL, *tmp = NULL;
+  mam_watch_sub_t* sub = NULL;
+  if (client_id == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&watches_lock);
+  HASH_ITER(hh, watches, watch, tmp) {
+    HASH_FIND_STR(watch->subs, client_id, sub);
+    if (sub) {
+      watch_sub_remove(watch, sub);
+    }
+  }
+  pthread_mutex_unlock(&watches_lock);
+  return SC_OK;
+}
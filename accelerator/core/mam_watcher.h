@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef CORE_MAM_WATCHER_H_
+#define CORE_MAM_WATCHER_H_
+
+#include "accelerator/config.h"
+#include "accelerator/core/response/ta_recv_mam.h"
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file accelerator/core/mam_watcher.h
+ * @brief Watch MAM channels and push their new messages
+ *
+ * Clients waiting for messages on a channel used to poll `/mam/recv`, so every client queried the full node and decoded
+ * the channel by itself. The MAM watcher keeps one watch for each channel however many clients subscribe to it. A
+ * background thread polls the Channel ID of every watched channel in each period with the cursor of the last message
+ * read, decodes the new messages once, and hands them to a push function, which delivers them to the subscribers.
+ *
+ * The messages already on a channel when it is watched are not pushed. Only public channels are watched, since the
+ * decoded messages are pushed to every subscriber.
+ *
+ * A failed poll keeps the cursor, so its messages are read again in the next period. Once a channel announces the next
+ * channel, the subscribers of the channel are subscribed to the announced one as well.
+ *
+ * Subscriptions are kept by client ID, so a client can only drop its own subscriptions, and all the subscriptions of a
+ * client are dropped with `mam_watcher_release()` once the client is gone.
+ */
+
+#define MAM_WATCH_MAX 1024         /**< Maximum number of channels watched at the same time */
+#define MAM_WATCH_CLIENT_ID_LEN 32 /**< Maximum length of the ID of a client subscribing to channels */
+
+/**
+ * @brief Deliver new messages of a watched channel
+ *
+ * @param[in] chid Channel ID in trytes
+ * @param[in] message New messages in the JSON format of the `/mam/recv` response
+ * @param[in] arg Argument given to `mam_watcher_init()`
+ */
+typedef void (*mam_watcher_push_t)(char const* const chid, char const* const message, void* const arg);
+
+/**
+ * @brief Read a watched channel
+ *
+ * @param[in] chid Channel ID in trytes
+ * @param[in] since Bundle hash of the last message read. NULL to read from the start of the channel.
+ * @param[in] skip Only move the cursor of `res` to the last bundle on the channel without reading the messages
+ * @param[out] res Messages after `since`, the announced channel and the cursor after them
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_NOT_FOUND if the channel is empty
+ * - non-zero on error
+ */
+typedef status_t (*mam_watcher_read_t)(char const* const chid, char const* const since, const bool skip,
+                                       ta_recv_mam_res_t* const res);
+
+/**
+ * @brief Replace the function reading the watched channels, which reads them from the IOTA full node by default
+ *
+ * It should be called before `mam_watcher_init()`.
+ *
+ * @param[in] read Function reading a channel. NULL restores the default one.
+ */
+void mam_watcher_set_reader(mam_watcher_read_t read);
+
+/**
+ * @brief Start polling the watched channels in background
+ *
+ * @param[in] iconf IOTA API parameter configurations. It must live until `mam_watcher_destroy()`.
+ * @param[in] service IOTA full node end point service to be polled
+ * @param[in] period Milliseconds between two polls
+ * @param[in] push Function delivering new messages
+ * @param[in] arg Argument passed to `push`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_watcher_init(const iota_config_t* const iconf, const iota_client_service_t* const service,
+                          const int period, mam_watcher_push_t push, void* const arg);
+
+/**
+ * @brief Stop polling and remove all the watched channels
+ */
+void mam_watcher_destroy();
+
+/**
+ * @brief Poll every watched channel at once, without waiting for the period
+ */
+void mam_watcher_poll();
+
+/**
+ * @brief Subscribe a client to a channel. The channel is watched from its first subscription, and subscribing to a
+ * channel the client already subscribes to does nothing.
+ *
+ * @param[in] chid Channel ID in trytes
+ * @param[in] client_id ID of the subscribing client in a null-terminated string
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_FAILED_INIT if the watcher is not started
+ * - SC_MAM_INVAID_CHID_OR_EPID if the Channel ID is malformed
+ * - SC_MAM_INVALID_CLIENT_ID if the client ID is empty or longer than `MAM_WATCH_CLIENT_ID_LEN`
+ * - SC_MAM_WATCH_LIMIT if `MAM_WATCH_MAX` channels are watched
+ * - non-zero on error
+ */
+status_t mam_watcher_watch(char const* const chid, char const* const client_id);
+
+/**
+ * @brief Drop the subscription of a client to a channel. The channel is no longer polled once no subscription is left.
+ *
+ * @param[in] chid Channel ID in trytes
+ * @param[in] client_id ID of the subscribing client in a null-terminated string
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_NOT_FOUND if the client does not subscribe to the channel
+ */
+status_t mam_watcher_unwatch(char const* const chid, char const* const client_id);
+
+/**
+ * @brief Drop all the subscriptions of a client
+ *
+ * @param[in] client_id ID of the client in a null-terminated string
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mam_watcher_release(char const* const client_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CORE_MAM_WATCHER_H_
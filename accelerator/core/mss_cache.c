@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "mss_cache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "common/logger.h"
+#include "uthash.h"
+#include "utlist.h"
+#include "utils/trit_pack.h"
+
+#define MSS_LOGGER "mss_cache"
+#define SEED_TRYTE_LEN 81
+#define STORE_MAGIC "TAMSSCH"
+#define STORE_VERSION 1
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define PREFETCH_QUEUE_MAX 16
+
+/** A channel is determined by the seed, the channel ordinal and the depth */
+typedef struct mss_cache_key_s {
+  uint64_t seed_hash;
+  int64_t ord;
+  uint64_t depth;
+} mss_cache_key_t;
+
+typedef struct mss_cache_entry_s {
+  mss_cache_key_t key;
+  uint8_t* packed;  /**< Serialized MAM API object carrying only the channel, packed with 5 trits per byte */
+  size_t num_trits; /**< Number of trits before packing */
+  UT_hash_handle hh;
+} mss_cache_entry_t;
+
+/** A channel waiting to be generated in background */
+typedef struct mss_prefetch_s {
+  mss_cache_key_t key;
+  tryte_t seed[SEED_TRYTE_LEN];
+  struct mss_prefetch_s* next;
+} mss_prefetch_t;
+
+/** Header of a file in the store directory, followed by the packed trits */
+typedef struct store_header_s {
+  char magic[sizeof(STORE_MAGIC) - 1];
+  uint8_t version;
+  uint64_t num_trits;
+} store_header_t;
+
+// Entries are kept in the order of use, and the least recently used one is at the head
+static mss_cache_entry_t* entries = NULL;
+static size_t cache_capacity = 0;
+static char* store_dir = NULL;
+static mss_cache_stats_t cache_stats = {0};
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static mss_prefetch_t* prefetch_queue = NULL;
+static mss_cache_key_t prefetch_key; /**< Channel being generated in background */
+static bool prefetching = false;
+static bool prefetch_running = false;
+static pthread_t prefetch_thread;
+static pthread_cond_t prefetch_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t prefetch_done_cond = PTHREAD_COND_INITIALIZER;
+static logger_id_t logger_id;
+
+void mss_logger_init() { logger_id = logger_helper_enable(MSS_LOGGER, LOGGER_DEBUG, true); }
+
+int mss_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+static uint64_t seed_hash(trit_t const* const secret_key) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < MAM_PRNG_SECRET_KEY_SIZE; i++) {
+    hash ^= (uint8_t)secret_key[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+static void store_path(char* path, const size_t len, const mss_cache_key_t* const key, char const* const suffix) {
+  snprintf(path, len, "%s/%016" PRIx64 "-%" PRId64 "-%" PRIu64 MSS_CACHE_SUFFIX "%s", store_dir, key->seed_hash,
+           key->ord, key->depth, suffix);
+}
+
+/**
+ * @brief Read the packed channel of `key` from the store directory with `mmap()`.
+ *
+ * Must be called with `cache_lock` held.
+ */
+static status_t store_read(const mss_cache_key_t* const key, uint8_t** packed, size_t* num_trits) {
+  status_t ret = SC_OK;
+  char path[FILENAME_MAX];
+  struct stat st;
+  void* map = MAP_FAILED;
+  store_path(path, sizeof(path), key, "");
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return SC_MAM_NOT_FOUND;
+  }
+  if (fstat(fd, &st) || (size_t)st.st_size < sizeof(store_header_t) ||
+      (map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+    ret = SC_MAM_NOT_FOUND;
+    goto done;
+  }
+
+  const store_header_t* header = (const store_header_t*)map;
+  if (memcmp(header->magic, STORE_MAGIC, sizeof(header->magic)) || header->version != STORE_VERSION ||
+      (size_t)st.st_size != sizeof(store_header_t) + TRIT_PACK_SIZE(header->num_trits)) {
+    ta_log_warning("Ignore malformed MSS cache file %s\n", path);
+    ret = SC_MAM_NOT_FOUND;
+    goto done;
+  }
+
+  *packed = (uint8_t*)malloc(TRIT_PACK_SIZE(header->num_trits));
+  if (*packed == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  memcpy(*packed, (const uint8_t*)map + sizeof(store_header_t), TRIT_PACK_SIZE(header->num_trits));
+  *num_trits = header->num_trits;
+
+done:
+  if (map != MAP_FAILED) {
+    munmap(map, st.st_size);
+  }
+  close(fd);
+  return ret;
+}
+
+/**
+ * @brief Write the packed channel of `key` to a temporary file in the store directory and rename it, so a file is never
+ * read half-written. Failing to write only loses the chance to reuse the channel after restarting.
+ */
+static void store_write(const mss_cache_key_t* const key, uint8_t const* const packed, const size_t num_trits) {
+  char path[FILENAME_MAX], tmp_path[FILENAME_MAX];
+  store_header_t header = {.version = STORE_VERSION, .num_trits = num_trits};
+  memcpy(header.magic, STORE_MAGIC, sizeof(header.magic));
+  store_path(path, sizeof(path), key, "");
+  store_path(tmp_path, sizeof(tmp_path), key, ".tmp");
+
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    ta_log_warning("Failed to write MSS cache file %s\n", tmp_path);
+    return;
+  }
+  const size_t packed_size = TRIT_PACK_SIZE(num_trits);
+  const bool written = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+                       write(fd, packed, packed_size) == (ssize_t)packed_size;
+  close(fd);
+  if (!written || rename(tmp_path, path)) {
+    ta_log_warning("Failed to write MSS cache file %s\n", path);
+    unlink(tmp_path);
+  }
+}
+
+/**
+ * @brief Insert a packed channel as the most recently used one, and evict the least recently used one if the capacity
+ * is exceeded. The ownership of `packed` is taken.
+ *
+ * Must be called with `cache_lock` held.
+ */
+static void memory_insert(const mss_cache_key_t* const key, uint8_t* packed, const size_t num_trits) {
+  mss_cache_entry_t* entry = NULL;
+  HASH_FIND(hh, entries, key, sizeof(mss_cache_key_t), entry);
+  if (entry) {
+    free(packed);
+    return;
+  }
+
+  entry = (mss_cache_entry_t*)malloc(sizeof(mss_cache_entry_t));
+  if (entry == NULL) {
+    free(packed);
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return;
+  }
+  entry->key = *key;
+  entry->packed = packed;
+  entry->num_trits = num_trits;
+  HASH_ADD(hh, entries, key, sizeof(mss_cache_key_t), entry);
+
+  while (HASH_COUNT(entries) > cache_capacity) {
+    mss_cache_entry_t* lru = entries;
+    HASH_DEL(entries, lru);
+    free(lru->packed);
+    free(lru);
+  }
+}
+
+/**
+ * @brief Find the channel of `key` in memory, or in the store directory. The serialized trits are returned in `trits`,
+ * which should be freed by the caller.
+ */
+static status_t cache_lookup(const mss_cache_key_t* const key, trit_t** trits, size_t* num_trits) {
+  status_t ret = SC_OK;
+  mss_cache_entry_t* entry = NULL;
+  uint8_t* packed = NULL;
+
+  pthread_mutex_lock(&cache_lock);
+  HASH_FIND(hh, entries, key, sizeof(mss_cache_key_t), entry);
+  if (entry) {
+    // Move the entry to the tail as the most recently used one
+    HASH_DEL(entries, entry);
+    HASH_ADD(hh, entries, key, sizeof(mss_cache_key_t), entry);
+    *num_trits = entry->num_trits;
+    cache_stats.hits++;
+  } else if (store_dir && store_read(key, &packed, num_trits) == SC_OK) {
+    cache_stats.disk_hits++;
+  } else {
+    ret = SC_MAM_NOT_FOUND;
+    goto done;
+  }
+
+  *trits = (trit_t*)malloc(sizeof(trit_t) * (*num_trits));
+  if (*trits == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  ret = trit_pack_decode(entry ? entry->packed : packed, *num_trits, *trits);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    free(*trits);
+    *trits = NULL;
+  }
+
+done:
+  if (packed) {
+    memory_insert(key, packed, *num_trits);
+  }
+  pthread_mutex_unlock(&cache_lock);
+  return ret;
+}
+
+static void cache_insert(const mss_cache_key_t* const key, trit_t const* const trits, const size_t num_trits,
+                         const bool prefetched) {
+  uint8_t* packed = (uint8_t*)malloc(TRIT_PACK_SIZE(num_trits));
+  if (packed == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return;
+  }
+  trit_pack_encode(trits, num_trits, packed);
+
+  pthread_mutex_lock(&cache_lock);
+  if (prefetched) {
+    cache_stats.prefetched++;
+  } else {
+    cache_stats.misses++;
+  }
+  if (store_dir) {
+    store_write(key, packed, num_trits);
+  }
+  memory_insert(key, packed, num_trits);
+  pthread_mutex_unlock(&cache_lock);
+}
+
+/**
+ * @brief Restore the API object carrying only the channel of `key`. An object of another seed, which only happens on a
+ * collision of `seed_hash`, is rejected.
+ */
+static bool scratch_restore(const mss_cache_key_t* const key, mam_api_t const* const api, mam_api_t* const scratch) {
+  trit_t* trits = NULL;
+  size_t num_trits = 0;
+  bool restored = false;
+  if (cache_lookup(key, &trits, &num_trits) != SC_OK) {
+    return false;
+  }
+
+  memset(scratch, 0, sizeof(mam_api_t));
+  if (mam_api_deserialize(trits, num_trits, scratch, NULL, 0) == RC_OK) {
+    restored = !memcmp(scratch->prng.secret_key, api->prng.secret_key, MAM_PRNG_SECRET_KEY_SIZE) &&
+               mam_channel_t_set_size(scratch->channels) == 1;
+    if (!restored) {
+      mam_api_destroy(scratch);
+    }
+  }
+  free(trits);
+  return restored;
+}
+
+/**
+ * @brief Generate the channel of `key` in an API object which carries only that channel, and insert it into the cache.
+ */
+static status_t scratch_generate(const mss_cache_key_t* const key, tryte_t const* const seed, const bool prefetched,
+                                 mam_api_t* const scratch) {
+  tryte_t chid[MAM_CHANNEL_ID_TRYTE_SIZE];
+  if (mam_api_init(scratch, seed) != RC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_INIT));
+    return SC_MAM_FAILED_INIT;
+  }
+
+  scratch->channel_ord = key->ord;
+  if (mam_api_channel_create(scratch, key->depth, chid) != RC_OK) {
+    mam_api_destroy(scratch);
+    ta_log_error("%s\n", ta_error_to_string(SC_MAM_FAILED_CREATE_OR_GET_ID));
+    return SC_MAM_FAILED_CREATE_OR_GET_ID;
+  }
+
+  const size_t num_trits = mam_api_serialized_size(scratch);
+  trit_t* trits = (trit_t*)malloc(sizeof(trit_t) * num_trits);
+  if (trits) {
+    mam_api_serialize(scratch, trits, NULL, 0);
+    cache_insert(key, trits, num_trits, prefetched);
+    free(trits);
+  }
+  return SC_OK;
+}
+
+/**
+ * @brief Check whether the channel of `key` is in memory or in the store directory, without counting it as a use.
+ *
+ * Must be called with `cache_lock` held.
+ */
+static bool cache_contains(const mss_cache_key_t* const key) {
+  mss_cache_entry_t* entry = NULL;
+  char path[FILENAME_MAX];
+  HASH_FIND(hh, entries, key, sizeof(mss_cache_key_t), entry);
+  if (entry) {
+    return true;
+  }
+  if (store_dir) {
+    store_path(path, sizeof(path), key, "");
+    return access(path, F_OK) == 0;
+  }
+  return false;
+}
+
+static void* prefetch_loop(void* arg) {
+  (void)arg;
+  mam_api_t scratch;
+
+  pthread_mutex_lock(&cache_lock);
+  while (prefetch_running) {
+    mss_prefetch_t* job = prefetch_queue;
+    if (job == NULL) {
+      pthread_cond_wait(&prefetch_cond, &cache_lock);
+      continue;
+    }
+    LL_DELETE(prefetch_queue, job);
+    // The channel may have been created by a request while it was queued
+    if (cache_contains(&job->key)) {
+      free(job);
+      continue;
+    }
+    prefetch_key = job->key;
+    prefetching = true;
+    pthread_mutex_unlock(&cache_lock);
+
+    if (scratch_generate(&job->key, job->seed, true, &scratch) == SC_OK) {
+      mam_api_destroy(&scratch);
+      ta_log_debug("Prefetched MSS channel %" PRId64 " of depth %" PRIu64 "\n", job->key.ord, job->key.depth);
+    }
+    memset(job->seed, 0, sizeof(job->seed));
+    free(job);
+
+    pthread_mutex_lock(&cache_lock);
+    prefetching = false;
+    pthread_cond_broadcast(&prefetch_done_cond);
+  }
+  pthread_mutex_unlock(&cache_lock);
+  return NULL;
+}
+
+status_t mss_cache_init(const size_t capacity, char const* const dir) {
+  status_t ret = SC_OK;
+  bool start_prefetch = false;
+  pthread_mutex_lock(&cache_lock);
+  cache_capacity = capacity;
+  if (dir == NULL) {
+    goto done;
+  }
+
+  if (mkdir(dir, S_IRWXU) && errno != EEXIST) {
+    ret = SC_MAM_FAILED_INIT;
+    ta_log_error("Failed to create MSS cache directory %s\n", dir);
+    goto done;
+  }
+  if ((store_dir = strdup(dir)) == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+done:
+  start_prefetch = ret == SC_OK && (cache_capacity > 0 || store_dir) && !prefetch_running;
+  prefetch_running = prefetch_running || start_prefetch;
+  pthread_mutex_unlock(&cache_lock);
+
+  // Failing to start the thread only leaves every channel generated in the request
+  if (start_prefetch && pthread_create(&prefetch_thread, NULL, prefetch_loop, NULL)) {
+    pthread_mutex_lock(&cache_lock);
+    prefetch_running = false;
+    pthread_mutex_unlock(&cache_lock);
+    ta_log_warning("%s\n", "Failed to start prefetching MSS channels.");
+  }
+  return ret;
+}
+
+void mss_cache_destroy() {
+  mss_cache_entry_t *entry = NULL, *tmp = NULL;
+  mss_prefetch_t *job = NULL, *job_tmp = NULL;
+
+  pthread_mutex_lock(&cache_lock);
+  const bool running = prefetch_running;
+  prefetch_running = false;
+  pthread_cond_signal(&prefetch_cond);
+  pthread_mutex_unlock(&cache_lock);
+  if (running) {
+    pthread_join(prefetch_thread, NULL);
+  }
+
+  pthread_mutex_lock(&cache_lock);
+  LL_FOREACH_SAFE(prefetch_queue, job, job_tmp) {
+    LL_DELETE(prefetch_queue, job);
+    memset(job->seed, 0, sizeof(job->seed));
+    free(job);
+  }
+  HASH_ITER(hh, entries, entry, tmp) {
+    HASH_DEL(entries, entry);
+    free(entry->packed);
+    free(entry);
+  }
+  cache_capacity = 0;
+  free(store_dir);
+  store_dir = NULL;
+  pthread_mutex_unlock(&cache_lock);
+}
+
+status_t mss_cache_channel_create(mam_api_t* const api, const size_t depth, tryte_t* const chid) {
+  status_t ret = SC_OK;
+  mam_api_t scratch;
+  mam_channel_t_set_entry_t *entry = NULL, *tmp = NULL;
+  if (api == NULL || chid == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&cache_lock);
+  const bool enabled = cache_capacity > 0 || store_dir;
+  pthread_mutex_unlock(&cache_lock);
+  if (!enabled) {
+    if (mam_api_channel_create(api, depth, chid) != RC_OK) {
+      ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+    }
+    return ret;
+  }
+
+  const mss_cache_key_t key = {.seed_hash = seed_hash(api->prng.secret_key), .ord = api->channel_ord, .depth = depth};
+
+  // Wait for the channel if it is being generated in background, rather than generating it twice
+  pthread_mutex_lock(&cache_lock);
+  while (prefetching && !memcmp(&prefetch_key, &key, sizeof(mss_cache_key_t))) {
+    pthread_cond_wait(&prefetch_done_cond, &cache_lock);
+  }
+  pthread_mutex_unlock(&cache_lock);
+
+  if (!scratch_restore(&key, api, &scratch)) {
+    tryte_t seed[SEED_TRYTE_LEN];
+    trits_to_trytes(api->prng.secret_key, seed, MAM_PRNG_SECRET_KEY_SIZE);
+    ret = scratch_generate(&key, seed, false, &scratch);
+    memset(seed, 0, sizeof(seed));
+    if (ret) {
+      return ret;
+    }
+  }
+
+  // Move the channel into `api`. The set only holds shallow copies, so the trees are owned by `api` afterwards.
+  SET_ITER(scratch.channels, entry, tmp) {
+    if (mam_channel_t_set_add(&api->channels, &entry->value) != RC_OK) {
+      ret = SC_MAM_FAILED_CREATE_OR_GET_ID;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      mam_api_destroy(&scratch);
+      return ret;
+    }
+    trits_to_trytes(trits_begin(mam_channel_id(&entry->value)), chid, MAM_CHANNEL_ID_TRIT_SIZE);
+  }
+  mam_channel_t_set_free(&scratch.channels);
+  api->channel_ord++;
+
+  mam_api_destroy(&scratch);
+  return SC_OK;
+}
+
+void mss_cache_prefetch(mam_api_t const* const api, const size_t depth, const size_t remain_key_num) {
+  mss_prefetch_t* job = NULL;
+  int queued = 0;
+  if (api == NULL || remain_key_num * MSS_PREFETCH_RATIO > ((size_t)1 << depth)) {
+    return;
+  }
+
+  const mss_cache_key_t key = {.seed_hash = seed_hash(api->prng.secret_key), .ord = api->channel_ord, .depth = depth};
+  pthread_mutex_lock(&cache_lock);
+  if (!prefetch_running || (prefetching && !memcmp(&prefetch_key, &key, sizeof(mss_cache_key_t))) ||
+      cache_contains(&key)) {
+    goto done;
+  }
+  LL_FOREACH(prefetch_queue, job) {
+    if (!memcmp(&job->key, &key, sizeof(mss_cache_key_t))) {
+      goto done;
+    }
+    queued++;
+  }
+  if (queued >= PREFETCH_QUEUE_MAX) {
+    ta_log_debug("%s\n", "MSS prefetch queue is full.");
+    goto done;
+  }
+
+  job = (mss_prefetch_t*)malloc(sizeof(mss_prefetch_t));
+  if (job == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    goto done;
+  }
+  job->key = key;
+  trits_to_trytes(api->prng.secret_key, job->seed, MAM_PRNG_SECRET_KEY_SIZE);
+  LL_APPEND(prefetch_queue, job);
+  pthread_cond_signal(&prefetch_cond);
+
+done:
+  pthread_mutex_unlock(&cache_lock);
+}
+
+void mss_cache_stats(mss_cache_stats_t* const stats) {
+  pthread_mutex_lock(&cache_lock);
+  *stats = cache_stats;
+  pthread_mutex_unlock(&cache_lock);
+}
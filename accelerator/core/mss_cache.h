@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef CORE_MSS_CACHE_H_
+#define CORE_MSS_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "common/trinary/trit_tryte.h"
+#include "mam/api/api.h"
+#include "mam/mam/mam_channel_t_set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file accelerator/core/mss_cache.h
+ * @brief Cache of MAM channels with generated MSS Merkle trees
+ *
+ * Creating a MAM channel generates its MSS Merkle tree, which costs 2^depth WOTS key generations. A channel is
+ * determined by the seed, the channel ordinal and the depth, so channels created once are kept in the cache, and
+ * creating the same channel again becomes a lookup.
+ *
+ * Channels are kept in an in-memory LRU list, packed with 5 trits per byte. If a store directory is given, channels are
+ * also written to files under it, and read back with `mmap()` on a miss of the in-memory cache, so generated trees
+ * survive restarts. The files carry the seed like the MAM file does, so the directory should be kept private.
+ *
+ * Once few keys of a channel remain, the next channel can be generated by a background thread with
+ * `mss_cache_prefetch()`, so announcing it only looks it up in the cache.
+ */
+
+#define MSS_CACHE_CAPACITY 64   /**< Default number of channels kept in memory */
+#define MSS_CACHE_SUFFIX ".mss" /**< Suffix of the files in the store directory */
+#define MSS_PREFETCH_RATIO 4    /**< The next channel is prefetched once 1/MSS_PREFETCH_RATIO of the keys remain */
+
+/** struct of mss_cache_stats_t */
+typedef struct mss_cache_stats_s {
+  uint64_t hits;       /**< Number of channels found in memory */
+  uint64_t disk_hits;  /**< Number of channels found in the store directory */
+  uint64_t misses;     /**< Number of channels generated in the request */
+  uint64_t prefetched; /**< Number of channels generated in background */
+} mss_cache_stats_t;
+
+/**
+ * @brief Initialize the MSS cache
+ *
+ * Without initializing, every channel is generated.
+ *
+ * @param[in] capacity Maximum number of channels kept in memory
+ * @param[in] dir Store directory. NULL keeps channels in memory only. It is created if it does not exist.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mss_cache_init(const size_t capacity, char const* const dir);
+
+/**
+ * @brief Release all the channels kept in memory
+ */
+void mss_cache_destroy();
+
+/**
+ * @brief Create the next channel of a MAM API object, the same as `mam_api_channel_create()`
+ *
+ * @param[in,out] api MAM API object
+ * @param[in] depth Depth of the MSS Merkle tree of the channel
+ * @param[out] chid Channel ID in trytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_MAM_FAILED_CREATE_OR_GET_ID on error of creating the channel
+ * - non-zero on error
+ */
+status_t mss_cache_channel_create(mam_api_t* const api, const size_t depth, tryte_t* const chid);
+
+/**
+ * @brief Generate the next channel of a MAM API object in background, if at most 1/`MSS_PREFETCH_RATIO` of the keys of
+ * the current channel remain
+ *
+ * The channel is the one `mss_cache_channel_create()` creates next with the same `api` and `depth`. Nothing is done if
+ * the channel is already cached, or the MSS cache is not initialized.
+ *
+ * @param[in] api MAM API object
+ * @param[in] depth Depth of the MSS Merkle tree of the channel
+ * @param[in] remain_key_num Number of unused keys of the current channel
+ */
+void mss_cache_prefetch(mam_api_t const* const api, const size_t depth, const size_t remain_key_num);
+
+/**
+ * @brief Get the accumulated statistics of the MSS cache
+ *
+ * @param[out] stats Statistics
+ */
+void mss_cache_stats(mss_cache_stats_t* const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CORE_MSS_CACHE_H_
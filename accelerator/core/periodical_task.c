@@ -11,6 +11,9 @@
 #define PT_LOGGER "periodical_task"
 
 static logger_id_t logger_id;
+static pthread_mutex_t health_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t health_cond = PTHREAD_COND_INITIALIZER;
+static bool cache_reconnected = false;
 
 void bk_logger_init() { logger_id = logger_helper_enable(PT_LOGGER, LOGGER_DEBUG, true); }
 
@@ -60,32 +63,76 @@ done:
   return ret;
 }
 
+/**
+ * @brief Move the head of the buffer list to the dead-letter list
+ *
+ * The bundle blob is kept under the UUID, so it can be inspected or buffered again.
+ *
+ * @param[in] core Context of tangle-accelerator core
+ * @param[in] uuid UUID at the head of the buffer list
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+static status_t move_to_dead_list(const ta_core_t* const core, const char* const uuid) {
+  status_t ret = SC_OK;
+  char pop_uuid[UUID_STR_LEN];
+  if (pthread_rwlock_trywrlock(core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  ret = cache_list_pop(core->cache.buffer_list_name, pop_uuid);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  ret = cache_list_push(core->cache.dead_list_name, strlen(core->cache.dead_list_name), uuid, UUID_STR_LEN - 1);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  ta_log_warning("Move buffered request %s to %s\n", uuid, core->cache.dead_list_name);
+
+done:
+  if (pthread_rwlock_unlock(core->cache.rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
+
 status_t broadcast_buffered_txn(const ta_core_t* const core) {
   status_t ret = SC_OK;
   int uuid_list_len = 0;
   hash8019_array_p txn_trytes_array = NULL;
+  char* blob = NULL;
+  size_t blob_len = 0;
 
   /*
    *There are 4 data structures used here.
-   * 1. List: A list of unsent uuid which can be used to identify an unsent transaction object
-   * 2. Key-value: UUID to unsent transaction object in `flex_trit_t`
-   * 3. List: Store all the UUID of sent transaction objects. (We could use set after investigation in the future)
-   * 4. Key-value: UUID to sent transaction object in `flex_trit_t`
+   * 1. List: A list of unsent uuid which can be used to identify an unsent bundle blob
+   * 2. Key-value: UUID to the bundle blob of unsent or sent transaction objects in `flex_trit_t`
+   * 3. List: Store all the UUID of sent bundle blobs. (We could use set after investigation in the future)
+   * 4. List: Store all the UUID of bundle blobs which can't be decoded
    *
    * 'push_txn_to_buffer()':
    *    Push UUID to the unsent UUID list.
-   *    Store UUID as key and unsent transaction `flex_trit_t` as value.
+   *    Store UUID as key and unsent bundle blob as value.
    *
    * 'broadcast_buffered_txn()':
-   *    Pop an unsent UUID in the unsent UUID list.
-   *    Delete UUID-unsent_transaction pair from key value storage
-   *    Store UUID as key and sent transaction object in `flex_trit_t` as value.
-   *    Push UUID of sent transaction into sent transaction list.
+   *    Peek an unsent UUID in the unsent UUID list.
+   *    Convert the bundle buffered by a previous version into a bundle blob.
+   *    Move UUID of a bundle blob which can't be decoded into the dead-letter list.
+   *    Replace the unsent bundle blob with the sent one.
+   *    Move UUID of sent bundle into sent UUID list.
    *
    * 'ta_fetch_buffered_request_status()':
-   *    Fetch transaction object with UUID in key-value storage.
-   *    Delete UUID from sent transaction list
-   *    Delete UUID-sent_transaction pair from key-value storage
+   *    Fetch bundle blob with UUID in key-value storage.
+   *    Delete UUID from sent UUID list
+   *    Delete UUID-bundle_blob pair from key-value storage
    */
 
   get_trytes_req_t* req = NULL;
@@ -111,37 +158,46 @@ status_t broadcast_buffered_txn(const ta_core_t* const core) {
       goto done;
     }
 
-    // TODO Now we assume every time we call `cache_get()`, we would get a transaction object. However, in the future,
-    // the returned result may be a bundle.
-    int trytes_array_len = 0;
-    ret = cache_list_size(uuid, &trytes_array_len);
+    bundle_blob_header_t header;
+    ret = upgrade_buffered_txn(uuid, core->iota_conf.mwm, false);
+    if (ret == SC_OK) {
+      ret = cache_get_blob(uuid, &blob, &blob_len);
+    }
+    if (ret == SC_OK) {
+      ret = bundle_blob_decode(blob, blob_len, &header, txn_trytes_array);
+    }
+    free(blob);
+    blob = NULL;
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+      if (ret == SC_CACHE_OFF || ret == SC_OOM) {
+        goto done;
+      }
 
-    for (int i = 0; i < trytes_array_len; ++i) {
-      flex_trit_t req_txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION + 1] = {};
-      ret = cache_list_at(uuid, i, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION, (char*)req_txn_flex_trits);
+      // Otherwise the request would block all the requests behind it
+      ret = move_to_dead_list(core, uuid);
       if (ret) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
         goto done;
       }
-      hash_array_push(txn_trytes_array, req_txn_flex_trits);
+      hash_array_free(txn_trytes_array);
+      txn_trytes_array = NULL;
+      continue;
     }
 
-    ret = ta_send_trytes(&core->ta_conf, &core->iota_conf, &core->iota_service, txn_trytes_array);
+    // Attach the bundle with the MWM it was buffered with
+    iota_config_t iota_conf = core->iota_conf;
+    iota_conf.mwm = header.mwm;
+    ret = ta_send_trytes(&core->ta_conf, &iota_conf, &core->iota_service, txn_trytes_array);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
 
-    // TODO Update the transaction object saved in redis, which allows `ta_fetch_buffered_request_status()` to
-    // return the transaction object much faster.
+    // Fetch the attached transaction objects, so `ta_fetch_buffered_request_status()` can return them directly.
     req = get_trytes_req_new();
     res = get_trytes_res_new();
     iota_transaction_t txn;
-    for (int i = 0; i < trytes_array_len; ++i) {
+    for (int i = 0; i < header.txn_num; ++i) {
       transaction_deserialize_from_trits(&txn, hash_array_at(txn_trytes_array, i), true);
       flex_trit_t* hash = transaction_hash(&txn);
 
@@ -162,22 +218,34 @@ status_t broadcast_buffered_txn(const ta_core_t* const core) {
       goto done;
     }
 
-    // Delete the old transaction object
-    ret = cache_del(uuid);
+    txn_trytes_array = hash8019_array_new();
+    const int trytes_array_len = hash8019_queue_count(res->trytes);
+    for (int i = 0; i < trytes_array_len; ++i) {
+      hash_array_push(txn_trytes_array, hash8019_queue_at(res->trytes, i));
+    }
+    header.broadcast_timestamp = current_timestamp_ms();
+    ret = bundle_blob_encode(&header, txn_trytes_array, &blob, &blob_len);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+    hash_array_free(txn_trytes_array);
+    txn_trytes_array = NULL;
 
-    trytes_array_len = hash8019_queue_count(res->trytes);
-    for (int i = 0; i < trytes_array_len; ++i) {
-      ret = cache_list_push(uuid, UUID_STR_LEN - 1, hash8019_queue_at(res->trytes, i),
-                            NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
-      if (ret) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
+    // Replace the old bundle blob
+    ret = cache_set_overwrite(uuid, UUID_STR_LEN - 1, blob, blob_len, 0);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    cache_eviction_untrack(uuid);
+    ret = cache_eviction_track(uuid, blob_len + 2 * (UUID_STR_LEN - 1));
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
     }
+    free(blob);
+    blob = NULL;
 
     if (pthread_rwlock_trywrlock(core->cache.rwlock)) {
       ret = SC_CACHE_LOCK_FAILURE;
@@ -198,6 +266,11 @@ status_t broadcast_buffered_txn(const ta_core_t* const core) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+    ret = cache_eviction_complete(uuid, core->cache.complete_list_name, core->cache.complete_ttl);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
     if (pthread_rwlock_unlock(core->cache.rwlock)) {
       ret = SC_CACHE_LOCK_FAILURE;
       ta_log_error("%s\n", ta_error_to_string(ret));
@@ -209,6 +282,7 @@ status_t broadcast_buffered_txn(const ta_core_t* const core) {
   } while (uuid_list_len);
 
 done:
+  free(blob);
   hash_array_free(txn_trytes_array);
   get_trytes_req_free(&req);
   get_trytes_res_free(&res);
@@ -218,10 +292,7 @@ done:
 status_t broadcast_buffered_send_mam_request(const ta_core_t* const core) {
   status_t ret = SC_OK;
   int uuid_list_len = 0;
-  char* json = NULL;
 
-  ta_send_mam_req_t* req = NULL;
-  ta_send_mam_res_t* res = NULL;
   do {
     char uuid[UUID_STR_LEN];
 
@@ -242,98 +313,89 @@ status_t broadcast_buffered_send_mam_request(const ta_core_t* const core) {
       goto done;
     }
 
-    ret = cache_get(uuid, &json);
-    if (ret) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
-
-    req = send_mam_req_new();
-    res = send_mam_res_new();
-    if (!req || !res) {
-      ret = SC_OOM;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
-
-    ret = send_mam_message_req_deserialize(json, req);
-    if (ret) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
-    free(json);
-    json = NULL;
-
-    ret = ta_send_mam_message(&core->ta_conf, &core->iota_conf, &core->iota_service, req, res);
+    ret = mam_send_buffered_request(core, uuid);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
+  } while (uuid_list_len);
 
-    ret = send_mam_message_res_serialize(res, NULL, &json);
-    if (ret != SC_OK) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+done:
+  return ret;
+}
 
-    if (pthread_rwlock_trywrlock(core->cache.rwlock)) {
-      ret = SC_CACHE_LOCK_FAILURE;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+status_t replay_spooled_requests(const ta_core_t* const core) {
+  status_t ret = SC_OK;
+  int replayed = 0;
+  spool_record_t record;
+  if (core->cache.spool == NULL) {
+    return SC_OK;
+  }
 
-    // Delete the old transaction object
-    ret = cache_del(uuid);
-    if (ret) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+  ret = spool_sync(core->cache.spool);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
 
-    ret = cache_set(uuid, UUID_STR_LEN - 1, json, strlen(json), core->cache.timeout);
-    if (ret) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
+  while ((ret = spool_peek(core->cache.spool, &record)) == SC_OK) {
+    // A previous replay may be interrupted before the request is acknowledged. Failing to delete it is harmless.
+    cache_del(record.key);
 
-    // Pop transaction from buffered list
-    ret = cache_list_pop(core->cache.mam_buffer_list_name, (char*)uuid);
+    ret = ta_buffer_request(&core->cache, record.type, record.key, record.data, record.len, false);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
 
-    // Transfer the transaction to another list in where we store all the successfully broadcasted transactions.
-    ret = cache_list_push(core->cache.mam_complete_list_name, strlen(core->cache.mam_complete_list_name), uuid,
-                          UUID_STR_LEN - 1);
+    ret = spool_ack(core->cache.spool, &record);
     if (ret) {
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
-    if (pthread_rwlock_unlock(core->cache.rwlock)) {
-      ret = SC_CACHE_LOCK_FAILURE;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
-
-    send_mam_req_free(&req);
-    send_mam_res_free(&res);
-    free(json);
-    json = NULL;
-  } while (uuid_list_len);
+    replayed++;
+  }
+  if (ret == SC_UTILS_SPOOL_EMPTY) {
+    ret = SC_OK;
+  }
 
 done:
-  send_mam_req_free(&req);
-  send_mam_res_free(&res);
-  free(json);
+  if (replayed) {
+    ta_log_info("Moved %d requests from local spool to cache server. %zu requests left\n", replayed,
+                spool_pending(core->cache.spool));
+  }
   return ret;
 }
 
+/**
+ * @brief Wake up health tracking once the cache server comes back, so spooled requests are moved right away
+ *
+ * @param[in] arg Unused
+ */
+static void wake_health_track(void* const arg) {
+  (void)arg;
+  pthread_mutex_lock(&health_lock);
+  cache_reconnected = true;
+  pthread_cond_signal(&health_cond);
+  pthread_mutex_unlock(&health_lock);
+}
+
 void* health_track(void* arg) {
   ta_core_t* core = (ta_core_t*)arg;
-  char uuid[UUID_STR_LEN] = {};
+  const char* const complete_list_names[] = {core->cache.complete_list_name, core->cache.mam_complete_list_name};
+  struct timespec deadline;
+
+  if (core->cache.spool) {
+    cache_set_reconnect_callback(wake_health_track, NULL);
+  }
 
   while (core->cache.state) {
-    status_t ret = ta_get_node_status(&core->iota_service);
+    // Requests buffered in the local spool are moved to the cache server once it is available
+    status_t ret = replay_spooled_requests(core);
+    if (ret) {
+      ta_log_error("Replay spooled requests failed. %s\n", ta_error_to_string(ret));
+    }
+
+    ret = ta_get_node_status(&core->iota_service);
     if (ret == SC_CORE_NODE_UNSYNC || ret == SC_CCLIENT_FAILED_RESPONSE) {
       ta_log_error("IOTA full node status error %d. Try to connect to another IOTA full node on priority list\n", ret);
       ret = ta_update_full_node_connection(&core->ta_conf, &core->iota_service);
@@ -350,35 +412,39 @@ void* health_track(void* arg) {
       }
     }
 
+    // Buffered MAM requests are sent by the MAM sender if it runs, which only needs the ones it has not queued
     if (ret == SC_OK) {
-      ret = broadcast_buffered_send_mam_request(core);
+      ret = mam_sender_running() ? mam_sender_recover() : broadcast_buffered_send_mam_request(core);
       if (ret) {
         ta_log_error("Broadcast buffered send MAM message requests failed. %s\n", ta_error_to_string(ret));
       }
     }
 
-    // The usage exceeds the maximum redis capacity
-    while (core->cache.capacity < cache_occupied_space()) {
-      if (pthread_rwlock_trywrlock(core->cache.rwlock)) {
-        ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
-        break;
-      }
-
-      ret = cache_list_pop(core->cache.complete_list_name, uuid);
-      if (ret) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
-      }
-      ret = cache_del(uuid);
-      if (ret) {
-        ta_log_error("%s\n", ta_error_to_string(ret));
-      }
-
-      if (pthread_rwlock_unlock(core->cache.rwlock)) {
-        ta_log_error("%s\n", ta_error_to_string(SC_CACHE_LOCK_FAILURE));
-      }
+    // Expire completed requests and evict the oldest ones if the usage exceeds the maximum redis capacity
+    int evicted = 0, expired = 0;
+    ret = cache_eviction_run(core->cache.rwlock, core->cache.capacity, core->cache.low_water_percent,
+                             complete_list_names, ARRAY_SIZE(complete_list_names), &evicted, &expired);
+    if (ret) {
+      ta_log_error("Evict buffered requests failed. %s\n", ta_error_to_string(ret));
+    }
+    if (evicted || expired) {
+      ta_log_info("Evicted %d and expired %d completed requests from cache server\n", evicted, expired);
     }
 
-    sleep(core->ta_conf.health_track_period);
+    // Sleep until the next period, unless the cache server comes back in between
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += core->ta_conf.health_track_period;
+    int wait_ret = 0;
+    pthread_mutex_lock(&health_lock);
+    while (!cache_reconnected && wait_ret != ETIMEDOUT) {
+      wait_ret = pthread_cond_timedwait(&health_cond, &health_lock, &deadline);
+    }
+    if (cache_reconnected) {
+      ta_log_info("Cache server is back. Start health tracking before the next period\n");
+    }
+    cache_reconnected = false;
+    pthread_mutex_unlock(&health_lock);
   }
+  cache_set_reconnect_callback(NULL, NULL);
   return ((void*)NULL);
 }
@@ -13,6 +13,7 @@
 #include "accelerator/config.h"
 #include "accelerator/core/core.h"
 #include "accelerator/core/mam_core.h"
+#include "accelerator/core/mam_sender.h"
 #include "common/logger.h"
 #include "common/ta_errors.h"
 #include "pthread.h"
@@ -54,6 +55,20 @@ status_t broadcast_buffered_txn(const ta_core_t* const core);
  */
 status_t broadcast_buffered_send_mam_request(const ta_core_t* const core);
 
+/**
+ * @brief Move requests buffered in the local spool into the cache server
+ *
+ * Requests are buffered in the local spool while the cache server is unavailable. Once the cache server comes back,
+ * they are moved into the buffer lists in the order they were buffered, and broadcast as other buffered requests.
+ *
+ * @param[in] core Pointer to Tangle-accelerator core configuration structure
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t replay_spooled_requests(const ta_core_t* const core);
+
 #ifdef __cplusplus
 }
 #endif
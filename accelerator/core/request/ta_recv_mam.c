@@ -24,9 +24,11 @@ static void recv_mam_req_v1_free(ta_recv_mam_req_t** req) {
     free(data_id->bundle_hash);
     free(data_id->chid);
     free(data_id->msg_id);
+    free(data_id->since);
     data_id->bundle_hash = NULL;
     data_id->chid = NULL;
     data_id->msg_id = NULL;
+    data_id->since = NULL;
 
     free((*req)->data_id);
     (*req)->data_id = NULL;
@@ -77,6 +79,7 @@ status_t recv_mam_req_v1_init(ta_recv_mam_req_t* req) {
   data_id->bundle_hash = NULL;
   data_id->chid = NULL;
   data_id->msg_id = NULL;
+  data_id->since = NULL;
 
   recv_mam_key_mam_v1_t* key = (recv_mam_key_mam_v1_t*)req->key;
   utarray_new(key->psk_array, &ut_str_icd);
@@ -122,3 +125,18 @@ error:
   free(data_id->msg_id);
   return ret;
 }
+
+status_t recv_mam_set_mam_v1_since(ta_recv_mam_req_t* req, char* since) {
+  if (req == NULL || req->data_id == NULL || since == NULL) {
+    return SC_NULL;
+  }
+
+  recv_mam_data_id_mam_v1_t* data_id = (recv_mam_data_id_mam_v1_t*)req->data_id;
+  free(data_id->since);
+  data_id->since = (tryte_t*)strdup(since);
+  if (!data_id->since) {
+    return SC_OOM;
+  }
+
+  return SC_OK;
+}
@@ -57,6 +57,8 @@ typedef struct recv_mam_data_id_mam_v1_s {
   tryte_t* chid;
   /** message id in trytes */
   tryte_t* msg_id;
+  /** Optional. Bundle hash or message ID of the last message read on `chid`. Only newer messages are returned. */
+  tryte_t* since;
 } recv_mam_data_id_mam_v1_t;
 
 typedef struct recv_mam_key_mam_v1_s {
@@ -80,6 +82,18 @@ typedef struct recv_mam_key_mam_v1_s {
  */
 status_t recv_mam_set_mam_v1_data_id(ta_recv_mam_req_t* req, char* bundle_hash, char* chid, char* msg_id);
 
+/**
+ * @brief Set the cursor of the last message read for MAMv1
+ *
+ * @param[in] req Response data in type of ta_recv_mam_req_t object
+ * @param[in] since Bundle hash or message ID of the last message read
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t recv_mam_set_mam_v1_since(ta_recv_mam_req_t* req, char* since);
+
 /**
  * @brief Set the key for MAMv1
  *
@@ -38,6 +38,7 @@ status_t send_mam_req_v1_init(ta_send_mam_req_t* req) {
   data->seed = NULL;
   data->chid = NULL;
   data->message = NULL;
+  data->messages = NULL;
   data->ch_mss_depth = 6;
 
   send_mam_key_mam_v1_t* key = req->key;
@@ -53,6 +54,9 @@ static void send_mam_req_v1_free(ta_send_mam_req_t** req) {
     free(data->seed);
     free(data->chid);
     free(data->message);
+    if (data->messages) {
+      utarray_free(data->messages);
+    }
     free((*req)->data);
     (*req)->data = NULL;
   }
@@ -25,6 +25,7 @@ extern "C" {
  */
 
 #define SERVICE_TOKEN_LEN 64
+#define SEND_MAM_BATCH_MAX 64 /**< Maximum number of messages in a batch request */
 
 /** struct of ta_send_mam_req_t */
 typedef struct send_mam_req_s {
@@ -43,7 +44,8 @@ typedef struct send_mam_data_mam_v1_s {
                   * are accepted, but tangle-accelerator won't ensure the security during seed transmission. */
   int32_t ch_mss_depth; /**< Optional. The depth of channel merkle tree. */
   tryte_t* chid; /**< Optional. The Channel ID which tangle-accelerator starts to search available message slot. */
-  char* message; /**< Required. The message will be append to the channel. */
+  char* message;      /**< Required if `messages` is absent. The message will be append to the channel. */
+  UT_array* messages; /**< Optional. Messages appended to the channel in order in a batch request. NULL if absent. */
 } send_mam_data_mam_v1_t;
 
 /** struct of send_mam_key_mam_v1_t */
@@ -11,6 +11,7 @@ ta_recv_mam_res_t* recv_mam_res_new() {
   ta_recv_mam_res_t* res = (ta_recv_mam_res_t*)malloc(sizeof(ta_recv_mam_res_t));
   if (res) {
     memset(res->chid1, 0, NUM_TRYTES_ADDRESS + 1);
+    memset(res->cursor, 0, NUM_TRYTES_HASH + 1);
     utarray_new(res->payload_array, &ut_str_icd);
   }
   return res;
@@ -24,6 +24,7 @@ extern "C" {
 typedef struct recv_mam_res_s {
   UT_array* payload_array;         /**< An array of MAM messages */
   char chid1[NUM_TRYTES_HASH + 1]; /**< The Channel ID of next Channel */
+  char cursor[NUM_TRYTES_HASH + 1]; /**< Bundle hash of the last message read, to be passed as `since` next time */
 } ta_recv_mam_res_t;
 
 /**
@@ -14,6 +14,7 @@
 #include "common/ta_errors.h"
 #include "common/trinary/tryte.h"
 #include "mam/mam/message.h"
+#include "utarray.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,9 @@ typedef struct send_mam_res_s {
   char chid1[NUM_TRYTES_HASH + 1];
 } ta_send_mam_res_t;
 
+/** The results of a batch of MAM messages are kept in a UT_array of ta_send_mam_res_t */
+static UT_icd send_mam_res_icd = {sizeof(ta_send_mam_res_t), 0, 0, 0};
+
 /**
  * @brief Allocate memory of ta_send_mam_res_t
  *
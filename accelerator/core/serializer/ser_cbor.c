@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "ser_cbor.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common/logger.h"
+#include "ser_helper.h"
+#include "utils/cbor.h"
+
+#define logger_id ser_logger_id
+
+#define TXN_CBOR_FIELD_NUM 16
+#define MAM_TIMESTAMP_LEN 20 /**< Length of the zero-padded timestamp in front of a received MAM payload */
+
+#define cbor_write_key(writer, key) cbor_write_text(writer, key, sizeof(key) - 1)
+
+static inline bool key_equal(char const* const text, const size_t len, char const* const key) {
+  return strlen(key) == len && !strncmp(text, key, len);
+}
+
+static void transaction_to_cbor(iota_transaction_t const* const txn, cbor_writer_t* const writer) {
+  cbor_write_map(writer, TXN_CBOR_FIELD_NUM);
+  cbor_write_key(writer, "hash");
+  cbor_write_trits(writer, transaction_hash(txn), NUM_TRITS_HASH);
+  cbor_write_key(writer, "signature_and_message_fragment");
+  cbor_write_trits(writer, transaction_message(txn), NUM_TRITS_SIGNATURE);
+  cbor_write_key(writer, "address");
+  cbor_write_trits(writer, transaction_address(txn), NUM_TRITS_HASH);
+  cbor_write_key(writer, "value");
+  cbor_write_int(writer, transaction_value(txn));
+  cbor_write_key(writer, "obsolete_tag");
+  cbor_write_trits(writer, transaction_obsolete_tag(txn), NUM_TRITS_TAG);
+  cbor_write_key(writer, "timestamp");
+  cbor_write_int(writer, transaction_timestamp(txn));
+  cbor_write_key(writer, "current_index");
+  cbor_write_int(writer, transaction_current_index(txn));
+  cbor_write_key(writer, "last_index");
+  cbor_write_int(writer, transaction_last_index(txn));
+  cbor_write_key(writer, "bundle_hash");
+  cbor_write_trits(writer, transaction_bundle(txn), NUM_TRITS_HASH);
+  cbor_write_key(writer, "trunk_transaction_hash");
+  cbor_write_trits(writer, transaction_trunk(txn), NUM_TRITS_HASH);
+  cbor_write_key(writer, "branch_transaction_hash");
+  cbor_write_trits(writer, transaction_branch(txn), NUM_TRITS_HASH);
+  cbor_write_key(writer, "tag");
+  cbor_write_trits(writer, transaction_tag(txn), NUM_TRITS_TAG);
+  cbor_write_key(writer, "attachment_timestamp");
+  cbor_write_int(writer, transaction_attachment_timestamp(txn));
+  cbor_write_key(writer, "attachment_timestamp_lower_bound");
+  cbor_write_int(writer, transaction_attachment_timestamp_lower(txn));
+  cbor_write_key(writer, "attachment_timestamp_upper_bound");
+  cbor_write_int(writer, transaction_attachment_timestamp_upper(txn));
+  cbor_write_key(writer, "nonce");
+  cbor_write_trits(writer, transaction_nonce(txn), NUM_TRITS_NONCE);
+}
+
+static status_t transaction_from_cbor(cbor_reader_t* const reader, iota_transaction_t* const txn) {
+  flex_trit_t msg_trits[FLEX_TRIT_SIZE_6561], hash_trits[FLEX_TRIT_SIZE_243], tag_trits[FLEX_TRIT_SIZE_81];
+  char const* key = NULL;
+  size_t num = 0, key_len = 0;
+  int64_t value = 0;
+
+  status_t ret = cbor_read_map(reader, &num);
+  for (size_t i = 0; ret == SC_OK && i < num; i++) {
+    ret = cbor_read_text(reader, &key, &key_len);
+    if (ret) {
+      break;
+    }
+
+    if (key_equal(key, key_len, "signature_and_message_fragment")) {
+      if (!(ret = cbor_read_trits(reader, msg_trits, NUM_TRITS_SIGNATURE))) {
+        transaction_set_signature(txn, msg_trits);
+      }
+    } else if (key_equal(key, key_len, "hash") || key_equal(key, key_len, "address") ||
+               key_equal(key, key_len, "bundle_hash") || key_equal(key, key_len, "trunk_transaction_hash") ||
+               key_equal(key, key_len, "branch_transaction_hash")) {
+      if ((ret = cbor_read_trits(reader, hash_trits, NUM_TRITS_HASH))) {
+        break;
+      }
+      if (key_equal(key, key_len, "hash")) {
+        transaction_set_hash(txn, hash_trits);
+      } else if (key_equal(key, key_len, "address")) {
+        transaction_set_address(txn, hash_trits);
+      } else if (key_equal(key, key_len, "bundle_hash")) {
+        transaction_set_bundle(txn, hash_trits);
+      } else if (key_equal(key, key_len, "trunk_transaction_hash")) {
+        transaction_set_trunk(txn, hash_trits);
+      } else {
+        transaction_set_branch(txn, hash_trits);
+      }
+    } else if (key_equal(key, key_len, "obsolete_tag") || key_equal(key, key_len, "tag") ||
+               key_equal(key, key_len, "nonce")) {
+      if ((ret = cbor_read_trits(reader, tag_trits, NUM_TRITS_TAG))) {
+        break;
+      }
+      if (key_equal(key, key_len, "obsolete_tag")) {
+        transaction_set_obsolete_tag(txn, tag_trits);
+      } else if (key_equal(key, key_len, "tag")) {
+        transaction_set_tag(txn, tag_trits);
+      } else {
+        transaction_set_nonce(txn, tag_trits);
+      }
+    } else {
+      if ((ret = cbor_read_int(reader, &value))) {
+        break;
+      }
+      if (key_equal(key, key_len, "value")) {
+        transaction_set_value(txn, value);
+      } else if (key_equal(key, key_len, "timestamp")) {
+        transaction_set_timestamp(txn, value);
+      } else if (key_equal(key, key_len, "current_index")) {
+        transaction_set_current_index(txn, value);
+      } else if (key_equal(key, key_len, "last_index")) {
+        transaction_set_last_index(txn, value);
+      } else if (key_equal(key, key_len, "attachment_timestamp")) {
+        transaction_set_attachment_timestamp(txn, value);
+      } else if (key_equal(key, key_len, "attachment_timestamp_lower_bound")) {
+        transaction_set_attachment_timestamp_lower(txn, value);
+      } else if (key_equal(key, key_len, "attachment_timestamp_upper_bound")) {
+        transaction_set_attachment_timestamp_upper(txn, value);
+      } else {
+        ret = SC_UTILS_CBOR_MALFORMED;
+      }
+    }
+  }
+
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
+
+static status_t writer_finish(cbor_writer_t* const writer, char** obj, size_t* obj_len) {
+  uint8_t* data = NULL;
+  status_t ret = cbor_writer_finish(writer, &data, obj_len);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  *obj = (char*)data;
+  return SC_OK;
+}
+
+status_t ta_find_transaction_objects_res_serialize_cbor(const transaction_array_t* const res, char** obj,
+                                                        size_t* obj_len) {
+  cbor_writer_t writer;
+  iota_transaction_t* txn = NULL;
+  if (res == NULL || obj == NULL || obj_len == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  const size_t txn_num = transaction_array_len((transaction_array_t*)res);
+  status_t ret = cbor_writer_init(&writer, txn_num * TXN_CBOR_MAX_SIZE + 9);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  cbor_write_array(&writer, txn_num);
+  TX_OBJS_FOREACH(res, txn) { transaction_to_cbor(txn, &writer); }
+  return writer_finish(&writer, obj, obj_len);
+}
+
+status_t ta_find_transaction_object_single_res_serialize_cbor(transaction_array_t* res, char** obj, size_t* obj_len) {
+  cbor_writer_t writer;
+  if (obj == NULL || obj_len == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  iota_transaction_t* txn = transaction_array_at(res, 0);
+  if (txn == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_CCLIENT_NOT_FOUND));
+    return SC_CCLIENT_NOT_FOUND;
+  }
+
+  status_t ret = cbor_writer_init(&writer, TXN_CBOR_MAX_SIZE);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  transaction_to_cbor(txn, &writer);
+  return writer_finish(&writer, obj, obj_len);
+}
+
+status_t ta_find_transaction_objects_res_deserialize_cbor(char const* const obj, const size_t obj_len,
+                                                          transaction_array_t* const res) {
+  cbor_reader_t reader;
+  size_t txn_num = 0;
+  if (obj == NULL || res == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  cbor_reader_init(&reader, (const uint8_t*)obj, obj_len);
+  status_t ret = cbor_read_array(&reader, &txn_num);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  for (size_t i = 0; i < txn_num; i++) {
+    iota_transaction_t* txn = transaction_new();
+    if (txn == NULL) {
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      return ret;
+    }
+    ret = transaction_from_cbor(&reader, txn);
+    if (ret == SC_OK) {
+      transaction_array_push_back(res, txn);
+    }
+    transaction_free(txn);
+    if (ret) {
+      return ret;
+    }
+  }
+
+  if (!cbor_reader_done(&reader)) {
+    ret = SC_UTILS_CBOR_MALFORMED;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
+
+status_t recv_mam_message_res_serialize_cbor(ta_recv_mam_res_t* const res, char** obj, size_t* obj_len) {
+  cbor_writer_t writer;
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  char** p = NULL;
+  size_t payload_num = 0;
+  if (res == NULL || obj == NULL || obj_len == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  status_t ret = cbor_writer_init(&writer, 0);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  while ((p = (char**)utarray_next(res->payload_array, p))) {
+    payload_num += (*p != NULL);
+  }
+  cbor_write_map(&writer, 1 + (res->chid1[0] != '\0') + (res->cursor[0] != '\0'));
+
+  // Each payload is a pair of its timestamp and message, the same as the one in JSON
+  cbor_write_key(&writer, "payload");
+  cbor_write_array(&writer, payload_num);
+  while ((p = (char**)utarray_next(res->payload_array, p))) {
+    if (!(*p)) {
+      continue;
+    }
+    char timestamp[MAM_TIMESTAMP_LEN + 1] = {0};
+    strncpy(timestamp, *p, MAM_TIMESTAMP_LEN);
+    cbor_write_array(&writer, 2);
+    cbor_write_int(&writer, strtoll(timestamp, NULL, 10));
+    cbor_write_text(&writer, *p + strlen(timestamp), strlen(*p + strlen(timestamp)));
+  }
+
+  if (res->chid1[0]) {
+    flex_trits_from_trytes_simd(hash_trits, NUM_TRITS_HASH, (const tryte_t*)res->chid1, NUM_TRYTES_HASH,
+                                NUM_TRYTES_HASH);
+    cbor_write_key(&writer, "chid1");
+    cbor_write_trits(&writer, hash_trits, NUM_TRITS_HASH);
+  }
+
+  if (res->cursor[0]) {
+    flex_trits_from_trytes_simd(hash_trits, NUM_TRITS_HASH, (const tryte_t*)res->cursor, NUM_TRYTES_HASH,
+                                NUM_TRYTES_HASH);
+    cbor_write_key(&writer, "cursor");
+    cbor_write_trits(&writer, hash_trits, NUM_TRITS_HASH);
+  }
+
+  return writer_finish(&writer, obj, obj_len);
+}
+
+status_t recv_mam_message_res_deserialize_cbor(char const* const obj, const size_t obj_len,
+                                               ta_recv_mam_res_t* const res) {
+  cbor_reader_t reader;
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  char const* text = NULL;
+  size_t num = 0, len = 0;
+  if (obj == NULL || res == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  cbor_reader_init(&reader, (const uint8_t*)obj, obj_len);
+  status_t ret = cbor_read_map(&reader, &num);
+  for (size_t i = 0; ret == SC_OK && i < num; i++) {
+    ret = cbor_read_text(&reader, &text, &len);
+    if (ret) {
+      break;
+    }
+
+    if (key_equal(text, len, "payload")) {
+      size_t payload_num = 0, pair_len = 0;
+      ret = cbor_read_array(&reader, &payload_num);
+      for (size_t j = 0; ret == SC_OK && j < payload_num; j++) {
+        int64_t timestamp = 0;
+        if ((ret = cbor_read_array(&reader, &pair_len)) || pair_len != 2 ||
+            (ret = cbor_read_int(&reader, &timestamp)) || (ret = cbor_read_text(&reader, &text, &len))) {
+          ret = ret ? ret : SC_UTILS_CBOR_MALFORMED;
+          break;
+        }
+
+        // Payloads are restored to the zero-padded timestamp followed by the message
+        char* payload = (char*)malloc(MAM_TIMESTAMP_LEN + len + 1);
+        if (payload == NULL) {
+          ret = SC_OOM;
+          break;
+        }
+        snprintf(payload, MAM_TIMESTAMP_LEN + len + 1, "%0*" PRId64 "%.*s", MAM_TIMESTAMP_LEN, timestamp, (int)len,
+                 text);
+        utarray_push_back(res->payload_array, &payload);
+        free(payload);
+      }
+    } else if (key_equal(text, len, "chid1") || key_equal(text, len, "cursor")) {
+      char* trytes = key_equal(text, len, "chid1") ? res->chid1 : res->cursor;
+      if (!(ret = cbor_read_trits(&reader, hash_trits, NUM_TRITS_HASH))) {
+        flex_trits_to_trytes_simd((tryte_t*)trytes, NUM_TRYTES_HASH, hash_trits, NUM_TRITS_HASH, NUM_TRITS_HASH);
+        trytes[NUM_TRYTES_HASH] = '\0';
+      }
+    } else {
+      ret = SC_UTILS_CBOR_MALFORMED;
+    }
+  }
+
+  if (ret == SC_OK && !cbor_reader_done(&reader)) {
+    ret = SC_UTILS_CBOR_MALFORMED;
+  }
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef SERIALIZER_SER_CBOR_H_
+#define SERIALIZER_SER_CBOR_H_
+
+#include "accelerator/core/request/request.h"
+#include "accelerator/core/response/response.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file accelerator/core/serializer/ser_cbor.h
+ * @brief Functions for serialization of binary responses in CBOR
+ *
+ * A binary response has the same structure and keys as its JSON counterpart, while the fields in trytes are byte
+ * strings of packed trits and the numbers are CBOR integers. See `docs/binary-response.md` for the layout.
+ */
+
+/**
+ * Upper bound of the size of a transaction object in CBOR. It is about 61% of the one in JSON.
+ */
+#define TXN_CBOR_MAX_SIZE 1920
+
+/**
+ * @brief Serialize transaction objects into a CBOR array
+ *
+ * @param[in] res Transaction objects
+ * @param[out] obj Output data in CBOR, which is not NUL-terminated
+ * @param[out] obj_len Length of the output data
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_find_transaction_objects_res_serialize_cbor(const transaction_array_t* const res, char** obj,
+                                                        size_t* obj_len);
+
+/**
+ * @brief Serialize the first transaction object into a CBOR map
+ *
+ * @param[in] res Transaction objects
+ * @param[out] obj Output data in CBOR, which is not NUL-terminated
+ * @param[out] obj_len Length of the output data
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_NOT_FOUND if there is no transaction object
+ * - non-zero on error
+ */
+status_t ta_find_transaction_object_single_res_serialize_cbor(transaction_array_t* res, char** obj, size_t* obj_len);
+
+/**
+ * @brief Deserialize a CBOR array of transaction objects
+ *
+ * @param[in] obj Input data in CBOR
+ * @param[in] obj_len Length of the input data
+ * @param[out] res Transaction objects
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_find_transaction_objects_res_deserialize_cbor(char const* const obj, const size_t obj_len,
+                                                          transaction_array_t* const res);
+
+/**
+ * @brief Serialize the response of `/mam/recv` into a CBOR map
+ *
+ * @param[in] res Response data in type of ta_recv_mam_res_t
+ * @param[out] obj Output data in CBOR, which is not NUL-terminated
+ * @param[out] obj_len Length of the output data
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t recv_mam_message_res_serialize_cbor(ta_recv_mam_res_t* const res, char** obj, size_t* obj_len);
+
+/**
+ * @brief Deserialize the response of `/mam/recv` in CBOR
+ *
+ * @param[in] obj Input data in CBOR
+ * @param[in] obj_len Length of the input data
+ * @param[out] res Response data in type of ta_recv_mam_res_t
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t recv_mam_message_res_deserialize_cbor(char const* const obj, const size_t obj_len,
+                                               ta_recv_mam_res_t* const res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SERIALIZER_SER_CBOR_H_
@@ -11,13 +11,7 @@
 
 #define logger_id ser_logger_id
 
-bool valid_tryte(char* trytes, int len) {
-  for (int i = 0; i < len; i++)
-    if ((trytes[i] < 'A' || trytes[i] > 'Z') && trytes[i] != '9') {
-      return false;
-    }
-  return true;
-}
+bool valid_tryte(char* trytes, int len) { return len <= 0 || trytes_valid(trytes, len); }
 
 status_t ta_json_string_array_to_string_utarray(cJSON const* const obj, char const* const obj_name,
                                                 UT_array* const ut) {
@@ -52,7 +46,8 @@ status_t ta_hash243_stack_to_json_array(hash243_stack_t stack, cJSON* json_root)
   array_count = hash243_stack_count(stack);
   if (array_count > 0) {
     LL_FOREACH(stack, s_iter) {
-      trits_count = flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, s_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+      trits_count = flex_trits_to_trytes_simd(trytes_out, NUM_TRYTES_HASH, s_iter->hash, NUM_TRITS_HASH,
+                                              NUM_TRITS_HASH);
       trytes_out[NUM_TRYTES_HASH] = '\0';
       if (trits_count != 0) {
         cJSON_AddItemToArray(json_root, cJSON_CreateString((const char*)trytes_out));
@@ -81,8 +76,8 @@ status_t ta_json_array_to_hash243_queue(cJSON const* const obj, char const* cons
     cJSON* current_obj = NULL;
     cJSON_ArrayForEach(current_obj, json_item) {
       if (current_obj->valuestring != NULL) {
-        flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t const*)current_obj->valuestring, NUM_TRYTES_HASH,
-                               NUM_TRYTES_HASH);
+        flex_trits_from_trytes_simd(hash, NUM_TRITS_HASH, (tryte_t const*)current_obj->valuestring, NUM_TRYTES_HASH,
+                                    NUM_TRYTES_HASH);
         if (hash243_queue_push(queue, hash) != RC_OK) {
           ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_JSON_PARSE));
           return SC_SERIALIZER_JSON_PARSE;
@@ -105,7 +100,7 @@ status_t ta_hash243_queue_to_json_array(hash243_queue_t queue, cJSON* const json
     CDL_FOREACH(queue, q_iter) {
       tryte_t trytes_out[NUM_TRYTES_HASH + 1];
       size_t trits_count =
-          flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+          flex_trits_to_trytes_simd(trytes_out, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
       trytes_out[NUM_TRYTES_HASH] = '\0';
       if (trits_count != 0) {
         cJSON_AddItemToArray(json_root, cJSON_CreateString((const char*)trytes_out));
@@ -137,8 +132,8 @@ status_t ta_json_array_to_hash8019_array(cJSON const* const obj, char const* con
         ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_INVALID_REQ));
         return SC_SERIALIZER_INVALID_REQ;
       }
-      flex_trits_from_trytes(hash, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t const*)current_obj->valuestring,
-                             NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+      flex_trits_from_trytes_simd(hash, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t const*)current_obj->valuestring,
+                                  NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
       hash_array_push(array, hash);
     }
   }
@@ -162,8 +157,8 @@ status_t ta_hash8019_array_to_json_array(hash8019_array_p array, char const* con
     cJSON_AddItemToObject(json_root, obj_name, array_obj);
 
     HASH_ARRAY_FOREACH(array, elt) {
-      trits_count = flex_trits_to_trytes(trytes_out, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
-                                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+      trits_count = flex_trits_to_trytes_simd(trytes_out, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
+                                              NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
       trytes_out[NUM_TRYTES_SERIALIZED_TRANSACTION] = '\0';
       if (trits_count == 0) {
         ta_log_error("%s\n", ta_error_to_string(SC_CCLIENT_FLEX_TRITS));
@@ -188,26 +183,27 @@ status_t ta_iota_transaction_to_json_object(iota_transaction_t const* const txn,
   }
 
   // transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_hash(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
+  flex_trits_to_trytes_simd((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_hash(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
   hash_trytes[NUM_TRYTES_HASH] = '\0';
   cJSON_AddStringToObject(*txn_json, "hash", hash_trytes);
 
   // message
-  flex_trits_to_trytes((tryte_t*)msg_trytes, NUM_TRYTES_SIGNATURE, transaction_message(txn), NUM_TRITS_SIGNATURE,
-                       NUM_TRITS_SIGNATURE);
+  flex_trits_to_trytes_simd((tryte_t*)msg_trytes, NUM_TRYTES_SIGNATURE, transaction_message(txn), NUM_TRITS_SIGNATURE,
+                            NUM_TRITS_SIGNATURE);
   msg_trytes[NUM_TRYTES_SIGNATURE] = '\0';
   cJSON_AddStringToObject(*txn_json, "signature_and_message_fragment", msg_trytes);
 
   // address
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_address(txn), NUM_TRITS_HASH,
-                       NUM_TRITS_HASH);
+  flex_trits_to_trytes_simd((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_address(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
   hash_trytes[NUM_TRYTES_HASH] = '\0';
   cJSON_AddStringToObject(*txn_json, "address", hash_trytes);
   // value
   cJSON_AddNumberToObject(*txn_json, "value", transaction_value(txn));
   // obsolete tag
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_obsolete_tag(txn), NUM_TRITS_TAG,
-                       NUM_TRITS_TAG);
+  flex_trits_to_trytes_simd((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_obsolete_tag(txn), NUM_TRITS_TAG,
+                            NUM_TRITS_TAG);
   tag_trytes[NUM_TRYTES_TAG] = '\0';
   cJSON_AddStringToObject(*txn_json, "obsolete_tag", tag_trytes);
 
@@ -221,22 +217,25 @@ status_t ta_iota_transaction_to_json_object(iota_transaction_t const* const txn,
   cJSON_AddNumberToObject(*txn_json, "last_index", transaction_last_index(txn));
 
   // bundle hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_bundle(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
+  flex_trits_to_trytes_simd((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_bundle(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
   hash_trytes[NUM_TRYTES_HASH] = '\0';
   cJSON_AddStringToObject(*txn_json, "bundle_hash", hash_trytes);
 
   // trunk transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_trunk(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
+  flex_trits_to_trytes_simd((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_trunk(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
   hash_trytes[NUM_TRYTES_HASH] = '\0';
   cJSON_AddStringToObject(*txn_json, "trunk_transaction_hash", hash_trytes);
 
   // branch transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_branch(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
+  flex_trits_to_trytes_simd((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_branch(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
   hash_trytes[NUM_TRYTES_HASH] = '\0';
   cJSON_AddStringToObject(*txn_json, "branch_transaction_hash", hash_trytes);
 
   // tag
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_tag(txn), NUM_TRITS_TAG, NUM_TRITS_TAG);
+  flex_trits_to_trytes_simd((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_tag(txn), NUM_TRITS_TAG, NUM_TRITS_TAG);
   tag_trytes[NUM_TRYTES_TAG] = '\0';
   cJSON_AddStringToObject(*txn_json, "tag", tag_trytes);
 
@@ -250,14 +249,84 @@ status_t ta_iota_transaction_to_json_object(iota_transaction_t const* const txn,
   cJSON_AddNumberToObject(*txn_json, "attachment_timestamp_upper_bound", transaction_attachment_timestamp_upper(txn));
 
   // nonce
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_NONCE, transaction_nonce(txn), NUM_TRITS_NONCE,
-                       NUM_TRITS_NONCE);
+  flex_trits_to_trytes_simd((tryte_t*)tag_trytes, NUM_TRYTES_NONCE, transaction_nonce(txn), NUM_TRITS_NONCE,
+                            NUM_TRITS_NONCE);
   tag_trytes[NUM_TRYTES_TAG] = '\0';
   cJSON_AddStringToObject(*txn_json, "nonce", tag_trytes);
 
   return SC_OK;
 }
 
+status_t ta_iota_transaction_to_json_writer(iota_transaction_t const* const txn, json_writer_t* const writer) {
+  if (txn == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_CCLIENT_NOT_FOUND));
+    return SC_CCLIENT_NOT_FOUND;
+  }
+  if (writer == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  json_writer_key(writer, "hash");
+  json_writer_trytes(writer, transaction_hash(txn), NUM_TRITS_HASH);
+  json_writer_key(writer, "signature_and_message_fragment");
+  json_writer_trytes(writer, transaction_message(txn), NUM_TRITS_SIGNATURE);
+  json_writer_key(writer, "address");
+  json_writer_trytes(writer, transaction_address(txn), NUM_TRITS_HASH);
+  json_writer_key(writer, "value");
+  json_writer_int(writer, transaction_value(txn));
+  json_writer_key(writer, "obsolete_tag");
+  json_writer_trytes(writer, transaction_obsolete_tag(txn), NUM_TRITS_TAG);
+  json_writer_key(writer, "timestamp");
+  json_writer_int(writer, transaction_timestamp(txn));
+  json_writer_key(writer, "current_index");
+  json_writer_int(writer, transaction_current_index(txn));
+  json_writer_key(writer, "last_index");
+  json_writer_int(writer, transaction_last_index(txn));
+  json_writer_key(writer, "bundle_hash");
+  json_writer_trytes(writer, transaction_bundle(txn), NUM_TRITS_HASH);
+  json_writer_key(writer, "trunk_transaction_hash");
+  json_writer_trytes(writer, transaction_trunk(txn), NUM_TRITS_HASH);
+  json_writer_key(writer, "branch_transaction_hash");
+  json_writer_trytes(writer, transaction_branch(txn), NUM_TRITS_HASH);
+  json_writer_key(writer, "tag");
+  json_writer_trytes(writer, transaction_tag(txn), NUM_TRITS_TAG);
+  json_writer_key(writer, "attachment_timestamp");
+  json_writer_int(writer, transaction_attachment_timestamp(txn));
+  json_writer_key(writer, "attachment_timestamp_lower_bound");
+  json_writer_int(writer, transaction_attachment_timestamp_lower(txn));
+  json_writer_key(writer, "attachment_timestamp_upper_bound");
+  json_writer_int(writer, transaction_attachment_timestamp_upper(txn));
+  json_writer_key(writer, "nonce");
+  json_writer_trytes(writer, transaction_nonce(txn), NUM_TRITS_NONCE);
+
+  if (writer->status != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(writer->status));
+  }
+  return writer->status;
+}
+
+status_t ta_transaction_array_to_json_writer(const transaction_array_t* const txn_array, json_writer_t* const writer) {
+  status_t ret = SC_OK;
+  iota_transaction_t* txn = NULL;
+  if (txn_array == NULL || writer == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  json_writer_array_begin(writer);
+  TX_OBJS_FOREACH(txn_array, txn) {
+    json_writer_object_begin(writer);
+    ret = ta_iota_transaction_to_json_writer(txn, writer);
+    if (ret != SC_OK) {
+      return ret;
+    }
+    json_writer_object_end(writer);
+  }
+  json_writer_array_end(writer);
+  return writer->status;
+}
+
 status_t ta_transaction_array_to_json_array(const transaction_array_t* const txn_array, cJSON* json_root) {
   status_t ret = SC_OK;
   iota_transaction_t* txn = NULL;
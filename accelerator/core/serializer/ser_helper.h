@@ -14,6 +14,9 @@
 #include "cJSON.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "utils/json_reader.h"
+#include "utils/json_writer.h"
+#include "utils/tryte_simd.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +29,13 @@ extern "C" {
 
 logger_id_t ser_logger_id;
 
+/**
+ * Upper bound of the length of a transaction object written by `ta_iota_transaction_to_json_writer()`, including the
+ * comma before it in an array. The buffer of a response with `n` transactions is allocated once with `n` times this
+ * size.
+ */
+#define TXN_JSON_MAX_SIZE 3200
+
 /**
  * @brief Examine whether the given string is a list of trytes in 'len' long
  *
@@ -126,6 +136,34 @@ status_t ta_hash8019_array_to_json_array(hash8019_array_p array, char const* con
  */
 status_t ta_iota_transaction_to_json_object(iota_transaction_t const* const txn, cJSON** txn_json);
 
+/**
+ * @brief Write the fields of iota_transaction_t object into the JSON object being written
+ *
+ * The fields are the same as the ones of `ta_iota_transaction_to_json_object()`, while the trytes are written into the
+ * buffer of the writer directly without building a cJSON tree. The object is begun and ended by the caller, so more
+ * fields can be added to it.
+ *
+ * @param[in] txn Input iota_transaction_t object
+ * @param[out] writer JSON writer
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_iota_transaction_to_json_writer(iota_transaction_t const* const txn, json_writer_t* const writer);
+
+/**
+ * @brief Write transaction_array_t as a JSON array of transaction objects
+ *
+ * @param[in] txn_array transaction_array_t object
+ * @param[out] writer JSON writer
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_array_to_json_writer(const transaction_array_t* const txn_array, json_writer_t* const writer);
+
 /**
  * @brief Convert transaction_array_t to cJSON array element
  *
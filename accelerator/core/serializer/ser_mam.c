@@ -90,113 +90,144 @@ static inline status_t ta_json_recv_payload_to_string_utarray(cJSON const* const
   return SC_OK;
 }
 
-static status_t send_mam_message_mam_v1_req_deserialize(cJSON const* const json_obj, ta_send_mam_req_t* const req) {
-  cJSON *json_key = NULL, *json_value = NULL;
-  status_t ret = SC_OK;
-  send_mam_data_mam_v1_t* data = (send_mam_data_mam_v1_t*)req->data;
-  send_mam_key_mam_v1_t* key = (send_mam_key_mam_v1_t*)req->key;
-
-  if (cJSON_HasObjectItem(json_obj, "x-api-key")) {
-    ret = ta_json_get_string(json_obj, "x-api-key", req->service_token, SERVICE_TOKEN_LEN);
-    if (ret != SC_OK) {
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
+/**
+ * @brief Check whether a MAM message only contains ASCII characters
+ *
+ * In case the payload is unicode, the character whose ASCII code is beyond 128 result to an error status_t code
+ */
+static status_t send_mam_message_check_ascii(char const* const message) {
+  for (char const* c = message; *c; c++) {
+    if (*c & 0x80) {
+      ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_JSON_PARSE_NOT_TRYTE));
+      return SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
     }
   }
+  return SC_OK;
+}
 
-  if (cJSON_HasObjectItem(json_obj, "key")) {
-    json_key = cJSON_GetObjectItem(json_obj, "key");
-    if (json_key == NULL) {
-      ret = SC_SERIALIZER_JSON_PARSE;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
+/**
+ * @brief Read an array of strings into a string utarray
+ */
+static status_t send_mam_read_string_array(json_reader_t* const reader, UT_array* const ut) {
+  char* str = NULL;
+  bool more = false;
+  status_t ret = json_reader_array_begin(reader);
+  while (ret == SC_OK && (ret = json_reader_array_next(reader, &more)) == SC_OK && more) {
+    if (json_reader_peek(reader) != JSON_READER_STRING) {
+      ta_log_error("%s\n", "Encountered non-string array member");
+      return SC_SERIALIZER_JSON_PARSE;
     }
-
-    if (cJSON_HasObjectItem(json_key, "psk")) {
-      ret = ta_json_string_array_to_string_utarray(json_key, "psk", key->psk_array);
-      if (ret != SC_OK) {
-        ret = SC_SERIALIZER_JSON_PARSE;
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
+    ret = json_reader_string(reader, &str, NULL);
+    if (ret == SC_OK) {
+      utarray_push_back(ut, &str);
     }
+  }
+  return ret;
+}
 
-    if (cJSON_HasObjectItem(json_key, "ntru")) {
-      ret = ta_json_string_array_to_string_utarray(json_key, "ntru", key->ntru_array);
-      if (ret != SC_OK) {
-        ret = SC_SERIALIZER_JSON_PARSE;
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
+static status_t send_mam_key_mam_v1_req_deserialize(json_reader_t* const reader, send_mam_key_mam_v1_t* const key) {
+  char* name = NULL;
+  status_t ret = json_reader_object_begin(reader);
+  while (ret == SC_OK && (ret = json_reader_object_next(reader, &name)) == SC_OK && name) {
+    if (!strcmp(name, "psk")) {
+      ret = send_mam_read_string_array(reader, key->psk_array);
+    } else if (!strcmp(name, "ntru")) {
+      ret = send_mam_read_string_array(reader, key->ntru_array);
+    } else {
+      ret = json_reader_skip(reader);
     }
   }
+  return (ret == SC_OK) ? SC_OK : SC_SERIALIZER_JSON_PARSE;
+}
 
-  json_key = cJSON_GetObjectItem(json_obj, "data");
-  if (json_key == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
+/**
+ * @brief Read a string of 81 trytes into a newly allocated string
+ */
+static status_t send_mam_read_hash(json_reader_t* const reader, tryte_t** const hash) {
+  char* str = NULL;
+  size_t len = 0;
+  status_t ret = json_reader_string(reader, &str, &len);
+  if (ret != SC_OK) {
+    return SC_SERIALIZER_JSON_PARSE;
   }
-
-  json_value = cJSON_GetObjectItemCaseSensitive(json_key, "seed");
-  if (json_value && json_value->valuestring) {
-    size_t seed_size = strnlen(json_value->valuestring, NUM_TRYTES_ADDRESS);
-
-    if (seed_size != NUM_TRYTES_HASH) {
-      ret = SC_SERIALIZER_INVALID_REQ;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
-    }
-    data->seed = (tryte_t*)malloc(sizeof(tryte_t) * (NUM_TRYTES_ADDRESS + 1));
-    snprintf((char*)data->seed, seed_size + 1, "%s", json_value->valuestring);
+  if (len != NUM_TRYTES_HASH) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_INVALID_REQ));
+    return SC_SERIALIZER_INVALID_REQ;
   }
-
-  json_value = cJSON_GetObjectItemCaseSensitive(json_key, "chid");
-  if (json_value && json_value->valuestring) {
-    size_t chid_size = strnlen(json_value->valuestring, NUM_TRYTES_ADDRESS);
-
-    if (chid_size != NUM_TRYTES_HASH) {
-      ret = SC_SERIALIZER_INVALID_REQ;
-      ta_log_error("%s\n", ta_error_to_string(ret));
-      goto done;
+  if (*hash == NULL) {
+    *hash = (tryte_t*)malloc(sizeof(tryte_t) * (NUM_TRYTES_ADDRESS + 1));
+    if (*hash == NULL) {
+      return SC_OOM;
     }
-    data->chid = (tryte_t*)malloc(sizeof(tryte_t) * (NUM_TRYTES_ADDRESS + 1));
-    snprintf((char*)data->chid, chid_size + 1, "%s", json_value->valuestring);
+    memcpy(*hash, str, NUM_TRYTES_HASH + 1);
   }
+  return SC_OK;
+}
 
-  json_value = cJSON_GetObjectItemCaseSensitive(json_key, "message");
-  if (json_value && json_value->valuestring) {
-    size_t payload_size = strlen(json_value->valuestring);
-    data->message = (char*)malloc((payload_size + 1) * sizeof(char));
+static status_t send_mam_data_mam_v1_req_deserialize(json_reader_t* const reader, send_mam_data_mam_v1_t* const data) {
+  char *name = NULL, *message = NULL;
+  size_t message_len = 0;
+  status_t ret = json_reader_object_begin(reader);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_JSON_PARSE));
+    return SC_SERIALIZER_JSON_PARSE;
+  }
 
-    // In case the payload is unicode, the character whose ASCII code is beyond 128 result to an
-    // error status_t code
-    for (size_t i = 0; i < payload_size; i++) {
-      if (json_value->valuestring[i] & 0x80) {
-        ret = SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
+  while ((ret = json_reader_object_next(reader, &name)) == SC_OK && name) {
+    const json_reader_type_t type = json_reader_peek(reader);
+    if (type == JSON_READER_STRING && !strcmp(name, "seed")) {
+      ret = send_mam_read_hash(reader, &data->seed);
+    } else if (type == JSON_READER_STRING && !strcmp(name, "chid")) {
+      ret = send_mam_read_hash(reader, &data->chid);
+    } else if (data->messages == NULL && !strcmp(name, "messages")) {
+      utarray_new(data->messages, &ut_str_icd);
+      ret = send_mam_read_string_array(reader, data->messages);
+      if (ret != SC_OK) {
+        ret = SC_SERIALIZER_JSON_PARSE;
+      } else if (utarray_len(data->messages) == 0 || utarray_len(data->messages) > SEND_MAM_BATCH_MAX) {
+        ret = SC_SERIALIZER_INVALID_REQ;
+      }
+      char** msg = NULL;
+      while (ret == SC_OK && (msg = (char**)utarray_next(data->messages, msg))) {
+        ret = send_mam_message_check_ascii(*msg);
       }
+    } else if (type == JSON_READER_STRING && data->message == NULL && !strcmp(name, "message")) {
+      ret = json_reader_string(reader, &message, &message_len);
+      if (ret == SC_OK && (ret = send_mam_message_check_ascii(message)) == SC_OK) {
+        data->message = (char*)malloc((message_len + 1) * sizeof(char));
+        if (data->message == NULL) {
+          ret = SC_OOM;
+        } else {
+          memcpy(data->message, message, message_len + 1);
+        }
+      }
+    } else if (type == JSON_READER_NUMBER && !strcmp(name, "ch_mss_depth")) {
+      ret = json_reader_int(reader, &data->ch_mss_depth);
+    } else {
+      ret = json_reader_skip(reader);
     }
-    memcpy(data->message, json_value->valuestring, payload_size + 1);
-  } else {
-    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
-    ret = SC_SERIALIZER_NULL;
-  }
 
-  json_value = cJSON_GetObjectItemCaseSensitive(json_key, "ch_mss_depth");
-  if ((json_value != NULL) && cJSON_IsNumber(json_value)) {
-    data->ch_mss_depth = json_value->valueint;
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      return ret;
+    }
+  }
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
   }
 
-done:
-  return ret;
+  if (data->message == NULL && data->messages == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+  return SC_OK;
 }
 
 static status_t recv_mam_message_mam_v1_req_deserialize(cJSON const* const json_obj, ta_recv_mam_req_t* const req) {
   cJSON *json_key = NULL, *json_value = NULL;
   status_t ret = SC_OK;
-  char *bundle_hash = NULL, *chid = NULL, *msg_id = NULL, *psk = NULL, *ntru = NULL;
+  char *bundle_hash = NULL, *chid = NULL, *msg_id = NULL, *since = NULL, *psk = NULL, *ntru = NULL;
 
   recv_mam_key_mam_v1_t* key = (recv_mam_key_mam_v1_t*)req->key;
   if (cJSON_HasObjectItem(json_obj, "key")) {
@@ -287,12 +318,32 @@ static status_t recv_mam_message_mam_v1_req_deserialize(cJSON const* const json_
     }
   }
 
+  if (cJSON_HasObjectItem(json_key, "since")) {
+    json_value = cJSON_GetObjectItemCaseSensitive(json_key, "since");
+    if (cJSON_IsString(json_value) && (json_value->valuestring != NULL) &&
+        (strlen(json_value->valuestring) == NUM_TRYTES_HASH ||
+         strlen(json_value->valuestring) == NUM_TRYTES_MAM_MSG_ID)) {
+      since = strdup(json_value->valuestring);
+    } else {
+      ret = SC_CCLIENT_JSON_PARSE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+
 set_data_id:
   ret = recv_mam_set_mam_v1_data_id(req, bundle_hash, chid, msg_id);
   if (ret != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
+  if (since) {
+    ret = recv_mam_set_mam_v1_since(req, since);
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
 
 done:
   free(psk);
@@ -300,6 +351,7 @@ done:
   free(bundle_hash);
   free(chid);
   free(msg_id);
+  free(since);
   return ret;
 }
 
@@ -308,36 +360,73 @@ status_t send_mam_message_req_deserialize(const char* const obj, ta_send_mam_req
     ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
     return SC_SERIALIZER_NULL;
   }
-  status_t ret = SC_OK;
-  cJSON* json_obj = cJSON_Parse(obj);
-
-  const int protocol_len = 20;
-  char protocol_str[protocol_len];
+  json_reader_t reader;
+  char *name = NULL, *str = NULL;
+  bool has_protocol = false, has_data = false;
+  status_t ret = json_reader_init(&reader, obj);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
 
-  if (json_obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
+  ret = send_mam_req_v1_init(req);
+  if (ret) {
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
 
-  ret = ta_json_get_string(json_obj, "protocol", protocol_str, protocol_len);
+  // Members are decoded into the request as they are read
+  ret = json_reader_object_begin(&reader);
+  while (ret == SC_OK && (ret = json_reader_object_next(&reader, &name)) == SC_OK && name) {
+    const json_reader_type_t type = json_reader_peek(&reader);
+    const bool is_protocol = !strcmp(name, "protocol");
+    if (is_protocol || !strcmp(name, "x-api-key")) {
+      if (type != JSON_READER_STRING) {
+        ret = SC_CCLIENT_JSON_PARSE;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      ret = json_reader_string(&reader, &str, NULL);
+      if (ret != SC_OK) {
+        break;
+      }
+      if (!is_protocol) {
+        strncpy(req->service_token, str, SERVICE_TOKEN_LEN);
+      } else if (!strncmp(str, "MAM_V1", strlen("MAM_V1"))) {
+        req->protocol = MAM_V1;
+      }
+      has_protocol |= is_protocol;
+    } else if (type == JSON_READER_OBJECT && !strcmp(name, "key")) {
+      ret = send_mam_key_mam_v1_req_deserialize(&reader, (send_mam_key_mam_v1_t*)req->key);
+    } else if (!has_data && !strcmp(name, "data")) {
+      has_data = true;
+      ret = send_mam_data_mam_v1_req_deserialize(&reader, (send_mam_data_mam_v1_t*)req->data);
+      if (ret != SC_OK) {
+        goto done;
+      }
+    } else {
+      ret = json_reader_skip(&reader);
+    }
+  }
+  if (ret == SC_OK) {
+    ret = json_reader_finish(&reader);
+  }
   if (ret != SC_OK) {
+    ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
-  if (!strncmp(protocol_str, "MAM_V1", strlen("MAM_V1"))) {
-    req->protocol = MAM_V1;
-  }
 
-  send_mam_req_v1_init(req);
-  ret = send_mam_message_mam_v1_req_deserialize(json_obj, req);
-  if (ret) {
+  if (!has_protocol) {
+    ret = SC_CCLIENT_JSON_KEY;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  } else if (!has_data) {
+    ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
   }
 
 done:
-  cJSON_Delete(json_obj);
+  json_reader_destroy(&reader);
   return ret;
 }
 
@@ -400,6 +489,22 @@ done:
   return ret;
 }
 
+static void send_mam_res_to_json(const ta_send_mam_res_t* const res, cJSON* const json_obj) {
+  cJSON_AddStringToObject(json_obj, "bundle_hash", res->bundle_hash);
+
+  cJSON_AddStringToObject(json_obj, "chid", res->chid);
+
+  cJSON_AddStringToObject(json_obj, "msg_id", res->msg_id);
+
+  if (res->announcement_bundle_hash[0]) {
+    cJSON_AddStringToObject(json_obj, "announcement_bundle_hash", res->announcement_bundle_hash);
+  }
+
+  if (res->chid1[0]) {
+    cJSON_AddStringToObject(json_obj, "chid1", res->chid1);
+  }
+}
+
 status_t send_mam_message_res_serialize(const ta_send_mam_res_t* const res, char const* const uuid, char** obj) {
   status_t ret = SC_OK;
   if ((!res && !uuid) || !obj) {
@@ -418,25 +523,54 @@ status_t send_mam_message_res_serialize(const ta_send_mam_res_t* const res, char
   if (uuid) {
     cJSON_AddStringToObject(json_root, "uuid", uuid);
   } else {
-    cJSON_AddStringToObject(json_root, "bundle_hash", res->bundle_hash);
+    send_mam_res_to_json(res, json_root);
+  }
+  *obj = cJSON_PrintUnformatted(json_root);
+  if (*obj == NULL) {
+    ret = SC_SERIALIZER_JSON_PARSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
 
-    cJSON_AddStringToObject(json_root, "chid", res->chid);
+done:
+  cJSON_Delete(json_root);
+  return ret;
+}
 
-    cJSON_AddStringToObject(json_root, "msg_id", res->msg_id);
+status_t send_mam_message_batch_res_serialize(UT_array const* const res_array, char** obj) {
+  status_t ret = SC_OK;
+  if (!res_array || !obj) {
+    ret = SC_SERIALIZER_NULL;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
 
-    if (res->announcement_bundle_hash[0]) {
-      cJSON_AddStringToObject(json_root, "announcement_bundle_hash", res->announcement_bundle_hash);
-    }
+  cJSON* json_root = cJSON_CreateObject();
+  cJSON* json_results = cJSON_CreateArray();
+  if (json_root == NULL || json_results == NULL) {
+    cJSON_Delete(json_results);
+    ret = SC_SERIALIZER_JSON_CREATE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  cJSON_AddItemToObject(json_root, "results", json_results);
 
-    if (res->chid1[0]) {
-      cJSON_AddStringToObject(json_root, "chid1", res->chid1);
+  ta_send_mam_res_t* res = NULL;
+  while ((res = (ta_send_mam_res_t*)utarray_next(res_array, res))) {
+    cJSON* json_res = cJSON_CreateObject();
+    if (json_res == NULL) {
+      ret = SC_SERIALIZER_JSON_CREATE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
     }
+    send_mam_res_to_json(res, json_res);
+    cJSON_AddItemToArray(json_results, json_res);
   }
+
   *obj = cJSON_PrintUnformatted(json_root);
   if (*obj == NULL) {
     ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
   }
 
 done:
@@ -516,6 +650,15 @@ status_t recv_mam_message_res_deserialize(const char* const obj, ta_recv_mam_res
 
   if (cJSON_HasObjectItem(json_obj, "chid1")) {
     ret = ta_json_get_string(json_obj, "chid1", res->chid1, NUM_TRYTES_ADDRESS);
+    if (ret) {
+      ret = SC_CCLIENT_JSON_KEY;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+  }
+
+  if (cJSON_HasObjectItem(json_obj, "cursor")) {
+    ret = ta_json_get_string(json_obj, "cursor", res->cursor, NUM_TRYTES_HASH);
     if (ret) {
       ret = SC_CCLIENT_JSON_KEY;
       ta_log_error("%s\n", ta_error_to_string(ret));
@@ -553,6 +696,10 @@ status_t recv_mam_message_res_serialize(ta_recv_mam_res_t* const res, char** obj
     cJSON_AddStringToObject(json_root, "chid1", res->chid1);
   }
 
+  if (res->cursor[0]) {
+    cJSON_AddStringToObject(json_root, "cursor", res->cursor);
+  }
+
   *obj = cJSON_PrintUnformatted(json_root);
   if (*obj == NULL) {
     ret = SC_SERIALIZER_JSON_PARSE;
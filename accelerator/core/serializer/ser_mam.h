@@ -57,6 +57,21 @@ status_t send_mam_message_res_deserialize(const char* const obj, ta_send_mam_res
  */
 status_t send_mam_message_res_serialize(const ta_send_mam_res_t* const res, char const* const uuid, char** obj);
 
+/**
+ * @brief Serialize the results of a batch of MAM messages to JSON string
+ *
+ * The result of each message is in the same format as `send_mam_message_res_serialize()`, and they are kept in the
+ * order of the messages in the request.
+ *
+ * @param[in] res_array Result of each message in ta_send_mam_res_t
+ * @param[out] obj send mam response object in JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t send_mam_message_batch_res_serialize(UT_array const* const res_array, char** obj);
+
 /**
  * @brief Deserialize request of recv_mam_message
  *
@@ -100,41 +100,60 @@ status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfe
     ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
     return SC_SERIALIZER_NULL;
   }
-  cJSON* json_obj = cJSON_Parse(obj);
-  cJSON* json_result = NULL;
+  json_reader_t reader;
+  char *key = NULL, *address = NULL, *tag = NULL, *message_format = NULL, *message = NULL;
+  size_t address_len = 0, tag_len = 0, msg_len = 0;
   flex_trit_t tag_trits[NUM_TRITS_TAG], address_trits[NUM_TRITS_HASH];
   bool raw_message = true;
-  status_t ret = SC_OK;
-
-  if (json_obj == NULL) {
+  status_t ret = json_reader_init(&reader, obj);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  // 'value' does not exist or invalid, set to 0
+  req->value = 0;
+
+  // Members are located in a single pass and decoded afterwards, since 'message' depends on 'message_format'
+  ret = json_reader_object_begin(&reader);
+  while (ret == SC_OK && (ret = json_reader_object_next(&reader, &key)) == SC_OK && key) {
+    const json_reader_type_t type = json_reader_peek(&reader);
+    if (type == JSON_READER_NUMBER && !strcmp(key, "value")) {
+      ret = json_reader_int(&reader, &req->value);
+    } else if (type == JSON_READER_STRING && !strcmp(key, "address")) {
+      ret = json_reader_string(&reader, &address, &address_len);
+    } else if (type == JSON_READER_STRING && !strcmp(key, "tag")) {
+      ret = json_reader_string(&reader, &tag, &tag_len);
+    } else if (type == JSON_READER_STRING && !strcmp(key, "message_format")) {
+      ret = json_reader_string(&reader, &message_format, NULL);
+    } else if (type == JSON_READER_STRING && !strcmp(key, "message")) {
+      ret = json_reader_string(&reader, &message, &msg_len);
+    } else {
+      ret = json_reader_skip(&reader);
+    }
+  }
+  if (ret == SC_OK) {
+    ret = json_reader_finish(&reader);
+  }
+  if (ret != SC_OK) {
     ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_JSON_PARSE));
+    ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "value");
-  if ((json_result != NULL) && cJSON_IsNumber(json_result)) {
-    req->value = json_result->valueint;
-  } else {
-    // 'value' does not exist or invalid, set to 0
-    req->value = 0;
-  }
-
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "address");
-  if (json_result != NULL && json_result->valuestring != NULL) {
-    int addr_len = strlen(json_result->valuestring);
-    if (!valid_tryte(json_result->valuestring, addr_len)) {
+  if (address != NULL) {
+    if (address_len < NUM_TRYTES_ADDRESS || !trytes_valid(address, address_len)) {
       ret = SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
     }
 
-    flex_trits_from_trytes(address_trits, NUM_TRITS_ADDRESS, (const tryte_t*)json_result->valuestring,
-                           NUM_TRYTES_ADDRESS, NUM_TRYTES_ADDRESS);
+    flex_trits_from_trytes_simd(address_trits, NUM_TRITS_ADDRESS, (const tryte_t*)address, NUM_TRYTES_ADDRESS,
+                                NUM_TRYTES_ADDRESS);
   } else {
     // 'address' does not exists, set to DEFAULT_ADDRESS
-    flex_trits_from_trytes(address_trits, NUM_TRITS_ADDRESS, (const tryte_t*)DEFAULT_ADDRESS, NUM_TRYTES_ADDRESS,
-                           NUM_TRYTES_ADDRESS);
+    flex_trits_from_trytes_simd(address_trits, NUM_TRITS_ADDRESS, (const tryte_t*)DEFAULT_ADDRESS, NUM_TRYTES_ADDRESS,
+                                NUM_TRYTES_ADDRESS);
   }
   ret = hash243_queue_push(&req->address, address_trits);
   if (ret) {
@@ -143,11 +162,8 @@ status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfe
     goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "tag");
-  if (json_result != NULL && json_result->valuestring != NULL) {
-    int tag_len = strlen(json_result->valuestring);
-
-    if (!valid_tryte(json_result->valuestring, tag_len)) {
+  if (tag != NULL) {
+    if (!trytes_valid(tag, tag_len)) {
       ret = SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
       ta_log_error("%s\n", ta_error_to_string(ret));
       goto done;
@@ -157,17 +173,16 @@ status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfe
     if (tag_len < NUM_TRYTES_TAG) {
       char new_tag[NUM_TRYTES_TAG + 1];
       // Fill in '9' to get valid tag (27 trytes)
-      fill_nines(new_tag, json_result->valuestring, NUM_TRYTES_TAG);
+      fill_nines(new_tag, tag, NUM_TRYTES_TAG);
       new_tag[NUM_TRYTES_TAG] = '\0';
-      flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)new_tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+      flex_trits_from_trytes_simd(tag_trits, NUM_TRITS_TAG, (const tryte_t*)new_tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
     } else {
       // Valid tag from request, use it directly
-      flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)json_result->valuestring, NUM_TRYTES_TAG,
-                             NUM_TRYTES_TAG);
+      flex_trits_from_trytes_simd(tag_trits, NUM_TRITS_TAG, (const tryte_t*)tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
     }
   } else {
     // 'tag' does not exists, set to DEFAULT_TAG
-    flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)DEFAULT_TAG, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+    flex_trits_from_trytes_simd(tag_trits, NUM_TRITS_TAG, (const tryte_t*)DEFAULT_TAG, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
   }
   ret = hash81_queue_push(&req->tag, tag_trits);
   if (ret) {
@@ -176,54 +191,44 @@ status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfe
     goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "message_format");
-  if (json_result != NULL) {
-    if (!strncmp("trytes", json_result->valuestring, 6)) {
-      raw_message = false;
-    }
+  if (message_format != NULL && !strncmp("trytes", message_format, 6)) {
+    raw_message = false;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "message");
-  if (json_result != NULL && json_result->valuestring != NULL) {
-    int msg_len = strlen(json_result->valuestring);
-
+  if (message != NULL) {
     // In case the payload is unicode, the character whose ASCII code is beyond 128 result to an
     // error status_t code
-    for (int i = 0; i < msg_len; i++) {
-      if (json_result->valuestring[i] & 0x80) {
+    for (size_t i = 0; i < msg_len; i++) {
+      if (message[i] & 0x80) {
         ret = SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
         ta_log_error("%s\n", ta_error_to_string(ret));
         goto done;
       }
     }
 
+    // A raw message takes 2 trytes per character
+    if ((raw_message ? msg_len * 2 : msg_len) > NUM_TRYTES_MESSAGE) {
+      ret = SC_SERIALIZER_MESSAGE_OVERRUN;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
     if (raw_message) {
       req->msg_len = msg_len * 2;
-      if (req->msg_len > NUM_TRYTES_MESSAGE) {
-        ret = SC_SERIALIZER_MESSAGE_OVERRUN;
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
-
-      ascii_to_trytes(json_result->valuestring, req->message);
+      ascii_to_trytes(message, req->message);
     } else {
       req->msg_len = msg_len;
-      if (req->msg_len > NUM_TRYTES_MESSAGE) {
-        ret = SC_SERIALIZER_MESSAGE_OVERRUN;
-        ta_log_error("%s\n", ta_error_to_string(ret));
-        goto done;
-      }
-      memcpy(req->message, json_result->valuestring, req->msg_len);
+      memcpy(req->message, message, req->msg_len);
     }
 
   } else {
     // 'message' does not exists, set to DEFAULT_MSG
     req->msg_len = DEFAULT_MSG_LEN * 3;
-    flex_trits_from_trytes(req->message, req->msg_len, (const tryte_t*)DEFAULT_MSG, DEFAULT_MSG_LEN, DEFAULT_MSG_LEN);
+    flex_trits_from_trytes_simd(req->message, req->msg_len, (const tryte_t*)DEFAULT_MSG, DEFAULT_MSG_LEN,
+                                DEFAULT_MSG_LEN);
   }
 
 done:
-  cJSON_Delete(json_obj);
+  json_reader_destroy(&reader);
   return ret;
 }
 
@@ -232,22 +237,67 @@ status_t ta_send_trytes_req_deserialize(const char* const obj, hash8019_array_p
     ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
     return SC_SERIALIZER_NULL;
   }
-  status_t ret = SC_OK;
-  cJSON* json_obj = cJSON_Parse(obj);
+  json_reader_t reader;
+  flex_trit_t hash[FLEX_TRIT_SIZE_8019] = {};
+  char *key = NULL, *trytes = NULL;
+  size_t trytes_len = 0;
+  bool found = false, more = false;
+  status_t ret = json_reader_init(&reader, obj);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
 
-  if (json_obj == NULL) {
+  // Each transaction is validated and converted into flex_trits as soon as it is read
+  ret = json_reader_object_begin(&reader);
+  while (ret == SC_OK && (ret = json_reader_object_next(&reader, &key)) == SC_OK && key) {
+    if (found || strcmp(key, "trytes") || json_reader_peek(&reader) != JSON_READER_ARRAY) {
+      ret = json_reader_skip(&reader);
+      continue;
+    }
+
+    found = true;
+    ret = json_reader_array_begin(&reader);
+    while (ret == SC_OK && (ret = json_reader_array_next(&reader, &more)) == SC_OK && more) {
+      if (json_reader_peek(&reader) != JSON_READER_STRING) {
+        ret = json_reader_skip(&reader);
+        continue;
+      }
+      ret = json_reader_string(&reader, &trytes, &trytes_len);
+      if (ret != SC_OK) {
+        break;
+      }
+      if (trytes_len != NUM_TRYTES_SERIALIZED_TRANSACTION) {
+        ret = SC_SERIALIZER_INVALID_REQ;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      if (!trytes_valid(trytes, trytes_len)) {
+        ret = SC_SERIALIZER_JSON_PARSE_NOT_TRYTE;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      flex_trits_from_trytes_simd(hash, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t const*)trytes,
+                                  NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+      hash_array_push(out_trytes, hash);
+    }
+  }
+  if (ret == SC_OK) {
+    ret = json_reader_finish(&reader);
+  }
+  if (ret != SC_OK) {
     ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
     goto done;
   }
 
-  ret = ta_json_array_to_hash8019_array(json_obj, "trytes", out_trytes);
-  if (ret != SC_OK) {
-    goto done;
+  if (!found) {
+    ret = SC_CCLIENT_JSON_PARSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
   }
 
 done:
-  cJSON_Delete(json_obj);
+  json_reader_destroy(&reader);
   return ret;
 }
 
@@ -299,51 +349,91 @@ status_t ta_find_transaction_objects_req_deserialize(const char* const obj,
   return ret;
 }
 
-status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* res, char** obj) {
-  status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateObject();
-  if (json_root == NULL) {
-    ta_log_error("%s\n", ta_error_to_string(SC_CCLIENT_JSON_CREATE));
-    return SC_CCLIENT_JSON_CREATE;
+status_t ta_transaction_object_serialize(iota_transaction_t const* const txn, char** obj) {
+  json_writer_t writer;
+  status_t ret = json_writer_init(&writer, TXN_JSON_MAX_SIZE);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
   }
 
-  ret = ta_iota_transaction_to_json_object(transaction_array_at(res, 0), &json_root);
+  json_writer_object_begin(&writer);
+  ret = ta_iota_transaction_to_json_writer(txn, &writer);
   if (ret != SC_OK) {
-    goto done;
+    json_writer_destroy(&writer);
+    return ret;
   }
+  json_writer_object_end(&writer);
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
+  ret = json_writer_finish(&writer, obj);
+  if (ret != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
+  return ret;
+}
 
-done:
-  cJSON_Delete(json_root);
+status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* res, char** obj) {
+  return ta_transaction_object_serialize(transaction_array_at(res, 0), obj);
+}
+
+status_t ta_transaction_fragments_serialize(char* const* const fragments, const size_t num, char** obj) {
+  json_writer_t writer;
+  size_t capacity = 2;
+  if (fragments == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+
+  for (size_t i = 0; i < num; i++) {
+    if (fragments[i] == NULL) {
+      ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+      return SC_SERIALIZER_NULL;
+    }
+    capacity += strlen(fragments[i]) + 1;
+  }
+  status_t ret = json_writer_init(&writer, capacity);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  json_writer_array_begin(&writer);
+  for (size_t i = 0; i < num; i++) {
+    json_writer_raw(&writer, fragments[i], strlen(fragments[i]));
+  }
+  json_writer_array_end(&writer);
+
+  ret = json_writer_finish(&writer, obj);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
   return ret;
 }
 
 status_t ta_find_transaction_objects_res_serialize(const transaction_array_t* const res, char** obj) {
-  status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateArray();
-  if (json_root == NULL) {
-    ta_log_error("%s\n", ta_error_to_string(SC_CCLIENT_JSON_CREATE));
-    return SC_CCLIENT_JSON_CREATE;
+  json_writer_t writer;
+  if (res == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
   }
 
-  ret = ta_transaction_array_to_json_array(res, json_root);
+  // The whole response is written into a single buffer allocated here
+  status_t ret = json_writer_init(&writer, transaction_array_len((transaction_array_t*)res) * TXN_JSON_MAX_SIZE + 2);
   if (ret != SC_OK) {
-    goto done;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
   }
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", ta_error_to_string(ret));
+  ret = ta_transaction_array_to_json_writer(res, &writer);
+  if (ret != SC_OK) {
+    json_writer_destroy(&writer);
+    return ret;
   }
 
-done:
-  cJSON_Delete(json_root);
+  ret = json_writer_finish(&writer, obj);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
   return ret;
 }
 
@@ -380,37 +470,39 @@ done:
 }
 
 status_t ta_send_transfer_res_serialize(ta_send_transfer_res_t* res, char** obj) {
-  status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateObject();
-  if (json_root == NULL) {
-    ret = SC_SERIALIZER_JSON_CREATE;
+  json_writer_t writer;
+  status_t ret = json_writer_init(&writer, TXN_JSON_MAX_SIZE);
+  if (ret != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
+    return ret;
   }
 
+  json_writer_object_begin(&writer);
   if (res->uuid) {
-    cJSON_AddStringToObject(json_root, "uuid", res->uuid);
-    cJSON_AddStringToObject(json_root, "address", (char*)res->address);
+    json_writer_key(&writer, "uuid");
+    json_writer_string(&writer, res->uuid);
+    if (res->address) {
+      json_writer_key(&writer, "address");
+      json_writer_string(&writer, (char*)res->address);
+    }
   } else {
-    ret = ta_iota_transaction_to_json_object(transaction_array_at(res->txn_array, 0), &json_root);
+    ret = ta_iota_transaction_to_json_writer(transaction_array_at(res->txn_array, 0), &writer);
     if (ret != SC_OK) {
       ta_log_error("%s\n", error_2_string(ret));
-      goto done;
+      json_writer_destroy(&writer);
+      return ret;
     }
 #ifdef DB_ENABLE
-    cJSON_AddStringToObject(json_root, "id", res->uuid_string);
+    json_writer_key(&writer, "id");
+    json_writer_string(&writer, res->uuid_string);
 #endif
   }
+  json_writer_object_end(&writer);
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
+  ret = json_writer_finish(&writer, obj);
+  if (ret != SC_OK) {
     ta_log_error("%s\n", ta_error_to_string(ret));
-    goto done;
   }
-
-done:
-  cJSON_Delete(json_root);
   return ret;
 }
 
@@ -482,6 +574,30 @@ status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
 
+done:
+  cJSON_Delete(json_obj);
+  return ret;
+}
+
+status_t mqtt_chid_req_deserialize(const char* const obj, char* chid) {
+  if (obj == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_SERIALIZER_NULL));
+    return SC_SERIALIZER_NULL;
+  }
+  status_t ret = SC_OK;
+  cJSON* json_obj = cJSON_Parse(obj);
+
+  if (json_obj == NULL) {
+    ret = SC_SERIALIZER_JSON_PARSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = ta_json_get_string(json_obj, "chid", chid, NUM_TRYTES_ADDRESS + 1);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
 done:
   cJSON_Delete(json_obj);
   return ret;
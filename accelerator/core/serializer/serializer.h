@@ -14,6 +14,7 @@
 #include "accelerator/core/response/response.h"
 #include "cJSON.h"
 #include "common/trinary/tryte_ascii.h"
+#include "ser_cbor.h"
 #include "ser_mam.h"
 #include "utils/fill_nines.h"
 
@@ -26,6 +27,12 @@ extern "C" {
  * @example unit-test/test_serializer.c
  */
 
+/** Format of a response */
+typedef enum ta_res_format_e {
+  TA_RES_JSON = 0, /**< JSON with fields in trytes */
+  TA_RES_CBOR,     /**< CBOR with fields in packed trits */
+} ta_res_format_t;
+
 /** @name Default input fields */
 /** @{ */
 /**
@@ -136,6 +143,33 @@ status_t ta_send_trytes_req_deserialize(const char* const obj, hash8019_array_p
  */
 status_t ta_send_trytes_res_serialize(const hash8019_array_p trytes, char** obj);
 
+/**
+ * @brief Serialize a transaction object into JSON
+ *
+ * The result is also the fragment of the transaction cached by `utils/cache/fragment.h`.
+ *
+ * @param[in] txn Transaction object
+ * @param[out] obj Result of serialization in JSON format.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_object_serialize(iota_transaction_t const* const txn, char** obj);
+
+/**
+ * @brief Assemble pre-serialized transaction objects into a JSON array
+ *
+ * @param[in] fragments Transaction objects in JSON, which are written as they are
+ * @param[in] num Number of fragments
+ * @param[out] obj Result of serialization in JSON format.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_fragments_serialize(char* const* const fragments, const size_t num, char** obj);
+
 /**
  * @brief Serialize response of api_transaction_object_single into JSON
  *
@@ -221,6 +255,18 @@ status_t mqtt_tag_req_deserialize(const char* const obj, char* tag);
  * - non-zero on error
  */
 status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash);
+
+/**
+ * @brief Deserialize MAM Channel ID in string from MQTT JSON request.
+ *
+ * @param[in] obj Input request in JSON with chid field
+ * @param[out] chid Channel ID in string
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mqtt_chid_req_deserialize(const char* const obj, char* chid);
 #endif
 
 /**
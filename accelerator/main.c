@@ -54,6 +54,13 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  // Buffered MAM requests are sent right away by the MAM sender if it is enabled, instead of in health tracking
+  if (ta_core.iota_conf.mam_send_workers > 0 &&
+      mam_sender_init(&ta_core, ta_core.iota_conf.mam_send_workers) != SC_OK) {
+    ta_log_error("Starting MAM sender failed %s.\n", MAIN_LOGGER);
+    return EXIT_FAILURE;
+  }
+
   pthread_t health_thread;
   pthread_create(&health_thread, NULL, health_track, (void*)&ta_core);
 
@@ -89,6 +96,7 @@ int main(int argc, char* argv[]) {
 
 cleanup:
   log_info(logger_id, "Destroying TA configurations\n");
+  mam_sender_destroy();
   ta_logger_switch(true, false, &(ta_core.ta_conf));
   ta_core_destroy(&ta_core);
   logger_helper_release(logger_id);
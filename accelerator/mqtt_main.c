@@ -3,6 +3,7 @@
 #include "config.h"
 #include "connectivity/mqtt/duplex_callback.h"
 #include "connectivity/mqtt/duplex_utils.h"
+#include "connectivity/mqtt/mam_push.h"
 #include "connectivity/mqtt/mqtt_common.h"
 
 #define CONN_MQTT_LOGGER "conn-mqtt"
@@ -67,6 +68,11 @@ int main(int argc, char *argv[]) {
     goto done;
   }
 
+  // Publish new messages of the MAM channels subscribed through `mam/subscribe`. Other APIs are served without it.
+  if (mqtt_mam_push_start(&ta_core, &cfg) != SC_OK) {
+    ta_log_warning("%s\n", "Failed to start publishing MAM channels, which cannot be subscribed.");
+  }
+
   // Set cfg as `userdata` field of `mosq` which allows the callback functions to use `cfg`.
   mosquitto_user_data_set(mosq, &cfg);
 
@@ -81,6 +87,7 @@ int main(int argc, char *argv[]) {
   } while (!ret);
 
 done:
+  mqtt_mam_push_stop();
   mosquitto_destroy(mosq);
   mosquitto_lib_cleanup();
   mosq_config_free(&cfg);
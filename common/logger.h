@@ -151,6 +151,40 @@ void mqtt_sub_logger_init();
  * - EXIT_FAILURE on error
  */
 int mqtt_sub_logger_release();
+
+/**
+ * @brief Initialize MQTT MAM push logger
+ *
+ * This function is implemented in connectivity/mqtt/mam_push.c
+ */
+void mqtt_mam_push_logger_init();
+/**
+ * @brief Release MQTT MAM push logger
+ *
+ * This function is implemented in connectivity/mqtt/mam_push.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int mqtt_mam_push_logger_release();
+
+/**
+ * @brief Initialize MAM watcher logger
+ *
+ * This function is implemented in accelerator/core/mam_watcher.c
+ */
+void mw_logger_init();
+/**
+ * @brief Release MAM watcher logger
+ *
+ * This function is implemented in accelerator/core/mam_watcher.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int mw_logger_release();
 #else
 /**
  * @brief Initialize http logger
@@ -294,6 +328,114 @@ void br_logger_init();
  */
 int br_logger_release();
 
+/**
+ * @brief Initialize cache eviction logger
+ *
+ * This function is implemented in utils/cache/eviction.c
+ */
+void ce_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in utils/cache/eviction.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int ce_logger_release();
+
+/**
+ * @brief Initialize spool logger
+ *
+ * This function is implemented in utils/spool.c
+ */
+void sp_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in utils/spool.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int sp_logger_release();
+
+/**
+ * @brief Initialize cache dedup logger
+ *
+ * This function is implemented in utils/cache/dedup.c
+ */
+void cd_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in utils/cache/dedup.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int cd_logger_release();
+
+/**
+ * @brief Initialize MAM state manager logger
+ *
+ * This function is implemented in accelerator/core/mam_state.c
+ */
+void ms_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in accelerator/core/mam_state.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int ms_logger_release();
+
+/**
+ * @brief Initialize MSS cache logger
+ *
+ * This function is implemented in accelerator/core/mss_cache.c
+ */
+void mss_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in accelerator/core/mss_cache.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int mss_logger_release();
+
+/**
+ * @brief Initialize MAM sender logger
+ *
+ * This function is implemented in accelerator/core/mam_sender.c
+ */
+void mam_sender_logger_init();
+
+/**
+ * @brief Release logger
+ *
+ * This function is implemented in accelerator/core/mam_sender.c
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int mam_sender_logger_release();
+
 /**
  * Initialize logger for ECDH
  */
@@ -94,6 +94,10 @@ const char* ta_error_to_string(status_t err) {
       return "Failed to add trusted channel ID or endpoint ID";
     case SC_MAM_EXCEEDED_CHID_ITER:
       return "Too much iteration for finding a starting chid";
+    case SC_MAM_WATCH_LIMIT:
+      return "Too many MAM channels watched";
+    case SC_MAM_INVALID_CLIENT_ID:
+      return "Malformed ID of the client watching MAM channels";
 
     // Configuration
     case SC_CONF_MISSING_ARGUMENT:
@@ -136,6 +140,16 @@ const char* ta_error_to_string(status_t err) {
       return "Overflow error";
     case SC_UTILS_CIPHER_ERROR:
       return "Error occurred when encrypting or descrypting message";
+    case SC_UTILS_BLOB_MALFORMED:
+      return "Malformed or unsupported version of buffered bundle blob";
+    case SC_UTILS_TRIT_PACK_INVALID:
+      return "Packed trits out of valid range";
+    case SC_UTILS_SPOOL_IO_ERROR:
+      return "Failed to access local spool";
+    case SC_UTILS_SPOOL_EMPTY:
+      return "No request left in local spool";
+    case SC_UTILS_CBOR_MALFORMED:
+      return "Malformed or unsupported CBOR data";
 
     // Connection HTTP
     case SC_HTTP_INVALID_REGEX:
@@ -146,6 +160,8 @@ const char* ta_error_to_string(status_t err) {
       return "URL parameter parsing error.";
     case SC_HTTP_COMMAND_NOT_MATCH:
       return "Proxy API command hash does not match.";
+    case SC_HTTP_COMPRESS_ERROR:
+      return "Failed to compress HTTP response.";
 
     // Connection MQTT
     case SC_MQTT_INIT:
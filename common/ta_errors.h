@@ -159,6 +159,10 @@ typedef enum {
   /**< Failed to add trusted channel ID or endpoint ID */
   SC_MAM_EXCEEDED_CHID_ITER = 0x0D | SC_MODULE_MAM | SC_SEVERITY_FATAL,
   /**< Too much iteration for finding a starting chid */
+  SC_MAM_WATCH_LIMIT = 0x0E | SC_MODULE_MAM | SC_SEVERITY_FATAL,
+  /**< Too many MAM channels watched */
+  SC_MAM_INVALID_CLIENT_ID = 0x0F | SC_MODULE_MAM | SC_SEVERITY_FATAL,
+  /**< Malformed ID of the client watching MAM channels */
 
   // configuration module
   SC_CONF_MISSING_ARGUMENT = 0x01 | SC_MODULE_CONF | SC_SEVERITY_FATAL,
@@ -201,6 +205,16 @@ typedef enum {
   /**< Overflow error */
   SC_UTILS_CIPHER_ERROR = 0x0D | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
   /**< Error occurred when encrypting or descrypting message */
+  SC_UTILS_BLOB_MALFORMED = 0x0E | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Malformed or unsupported version of buffered bundle blob */
+  SC_UTILS_TRIT_PACK_INVALID = 0x0F | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Packed trits out of valid range */
+  SC_UTILS_SPOOL_IO_ERROR = 0x10 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Failed to access local spool */
+  SC_UTILS_SPOOL_EMPTY = 0x11 | SC_MODULE_UTILS | SC_SEVERITY_MINOR,
+  /**< No request left in local spool */
+  SC_UTILS_CBOR_MALFORMED = 0x12 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Malformed or unsupported CBOR data */
 
   // HTTP module
   SC_HTTP_INVALID_REGEX = 0x01 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
@@ -211,6 +225,8 @@ typedef enum {
   /**< Proxy API command not match */
   SC_HTTP_COMMAND_NOT_MATCH = 0x04 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
   /**< URL parameter parsing error */
+  SC_HTTP_COMPRESS_ERROR = 0x05 | SC_MODULE_HTTP | SC_SEVERITY_MINOR,
+  /**< Failed to compress HTTP response */
 
   // MQTT module
   SC_MQTT_INIT = 0x01 | SC_MODULE_MQTT | SC_SEVERITY_MAJOR,
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "compress.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <zlib.h>
+#include "brotli/encode.h"
+#include "utils/buffer_pool.h"
+
+#define GZIP_WINDOW_BITS (15 + 16) /**< The largest window, plus 16 for a gzip header and trailer */
+#define GZIP_MEM_LEVEL 8           /**< Default memory level of zlib */
+
+typedef struct gzip_context_s {
+  z_stream stream;
+  int level; /**< Level of the initialized stream, or 0 if it is not initialized */
+} gzip_context_t;
+
+static pthread_key_t gzip_key;
+static pthread_once_t gzip_key_once = PTHREAD_ONCE_INIT;
+
+static void gzip_context_destroy(void* arg) {
+  gzip_context_t* ctx = (gzip_context_t*)arg;
+  if (ctx->level) {
+    deflateEnd(&ctx->stream);
+  }
+  free(ctx);
+}
+
+static void gzip_key_init() { pthread_key_create(&gzip_key, gzip_context_destroy); }
+
+/**
+ * @brief Get the zlib stream of the current thread, which is ready for a new response
+ */
+static z_stream* gzip_stream(const int level) {
+  pthread_once(&gzip_key_once, gzip_key_init);
+  gzip_context_t* ctx = (gzip_context_t*)pthread_getspecific(gzip_key);
+  if (ctx == NULL) {
+    ctx = (gzip_context_t*)calloc(1, sizeof(gzip_context_t));
+    if (ctx == NULL) {
+      return NULL;
+    }
+    if (pthread_setspecific(gzip_key, ctx) != 0) {
+      free(ctx);
+      return NULL;
+    }
+  }
+
+  if (ctx->level == level) {
+    return (deflateReset(&ctx->stream) == Z_OK) ? &ctx->stream : NULL;
+  }
+  if (ctx->level) {
+    deflateEnd(&ctx->stream);
+    ctx->level = 0;
+  }
+  memset(&ctx->stream, 0, sizeof(z_stream));
+  if (deflateInit2(&ctx->stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return NULL;
+  }
+  ctx->level = level;
+  return &ctx->stream;
+}
+
+static status_t gzip_compress(const int level, char const* const in, const size_t in_len, char** out,
+                              size_t* out_len) {
+  z_stream* stream = gzip_stream(level);
+  if (stream == NULL || in_len > UINT_MAX) {
+    return SC_HTTP_COMPRESS_ERROR;
+  }
+
+  size_t capacity = deflateBound(stream, in_len);
+  uint8_t* buf = (uint8_t*)buffer_pool_alloc(capacity, &capacity);
+  if (buf == NULL) {
+    return SC_OOM;
+  }
+  stream->next_in = (Bytef*)in;
+  stream->avail_in = (uInt)in_len;
+  stream->next_out = buf;
+  stream->avail_out = (capacity > UINT_MAX) ? UINT_MAX : (uInt)capacity;
+  if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+    buffer_pool_release(buf);
+    return SC_HTTP_COMPRESS_ERROR;
+  }
+
+  *out = (char*)buf;
+  *out_len = stream->total_out;
+  return SC_OK;
+}
+
+static status_t br_compress(const int level, char const* const in, const size_t in_len, char** out, size_t* out_len) {
+  size_t capacity = BrotliEncoderMaxCompressedSize(in_len);
+  if (capacity == 0) {
+    return SC_HTTP_COMPRESS_ERROR;
+  }
+  uint8_t* buf = (uint8_t*)buffer_pool_alloc(capacity, &capacity);
+  if (buf == NULL) {
+    return SC_OOM;
+  }
+
+  size_t encoded_len = capacity;
+  if (!BrotliEncoderCompress(level, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, in_len, (const uint8_t*)in, &encoded_len,
+                             buf)) {
+    buffer_pool_release(buf);
+    return SC_HTTP_COMPRESS_ERROR;
+  }
+
+  *out = (char*)buf;
+  *out_len = encoded_len;
+  return SC_OK;
+}
+
+double http_header_quality(char const* const header, char const* const token) {
+  // A negative quality value means the token is not listed
+  double quality = -1;
+  if (header == NULL || token == NULL) {
+    return quality;
+  }
+
+  const size_t token_len = strlen(token);
+  char const* p = header;
+  while (*p) {
+    while (*p == ' ' || *p == '\t' || *p == ',') {
+      p++;
+    }
+    char const* name = p;
+    while (*p && *p != ',' && *p != ';' && *p != ' ' && *p != '\t') {
+      p++;
+    }
+    const size_t name_len = p - name;
+
+    double q = 1;
+    while (*p && *p != ',') {
+      if (*p++ != ';') {
+        continue;
+      }
+      while (*p == ' ' || *p == '\t') {
+        p++;
+      }
+      if ((*p == 'q' || *p == 'Q') && p[1] == '=') {
+        q = strtod(p + 2, NULL);
+      }
+    }
+
+    if (name_len == token_len && !strncasecmp(name, token, name_len)) {
+      quality = q;
+    }
+  }
+  return quality;
+}
+
+http_encoding_t http_accept_encoding(char const* const accept_encoding) {
+  if (accept_encoding == NULL) {
+    return HTTP_ENCODING_IDENTITY;
+  }
+
+  const double q_any = http_header_quality(accept_encoding, "*");
+  double q_gzip = http_header_quality(accept_encoding, "gzip");
+  double q_br = http_header_quality(accept_encoding, "br");
+  q_gzip = (q_gzip < 0) ? q_any : q_gzip;
+  q_br = (q_br < 0) ? q_any : q_br;
+  if (q_br > 0 && q_br >= q_gzip) {
+    return HTTP_ENCODING_BR;
+  } else if (q_gzip > 0) {
+    return HTTP_ENCODING_GZIP;
+  }
+  return HTTP_ENCODING_IDENTITY;
+}
+
+char const* http_encoding_name(const http_encoding_t encoding) {
+  switch (encoding) {
+    case HTTP_ENCODING_GZIP:
+      return "gzip";
+    case HTTP_ENCODING_BR:
+      return "br";
+    default:
+      return NULL;
+  }
+}
+
+status_t http_compress(const http_encoding_t encoding, const int level, char const* const in, const size_t in_len,
+                       char** out, size_t* out_len) {
+  if (in == NULL || out == NULL || out_len == NULL) {
+    return SC_NULL;
+  }
+  if (level < 1 || level > Z_BEST_COMPRESSION) {
+    return SC_HTTP_COMPRESS_ERROR;
+  }
+
+  switch (encoding) {
+    case HTTP_ENCODING_GZIP:
+      return gzip_compress(level, in, in_len, out, out_len);
+    case HTTP_ENCODING_BR:
+      return br_compress(level, in, in_len, out, out_len);
+    default:
+      return SC_HTTP_COMPRESS_ERROR;
+  }
+}
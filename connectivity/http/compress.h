@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef HTTP_COMPRESS_H_
+#define HTTP_COMPRESS_H_
+
+#include <stddef.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file connectivity/http/compress.h
+ * @brief Compression of HTTP responses negotiated with Accept-Encoding
+ *
+ * Responses are mostly trytes, which are compressed to about 40% of their size. gzip is done with a zlib stream kept
+ * by each thread and reset for every response. Brotli is done in one shot, since its encoder can not be reset.
+ */
+
+/** Content codings of responses */
+typedef enum http_encoding_e {
+  HTTP_ENCODING_IDENTITY = 0, /**< Not compressed */
+  HTTP_ENCODING_GZIP,         /**< gzip */
+  HTTP_ENCODING_BR,           /**< Brotli */
+} http_encoding_t;
+
+/**
+ * @brief Quality value of a token in a header listing tokens with quality values, such as Accept or Accept-Encoding
+ *
+ * Tokens are compared case-insensitively. Wildcards are not expanded, so they are looked up as tokens by the caller.
+ *
+ * @param[in] header Value of the header
+ * @param[in] token Content coding or media type to look up
+ *
+ * @return The quality value of the token, which is 1 without `q=`, or a negative value if the token is not listed
+ */
+double http_header_quality(char const* const header, char const* const token);
+
+/**
+ * @brief Choose the content coding from the value of Accept-Encoding
+ *
+ * Brotli is preferred to gzip unless gzip has a higher quality value. Codings with `q=0` are never chosen.
+ *
+ * @param[in] accept_encoding Value of Accept-Encoding
+ *
+ * @return The chosen content coding
+ */
+http_encoding_t http_accept_encoding(char const* const accept_encoding);
+
+/**
+ * @brief Name of a content coding used in Content-Encoding
+ *
+ * @param[in] encoding Content coding
+ *
+ * @return Name of the content coding, or NULL for the identity
+ */
+char const* http_encoding_name(const http_encoding_t encoding);
+
+/**
+ * @brief Compress a response body
+ *
+ * @param[in] encoding Content coding other than the identity
+ * @param[in] level Compression level from 1 to 9, which is the range of zlib. It is the quality of Brotli as well.
+ * @param[in] in Response body
+ * @param[in] in_len Length of the response body
+ * @param[out] out Compressed body, which is taken from `utils/buffer_pool.h`
+ * @param[out] out_len Length of the compressed body
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t http_compress(const http_encoding_t encoding, const int level, char const* const in, const size_t in_len,
+                       char** out, size_t* out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HTTP_COMPRESS_H_
@@ -1,26 +1,47 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <microhttpd.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#include "compress.h"
 #include "connectivity/common.h"
 #include "http.h"
+#include "utils/buffer_pool.h"
 #include "utils/macros.h"
 
 #define HTTP_LOGGER "http"
-#define MAX_REQUEST_LEN 65536
+#define HTTP_BULK_PATH "/transaction/object/bulk[/]?"
+#define HTTP_BULK_BLOCK_SIZE (32 * 1024) /**< Size of the blocks in which a bulk response is sent */
 
 static logger_id_t logger_id;
 
 typedef struct ta_http_request_s {
   bool valid_content_type;
+  ta_res_format_t answer_format; /**< Format asked by the Accept header, and then the format of answer_string */
   char *answer_string;
+  size_t answer_len;               /**< Length of answer_string in CBOR, which is not NUL-terminated */
+  http_encoding_t answer_encoding; /**< Content coding chosen from the Accept-Encoding header */
   uint32_t answer_code;
   char *request;
   size_t request_len;
+  size_t request_capacity; /**< Allocated size of request */
+  size_t content_len;      /**< Value of the Content-Length header, or 0 if it is absent */
+  bool bulk;               /**< Transaction objects are streamed in newline-delimited JSON */
 } ta_http_request_t;
 
+/** Transaction objects of a bulk request which are being streamed */
+typedef struct ta_http_bulk_s {
+  iota_client_service_t iota_service;
+  ta_find_transaction_objects_req_t *req; /**< Hashes which are not streamed yet */
+  char *lines;                            /**< Transaction objects of the current batch */
+  size_t lines_len;                       /**< Length of lines */
+  size_t offset;                          /**< Bytes of lines which are sent */
+  bool failed;                            /**< The stream ends with an error message */
+} ta_http_bulk_t;
+
 void http_logger_init() { logger_id = logger_helper_enable(HTTP_LOGGER, LOGGER_DEBUG, true); }
 
 int http_logger_release() {
@@ -66,16 +87,27 @@ static status_t ta_get_url_parameter(char const *const url, int index, char **pa
   return SC_OK;
 }
 
+/*
+ * Error messages are always in JSON, so the format falls back to JSON on error
+ */
+static inline int set_formatted_response_content(status_t ret, ta_res_format_t *const format, char **const out) {
+  if (ret != SC_OK) {
+    *format = TA_RES_JSON;
+  }
+  return set_response_content(ret, out);
+}
+
 static inline int process_find_txns_obj_by_tag_request(iota_client_service_t *const iota_service, char const *const url,
-                                                       char **const out) {
+                                                       ta_res_format_t *const format, char **const out,
+                                                       size_t *const out_len) {
   status_t ret;
   char *tag = NULL;
   ret = ta_get_url_parameter(url, 1, &tag);
   if (ret == SC_OK) {
-    ret = api_find_transactions_obj_by_tag(iota_service, tag, out);
+    ret = api_find_transactions_obj_by_tag(iota_service, tag, *format, out, out_len);
   }
   free(tag);
-  return set_response_content(ret, out);
+  return set_formatted_response_content(ret, format, out);
 }
 
 static inline int process_find_txns_by_tag_request(iota_client_service_t *const iota_service, char const *const url,
@@ -103,22 +135,24 @@ static inline int process_fetch_buffered_request_status(ta_http_t *const http, c
 }
 
 static inline int process_find_txn_obj_single_request(iota_client_service_t *const iota_service, char const *const url,
-                                                      char **const out) {
+                                                      ta_res_format_t *const format, char **const out,
+                                                      size_t *const out_len) {
   status_t ret;
   char *hash = NULL;
   ret = ta_get_url_parameter(url, 1, &hash);
   if (ret == SC_OK) {
-    ret = api_find_transaction_object_single(iota_service, hash, out);
+    ret = api_find_transaction_object_single(iota_service, hash, *format, out, out_len);
   }
   free(hash);
-  return set_response_content(ret, out);
+  return set_formatted_response_content(ret, format, out);
 }
 
 static inline int process_find_txn_obj_request(iota_client_service_t *const iota_service, char const *const payload,
-                                               char **const out) {
+                                               ta_res_format_t *const format, char **const out,
+                                               size_t *const out_len) {
   status_t ret;
-  ret = api_find_transaction_objects(iota_service, payload, out);
-  return set_response_content(ret, out);
+  ret = api_find_transaction_objects(iota_service, payload, *format, out, out_len);
+  return set_formatted_response_content(ret, format, out);
 }
 
 static inline int process_send_transfer_request(ta_http_t *const http, iota_client_service_t *const iota_service,
@@ -129,10 +163,11 @@ static inline int process_send_transfer_request(ta_http_t *const http, iota_clie
 }
 
 static inline int process_recv_mam_msg_request(ta_http_t *const http, iota_client_service_t *const iota_service,
-                                               char const *const payload, char **const out) {
+                                               char const *const payload, ta_res_format_t *const format,
+                                               char **const out, size_t *const out_len) {
   status_t ret;
-  ret = api_recv_mam_message(&http->core->iota_conf, iota_service, payload, out);
-  return set_response_content(ret, out);
+  ret = api_recv_mam_message(&http->core->iota_conf, iota_service, payload, *format, out, out_len);
+  return set_formatted_response_content(ret, format, out);
 }
 
 static inline int process_get_node_status(iota_client_service_t *const iota_service, char **const out) {
@@ -231,19 +266,27 @@ static inline int process_options_request(char **const out) {
   return MHD_HTTP_OK;
 }
 
+/*
+ * `format` is the format asked by the client on input. Only the routes of transaction objects and MAM messages answer
+ * in CBOR, so it is set to the format of `out` on output.
+ */
 static int ta_http_process_request(ta_http_t *const http, iota_client_service_t *const iota_service,
-                                   char const *const url, char const *const payload, char **const out, int options) {
+                                   char const *const url, char const *const payload, ta_res_format_t *const format,
+                                   char **const out, size_t *const out_len, int options) {
+  const ta_res_format_t accept = *format;
+  *format = TA_RES_JSON;
   if (options) {
     return process_options_request(out);
   }
 
-  if (api_path_matcher(url, "/mam/(recv|send)[/]?") == SC_OK) {
+  if (api_path_matcher(url, "/mam/(recv|send|send/batch)[/]?") == SC_OK) {
     if (payload == NULL) {
       return process_method_not_allowed_request(out);
     }
 
     if (api_path_matcher(url, ".*/recv.*") == SC_OK) {
-      return process_recv_mam_msg_request(http, iota_service, payload, out);
+      *format = accept;
+      return process_recv_mam_msg_request(http, iota_service, payload, format, out, out_len);
     } else {
       return process_send_mam_msg_request(http, payload, out);
     }
@@ -252,17 +295,23 @@ static int ta_http_process_request(ta_http_t *const http, iota_client_service_t
              SC_OK) {
     return process_fetch_buffered_request_status(http, url, out);
   } else if (api_path_matcher(url, "/transaction/[A-Z9]{81}[/]?") == SC_OK) {
-    return process_find_txn_obj_single_request(iota_service, url, out);
+    *format = accept;
+    return process_find_txn_obj_single_request(iota_service, url, format, out, out_len);
+  } else if (api_path_matcher(url, HTTP_BULK_PATH) == SC_OK) {
+    // POST requests are streamed by ta_http_bulk_response()
+    return process_method_not_allowed_request(out);
   } else if (api_path_matcher(url, "/transaction/object[/]?") == SC_OK) {
     if (payload != NULL) {
-      return process_find_txn_obj_request(iota_service, payload, out);
+      *format = accept;
+      return process_find_txn_obj_request(iota_service, payload, format, out, out_len);
     }
     return process_method_not_allowed_request(out);
 
   } else if (api_path_matcher(url, "/tag/[A-Z9]{1,27}/hashes[/]?") == SC_OK) {
     return process_find_txns_by_tag_request(iota_service, url, out);
   } else if (api_path_matcher(url, "/tag/[A-Z9]{1,27}[/]?") == SC_OK) {
-    return process_find_txns_obj_by_tag_request(iota_service, url, out);
+    *format = accept;
+    return process_find_txns_obj_by_tag_request(iota_service, url, format, out, out_len);
   } else if (api_path_matcher(url, "/status[/]?") == SC_OK) {
     return process_get_node_status(iota_service, out);
   }
@@ -299,6 +348,24 @@ static int ta_http_process_request(ta_http_t *const http, iota_client_service_t
   return MHD_HTTP_OK;
 }
 
+/**
+ * @brief Choose the format of the answer from the value of Accept
+ *
+ * CBOR is chosen only if it is listed explicitly with a quality value no lower than JSON. JSON also matches the
+ * `application` and the any media ranges, so clients accepting anything are still answered in JSON.
+ */
+static ta_res_format_t ta_http_accept_format(char const *const accept) {
+  const double q_cbor = http_header_quality(accept, "application/cbor");
+  double q_json = http_header_quality(accept, "application/json");
+  if (q_json < 0) {
+    q_json = http_header_quality(accept, "application/*");
+  }
+  if (q_json < 0) {
+    q_json = http_header_quality(accept, "*/*");
+  }
+  return (q_cbor > 0 && q_cbor >= q_json) ? TA_RES_CBOR : TA_RES_JSON;
+}
+
 static int ta_http_header_iter(void *cls, enum MHD_ValueKind kind, const char *key, const char *value) {
   UNUSED(kind);
   ta_http_request_t *header = cls;
@@ -309,6 +376,14 @@ static int ta_http_header_iter(void *cls, enum MHD_ValueKind kind, const char *k
     } else {
       header->valid_content_type = false;
     }
+  } else if (0 == strcasecmp(MHD_HTTP_HEADER_ACCEPT, key)) {
+    header->answer_format = ta_http_accept_format(value);
+  } else if (0 == strcasecmp(MHD_HTTP_HEADER_ACCEPT_ENCODING, key)) {
+    header->answer_encoding = http_accept_encoding(value);
+  } else if (0 == strcasecmp(MHD_HTTP_HEADER_CONTENT_LENGTH, key)) {
+    char *end = NULL;
+    const unsigned long long content_len = strtoull(value, &end, 10);
+    header->content_len = (end != value && content_len <= SIZE_MAX) ? (size_t)content_len : 0;
   }
   return MHD_YES;
 }
@@ -327,8 +402,11 @@ static int request_log(void *cls, const struct sockaddr *addr, socklen_t addrlen
 
 /*
  * Append data from the end of ta_http_request_t.request
+ *
+ * The buffer is taken from the pool of this thread. It is sized from Content-Length if present, and doubled otherwise,
+ * so the body is copied once in most cases. Content-Length is only a hint bounded by `max_len`.
  */
-static status_t build_request(ta_http_request_t *req, const char *data, size_t size) {
+static status_t build_request(ta_http_request_t *req, const char *data, size_t size, const size_t max_len) {
   if (req == NULL || data == NULL) {
     ta_log_error("Illegal NULL pointer\n");
     return SC_NULL;
@@ -337,29 +415,138 @@ static status_t build_request(ta_http_request_t *req, const char *data, size_t s
     ta_log_error("Illegal data size : 0\n");
     return SC_NULL;
   }
-  if (size + req->request_len >= MAX_REQUEST_LEN) {
+  if (size + req->request_len >= max_len || req->content_len >= max_len) {
     req->answer_string = strdup(STR_HTTP_REQUEST_SIZE_EXCEED);
     req->answer_code = MHD_HTTP_INTERNAL_SERVER_ERROR;
     return SC_HTTP_INTERNAL_SERVICE_ERROR;
   }
-  char *request = malloc(req->request_len + size + 1);
-  if (request == NULL) {
-    req->answer_string = strdup(STR_HTTP_INTERNAL_SERVICE_ERROR);
-    req->answer_code = MHD_HTTP_INTERNAL_SERVER_ERROR;
-    return SC_OOM;
-  }
-  if (req->request != NULL) {
-    memcpy(request, req->request, req->request_len);
+
+  const size_t required = req->request_len + size + 1;
+  if (required > req->request_capacity) {
+    size_t capacity = req->request_capacity * 2;
+    if (capacity < req->content_len + 1) {
+      capacity = req->content_len + 1;
+    }
+    if (capacity < required) {
+      capacity = required;
+    }
+    if (capacity > max_len) {
+      capacity = max_len;
+    }
+
+    char *request = NULL;
+    if (req->request == NULL) {
+      request = buffer_pool_alloc(capacity, &capacity);
+    } else {
+      request = realloc(req->request, capacity);
+    }
+    if (request == NULL) {
+      req->answer_string = strdup(STR_HTTP_INTERNAL_SERVICE_ERROR);
+      req->answer_code = MHD_HTTP_INTERNAL_SERVER_ERROR;
+      return SC_OOM;
+    }
+    req->request = request;
+    req->request_capacity = capacity;
   }
-  memcpy(request + req->request_len, data, size);
-  request[req->request_len + size] = 0;
-  free(req->request);
-  req->request = request;
+  memcpy(req->request + req->request_len, data, size);
   req->request_len += size;
+  req->request[req->request_len] = 0;
 
   return SC_OK;
 }
 
+/*
+ * Fill a block of a bulk response. Batches of transaction objects are fetched when the previous one is sent, so only
+ * a batch is kept in memory. As the status code is sent already, an error is reported by the last line of the stream.
+ */
+static ssize_t ta_http_bulk_read(void *cls, uint64_t pos, char *buf, size_t max) {
+  UNUSED(pos);
+  ta_http_bulk_t *bulk = cls;
+
+  while (bulk->offset == bulk->lines_len) {
+    buffer_pool_release(bulk->lines);
+    bulk->lines = NULL;
+    bulk->lines_len = 0;
+    bulk->offset = 0;
+    if (bulk->failed) {
+      return MHD_CONTENT_READER_END_WITH_ERROR;
+    }
+    if (bulk->req->hashes == NULL) {
+      return MHD_CONTENT_READER_END_OF_STREAM;
+    }
+
+    const status_t ret =
+        api_find_transaction_objects_bulk_next(&bulk->iota_service, bulk->req, &bulk->lines, &bulk->lines_len);
+    if (ret != SC_OK) {
+      char *message = NULL;
+      bulk->failed = true;
+      set_response_content(ret, &message);
+      bulk->lines = message ? malloc(strlen(message) + 2) : NULL;
+      if (bulk->lines) {
+        bulk->lines_len = (size_t)sprintf(bulk->lines, "%s\n", message);
+      }
+      free(message);
+    }
+  }
+
+  const size_t remaining = bulk->lines_len - bulk->offset;
+  const size_t len = remaining < max ? remaining : max;
+  memcpy(buf, bulk->lines + bulk->offset, len);
+  bulk->offset += len;
+  return len;
+}
+
+static void ta_http_bulk_free(void *cls) {
+  ta_http_bulk_t *bulk = cls;
+  ta_find_transaction_objects_req_free(&bulk->req);
+  buffer_pool_release(bulk->lines);
+  free(bulk);
+}
+
+/*
+ * Create the response of a bulk request, which is streamed in chunks. On error, the error message is set to the answer
+ * of the request instead.
+ */
+static struct MHD_Response *ta_http_bulk_response(ta_http_t *const http, ta_http_request_t *const http_req) {
+  struct MHD_Response *response = NULL;
+  ta_http_bulk_t *bulk = calloc(1, sizeof(ta_http_bulk_t));
+  status_t ret = SC_OK;
+  if (bulk == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  ret = api_find_transaction_objects_bulk_init(http_req->request, &bulk->req);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  ta_set_iota_client_service(&bulk->iota_service, http->core->iota_service.http.host,
+                             http->core->iota_service.http.port, http->core->iota_service.http.ca_pem);
+
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, HTTP_BULK_BLOCK_SIZE, ta_http_bulk_read, bulk,
+                                               ta_http_bulk_free);
+  if (response == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", "Failed to create response");
+    goto done;
+  }
+  bulk = NULL;
+  MHD_add_response_header(response, MHD_HTTP_HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+  MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, "application/x-ndjson");
+  http_req->answer_code = MHD_HTTP_OK;
+
+done:
+  if (bulk) {
+    ta_find_transaction_objects_req_free(&bulk->req);
+    free(bulk);
+  }
+  if (ret != SC_OK) {
+    http_req->answer_code = set_response_content(ret, &http_req->answer_string);
+  }
+  return response;
+}
+
 static int ta_http_handler(void *cls, struct MHD_Connection *connection, const char *url, const char *method,
                            const char *version, const char *upload_data, size_t *upload_data_size, void **ptr) {
   UNUSED(version);
@@ -381,14 +568,18 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
   // if http_req is NULL, that means it's the first call of the connection
   if (http_req == NULL) {
     http_req = malloc(sizeof(ta_http_request_t));
+    http_req->valid_content_type = false;
+    http_req->answer_format = TA_RES_JSON;
     http_req->answer_code = MHD_NO;
     http_req->answer_string = NULL;
+    http_req->answer_len = 0;
+    http_req->answer_encoding = HTTP_ENCODING_IDENTITY;
     http_req->request = NULL;
     http_req->request_len = 0;
-    // Only POST request needs to get header information
-    if (post) {
-      MHD_get_connection_values(connection, MHD_HEADER_KIND, ta_http_header_iter, http_req);
-    }
+    http_req->request_capacity = 0;
+    http_req->content_len = 0;
+    http_req->bulk = (post && api_path_matcher(url, HTTP_BULK_PATH) == SC_OK);
+    MHD_get_connection_values(connection, MHD_HEADER_KIND, ta_http_header_iter, http_req);
     *ptr = http_req;
 
     return MHD_YES;
@@ -406,7 +597,9 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
       *upload_data_size = 0;
       return MHD_YES;
     }
-    if (build_request(http_req, upload_data, *upload_data_size) != SC_OK) {
+    const size_t max_len =
+        http_req->bulk ? api->core->ta_conf.http_bulk_max_request_len : api->core->ta_conf.http_max_request_len;
+    if (build_request(http_req, upload_data, *upload_data_size, max_len) != SC_OK) {
       ta_log_error("Failed to build http request\n");
     }
     ta_log_debug("request = %s\n", http_req->request);
@@ -415,23 +608,68 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
     return MHD_YES;
   }
 
-  if (post && (http_req->request == NULL)) {
+  // An error answered while uploading, such as an oversized body, is sent even if no body is kept
+  if (post && http_req->answer_code == MHD_NO && http_req->request == NULL) {
     // POST but no body, so we skip this request
     ret = MHD_NO;
     ta_log_error("%s\n", "Received POST without body, skip request");
     goto cleanup;
   }
 
+  if (http_req->answer_code == MHD_NO && http_req->bulk) {
+    response = ta_http_bulk_response(api, http_req);
+    if (response != NULL) {
+      ret = MHD_queue_response(connection, http_req->answer_code, response);
+      MHD_destroy_response(response);
+      goto cleanup;
+    }
+  }
+
   if (http_req->answer_code == MHD_NO) {
     /* decide which API function should be called */
     iota_client_service_t iota_service;
     ta_set_iota_client_service(&iota_service, api->core->iota_service.http.host, api->core->iota_service.http.port,
                                api->core->iota_service.http.ca_pem);
     http_req->answer_code =
-        ta_http_process_request(api, &iota_service, url, http_req->request, &http_req->answer_string, options);
+        ta_http_process_request(api, &iota_service, url, http_req->request, &http_req->answer_format,
+                                &http_req->answer_string, &http_req->answer_len, options);
+  } else {
+    // The answer is an error message of build_request() or ta_http_bulk_response()
+    http_req->answer_format = TA_RES_JSON;
+  }
+  const bool cbor = (http_req->answer_format == TA_RES_CBOR);
+  size_t answer_len = cbor ? http_req->answer_len : (http_req->answer_string ? strlen(http_req->answer_string) : 0);
+
+  // The answer is compressed only if it is large enough and the compressed one is smaller
+  char const *encoding = NULL;
+  const ta_config_t *const ta_conf = &api->core->ta_conf;
+  if (!options && ta_conf->http_compress_level && http_req->answer_encoding != HTTP_ENCODING_IDENTITY &&
+      answer_len > 0 && answer_len >= ta_conf->http_compress_min_size) {
+    char *compressed = NULL;
+    size_t compressed_len = 0;
+    status_t compress_ret = http_compress(http_req->answer_encoding, ta_conf->http_compress_level,
+                                          http_req->answer_string, answer_len, &compressed, &compressed_len);
+    if (compress_ret != SC_OK) {
+      ta_log_warning("%s\n", ta_error_to_string(compress_ret));
+    } else if (compressed_len < answer_len) {
+      buffer_pool_release(http_req->answer_string);
+      http_req->answer_string = compressed;
+      answer_len = compressed_len;
+      encoding = http_encoding_name(http_req->answer_encoding);
+    } else {
+      buffer_pool_release(compressed);
+    }
+  }
+
+  // The answer is handed over without copying, and its buffer goes back to the pool of this thread after it is sent
+  response = MHD_create_response_from_buffer_with_free_callback(answer_len, http_req->answer_string,
+                                                                buffer_pool_release);
+  if (response == NULL) {
+    ret = MHD_NO;
+    ta_log_error("%s\n", "Failed to create response");
+    goto cleanup;
   }
-  response = MHD_create_response_from_buffer(http_req->answer_string ? strlen(http_req->answer_string) : 0,
-                                             http_req->answer_string, MHD_RESPMEM_MUST_COPY);
+  http_req->answer_string = NULL;
   // Set response header
   MHD_add_response_header(response, MHD_HTTP_HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, "*");
   if (options) {
@@ -441,7 +679,11 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
                             "Origin, Content-Type, Accept, X-IOTA-API-Version");
     MHD_add_response_header(response, "Access-Control-Max-Age", "86400");
   } else {
-    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, "application/json");
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, cbor ? "application/cbor" : "application/json");
+    MHD_add_response_header(response, MHD_HTTP_HEADER_VARY, "Accept, Accept-Encoding");
+    if (encoding) {
+      MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING, encoding);
+    }
   }
   ret = MHD_queue_response(connection, http_req->answer_code, response);
   MHD_destroy_response(response);
@@ -452,7 +694,7 @@ cleanup:
 
   if (http_req) {
     free(http_req->answer_string);
-    free(http_req->request);
+    buffer_pool_release(http_req->request);
     free(http_req);
   }
   *ptr = NULL;
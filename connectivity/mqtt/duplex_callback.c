@@ -9,7 +9,9 @@
 #include "duplex_callback.h"
 #include <stdlib.h>
 #include <string.h>
+#include "accelerator/core/mam_watcher.h"
 #include "connectivity/common.h"
+#include "mam_push.h"
 
 #define MQTT_CALLBACK_LOGGER "duplex_callback"
 static logger_id_t logger_id;
@@ -47,6 +49,36 @@ status_t check_valid_tag(char *tag) {
   return SC_OK;
 }
 
+/**
+ * @brief Watch or unwatch the MAM channel in the request for the device, and respond the topic its new messages are
+ * published to
+ */
+static status_t mqtt_mam_subscription(char *req, char const *const device_id, bool subscribe, char **json_result) {
+  status_t ret = SC_OK;
+  char chid[NUM_TRYTES_ADDRESS + 1] = {0};
+  char *topic = NULL;
+
+  ret = mqtt_chid_req_deserialize(req, chid);
+  if (ret != SC_OK) {
+    return ret;
+  }
+  ret = subscribe ? mam_watcher_watch(chid, device_id) : mam_watcher_unwatch(chid, device_id);
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  ret = mqtt_mam_push_topic(ta_core->ta_conf.mqtt_topic_root, chid, &topic);
+  if (ret != SC_OK) {
+    return ret;
+  }
+  cJSON *json_obj = cJSON_CreateObject();
+  cJSON_AddStringToObject(json_obj, "topic", topic);
+  *json_result = cJSON_PrintUnformatted(json_obj);
+  cJSON_Delete(json_obj);
+  free(topic);
+  return SC_OK;
+}
+
 static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic, char *req) {
   if (cfg == NULL || subscribe_topic == NULL || req == NULL) {
     ta_log_error("%s\n", ta_error_to_string(SC_NULL));
@@ -56,7 +88,7 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
   status_t ret = SC_OK;
   char *json_result = NULL;
   char *res_topic = NULL;
-  char device_id[ID_LEN] = {0};
+  char device_id[ID_LEN + 1] = {0};
 
   // get the Device ID.
   ret = mqtt_device_id_deserialize(req, device_id);
@@ -81,20 +113,27 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
     char tag[NUM_TRYTES_TAG + 1] = {0};
     mqtt_tag_req_deserialize(req, tag);
     if (check_valid_tag(tag) == SC_OK) {
-      ret = api_find_transactions_obj_by_tag(&iota_service, tag, &json_result);
+      ret = api_find_transactions_obj_by_tag(&iota_service, tag, TA_RES_JSON, &json_result, NULL);
     } else {
       ret = SC_HTTP_URL_NOT_MATCH;
     }
   } else if (api_path_matcher(api_sub_topic, "/transaction") == SC_OK) {
     char hash[NUM_TRYTES_HASH + 1];
     mqtt_transaction_hash_req_deserialize(req, hash);
-    ret = api_find_transaction_object_single(&iota_service, hash, &json_result);
+    ret = api_find_transaction_object_single(&iota_service, hash, TA_RES_JSON, &json_result, NULL);
   } else if (api_path_matcher(api_sub_topic, "/transaction/object") == SC_OK) {
-    ret = api_find_transaction_objects(&iota_service, req, &json_result);
+    ret = api_find_transaction_objects(&iota_service, req, TA_RES_JSON, &json_result, NULL);
   } else if (api_path_matcher(api_sub_topic, "/transaction/send") == SC_OK) {
     ret = api_send_transfer(ta_core, &iota_service, req, &json_result);
   } else if (api_path_matcher(api_sub_topic, "/tryte") == SC_OK) {
     ret = api_send_trytes(&ta_core->ta_conf, &ta_core->iota_conf, &iota_service, req, &json_result);
+  } else if (api_path_matcher(api_sub_topic, "/mam/subscribe") == SC_OK) {
+    ret = mqtt_mam_subscription(req, device_id, true, &json_result);
+  } else if (api_path_matcher(api_sub_topic, "/mam/unsubscribe") == SC_OK) {
+    ret = mqtt_mam_subscription(req, device_id, false, &json_result);
+  } else if (api_path_matcher(api_sub_topic, "/mam/disconnect") == SC_OK) {
+    // Published by the broker as the will of a device, which drops all its subscriptions
+    ret = mam_watcher_release(device_id);
   } else {
     cJSON *json_obj = cJSON_CreateObject();
     cJSON_AddStringToObject(json_obj, "message", api_sub_topic);
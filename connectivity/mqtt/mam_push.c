@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "mam_push.h"
+#include <stdlib.h>
+#include <string.h>
+#include "accelerator/core/mam_watcher.h"
+#include "common/logger.h"
+
+#define MQTT_MAM_PUSH_LOGGER "mqtt_mam_push"
+#define MQTT_MAM_PUSH_QOS 1
+
+static logger_id_t logger_id;
+static struct mosquitto* push_mosq = NULL;
+
+void mqtt_mam_push_logger_init() { logger_id = logger_helper_enable(MQTT_MAM_PUSH_LOGGER, LOGGER_DEBUG, true); }
+
+int mqtt_mam_push_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+status_t mqtt_mam_push_topic(char const* const topic_root, char const* const chid, char** topic) {
+  if (topic_root == NULL || chid == NULL || topic == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  const int topic_len = strlen(topic_root) + strlen("/mam/") + strlen(chid) + 1;
+  *topic = (char*)malloc(topic_len);
+  if (*topic == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  snprintf(*topic, topic_len, "%s/mam/%s", topic_root, chid);
+  return SC_OK;
+}
+
+static void mam_push_publish(char const* const chid, char const* const message, void* const arg) {
+  ta_core_t* core = (ta_core_t*)arg;
+  char* topic = NULL;
+
+  if (mqtt_mam_push_topic(core->ta_conf.mqtt_topic_root, chid, &topic) != SC_OK) {
+    return;
+  }
+  int ret = mosquitto_publish(push_mosq, NULL, topic, strlen(message), message, MQTT_MAM_PUSH_QOS, false);
+  if (ret != MOSQ_ERR_SUCCESS) {
+    ta_log_error("Failed to publish to %s: %s\n", topic, mosquitto_strerror(ret));
+  }
+  free(topic);
+}
+
+status_t mqtt_mam_push_start(ta_core_t* const core, mosq_config_t* const cfg) {
+  status_t ret = SC_OK;
+  if (core == NULL || cfg == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  push_mosq = mosquitto_new(NULL, true, NULL);
+  if (push_mosq == NULL) {
+    ret = SC_MQTT_MOSQ_OBJ_INIT_ERROR;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+
+  // Connect with the broker, port, TLS and credentials of the request client
+  ret = mosq_opts_set(push_mosq, cfg);
+  if (ret == SC_OK) {
+    ret = mosq_client_connect(push_mosq, cfg);
+  }
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  // Publishing is done by the network thread of mosquitto, so the watcher never waits for the broker
+  if (mosquitto_loop_start(push_mosq) != MOSQ_ERR_SUCCESS) {
+    ret = SC_MQTT_CONNECT;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    mosquitto_disconnect(push_mosq);
+    goto done;
+  }
+
+  ret = mam_watcher_init(&core->iota_conf, &core->iota_service, core->ta_conf.mam_watch_period, mam_push_publish,
+                         core);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    mosquitto_disconnect(push_mosq);
+    mosquitto_loop_stop(push_mosq, false);
+  }
+
+done:
+  if (ret) {
+    mosquitto_destroy(push_mosq);
+    push_mosq = NULL;
+  }
+  return ret;
+}
+
+void mqtt_mam_push_stop() {
+  mam_watcher_destroy();
+  if (push_mosq) {
+    mosquitto_disconnect(push_mosq);
+    mosquitto_loop_stop(push_mosq, false);
+    mosquitto_destroy(push_mosq);
+    push_mosq = NULL;
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef MQTT_MAM_PUSH_H_
+#define MQTT_MAM_PUSH_H_
+
+#include "accelerator/config.h"
+#include "common/ta_errors.h"
+#include "mqtt_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file connectivity/mqtt/mam_push.h
+ * @brief Publish new messages of watched MAM channels to MQTT subscribers
+ *
+ * New messages of a channel subscribed through the `mam/subscribe` topic are published to `<topic root>/mam/<chid>`,
+ * so the broker delivers each message to every client subscribing to the channel. Messages are published by a client
+ * of their own, which connects to the broker the same way as the client receiving requests.
+ */
+
+/**
+ * @brief Generate the topic new messages of a channel are published to
+ *
+ * @param[in] topic_root The topic root of MQTT topic
+ * @param[in] chid Channel ID in trytes
+ * @param[out] topic Generated topic. It should be freed by the caller.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mqtt_mam_push_topic(char const* const topic_root, char const* const chid, char** topic);
+
+/**
+ * @brief Connect to the MQTT broker and start watching MAM channels
+ *
+ * Channels can only be subscribed after this function succeeds.
+ *
+ * @param[in] core Pointer to Tangle-accelerator core configuration structure
+ * @param[in] cfg Configuration of the client receiving requests, whose host, port, TLS options and credentials are
+ * used to connect to the broker
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mqtt_mam_push_start(ta_core_t* const core, mosq_config_t* const cfg);
+
+/**
+ * @brief Stop watching MAM channels and disconnect from the MQTT broker
+ */
+void mqtt_mam_push_stop();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MQTT_MAM_PUSH_H_
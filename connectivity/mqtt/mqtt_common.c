@@ -382,7 +382,7 @@ status_t mosq_client_connect(struct mosquitto *mosq, mosq_config_t *cfg) {
         ta_log_error(":%s\n", mosquitto_strerror(ret));
       }
     }
-    mosquitto_lib_cleanup();
+    // The library is still used by other clients, so it is cleaned up by the caller
     return SC_MQTT_CONNECT;
   }
   return SC_OK;
@@ -12,6 +12,7 @@
 #include "cJSON.h"
 #include "tests/common.h"
 #include "tests/test_define.h"
+#include "utils/buffer_pool.h"
 
 static driver_test_cases_t test_case;
 static ta_core_t ta_core;
@@ -108,7 +109,7 @@ void test_find_transaction_objects(void) {
     ta_set_iota_client_service(&iota_service, ta_core.iota_service.http.host, ta_core.iota_service.http.port,
                                ta_core.iota_service.http.ca_pem);
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects(&iota_service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects(&iota_service, json, TA_RES_JSON, &json_result, NULL));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -116,6 +117,42 @@ void test_find_transaction_objects(void) {
   free(json);
 }
 
+void test_find_transaction_objects_bulk(void) {
+  const char* pre_json = "{\"hashes\":[\"%s\",\"%s\"]}";
+  int json_len = (NUM_TRYTES_HASH + 1) * 2 + strlen(pre_json) + 1;
+  char* json = (char*)malloc(sizeof(char) * json_len);
+  snprintf(json, json_len, pre_json, test_case.txn_hash[0], test_case.txn_hash[1]);
+  ta_find_transaction_objects_req_t* req = NULL;
+  char* lines = NULL;
+  size_t lines_len = 0;
+  double sum = 0;
+
+  for (size_t count = 0; count < TEST_COUNT; count++) {
+    iota_client_service_t iota_service;
+    ta_set_iota_client_service(&iota_service, ta_core.iota_service.http.host, ta_core.iota_service.http.port,
+                               ta_core.iota_service.http.ca_pem);
+    test_time_start(&start_time);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects_bulk_init(json, &req));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects_bulk_next(&iota_service, req, &lines, &lines_len));
+    test_time_end(&start_time, &end_time, &sum);
+
+    // Both transaction objects fit in a batch, one per line
+    TEST_ASSERT_NOT_NULL(lines);
+    TEST_ASSERT_EQUAL_UINT(lines_len, strlen(lines));
+    TEST_ASSERT_EQUAL_INT('\n', lines[lines_len - 1]);
+    TEST_ASSERT_NOT_NULL(strstr(lines, test_case.txn_hash[0]));
+    TEST_ASSERT_TRUE(strstr(lines, test_case.txn_hash[0]) < strchr(lines, '\n'));
+    TEST_ASSERT_NOT_NULL(strstr(strchr(lines, '\n'), test_case.txn_hash[1]));
+    buffer_pool_release(lines);
+
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects_bulk_next(&iota_service, req, &lines, &lines_len));
+    TEST_ASSERT_NULL(lines);
+    ta_find_transaction_objects_req_free(&req);
+  }
+  printf("Average time of find_transaction_objects_bulk: %lf\n", sum / TEST_COUNT);
+  free(json);
+}
+
 void test_find_transactions_by_tag(void) {
   char* json_result;
   double sum = 0;
@@ -191,7 +228,8 @@ void test_find_transactions_obj_by_tag(void) {
     ta_set_iota_client_service(&iota_service, ta_core.iota_service.http.host, ta_core.iota_service.http.port,
                                ta_core.iota_service.http.ca_pem);
 
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transactions_obj_by_tag(&iota_service, test_case.tag, &json_result));
+    TEST_ASSERT_EQUAL_INT32(
+        SC_OK, api_find_transactions_obj_by_tag(&iota_service, test_case.tag, TA_RES_JSON, &json_result, NULL));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -247,6 +285,7 @@ int main(int argc, char* argv[]) {
   RUN_TEST(test_send_transfer);
   RUN_TEST(test_send_trytes);
   RUN_TEST(test_find_transaction_objects);
+  RUN_TEST(test_find_transaction_objects_bulk);
   RUN_TEST(test_find_transactions_by_tag);
   RUN_TEST(test_find_transactions_obj_by_tag);
 #ifdef DB_ENABLE
@@ -6,6 +6,7 @@
  * "LICENSE" at the root of this distribution.
  */
 
+#include <pthread.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
@@ -61,7 +62,8 @@ void test_receive_mam_message(void) {
   snprintf(json, json_size, json_template, res.chid);
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, TA_RES_JSON,
+                                                        &json_result, NULL));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -69,6 +71,69 @@ void test_receive_mam_message(void) {
   free(json);
 }
 
+typedef struct mam_send_thread_s {
+  ta_send_mam_req_t* req;
+  ta_send_mam_res_t* res;
+  double elapsed;
+  status_t ret;
+  volatile bool done;
+} mam_send_thread_t;
+
+static void* mam_send_routine(void* arg) {
+  mam_send_thread_t* thread = (mam_send_thread_t*)arg;
+  struct timespec start, end;
+  test_time_start(&start);
+  thread->ret =
+      ta_send_mam_message(&ta_core.ta_conf, &ta_core.iota_conf, &ta_core.iota_service, thread->req, thread->res);
+  test_time_end(&start, &end, &thread->elapsed);
+  thread->done = true;
+  return NULL;
+}
+
+void test_mam_state_latency(void) {
+  // Requests without a seed use the resident state of tangle-accelerator
+  const char* json = "{\"x-api-key\":\"" TEST_TOKEN "\",\"data\":{\"ch_mss_depth\":" STR(
+      TEST_CH_DEPTH) ",\"message\":\"" TEST_PAYLOAD "\"}, \"protocol\":\"MAM_V1\"}";
+  double sum_send = 0, sum_acquire = 0, max_acquire = 0;
+  int acquired = 0;
+
+  for (size_t count = 0; count < TEST_COUNT; count++) {
+    ta_send_mam_res_t* send_res = send_mam_res_new();
+    mam_send_thread_t thread = {.req = send_mam_req_new(), .res = send_res, .elapsed = 0, .done = false};
+    pthread_t thread_id;
+    TEST_ASSERT_EQUAL_INT32(SC_OK, send_mam_message_req_deserialize(json, thread.req));
+    TEST_ASSERT_EQUAL_INT32(0, pthread_create(&thread_id, NULL, mam_send_routine, &thread));
+
+    // Another request on the same seed only waits for writing the bundle, but not for the PoW of it
+    while (!thread.done) {
+      mam_state_t* state = NULL;
+      double elapsed = 0;
+      test_time_start(&start_time);
+      TEST_ASSERT_EQUAL_INT32(
+          SC_OK, mam_state_acquire((tryte_t*)ta_core.iota_conf.seed, ta_core.iota_conf.mam_file_path, &state));
+      TEST_ASSERT_EQUAL_INT32(SC_OK, mam_state_release(state, false));
+      test_time_end(&start_time, &end_time, &elapsed);
+      sum_acquire += elapsed;
+      max_acquire = (elapsed > max_acquire) ? elapsed : max_acquire;
+      acquired++;
+      usleep(1000);
+    }
+
+    pthread_join(thread_id, NULL);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, thread.ret);
+    sum_send += thread.elapsed;
+    send_mam_req_free(&thread.req);
+    send_mam_res_free(&send_res);
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_state_flush());
+
+  printf("Average time of sending MAM message with resident MAM state: %lf\n", sum_send / TEST_COUNT);
+  if (acquired) {
+    printf("Average and maximum time of acquiring MAM state while sending: %lf, %lf\n", sum_acquire / acquired,
+           max_acquire);
+  }
+}
+
 void test_api_register_mam_channel(void) {
   char* json_result;
   const char* json = "{\"seed\":\"" TRYTES_81_1 "\"}";
@@ -100,6 +165,7 @@ int main(int argc, char* argv[]) {
   printf("Total samples for each API test: %d\n", TEST_COUNT);
   RUN_TEST(test_send_mam_message);
   RUN_TEST(test_receive_mam_message);
+  RUN_TEST(test_mam_state_latency);
   RUN_TEST(test_api_register_mam_channel);
   ta_core_destroy(&ta_core);
   return UNITY_END();
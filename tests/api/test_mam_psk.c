@@ -52,7 +52,8 @@ void test_encrypt_decrypt_psk(void) {
   const size_t len_recv_psk = strlen(json_template_recv_psk) + NUM_TRYTES_ADDRESS;
   json = (char*)malloc(sizeof(char) * len_recv_psk);
   snprintf(json, len_recv_psk, json_template_recv_psk, send_res->chid);
-  TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, &json_result));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, TA_RES_JSON,
+                                                      &json_result, NULL));
 
   // Deserialize json_result, compare the number which is equal to the number of sent message
   ta_recv_mam_res_t* recv_res = recv_mam_res_new();
@@ -67,7 +68,8 @@ void test_encrypt_decrypt_psk(void) {
   const size_t len_recv = strlen(json_template_recv) + NUM_TRYTES_ADDRESS;
   json = (char*)malloc(sizeof(char) * len_recv);
   snprintf(json, len_recv, json_template_recv, send_res->chid);
-  TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, &json_result));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, TA_RES_JSON,
+                                                      &json_result, NULL));
   recv_res = recv_mam_res_new();
   TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_deserialize(json_result, recv_res));
   TEST_ASSERT_EQUAL_INT32(0, utarray_len(recv_res->payload_array));
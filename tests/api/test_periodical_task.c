@@ -15,9 +15,14 @@
 #define TXN_NUM_IN_BUNDLE 2
 #define MAM_REQ_NUM 2
 #define ORDERED_PAYLOAD "test payload number"
+#define MAM_SENDER_WORKERS 2
+#define MAM_SENDER_TIMEOUT 300
 
 static ta_core_t ta_core;
 static char* response_uuid[MAM_REQ_NUM];
+static const char* mam_json_template =
+    "{\"x-api-key\":\"" TEST_TOKEN "\",\"data\":{\"seed\":\"%s\",\"ch_mss_depth\":" STR(
+        TEST_CH_DEPTH) ",\"message\":\"" ORDERED_PAYLOAD ":%d\"}, \"protocol\":\"MAM_V1\"}";
 
 status_t prepare_transfer(const iota_config_t* const iconf, const iota_client_service_t* const service,
                           ta_send_transfer_req_t** req, const int req_txn_num, hash8019_array_p raw_txn_array) {
@@ -111,17 +116,22 @@ void test_broadcast_buffered_txn(void) {
       SC_OK, prepare_transfer(&ta_core.iota_conf, &ta_core.iota_service, req, TXN_NUM_IN_BUNDLE, raw_txn_array));
 
   // Push transaction trytes to redis server
-  TEST_ASSERT_EQUAL_INT32(SC_OK, push_txn_to_buffer(&ta_core.cache, raw_txn_array, uuid));
-
-  int bundle_len = 0;
-  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(uuid, &bundle_len));
-  TEST_ASSERT_TRUE(bundle_len);
-  for (int i = 0; i < bundle_len; ++i) {
-    flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION + 1] = {};
-    TEST_ASSERT_EQUAL_INT32(SC_OK,
-                            cache_list_at(uuid, i, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION, (char*)txn_flex_trits));
-    TEST_ASSERT_FALSE(flex_trits_are_null(txn_flex_trits, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, push_txn_to_buffer(&ta_core.cache, raw_txn_array, ta_core.iota_conf.mwm, uuid));
+
+  char* blob = NULL;
+  size_t blob_len = 0;
+  bundle_blob_header_t header;
+  hash8019_array_p buffered_txn_array = hash8019_array_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_get_blob(uuid, &blob, &blob_len));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_decode(blob, blob_len, &header, buffered_txn_array));
+  TEST_ASSERT_EQUAL_INT32(TXN_NUM_IN_BUNDLE, header.txn_num);
+  TEST_ASSERT_EQUAL_INT32(ta_core.iota_conf.mwm, header.mwm);
+  TEST_ASSERT_EQUAL_UINT64(0, header.broadcast_timestamp);
+  for (int i = 0; i < header.txn_num; ++i) {
+    TEST_ASSERT_FALSE(flex_trits_are_null(hash_array_at(buffered_txn_array, i), NUM_FLEX_TRITS_SERIALIZED_TRANSACTION));
   }
+  free(blob);
+  hash_array_free(buffered_txn_array);
 
   TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.buffer_list_name, &list_len));
   TEST_ASSERT_EQUAL_INT32(init_list_len + 1, list_len);
@@ -133,14 +143,16 @@ void test_broadcast_buffered_txn(void) {
   TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.buffer_list_name, &list_len));
   TEST_ASSERT_EQUAL_INT32(init_list_len, list_len);
 
-  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(uuid, &bundle_len));
-  TEST_ASSERT_EQUAL_INT32(TXN_NUM_IN_BUNDLE, bundle_len);
-  for (int i = 0; i < bundle_len; ++i) {
-    flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION + 1] = {};
-    TEST_ASSERT_EQUAL_INT32(SC_OK,
-                            cache_list_at(uuid, i, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION, (char*)txn_flex_trits));
-    TEST_ASSERT_FALSE(flex_trits_are_null(txn_flex_trits, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION));
+  buffered_txn_array = hash8019_array_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_get_blob(uuid, &blob, &blob_len));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_decode(blob, blob_len, &header, buffered_txn_array));
+  TEST_ASSERT_EQUAL_INT32(TXN_NUM_IN_BUNDLE, header.txn_num);
+  TEST_ASSERT_TRUE(header.broadcast_timestamp >= header.buffered_timestamp);
+  for (int i = 0; i < header.txn_num; ++i) {
+    TEST_ASSERT_FALSE(flex_trits_are_null(hash_array_at(buffered_txn_array, i), NUM_FLEX_TRITS_SERIALIZED_TRANSACTION));
   }
+  free(blob);
+  hash_array_free(buffered_txn_array);
 
   for (int i = 0; i < TXN_NUM_IN_BUNDLE; i++) {
     ta_send_transfer_req_free(&req[i]);
@@ -149,6 +161,85 @@ void test_broadcast_buffered_txn(void) {
   hash_array_free(raw_txn_array);
 }
 
+void test_broadcast_malformed_and_legacy_txn(void) {
+  const char* json_template =
+      "{\"value\":100,"
+      "\"message_format\":\"trytes\","
+      "\"message\":\"%s\",\"tag\":\"" TEST_TAG
+      "\","
+      "\"address\":\"" TEST_ADDRESS "\"}";
+  tryte_t test_transfer_message[TXN_NUM_IN_BUNDLE][TEST_TRANSFER_MESSAGE_LEN + 1] = {};
+  const int len = strlen(json_template) + TEST_TRANSFER_MESSAGE_LEN;
+  char* json[TXN_NUM_IN_BUNDLE];
+  ta_send_transfer_req_t* req[TXN_NUM_IN_BUNDLE];
+  for (int i = 0; i < TXN_NUM_IN_BUNDLE; i++) {
+    gen_rand_trytes(TEST_TRANSFER_MESSAGE_LEN, test_transfer_message[i]);
+    json[i] = (char*)malloc(sizeof(char) * len);
+    snprintf(json[i], len, json_template, test_transfer_message[i]);
+    req[i] = ta_send_transfer_req_new();
+    TEST_ASSERT_EQUAL_INT32(SC_OK, ta_send_transfer_req_deserialize(json[i], req[i]));
+  }
+
+  uuid_t bin_uuid;
+  char legacy_uuid[UUID_STR_LEN], malformed_uuid[UUID_STR_LEN];
+  uuid_generate_random(bin_uuid);
+  uuid_unparse(bin_uuid, legacy_uuid);
+  uuid_generate_random(bin_uuid);
+  uuid_unparse(bin_uuid, malformed_uuid);
+  int list_len = -1;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.buffer_list_name, &list_len));
+  const int init_list_len = list_len;
+
+  // A bundle buffered by a previous version as a list of transactions
+  hash8019_array_p raw_txn_array = hash8019_array_new();
+  TEST_ASSERT_EQUAL_INT32(
+      SC_OK, prepare_transfer(&ta_core.iota_conf, &ta_core.iota_service, req, TXN_NUM_IN_BUNDLE, raw_txn_array));
+  for (int i = 0; i < TXN_NUM_IN_BUNDLE; ++i) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_push(legacy_uuid, UUID_STR_LEN - 1, hash_array_at(raw_txn_array, i),
+                                                   NUM_FLEX_TRITS_SERIALIZED_TRANSACTION));
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_push(ta_core.cache.buffer_list_name, strlen(ta_core.cache.buffer_list_name),
+                                                 legacy_uuid, UUID_STR_LEN - 1));
+
+  // A truncated blob at the head of the buffer list
+  const char truncated_blob[] = {BUNDLE_BLOB_VERSION, 14};
+  TEST_ASSERT_EQUAL_INT32(SC_OK,
+                          cache_set(malformed_uuid, UUID_STR_LEN - 1, truncated_blob, sizeof(truncated_blob), 0));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_push(ta_core.cache.buffer_list_name, strlen(ta_core.cache.buffer_list_name),
+                                                 malformed_uuid, UUID_STR_LEN - 1));
+
+  // The truncated blob doesn't block the bundle behind it
+  TEST_ASSERT_EQUAL_INT32(SC_OK, broadcast_buffered_txn(&ta_core));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.buffer_list_name, &list_len));
+  TEST_ASSERT_EQUAL_INT32(init_list_len, list_len);
+  bool exist = false;
+  TEST_ASSERT_EQUAL_INT32(SC_OK,
+                          cache_list_exist(ta_core.cache.dead_list_name, malformed_uuid, UUID_STR_LEN - 1, &exist));
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT_EQUAL_INT32(SC_OK,
+                          cache_list_exist(ta_core.cache.complete_list_name, legacy_uuid, UUID_STR_LEN - 1, &exist));
+  TEST_ASSERT_TRUE(exist);
+
+  char* blob = NULL;
+  size_t blob_len = 0;
+  bundle_blob_header_t header;
+  hash8019_array_p buffered_txn_array = hash8019_array_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_get_blob(legacy_uuid, &blob, &blob_len));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_decode(blob, blob_len, &header, buffered_txn_array));
+  TEST_ASSERT_EQUAL_INT32(TXN_NUM_IN_BUNDLE, header.txn_num);
+  TEST_ASSERT_TRUE(header.broadcast_timestamp >= header.buffered_timestamp);
+  free(blob);
+  hash_array_free(buffered_txn_array);
+
+  cache_list_remove(ta_core.cache.dead_list_name, malformed_uuid, UUID_STR_LEN - 1);
+  cache_del(malformed_uuid);
+  for (int i = 0; i < TXN_NUM_IN_BUNDLE; i++) {
+    ta_send_transfer_req_free(&req[i]);
+    free(json[i]);
+  }
+  hash_array_free(raw_txn_array);
+}
+
 void test_fetch_buffered_request_status(void) {
   // Generate transaction trytes, and don't send them
   const char* json_template =
@@ -178,7 +269,7 @@ void test_fetch_buffered_request_status(void) {
       SC_OK, prepare_transfer(&ta_core.iota_conf, &ta_core.iota_service, req, TXN_NUM_IN_BUNDLE, raw_txn_array));
 
   // Push transaction trytes to redis server
-  TEST_ASSERT_EQUAL_INT32(SC_OK, push_txn_to_buffer(&ta_core.cache, raw_txn_array, uuid));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, push_txn_to_buffer(&ta_core.cache, raw_txn_array, ta_core.iota_conf.mwm, uuid));
   TEST_ASSERT_EQUAL_INT32(SC_OK, ta_fetch_txn_with_uuid(&ta_core.cache, uuid, res));
   TEST_ASSERT_EQUAL_INT32(MAM_BUFREQ_UNSENT, res->status);
 
@@ -215,11 +306,9 @@ void test_fetch_buffered_request_status(void) {
 }
 
 void test_broadcast_buffered_mam(void) {
-  const char* json_template = "{\"x-api-key\":\"" TEST_TOKEN "\",\"data\":{\"seed\":\"%s\",\"ch_mss_depth\":" STR(
-      TEST_CH_DEPTH) ",\"message\":\"" ORDERED_PAYLOAD ":%d\"}, \"protocol\":\"MAM_V1\"}";
   char seed[NUM_TRYTES_ADDRESS + 1] = {};
   gen_rand_trytes(NUM_TRYTES_ADDRESS, (tryte_t*)seed);
-  const int len = strlen(json_template) + NUM_TRYTES_ADDRESS;
+  const int len = strlen(mam_json_template) + NUM_TRYTES_ADDRESS;
   int list_len = -1;
 
   TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.mam_buffer_list_name, &list_len));
@@ -228,7 +317,7 @@ void test_broadcast_buffered_mam(void) {
   for (int i = 0; i < MAM_REQ_NUM; i++) {
     char* json_result = NULL;
     char* json = (char*)malloc(sizeof(char) * len);
-    snprintf(json, len, json_template, seed, i);
+    snprintf(json, len, mam_json_template, seed, i);
     ta_send_mam_req_t* req = send_mam_req_new();
     TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_mam_message(&ta_core.cache, json, &json_result));
     response_uuid[i] = json_result;
@@ -259,6 +348,41 @@ void test_mam_fetch_with_uuid(void) {
   }
 }
 
+void test_mam_sender(void) {
+  char seed[MAM_SENDER_WORKERS][NUM_TRYTES_ADDRESS + 1] = {};
+  const int len = strlen(mam_json_template) + NUM_TRYTES_ADDRESS;
+  int list_len = -1;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.mam_buffer_list_name, &list_len));
+  const int init_list_len = list_len;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_sender_init(&ta_core, MAM_SENDER_WORKERS));
+
+  // Requests on different seeds are sent in parallel
+  for (int i = 0; i < MAM_SENDER_WORKERS; i++) {
+    gen_rand_trytes(NUM_TRYTES_ADDRESS, (tryte_t*)seed[i]);
+  }
+  for (int i = 0; i < MAM_REQ_NUM * MAM_SENDER_WORKERS; i++) {
+    char* json_result = NULL;
+    char* json = (char*)malloc(sizeof(char) * len);
+    snprintf(json, len, mam_json_template, seed[i % MAM_SENDER_WORKERS], i);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_mam_message(&ta_core.cache, json, &json_result));
+    free(json_result);
+    free(json);
+  }
+
+  // The requests are sent without health tracking
+  for (int i = 0; i < MAM_SENDER_TIMEOUT; i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, cache_list_size(ta_core.cache.mam_buffer_list_name, &list_len));
+    if (list_len == init_list_len) {
+      break;
+    }
+    sleep(1);
+  }
+  TEST_ASSERT_EQUAL_INT32(init_list_len, list_len);
+
+  mam_sender_destroy();
+}
+
 int main(int argc, char* argv[]) {
   rand_trytes_init();
 
@@ -282,9 +406,11 @@ int main(int argc, char* argv[]) {
 
   UNITY_BEGIN();
   RUN_TEST(test_broadcast_buffered_txn);
+  RUN_TEST(test_broadcast_malformed_and_legacy_txn);
   RUN_TEST(test_fetch_buffered_request_status);
   RUN_TEST(test_broadcast_buffered_mam);
   RUN_TEST(test_mam_fetch_with_uuid);
+  RUN_TEST(test_mam_sender);
   ta_core_destroy(&ta_core);
   return UNITY_END();
 }
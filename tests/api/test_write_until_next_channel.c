@@ -65,7 +65,8 @@ void test_write_until_next_channel(void) {
     TEST_ASSERT_NOT_NULL(res);
     json = (char*)malloc(json_size);
     snprintf(json, json_size, json_template_recv, mam_res_array[i * channel_leaf_msg_num]->chid);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_recv_mam_message(&ta_core.iota_conf, &ta_core.iota_service, json, TA_RES_JSON,
+                                                        &json_result, NULL));
 
     for (int j = i * channel_leaf_msg_num; j < ((i + 1) * channel_leaf_msg_num) && (j < msg_num); j++) {
       // Check whether a message exist under assigning channel ID.
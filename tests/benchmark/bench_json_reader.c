@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "accelerator/core/serializer/ser_helper.h"
+#include "accelerator/core/serializer/serializer.h"
+#include "tests/common.h"
+
+#define BENCH_ROUNDS 100
+#define BENCH_TRYTES_NUM 20
+#define BENCH_TAG "TANGLEACCELERATOR9999999999"
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static char* rand_send_trytes_req(const int num) {
+  char* json = (char*)malloc(strlen("{\"trytes\":[]}") + num * (NUM_TRYTES_SERIALIZED_TRANSACTION + 3) + 1);
+  size_t len = sprintf(json, "{\"trytes\":[");
+  for (int i = 0; i < num; i++) {
+    if (i) {
+      json[len++] = ',';
+    }
+    json[len++] = '"';
+    gen_rand_trytes(NUM_TRYTES_SERIALIZED_TRANSACTION, (tryte_t*)json + len);
+    len += NUM_TRYTES_SERIALIZED_TRANSACTION;
+    json[len++] = '"';
+  }
+  strcpy(json + len, "]}");
+  return json;
+}
+
+static char* rand_send_transfer_req() {
+  const char* json_template =
+      "{\"value\":0,\"message_format\":\"trytes\",\"message\":\"%s\",\"tag\":\"" BENCH_TAG "\",\"address\":\"%s\"}";
+  tryte_t message[NUM_TRYTES_MESSAGE + 1] = {}, address[NUM_TRYTES_ADDRESS + 1] = {};
+  gen_rand_trytes(NUM_TRYTES_MESSAGE, message);
+  gen_rand_trytes(NUM_TRYTES_ADDRESS, address);
+  char* json = (char*)malloc(strlen(json_template) + NUM_TRYTES_MESSAGE + NUM_TRYTES_ADDRESS);
+  sprintf(json, json_template, message, address);
+  return json;
+}
+
+/**
+ * Deserialize requests with the JSON reader, against parsing a cJSON tree, which is how requests were deserialized.
+ * Timings are only reported, since they depend on the machine.
+ */
+int main(void) {
+  hash8019_array_p cjson_trytes = NULL, reader_trytes = NULL;
+  struct timespec start;
+  int exit_code = EXIT_SUCCESS;
+
+  rand_trytes_init();
+  char* json = rand_send_trytes_req(BENCH_TRYTES_NUM);
+  const size_t json_len = strlen(json);
+
+  // Parsing a cJSON tree and converting its strings
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    hash_array_free(cjson_trytes);
+    cjson_trytes = hash8019_array_new();
+    cJSON* json_obj = cJSON_Parse(json);
+    ta_json_array_to_hash8019_array(json_obj, "trytes", cjson_trytes);
+    cJSON_Delete(json_obj);
+  }
+  const double cjson_ms = elapsed_ms(&start);
+
+  // Single pass with the JSON reader
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    hash_array_free(reader_trytes);
+    reader_trytes = hash8019_array_new();
+    ta_send_trytes_req_deserialize(json, reader_trytes);
+  }
+  const double reader_ms = elapsed_ms(&start);
+  free(json);
+
+  if (hash_array_len(reader_trytes) != BENCH_TRYTES_NUM || hash_array_len(cjson_trytes) != BENCH_TRYTES_NUM) {
+    fprintf(stderr, "Failed to deserialize %d trytes\n", BENCH_TRYTES_NUM);
+    exit_code = EXIT_FAILURE;
+    goto done;
+  }
+  for (int i = 0; i < BENCH_TRYTES_NUM; i++) {
+    if (memcmp(hash_array_at(cjson_trytes, i), hash_array_at(reader_trytes, i), FLEX_TRIT_SIZE_8019)) {
+      fprintf(stderr, "The JSON reader and cJSON give different trytes\n");
+      exit_code = EXIT_FAILURE;
+      goto done;
+    }
+  }
+  printf("send_trytes of %d transactions: cJSON %lf MB/s; JSON reader %lf MB/s\n", BENCH_TRYTES_NUM,
+         json_len * BENCH_ROUNDS / cjson_ms / 1e3, json_len * BENCH_ROUNDS / reader_ms / 1e3);
+
+  // A transfer with a full message, against building its cJSON tree alone
+  json = rand_send_transfer_req();
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    cJSON_Delete(cJSON_Parse(json));
+  }
+  const double tree_ms = elapsed_ms(&start);
+
+  size_t msg_len = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    ta_send_transfer_req_t* req = ta_send_transfer_req_new();
+    ta_send_transfer_req_deserialize(json, req);
+    msg_len = req->msg_len;
+    ta_send_transfer_req_free(&req);
+  }
+  const double transfer_ms = elapsed_ms(&start);
+  free(json);
+
+  if (msg_len != NUM_TRYTES_MESSAGE) {
+    fprintf(stderr, "Failed to deserialize a message of %d trytes\n", NUM_TRYTES_MESSAGE);
+    exit_code = EXIT_FAILURE;
+    goto done;
+  }
+  printf("send_transfer: cJSON tree %lf us; JSON reader %lf us\n", tree_ms * 1e3 / BENCH_ROUNDS,
+         transfer_ms * 1e3 / BENCH_ROUNDS);
+
+done:
+  hash_array_free(cjson_trytes);
+  hash_array_free(reader_trytes);
+  return exit_code;
+}
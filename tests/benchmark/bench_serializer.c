@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "accelerator/core/serializer/ser_helper.h"
+#include "accelerator/core/serializer/serializer.h"
+#include "tests/common.h"
+
+#define BENCH_TXN_NUM 100
+#define BENCH_ROUNDS 100
+
+static size_t cjson_alloc_count = 0;
+
+static void* counting_malloc(size_t size) {
+  cjson_alloc_count++;
+  return malloc(size);
+}
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void rand_flex_trits(flex_trit_t* flex_trits, const size_t num_trytes) {
+  tryte_t trytes[NUM_TRYTES_SIGNATURE];
+  gen_rand_trytes(num_trytes, trytes);
+  flex_trits_from_trytes(flex_trits, num_trytes * 3, trytes, num_trytes, num_trytes);
+}
+
+static transaction_array_t* rand_transaction_array(const int num) {
+  flex_trit_t msg_trits[FLEX_TRIT_SIZE_6561], tag_trits[FLEX_TRIT_SIZE_81], hash_trits[FLEX_TRIT_SIZE_243];
+  transaction_array_t* txn_array = transaction_array_new();
+
+  for (int i = 0; i < num; i++) {
+    iota_transaction_t* txn = transaction_new();
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_hash(txn, hash_trits);
+    rand_flex_trits(msg_trits, NUM_TRYTES_SIGNATURE);
+    transaction_set_signature(txn, msg_trits);
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_address(txn, hash_trits);
+    transaction_set_value(txn, rand() - RAND_MAX / 2);
+    rand_flex_trits(tag_trits, NUM_TRYTES_TAG);
+    transaction_set_obsolete_tag(txn, tag_trits);
+    transaction_set_timestamp(txn, 1546436542 + i);
+    transaction_set_current_index(txn, i);
+    transaction_set_last_index(txn, num - 1);
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_bundle(txn, hash_trits);
+    transaction_set_trunk(txn, hash_trits);
+    transaction_set_branch(txn, hash_trits);
+    transaction_set_tag(txn, tag_trits);
+    transaction_set_attachment_timestamp(txn, 1546436542000LL + i);
+    transaction_set_attachment_timestamp_lower(txn, 0);
+    transaction_set_attachment_timestamp_upper(txn, 3812798742493LL);
+    rand_flex_trits(tag_trits, NUM_TRYTES_NONCE);
+    transaction_set_nonce(txn, tag_trits);
+    transaction_array_push_back(txn_array, txn);
+    transaction_free(txn);
+  }
+  return txn_array;
+}
+
+/**
+ * Serialize a response of 100 transaction objects through a cJSON tree and with the JSON writer. Throughput and
+ * allocations per response are only reported, since timings depend on the machine.
+ */
+int main(void) {
+  cJSON_Hooks hooks = {.malloc_fn = counting_malloc, .free_fn = free};
+  char *cjson_result = NULL, *writer_result = NULL;
+  size_t cjson_bytes = 0, writer_bytes = 0;
+  struct timespec start;
+  int exit_code = EXIT_SUCCESS;
+
+  rand_trytes_init();
+  transaction_array_t* txn_array = rand_transaction_array(BENCH_TXN_NUM);
+
+  // Serialization through a cJSON tree
+  cJSON_InitHooks(&hooks);
+  cjson_alloc_count = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    cJSON* json_root = cJSON_CreateArray();
+    ta_transaction_array_to_json_array(txn_array, json_root);
+    free(cjson_result);
+    cjson_result = cJSON_PrintUnformatted(json_root);
+    cJSON_Delete(json_root);
+    cjson_bytes += strlen(cjson_result);
+  }
+  const double cjson_ms = elapsed_ms(&start);
+  const double cjson_allocs = (double)cjson_alloc_count / BENCH_ROUNDS;
+  cJSON_InitHooks(NULL);
+
+  // Serialization with the JSON writer, whose buffer is the only allocation if it is never grown
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    free(writer_result);
+    writer_result = NULL;
+    if (ta_find_transaction_objects_res_serialize(txn_array, &writer_result)) {
+      fprintf(stderr, "Failed to serialize transaction objects with the JSON writer\n");
+      exit_code = EXIT_FAILURE;
+      goto done;
+    }
+    writer_bytes += strlen(writer_result);
+  }
+  const double writer_ms = elapsed_ms(&start);
+
+  json_writer_t writer;
+  json_writer_init(&writer, BENCH_TXN_NUM * TXN_JSON_MAX_SIZE + 2);
+  const size_t init_capacity = writer.capacity;
+  ta_transaction_array_to_json_writer(txn_array, &writer);
+  const bool grown = (writer.capacity != init_capacity);
+  json_writer_destroy(&writer);
+
+  if (strcmp(cjson_result, writer_result)) {
+    fprintf(stderr, "The JSON writer and cJSON give different results\n");
+    exit_code = EXIT_FAILURE;
+    goto done;
+  }
+
+  printf("%d transactions: cJSON %lf MB/s, %.1lf allocations; JSON writer %lf MB/s, %s\n", BENCH_TXN_NUM,
+         cjson_bytes / cjson_ms / 1e3, cjson_allocs, writer_bytes / writer_ms / 1e3,
+         grown ? "buffer grown" : "1 allocation");
+
+done:
+  free(cjson_result);
+  free(writer_result);
+  transaction_array_free(txn_array);
+  return exit_code;
+}
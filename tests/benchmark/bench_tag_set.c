@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utils/tag_set.h"
+
+#define BENCH_MIN_DEPTH 10
+#define BENCH_MAX_DEPTH 12
+
+static const char tryte_alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void random_tags(tryte_t* tags, const size_t num, unsigned int seed) {
+  for (size_t i = 0; i < num * NUM_TRYTES_TAG; i++) {
+    tags[i] = tryte_alphabet[rand_r(&seed) % (sizeof(tryte_alphabet) - 1)];
+  }
+}
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * @brief The lookup `msg_id_exist()` used to do, which scans all the tags of a channel
+ */
+static bool linear_contains(tryte_t const* const tags, const size_t num, tryte_t const* const tag) {
+  for (size_t i = 0; i < num; i++) {
+    if (!memcmp(tags + i * NUM_TRYTES_TAG, tag, NUM_TRYTES_TAG)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Find the first unused key of a channel whose keys are all used, like sending a message to a full channel. Every
+ * candidate key is checked against the tags of the channel. Timings are only reported, since they depend on the
+ * machine.
+ */
+int main(void) {
+  for (int depth = BENCH_MIN_DEPTH; depth <= BENCH_MAX_DEPTH; depth++) {
+    const size_t key_num = 1 << depth;
+    tryte_t* tags = (tryte_t*)malloc(key_num * NUM_TRYTES_TAG);
+    tag_set_t set;
+    if (tags == NULL || tag_set_init(&set, key_num)) {
+      fprintf(stderr, "Failed to allocate %zu tags\n", key_num);
+      free(tags);
+      return EXIT_FAILURE;
+    }
+    random_tags(tags, key_num, depth);
+    struct timespec start;
+    size_t linear_found = 0, set_found = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < key_num; i++) {
+      linear_found += linear_contains(tags, key_num, tags + i * NUM_TRYTES_TAG);
+    }
+    const double linear_ms = elapsed_ms(&start);
+
+    // Building the set is part of the lookup, since it is built from the tags of the channel
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < key_num; i++) {
+      tag_set_add(&set, tags + i * NUM_TRYTES_TAG);
+    }
+    for (size_t i = 0; i < key_num; i++) {
+      set_found += tag_set_contains(&set, tags + i * NUM_TRYTES_TAG);
+    }
+    const double set_ms = elapsed_ms(&start);
+    tag_set_destroy(&set);
+    free(tags);
+
+    if (linear_found != key_num || set_found != key_num) {
+      fprintf(stderr, "Depth %d: %zu keys found by linear scan and %zu by tag set, out of %zu\n", depth, linear_found,
+              set_found, key_num);
+      return EXIT_FAILURE;
+    }
+    printf("Depth %d, %zu keys: linear scan %lf ms, tag set %lf ms\n", depth, key_num, linear_ms, set_ms);
+  }
+  return EXIT_SUCCESS;
+}
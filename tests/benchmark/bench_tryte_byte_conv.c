@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utils/tryte_byte_conv.h"
+
+#define BENCH_PAYLOAD_LEN (1 << 20)
+#define BENCH_ROUNDS 20
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Encode and decode a large message with the scalar and the dispatched implementations. Timings are only reported,
+ * since they depend on the machine.
+ */
+int main(void) {
+  int ret = EXIT_FAILURE;
+  uint8_t* bytes = malloc(BENCH_PAYLOAD_LEN);
+  char* trytes = malloc(BENCH_PAYLOAD_LEN * 2);
+  char* decoded = malloc(BENCH_PAYLOAD_LEN);
+  struct timespec start;
+  if (bytes == NULL || trytes == NULL || decoded == NULL) {
+    fprintf(stderr, "Failed to allocate the payload\n");
+    goto done;
+  }
+  for (size_t i = 0; i < BENCH_PAYLOAD_LEN; i++) {
+    bytes[i] = rand() % 256;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    bytes_to_trytes_scalar(bytes, BENCH_PAYLOAD_LEN, trytes);
+  }
+  const double encode_scalar_ms = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    bytes_to_trytes(bytes, BENCH_PAYLOAD_LEN, trytes);
+  }
+  const double encode_ms = elapsed_ms(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    trytes_to_bytes_scalar((uint8_t*)trytes, BENCH_PAYLOAD_LEN * 2, decoded);
+  }
+  const double decode_scalar_ms = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    trytes_to_bytes((uint8_t*)trytes, BENCH_PAYLOAD_LEN * 2, decoded);
+  }
+  const double decode_ms = elapsed_ms(&start);
+
+  // The round trip also keeps the conversions from being optimized out
+  if (memcmp(bytes, decoded, BENCH_PAYLOAD_LEN)) {
+    fprintf(stderr, "The decoded payload differs from the original one\n");
+    goto done;
+  }
+
+  printf("%d rounds of %d bytes, bytes_to_trytes: scalar %lf ms, dispatched %lf ms\n", BENCH_ROUNDS,
+         BENCH_PAYLOAD_LEN, encode_scalar_ms, encode_ms);
+  printf("%d rounds of %d bytes, trytes_to_bytes: scalar %lf ms, dispatched %lf ms\n", BENCH_ROUNDS,
+         BENCH_PAYLOAD_LEN, decode_scalar_ms, decode_ms);
+  ret = EXIT_SUCCESS;
+
+done:
+  free(bytes);
+  free(trytes);
+  free(decoded);
+  return ret;
+}
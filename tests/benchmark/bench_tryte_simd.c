@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include "common/model/transaction.h"
+#include "tests/common.h"
+#include "utils/tryte_simd.h"
+
+#define BENCH_ROUNDS 2000
+#define BENCH_CASES 4
+
+static double elapsed_ms(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Convert whole transactions, as serializing transaction objects and reading them from the cache do. Timings are only
+ * reported, since they depend on the machine.
+ */
+int main(void) {
+  tryte_t trytes[NUM_TRYTES_SERIALIZED_TRANSACTION];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  flex_trit_t flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+  const size_t num_trytes = NUM_TRYTES_SERIALIZED_TRANSACTION, num_trits = NUM_TRITS_SERIALIZED_TRANSACTION;
+  const char* names[BENCH_CASES] = {"flex_trits_to_trytes", "flex_trits_from_trytes", "flex_trits_to_trits",
+                                    "flex_trits_from_trits"};
+  double lib_ms[BENCH_CASES], simd_ms[BENCH_CASES];
+  size_t count = 0;
+  struct timespec start;
+
+  rand_trytes_init();
+  gen_rand_trytes(num_trytes, trytes);
+  flex_trits_from_trytes(flex_trits, num_trits, trytes, num_trytes, num_trytes);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_to_trytes(trytes, num_trytes, flex_trits, num_trits, num_trits);
+  }
+  lib_ms[0] = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_to_trytes_simd(trytes, num_trytes, flex_trits, num_trits, num_trits);
+  }
+  simd_ms[0] = elapsed_ms(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_from_trytes(flex_trits, num_trits, trytes, num_trytes, num_trytes);
+  }
+  lib_ms[1] = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_from_trytes_simd(flex_trits, num_trits, trytes, num_trytes, num_trytes);
+  }
+  simd_ms[1] = elapsed_ms(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_to_trits(trits, num_trits, flex_trits, num_trits, num_trits);
+  }
+  lib_ms[2] = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_to_trits_simd(trits, num_trits, flex_trits, num_trits, num_trits);
+  }
+  simd_ms[2] = elapsed_ms(&start);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_from_trits(flex_trits, num_trits, trits, num_trits, num_trits);
+  }
+  lib_ms[3] = elapsed_ms(&start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    count += flex_trits_from_trits_simd(flex_trits, num_trits, trits, num_trits, num_trits);
+  }
+  simd_ms[3] = elapsed_ms(&start);
+
+  // Keep the conversions from being optimized out
+  if (count == 0) {
+    fprintf(stderr, "No trits converted\n");
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 0; i < BENCH_CASES; i++) {
+    printf("%d transactions, %s: library %lf ms, SIMD %lf ms\n", BENCH_ROUNDS, names[i], lib_ms[i], simd_ms[i]);
+  }
+  return EXIT_SUCCESS;
+}
@@ -57,6 +57,16 @@ class SendTrytes(unittest.TestCase):
                   post_data=map_field(self.post_field, [self.query_string[6]]))
         self.assertEqual(STATUS_CODE_500, res["status_code"])
 
+    # Body larger than the maximum request size (fail)
+    @test_logger
+    def test_oversized_request(self):
+        if CONNECTION_METHOD == "mqtt":
+            return
+        res = API("/tryte",
+                  post_data=map_field(self.post_field, [[gen_rand_trytes(2673)] * 30]))
+        self.assertEqual(STATUS_CODE_500, res["status_code"])
+        self.assertIn("Request size exceed", res["content"])
+
     # Time statistics
     @test_logger
     def test_time_statistics(self):
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "tests/test_define.h"
+#include "utils/bloom_filter.h"
+
+#define ELEMENT_NUM 1000
+#define FALSE_POSITIVE_RATE 0.01
+
+static void element(const int idx, char* buf, const size_t len) { snprintf(buf, len, "element-%d", idx); }
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bloom_filter_init(void) {
+  bloom_filter_t filter;
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, bloom_filter_init(NULL, ELEMENT_NUM, FALSE_POSITIVE_RATE));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_WRONG_INPUT_ARG, bloom_filter_init(&filter, 0, FALSE_POSITIVE_RATE));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_WRONG_INPUT_ARG, bloom_filter_init(&filter, ELEMENT_NUM, 1));
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bloom_filter_init(&filter, ELEMENT_NUM, FALSE_POSITIVE_RATE));
+  // About 9.6 bits and 7 hashes for each element at 1% false positive rate
+  TEST_ASSERT_TRUE(filter.num_bits >= ELEMENT_NUM * 9);
+  TEST_ASSERT_EQUAL_UINT32(7, filter.num_hashes);
+  bloom_filter_destroy(&filter);
+  TEST_ASSERT_NULL(filter.bits);
+
+  // An uninitialized filter treats every element as possibly added
+  TEST_ASSERT_TRUE(bloom_filter_check(&filter, "element", strlen("element")));
+}
+
+void test_bloom_filter_no_false_negative(void) {
+  bloom_filter_t filter;
+  char buf[32];
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bloom_filter_init(&filter, ELEMENT_NUM, FALSE_POSITIVE_RATE));
+  for (int i = 0; i < ELEMENT_NUM; i++) {
+    element(i, buf, sizeof(buf));
+    bloom_filter_add(&filter, buf, strlen(buf));
+  }
+  for (int i = 0; i < ELEMENT_NUM; i++) {
+    element(i, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(bloom_filter_check(&filter, buf, strlen(buf)));
+  }
+
+  bloom_filter_reset(&filter);
+  element(0, buf, sizeof(buf));
+  TEST_ASSERT_FALSE(bloom_filter_check(&filter, buf, strlen(buf)));
+  bloom_filter_destroy(&filter);
+}
+
+void test_bloom_filter_false_positive_rate(void) {
+  bloom_filter_t filter;
+  char buf[32];
+  int false_positives = 0;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bloom_filter_init(&filter, ELEMENT_NUM, FALSE_POSITIVE_RATE));
+  for (int i = 0; i < ELEMENT_NUM; i++) {
+    element(i, buf, sizeof(buf));
+    bloom_filter_add(&filter, buf, strlen(buf));
+  }
+  for (int i = ELEMENT_NUM; i < ELEMENT_NUM * 11; i++) {
+    element(i, buf, sizeof(buf));
+    false_positives += bloom_filter_check(&filter, buf, strlen(buf));
+  }
+
+  // Allow three times of the expected rate to keep the test stable
+  TEST_ASSERT_TRUE(false_positives < ELEMENT_NUM * 10 * FALSE_POSITIVE_RATE * 3);
+  bloom_filter_destroy(&filter);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_bloom_filter_init);
+  RUN_TEST(test_bloom_filter_no_false_negative);
+  RUN_TEST(test_bloom_filter_false_positive_rate);
+
+  return UNITY_END();
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "tests/test_define.h"
+#include "utils/buffer_pool.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void pool_drain() {
+  while (buffer_pool_cached()) {
+    free(buffer_pool_alloc(0, NULL));
+  }
+}
+
+void test_buffer_pool_reuse(void) {
+  size_t capacity = 0;
+  char* buf = buffer_pool_alloc(BUFFER_POOL_MIN_CAPACITY * 4, &capacity);
+  TEST_ASSERT_NOT_NULL(buf);
+  TEST_ASSERT_TRUE(capacity >= BUFFER_POOL_MIN_CAPACITY * 4);
+
+  buffer_pool_release(buf);
+  TEST_ASSERT_EQUAL_UINT(1, buffer_pool_cached());
+
+  // A smaller request is served by the released buffer
+  TEST_ASSERT_EQUAL_PTR(buf, buffer_pool_alloc(BUFFER_POOL_MIN_CAPACITY, &capacity));
+  TEST_ASSERT_EQUAL_UINT(0, buffer_pool_cached());
+
+  // A buffer of the pool can be grown and freed as usual
+  buf = realloc(buf, BUFFER_POOL_MIN_CAPACITY * 8);
+  TEST_ASSERT_NOT_NULL(buf);
+  buffer_pool_release(buf);
+
+  // A larger request is allocated anew
+  char* large = buffer_pool_alloc(BUFFER_POOL_MIN_CAPACITY * 16, NULL);
+  TEST_ASSERT_NOT_NULL(large);
+  TEST_ASSERT_TRUE(large != buf);
+  TEST_ASSERT_EQUAL_UINT(1, buffer_pool_cached());
+  free(large);
+  pool_drain();
+}
+
+void test_buffer_pool_limits(void) {
+  char* bufs[BUFFER_POOL_SIZE + 1];
+
+  // Small and huge buffers are not kept
+  buffer_pool_release(malloc(16));
+  buffer_pool_release(malloc(BUFFER_POOL_MAX_CAPACITY * 2));
+  buffer_pool_release(NULL);
+  TEST_ASSERT_EQUAL_UINT(0, buffer_pool_cached());
+
+  for (int i = 0; i <= BUFFER_POOL_SIZE; i++) {
+    bufs[i] = malloc(BUFFER_POOL_MIN_CAPACITY * (i + 1));
+    TEST_ASSERT_NOT_NULL(bufs[i]);
+  }
+  for (int i = 0; i <= BUFFER_POOL_SIZE; i++) {
+    buffer_pool_release(bufs[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT(BUFFER_POOL_SIZE, buffer_pool_cached());
+
+  // The smallest buffer has been dropped for the largest one
+  size_t capacity = 0;
+  char* buf = buffer_pool_alloc(BUFFER_POOL_MIN_CAPACITY * (BUFFER_POOL_SIZE + 1), &capacity);
+  TEST_ASSERT_EQUAL_PTR(bufs[BUFFER_POOL_SIZE], buf);
+  free(buf);
+  pool_drain();
+}
+
+static void* thread_release(void* arg) {
+  buffer_pool_release(arg);
+  return (void*)buffer_pool_cached();
+}
+
+void test_buffer_pool_per_thread(void) {
+  pthread_t thread;
+  void* cached = NULL;
+
+  // A buffer released by another thread is kept there, and freed when the thread exits
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, thread_release, malloc(BUFFER_POOL_MIN_CAPACITY)));
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, &cached));
+  TEST_ASSERT_EQUAL_UINT(1, (size_t)cached);
+  TEST_ASSERT_EQUAL_UINT(0, buffer_pool_cached());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_buffer_pool_reuse);
+  RUN_TEST(test_buffer_pool_limits);
+  RUN_TEST(test_buffer_pool_per_thread);
+
+  return UNITY_END();
+}
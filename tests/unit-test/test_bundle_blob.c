@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "common/model/transaction.h"
+#include "tests/test_define.h"
+#include "utils/bundle_blob.h"
+#include "utils/trit_pack.h"
+
+#define TXN_NUM 3
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bundle_blob_round_trip(void) {
+  hash8019_array_p txn_array = hash8019_array_new();
+  hash8019_array_p decoded_array = hash8019_array_new();
+  for (int i = 0; i < TXN_NUM; i++) {
+    flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+    memset(txn_flex_trits, i + 1, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+    hash_array_push(txn_array, txn_flex_trits);
+  }
+
+  bundle_blob_header_t header = {.mwm = 14, .buffered_timestamp = 1585000000123, .broadcast_timestamp = 0};
+  bundle_blob_header_t decoded_header;
+  char* blob = NULL;
+  size_t blob_len = 0;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_encode(&header, txn_array, &blob, &blob_len));
+  TEST_ASSERT_EQUAL_UINT(BUNDLE_BLOB_HEADER_SIZE + TXN_NUM * TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION),
+                         blob_len);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_decode(blob, blob_len, &decoded_header, decoded_array));
+  TEST_ASSERT_EQUAL_UINT8(BUNDLE_BLOB_VERSION, decoded_header.version);
+  TEST_ASSERT_EQUAL_UINT8(header.mwm, decoded_header.mwm);
+  TEST_ASSERT_EQUAL_UINT16(TXN_NUM, decoded_header.txn_num);
+  TEST_ASSERT_EQUAL_UINT64(header.buffered_timestamp, decoded_header.buffered_timestamp);
+  TEST_ASSERT_EQUAL_UINT64(header.broadcast_timestamp, decoded_header.broadcast_timestamp);
+  TEST_ASSERT_EQUAL_INT(TXN_NUM, hash_array_len(decoded_array));
+  for (int i = 0; i < TXN_NUM; i++) {
+    TEST_ASSERT_EQUAL_MEMORY(hash_array_at(txn_array, i), hash_array_at(decoded_array, i),
+                             NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+  }
+
+  free(blob);
+  hash_array_free(txn_array);
+  hash_array_free(decoded_array);
+}
+
+void test_bundle_blob_flex_version(void) {
+  const size_t blob_len = BUNDLE_BLOB_HEADER_SIZE + NUM_FLEX_TRITS_SERIALIZED_TRANSACTION;
+  char blob[BUNDLE_BLOB_HEADER_SIZE + NUM_FLEX_TRITS_SERIALIZED_TRANSACTION] = {BUNDLE_BLOB_VERSION_FLEX, 14, 1};
+  memset(blob + BUNDLE_BLOB_HEADER_SIZE, 1, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+
+  bundle_blob_header_t header;
+  hash8019_array_p txn_array = hash8019_array_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_decode(blob, blob_len, &header, txn_array));
+  TEST_ASSERT_EQUAL_UINT8(BUNDLE_BLOB_VERSION_FLEX, header.version);
+  TEST_ASSERT_EQUAL_UINT16(1, header.txn_num);
+  TEST_ASSERT_EQUAL_MEMORY(blob + BUNDLE_BLOB_HEADER_SIZE, hash_array_at(txn_array, 0),
+                           NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+
+  hash_array_free(txn_array);
+}
+
+void test_bundle_blob_malformed(void) {
+  hash8019_array_p txn_array = hash8019_array_new();
+  flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION] = {};
+  hash_array_push(txn_array, txn_flex_trits);
+
+  bundle_blob_header_t header = {.mwm = 9};
+  char* blob = NULL;
+  size_t blob_len = 0;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, bundle_blob_encode(&header, txn_array, &blob, &blob_len));
+
+  // Truncated blob
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_BLOB_MALFORMED, bundle_blob_decode_header(blob, blob_len - 1, &header));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_BLOB_MALFORMED,
+                          bundle_blob_decode_header(blob, BUNDLE_BLOB_HEADER_SIZE - 1, &header));
+
+  // Unsupported version
+  blob[0] = BUNDLE_BLOB_VERSION + 1;
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_BLOB_MALFORMED, bundle_blob_decode_header(blob, blob_len, &header));
+
+  free(blob);
+  hash_array_free(txn_array);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_bundle_blob_round_trip);
+  RUN_TEST(test_bundle_blob_flex_version);
+  RUN_TEST(test_bundle_blob_malformed);
+
+  return UNITY_END();
+}
@@ -9,6 +9,9 @@
 #include <pthread.h>
 #include "tests/test_define.h"
 #include "utils/cache/cache.h"
+#include "utils/cache/dedup.h"
+#include "utils/cache/eviction.h"
+#include "utils/cache/fragment.h"
 #include "uuid/uuid.h"
 
 char test_uuid[UUID_STR_LEN] = {};
@@ -33,6 +36,20 @@ void test_cache_set(void) {
   TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(key, strlen(key), CACHE_VALUE, strlen(CACHE_VALUE), 0));
 }
 
+void test_cache_set_overwrite(void) {
+  char* key = test_uuid;
+  char* res = NULL;
+  const char* const value = "OVERWRITTEN";
+
+  TEST_ASSERT_EQUAL_INT(SC_CACHE_FAILED_RESPONSE, cache_set(key, strlen(key), value, strlen(value), 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set_overwrite(key, strlen(key), value, strlen(value), 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_get(key, &res));
+  TEST_ASSERT_EQUAL_STRING(value, res);
+  free(res);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set_overwrite(key, strlen(key), CACHE_VALUE, strlen(CACHE_VALUE), 0));
+}
+
 void test_cache_timeout(void) {
   char* key = test_uuid;
   char* res = NULL;
@@ -80,6 +97,234 @@ void test_cache_list_pop(void) {
   TEST_ASSERT_EQUAL_STRING(TEST_UUID, res);
 }
 
+void test_cache_list_pop_tail(void) {
+  char res[UUID_STR_LEN];
+
+  TEST_ASSERT_EQUAL_INT(
+      SC_OK, cache_list_push(TEST_UUID_LIST_NAME, strlen(TEST_UUID_LIST_NAME), TEST_UUID, strlen(TEST_UUID)));
+  TEST_ASSERT_EQUAL_INT(
+      SC_OK, cache_list_push(TEST_UUID_LIST_NAME, strlen(TEST_UUID_LIST_NAME), test_uuid, strlen(test_uuid)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_pop_tail(TEST_UUID_LIST_NAME, res));
+  TEST_ASSERT_EQUAL_STRING(TEST_UUID, res);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_remove(TEST_UUID_LIST_NAME, test_uuid, strlen(test_uuid)));
+
+  int len = -1;
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_size(TEST_UUID_LIST_NAME, &len));
+  TEST_ASSERT_EQUAL_INT(0, len);
+}
+
+void test_cache_expire(void) {
+  char* key = test_uuid;
+  char* res = NULL;
+  const int timeout = 2;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(key, strlen(key), CACHE_VALUE, strlen(CACHE_VALUE), 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_expire(key, timeout));
+  sleep(timeout + 1);
+  TEST_ASSERT_EQUAL_INT(SC_CACHE_FAILED_RESPONSE, cache_get(key, &res));
+  free(res);
+}
+
+void test_cache_eviction(void) {
+  pthread_rwlock_t rwlock;
+  const char* const list_names[] = {TEST_UUID_LIST_NAME};
+  // Values are far larger than the fluctuation of the occupied space of the cache server
+  const long int value_len = 1024 * 1024;
+  char* value = (char*)malloc(value_len);
+  cache_eviction_stats_t stats = {};
+  int evicted = 0, expired = 0;
+
+  TEST_ASSERT_NOT_NULL(value);
+  memset(value, 'A', value_len);
+  pthread_rwlock_init(&rwlock, NULL);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(TEST_UUID, strlen(TEST_UUID), value, value_len, 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_track(TEST_UUID, value_len));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(test_uuid, strlen(test_uuid), value, value_len, 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_track(test_uuid, value_len));
+
+  // Nothing is completed yet, so nothing can be evicted even if the capacity is exceeded.
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_run(&rwlock, 1, 100, list_names, 1, &evicted, &expired));
+  TEST_ASSERT_EQUAL_INT(0, evicted);
+
+  // The usage is read from the cache server, which holds both values besides its own overhead
+  const long int occupied = cache_occupied_space();
+  TEST_ASSERT_GREATER_THAN(2 * value_len, occupied);
+  cache_eviction_stats(&stats);
+  TEST_ASSERT_EQUAL_INT(2 * value_len, stats.tracked_bytes);
+  TEST_ASSERT_GREATER_THAN(0, stats.untracked_bytes);
+
+  // The older request would be evicted first, and eviction stops at the low-water mark.
+  TEST_ASSERT_EQUAL_INT(
+      SC_OK, cache_list_push(TEST_UUID_LIST_NAME, strlen(TEST_UUID_LIST_NAME), TEST_UUID, strlen(TEST_UUID)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_complete(TEST_UUID, TEST_UUID_LIST_NAME, 0));
+  TEST_ASSERT_EQUAL_INT(
+      SC_OK, cache_list_push(TEST_UUID_LIST_NAME, strlen(TEST_UUID_LIST_NAME), test_uuid, strlen(test_uuid)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_complete(test_uuid, TEST_UUID_LIST_NAME, 0));
+  TEST_ASSERT_EQUAL_INT(SC_OK,
+                        cache_eviction_run(&rwlock, occupied + 4 * value_len, 1, list_names, 1, &evicted, &expired));
+  TEST_ASSERT_EQUAL_INT(0, evicted);
+  TEST_ASSERT_EQUAL_INT(SC_OK,
+                        cache_eviction_run(&rwlock, occupied - value_len / 2, 100, list_names, 1, &evicted, &expired));
+  TEST_ASSERT_EQUAL_INT(1, evicted);
+  TEST_ASSERT_EQUAL_INT(0, expired);
+
+  char* res = NULL;
+  TEST_ASSERT_EQUAL_INT(SC_CACHE_FAILED_RESPONSE, cache_get(TEST_UUID, &res));
+  free(res);
+  bool exist = false;
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_exists(test_uuid, &exist));
+  TEST_ASSERT_TRUE(exist);
+
+  // The remaining request would be expired by TTL
+  const int ttl = 1;
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_eviction_complete(test_uuid, TEST_UUID_LIST_NAME, ttl));
+  sleep(ttl + 1);
+  TEST_ASSERT_EQUAL_INT(SC_OK,
+                        cache_eviction_run(&rwlock, occupied + 4 * value_len, 100, list_names, 1, &evicted, &expired));
+  TEST_ASSERT_EQUAL_INT(0, evicted);
+  TEST_ASSERT_EQUAL_INT(1, expired);
+
+  int len = -1;
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_size(TEST_UUID_LIST_NAME, &len));
+  TEST_ASSERT_EQUAL_INT(0, len);
+
+  cache_eviction_stats(&stats);
+  TEST_ASSERT_EQUAL_UINT64(1, stats.evicted);
+  TEST_ASSERT_EQUAL_UINT64(1, stats.expired);
+  TEST_ASSERT_EQUAL_INT(0, stats.tracked_bytes);
+
+  cache_eviction_clear();
+  pthread_rwlock_destroy(&rwlock);
+  free(value);
+}
+
+void test_cache_eviction_untracked(void) {
+  pthread_rwlock_t rwlock;
+  const char* const list_names[] = {TEST_UUID_LIST_NAME};
+  const long int value_len = 1024 * 1024;
+  char* value = (char*)malloc(value_len);
+  int evicted = 0, expired = 0;
+
+  // A request completed before restarting is only known by the cache server, but it is still evicted
+  TEST_ASSERT_NOT_NULL(value);
+  memset(value, 'A', value_len);
+  pthread_rwlock_init(&rwlock, NULL);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(TEST_UUID, strlen(TEST_UUID), value, value_len, 0));
+  TEST_ASSERT_EQUAL_INT(
+      SC_OK, cache_list_push(TEST_UUID_LIST_NAME, strlen(TEST_UUID_LIST_NAME), TEST_UUID, strlen(TEST_UUID)));
+  cache_eviction_reconcile();
+
+  const long int occupied = cache_occupied_space();
+  TEST_ASSERT_GREATER_THAN(value_len, occupied);
+  TEST_ASSERT_EQUAL_INT(SC_OK,
+                        cache_eviction_run(&rwlock, occupied - value_len / 2, 100, list_names, 1, &evicted, &expired));
+  TEST_ASSERT_EQUAL_INT(1, evicted);
+  TEST_ASSERT_TRUE(cache_occupied_space() < occupied - value_len / 2);
+
+  cache_eviction_clear();
+  pthread_rwlock_destroy(&rwlock);
+  free(value);
+}
+
+void test_cache_dedup(void) {
+  const char* const digest = "DEDUPTESTDIGEST";
+  const char* const list_name = "DEDUPTESTLIST";
+  char existing_uuid[UUID_STR_LEN] = {};
+  bool duplicated = true, exist = false;
+  const int window = 10;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_init(100));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, test_uuid, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_FALSE(duplicated);
+
+  // The content is not buffered under `test_uuid` yet, so the claim is stale
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, TEST_UUID, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_FALSE(duplicated);
+
+  // The same content is buffered under `TEST_UUID`
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_push(list_name, strlen(list_name), TEST_UUID, strlen(TEST_UUID)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, test_uuid, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_TRUE(duplicated);
+  TEST_ASSERT_EQUAL_STRING(TEST_UUID, existing_uuid);
+
+  // The claim is kept by the cache server even if the Bloom filter is lost, e.g., after restarting
+  cache_dedup_destroy();
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_init(100));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, test_uuid, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_TRUE(duplicated);
+  TEST_ASSERT_EQUAL_STRING(TEST_UUID, existing_uuid);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_release(digest));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, test_uuid, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_FALSE(duplicated);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_list_exist(list_name, TEST_UUID, strlen(TEST_UUID), &exist));
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_release(digest));
+
+  // A request which has left the buffer list, e.g. once it is broadcast, is not matched
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, TEST_UUID, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_FALSE(duplicated);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_del(list_name));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_claim(digest, test_uuid, list_name, window, existing_uuid, &duplicated));
+  TEST_ASSERT_FALSE(duplicated);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_dedup_release(digest));
+  cache_dedup_destroy();
+}
+
+void test_cache_fragment(void) {
+  const char* const key = CACHE_FRAGMENT_KEY_PREFIX TRYTES_81_1;
+  const char stale[] = {CACHE_FRAGMENT_VERSION + 1, '{', '}'};
+  char* fragment = NULL;
+  size_t len = 0;
+  bool exist = true;
+
+  TEST_ASSERT_FALSE(cache_fragment_enabled());
+  TEST_ASSERT_FALSE(cache_fragment_packed_enabled());
+  cache_fragment_init(10, 0);
+  TEST_ASSERT_TRUE(cache_fragment_enabled());
+  TEST_ASSERT_FALSE(cache_fragment_packed_enabled());
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_fragment_set(TRYTES_81_1, CACHE_VALUE, strlen(CACHE_VALUE)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_fragment_get(TRYTES_81_1, &fragment, &len));
+  TEST_ASSERT_EQUAL_INT(strlen(CACHE_VALUE), len);
+  TEST_ASSERT_EQUAL_STRING(CACHE_VALUE, fragment);
+  free(fragment);
+  fragment = NULL;
+
+  // A fragment in another format is a miss, and it is removed
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_del(key));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_set(key, strlen(key), stale, sizeof(stale), 0));
+  TEST_ASSERT_NOT_EQUAL(SC_OK, cache_fragment_get(TRYTES_81_1, &fragment, &len));
+  TEST_ASSERT_NULL(fragment);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_exists(key, &exist));
+  TEST_ASSERT_FALSE(exist);
+
+  // Packed transactions are not tied to fragments
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_fragment_set_packed(TRYTES_81_1, stale, sizeof(stale)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_exists(TRYTES_81_1, &exist));
+  TEST_ASSERT_FALSE(exist);
+  cache_fragment_init(0, 10);
+  TEST_ASSERT_FALSE(cache_fragment_enabled());
+  TEST_ASSERT_TRUE(cache_fragment_packed_enabled());
+
+  // Packed transactions are stored under the bare transaction hash
+  char* packed = NULL;
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_fragment_set_packed(TRYTES_81_1, stale, sizeof(stale)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_get_blob(TRYTES_81_1, &packed, &len));
+  TEST_ASSERT_EQUAL_INT(sizeof(stale), len);
+  TEST_ASSERT_EQUAL_MEMORY(stale, packed, len);
+  free(packed);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_del(TRYTES_81_1));
+
+  cache_fragment_init(0, 0);
+  TEST_ASSERT_FALSE(cache_fragment_packed_enabled());
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_fragment_set_packed(TRYTES_81_1, stale, sizeof(stale)));
+  TEST_ASSERT_EQUAL_INT(SC_OK, cache_exists(TRYTES_81_1, &exist));
+  TEST_ASSERT_FALSE(exist);
+}
+
 void test_cache_occupied_space() { TEST_ASSERT_GREATER_THAN(-1, cache_occupied_space()); }
 
 int main(void) {
@@ -89,12 +334,19 @@ int main(void) {
   RUN_TEST(test_generate_uuid);
   RUN_TEST(test_cache_set);
   RUN_TEST(test_cache_get);
+  RUN_TEST(test_cache_set_overwrite);
   RUN_TEST(test_cache_del);
   RUN_TEST(test_cache_timeout);
   RUN_TEST(test_cache_list_push);
   RUN_TEST(test_cache_list_at);
   RUN_TEST(test_cache_list_size);
   RUN_TEST(test_cache_list_pop);
+  RUN_TEST(test_cache_list_pop_tail);
+  RUN_TEST(test_cache_expire);
+  RUN_TEST(test_cache_eviction);
+  RUN_TEST(test_cache_eviction_untracked);
+  RUN_TEST(test_cache_dedup);
+  RUN_TEST(test_cache_fragment);
   RUN_TEST(test_cache_occupied_space);
   cache_stop(&rwlock);
   return UNITY_END();
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include <zlib.h>
+#include "brotli/decode.h"
+#include "connectivity/http/compress.h"
+#include "tests/common.h"
+#include "tests/test_define.h"
+
+#define RESPONSE_TRYTES 27000
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static char* rand_response() {
+  // A JSON array of tryte strings, like the response of transaction objects
+  char* response = (char*)malloc(RESPONSE_TRYTES + RESPONSE_TRYTES / NUM_TRYTES_HASH * 3 + 3);
+  size_t len = 0;
+  response[len++] = '[';
+  for (int i = 0; i < RESPONSE_TRYTES / NUM_TRYTES_HASH; i++) {
+    if (i) {
+      response[len++] = ',';
+    }
+    response[len++] = '"';
+    gen_rand_trytes(NUM_TRYTES_HASH, (tryte_t*)response + len);
+    len += NUM_TRYTES_HASH;
+    response[len++] = '"';
+  }
+  response[len++] = ']';
+  response[len] = '\0';
+  return response;
+}
+
+void test_accept_encoding(void) {
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_IDENTITY, http_accept_encoding(NULL));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_IDENTITY, http_accept_encoding(""));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_IDENTITY, http_accept_encoding("identity, deflate"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_GZIP, http_accept_encoding("gzip"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_GZIP, http_accept_encoding("deflate, GZIP"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_BR, http_accept_encoding("gzip, deflate, br"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_BR, http_accept_encoding("*"));
+  // Quality values
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_GZIP, http_accept_encoding("br;q=0.5, gzip;q=0.8"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_GZIP, http_accept_encoding("br; q=0, *"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_IDENTITY, http_accept_encoding("gzip;q=0, br;q=0.000"));
+  TEST_ASSERT_EQUAL_INT(HTTP_ENCODING_IDENTITY, http_accept_encoding("*;q=0"));
+}
+
+void test_header_quality(void) {
+  const char accept[] = "application/json;q=0.5, Application/CBOR, text/plain; charset=utf-8; q=0, */*;q=0.1";
+  TEST_ASSERT_TRUE(http_header_quality(NULL, "application/json") < 0);
+  TEST_ASSERT_TRUE(http_header_quality("", "application/json") < 0);
+  TEST_ASSERT_TRUE(http_header_quality(accept, "application/json") == 0.5);
+  TEST_ASSERT_TRUE(http_header_quality(accept, "application/cbor") == 1);
+  TEST_ASSERT_TRUE(http_header_quality(accept, "text/plain") == 0);
+  TEST_ASSERT_TRUE(http_header_quality(accept, "*/*") == 0.1);
+  // Only the whole token matches
+  TEST_ASSERT_TRUE(http_header_quality(accept, "application/") < 0);
+  TEST_ASSERT_TRUE(http_header_quality(accept, "application/json-seq") < 0);
+}
+
+void test_compress_gzip(void) {
+  char* response = rand_response();
+  const size_t len = strlen(response);
+  char* compressed = NULL;
+  size_t compressed_len = 0;
+  char* inflated = malloc(len + 1);
+
+  // The stream of this thread is reset for the same level and initialized again for another level
+  for (int level = 1; level <= 9; level += 4) {
+    for (int i = 0; i < 2; i++) {
+      TEST_ASSERT_EQUAL_INT32(SC_OK,
+                              http_compress(HTTP_ENCODING_GZIP, level, response, len, &compressed, &compressed_len));
+      TEST_ASSERT_TRUE(compressed_len < len * 7 / 10);
+      TEST_ASSERT_EQUAL_HEX8(0x1f, (uint8_t)compressed[0]);
+      TEST_ASSERT_EQUAL_HEX8(0x8b, (uint8_t)compressed[1]);
+
+      z_stream stream = {0};
+      TEST_ASSERT_EQUAL_INT(Z_OK, inflateInit2(&stream, 15 + 16));
+      stream.next_in = (Bytef*)compressed;
+      stream.avail_in = compressed_len;
+      stream.next_out = (Bytef*)inflated;
+      stream.avail_out = len + 1;
+      TEST_ASSERT_EQUAL_INT(Z_STREAM_END, inflate(&stream, Z_FINISH));
+      TEST_ASSERT_EQUAL_UINT(len, stream.total_out);
+      TEST_ASSERT_EQUAL_MEMORY(response, inflated, len);
+      inflateEnd(&stream);
+      free(compressed);
+    }
+  }
+
+  free(inflated);
+  free(response);
+}
+
+void test_compress_br(void) {
+  char* response = rand_response();
+  const size_t len = strlen(response);
+  char* compressed = NULL;
+  size_t compressed_len = 0;
+  char* decoded = malloc(len);
+  size_t decoded_len = len;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, http_compress(HTTP_ENCODING_BR, 5, response, len, &compressed, &compressed_len));
+  TEST_ASSERT_TRUE(compressed_len < len * 7 / 10);
+  TEST_ASSERT_EQUAL_INT(BROTLI_DECODER_RESULT_SUCCESS,
+                        BrotliDecoderDecompress(compressed_len, (const uint8_t*)compressed, &decoded_len,
+                                                (uint8_t*)decoded));
+  TEST_ASSERT_EQUAL_UINT(len, decoded_len);
+  TEST_ASSERT_EQUAL_MEMORY(response, decoded, len);
+
+  free(compressed);
+  free(decoded);
+  free(response);
+}
+
+void test_compress_invalid(void) {
+  const char* trytes = TRYTES_81_1;
+  char* compressed = NULL;
+  size_t compressed_len = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_HTTP_COMPRESS_ERROR,
+                          http_compress(HTTP_ENCODING_GZIP, 0, trytes, NUM_TRYTES_HASH, &compressed, &compressed_len));
+  TEST_ASSERT_EQUAL_INT32(SC_HTTP_COMPRESS_ERROR,
+                          http_compress(HTTP_ENCODING_BR, 10, trytes, NUM_TRYTES_HASH, &compressed, &compressed_len));
+  TEST_ASSERT_EQUAL_INT32(SC_HTTP_COMPRESS_ERROR, http_compress(HTTP_ENCODING_IDENTITY, 5, trytes, NUM_TRYTES_HASH,
+                                                                &compressed, &compressed_len));
+  TEST_ASSERT_NULL(compressed);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_accept_encoding);
+  RUN_TEST(test_header_quality);
+  RUN_TEST(test_compress_gzip);
+  RUN_TEST(test_compress_br);
+  RUN_TEST(test_compress_invalid);
+
+  return UNITY_END();
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include "tests/test_define.h"
+#include "utils/json_reader.h"
+
+#define LONG_STR_NUM 20
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_json_reader_nested(void) {
+  const char* json = " { \"a\" : [1, -2.5e1, {}, [], null, true, false] ,\"b\":{\"c\":\"" TRYTES_81_1 "\"},\"d\":7}\n";
+  json_reader_t reader;
+  char *key = NULL, *str = NULL;
+  size_t len = 0;
+  bool more = false;
+  double number = 0;
+  int value = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, json));
+  TEST_ASSERT_EQUAL_INT(JSON_READER_OBJECT, json_reader_peek(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_object_begin(&reader));
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_object_next(&reader, &key));
+  TEST_ASSERT_EQUAL_STRING("a", key);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_begin(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_TRUE(more);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_int(&reader, &value));
+  TEST_ASSERT_EQUAL_INT(1, value);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT(JSON_READER_NUMBER, json_reader_peek(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_number(&reader, &number));
+  TEST_ASSERT_TRUE(number == -25);
+  const json_reader_type_t types[] = {JSON_READER_OBJECT, JSON_READER_ARRAY, JSON_READER_NULL, JSON_READER_BOOL,
+                                      JSON_READER_BOOL};
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+    TEST_ASSERT_TRUE(more);
+    TEST_ASSERT_EQUAL_INT(types[i], json_reader_peek(&reader));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_skip(&reader));
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_FALSE(more);
+
+  // A nested object is skipped as a whole
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_object_next(&reader, &key));
+  TEST_ASSERT_EQUAL_STRING("b", key);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_skip(&reader));
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_object_next(&reader, &key));
+  TEST_ASSERT_EQUAL_STRING("d", key);
+  TEST_ASSERT_EQUAL_INT(JSON_READER_NUMBER, json_reader_peek(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_int(&reader, &value));
+  TEST_ASSERT_EQUAL_INT(7, value);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_object_next(&reader, &key));
+  TEST_ASSERT_NULL(key);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_finish(&reader));
+  json_reader_destroy(&reader);
+
+  // Strings are read in place
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, "[\"" TRYTES_81_1 "\",\"\"]"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_begin(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_string(&reader, &str, &len));
+  TEST_ASSERT_EQUAL_UINT(NUM_TRYTES_HASH, len);
+  TEST_ASSERT_EQUAL_STRING(TRYTES_81_1, str);
+  TEST_ASSERT_TRUE(str > reader.data && str < reader.cur);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_string(&reader, &str, &len));
+  TEST_ASSERT_EQUAL_UINT(0, len);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_FALSE(more);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_finish(&reader));
+  json_reader_destroy(&reader);
+}
+
+void test_json_reader_escape(void) {
+  const char* json =
+      "\"quote \\\" backslash \\\\ slash \\/ \\b\\f\\n\\r\\t \\u0041\\u00e9\\u53F0\\ud83d\\ude00 and a long tail\"";
+  const char* str_expected =
+      "quote \" backslash \\ slash / \b\f\n\r\t A\xc3\xa9\xe5\x8f\xb0\xf0\x9f\x98\x80 and a long tail";
+  json_reader_t reader;
+  char* str = NULL;
+  size_t len = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, json));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_string(&reader, &str, &len));
+  TEST_ASSERT_EQUAL_UINT(strlen(str_expected), len);
+  TEST_ASSERT_EQUAL_STRING(str_expected, str);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_finish(&reader));
+  json_reader_destroy(&reader);
+}
+
+void test_json_reader_long_strings(void) {
+  // Transaction trytes, which are the largest strings in requests
+  char json[LONG_STR_NUM * (NUM_TRYTES_SERIALIZED_TRANSACTION + 3) + 3] = {};
+  size_t json_len = 0;
+  json_reader_t reader;
+  char* str = NULL;
+  size_t len = 0;
+  bool more = false;
+
+  json[json_len++] = '[';
+  for (int i = 0; i < LONG_STR_NUM; i++) {
+    json[json_len++] = i ? ',' : ' ';
+    json[json_len++] = '"';
+    memset(json + json_len, 'A' + i, NUM_TRYTES_SERIALIZED_TRANSACTION);
+    json_len += NUM_TRYTES_SERIALIZED_TRANSACTION;
+    json[json_len++] = '"';
+  }
+  json[json_len++] = ']';
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, json));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_begin(&reader));
+  for (int i = 0; i < LONG_STR_NUM; i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+    TEST_ASSERT_TRUE(more);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_string(&reader, &str, &len));
+    TEST_ASSERT_EQUAL_UINT(NUM_TRYTES_SERIALIZED_TRANSACTION, len);
+    TEST_ASSERT_EQUAL_MEMORY(json + 3 + i * (NUM_TRYTES_SERIALIZED_TRANSACTION + 3), str, len);
+    TEST_ASSERT_EQUAL_INT('\0', str[len]);
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_FALSE(more);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_finish(&reader));
+  json_reader_destroy(&reader);
+}
+
+void test_json_reader_int_saturated(void) {
+  json_reader_t reader;
+  bool more = false;
+  int value = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, "[1e100,-1e100,-0.9]"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_begin(&reader));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_int(&reader, &value));
+  TEST_ASSERT_EQUAL_INT(INT_MAX, value);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_int(&reader, &value));
+  TEST_ASSERT_EQUAL_INT(INT_MIN, value);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_array_next(&reader, &more));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_int(&reader, &value));
+  TEST_ASSERT_EQUAL_INT(0, value);
+  json_reader_destroy(&reader);
+}
+
+void test_json_reader_malformed(void) {
+  const char* malformed[] = {
+      // Structure
+      "", "{", "{\"a\"}", "{\"a\":1,}", "{,\"a\":1}", "[1,]", "[1 2]", "{'a':1}", "{\"a\" 1}", "{\"a\":1}}", "[] []",
+      // Literals and numbers
+      "[tru]", "[nul]", "{\"a\":01}", "[-]", "[1.]", "[1e]", "[0x10]",
+      // Strings
+      "\"\\x\"", "\"\\u12\"", "\"\\udc00\"", "\"\\ud800x\"", "\"tab\tin\"", "\"unended",
+  };
+  json_reader_t reader;
+
+  for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, malformed[i]));
+    status_t ret = json_reader_skip(&reader);
+    if (ret == SC_OK) {
+      ret = json_reader_finish(&reader);
+    }
+    TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_PARSE, ret);
+    json_reader_destroy(&reader);
+  }
+
+  // Nesting is limited while skipping
+  char deep[JSON_READER_MAX_DEPTH * 2 + 5] = {};
+  memset(deep, '[', JSON_READER_MAX_DEPTH + 2);
+  memset(deep + JSON_READER_MAX_DEPTH + 2, ']', JSON_READER_MAX_DEPTH + 2);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_reader_init(&reader, deep));
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_PARSE, json_reader_skip(&reader));
+  json_reader_destroy(&reader);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_json_reader_nested);
+  RUN_TEST(test_json_reader_escape);
+  RUN_TEST(test_json_reader_long_strings);
+  RUN_TEST(test_json_reader_int_saturated);
+  RUN_TEST(test_json_reader_malformed);
+
+  return UNITY_END();
+}
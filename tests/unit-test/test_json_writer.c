@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+#include "tests/test_define.h"
+#include "utils/json_writer.h"
+
+void test_json_writer_nested(void) {
+  const char* json = "{\"a\":[1,-2,{}],\"b\":{\"c\":[]},\"d\":\"" TRYTES_81_1 "\",\"e\":\"\"}";
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  json_writer_t writer;
+  char* json_result = NULL;
+
+  // A small initial buffer makes the writer grow several times
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 1));
+  json_writer_object_begin(&writer);
+  json_writer_key(&writer, "a");
+  json_writer_array_begin(&writer);
+  json_writer_int(&writer, 1);
+  json_writer_int(&writer, -2);
+  json_writer_object_begin(&writer);
+  json_writer_object_end(&writer);
+  json_writer_array_end(&writer);
+  json_writer_key(&writer, "b");
+  json_writer_object_begin(&writer);
+  json_writer_key(&writer, "c");
+  json_writer_array_begin(&writer);
+  json_writer_array_end(&writer);
+  json_writer_object_end(&writer);
+  json_writer_key(&writer, "d");
+  json_writer_trytes(&writer, hash_trits, NUM_TRITS_HASH);
+  json_writer_key(&writer, "e");
+  json_writer_string(&writer, "");
+  json_writer_object_end(&writer);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_finish(&writer, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  free(json_result);
+}
+
+void test_json_writer_same_as_cjson(void) {
+  const char* str = "quote \" backslash \\ slash / \b\f\n\r\t \x01\x1f UTF-8 \xe5\x8f\xb0";
+  const int64_t values[] = {0, -1, INT32_MAX, INT32_MIN, 1573000000000, -2779530283277761};
+  cJSON* json_root = cJSON_CreateObject();
+  cJSON* json_array = cJSON_CreateArray();
+  json_writer_t writer;
+  char* json_result = NULL;
+
+  cJSON_AddStringToObject(json_root, "str", str);
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    cJSON_AddItemToArray(json_array, cJSON_CreateNumber(values[i]));
+  }
+  cJSON_AddItemToObject(json_root, "values", json_array);
+  char* json = cJSON_PrintUnformatted(json_root);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 0));
+  json_writer_object_begin(&writer);
+  json_writer_key(&writer, "str");
+  json_writer_string(&writer, str);
+  json_writer_key(&writer, "values");
+  json_writer_array_begin(&writer);
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    json_writer_int(&writer, values[i]);
+  }
+  json_writer_array_end(&writer);
+  json_writer_object_end(&writer);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_finish(&writer, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  cJSON_Delete(json_root);
+  free(json);
+  free(json_result);
+}
+
+void test_json_writer_unbalanced(void) {
+  json_writer_t writer;
+  char* json_result = NULL;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 0));
+  json_writer_array_begin(&writer);
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_CREATE, json_writer_finish(&writer, &json_result));
+  TEST_ASSERT_NULL(json_result);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 0));
+  json_writer_array_end(&writer);
+  // Writes after an error are ignored
+  json_writer_array_begin(&writer);
+  json_writer_array_end(&writer);
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_CREATE, json_writer_finish(&writer, &json_result));
+  TEST_ASSERT_NULL(json_result);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 0));
+  for (int i = 0; i <= JSON_WRITER_MAX_DEPTH; i++) {
+    json_writer_array_begin(&writer);
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_CREATE, writer.status);
+  json_writer_destroy(&writer);
+}
+
+void test_json_writer_raw(void) {
+  const char* fragments[] = {"{\"a\":1}", "{\"b\":\"c\"}"};
+  json_writer_t writer;
+  char* json_result = NULL;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 1));
+  json_writer_object_begin(&writer);
+  json_writer_key(&writer, "items");
+  json_writer_array_begin(&writer);
+  for (size_t i = 0; i < sizeof(fragments) / sizeof(fragments[0]); i++) {
+    json_writer_raw(&writer, fragments[i], strlen(fragments[i]));
+  }
+  json_writer_array_end(&writer);
+  json_writer_object_end(&writer);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_finish(&writer, &json_result));
+  TEST_ASSERT_EQUAL_STRING("{\"items\":[{\"a\":1},{\"b\":\"c\"}]}", json_result);
+  free(json_result);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, 0));
+  json_writer_raw(&writer, "", 0);
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, json_writer_finish(&writer, &json_result));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_json_writer_nested);
+  RUN_TEST(test_json_writer_same_as_cjson);
+  RUN_TEST(test_json_writer_unbalanced);
+  RUN_TEST(test_json_writer_raw);
+
+  return UNITY_END();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "accelerator/core/mam_watcher.h"
+#include "connectivity/mqtt/mam_push.h"
+#include "tests/test_define.h"
+
+// No broker listens on the port
+#define TEST_UNREACHABLE_PORT 1
+
+static const char chid[] = "QFAJMRKKNGKJOAHKDUAFKGTNZJIZIAJQXJGTHJIDWZMSFNWUWSPETKCSJHGXWDYMNMAKPTSFFUCZXDBHL";
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_mam_push_topic(void) {
+  char* topic = NULL;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mqtt_mam_push_topic("root/topics", chid, &topic));
+  TEST_ASSERT_EQUAL_STRING(
+      "root/topics/mam/QFAJMRKKNGKJOAHKDUAFKGTNZJIZIAJQXJGTHJIDWZMSFNWUWSPETKCSJHGXWDYMNMAKPTSFFUCZXDBHL", topic);
+  free(topic);
+
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, mqtt_mam_push_topic(NULL, chid, &topic));
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, mqtt_mam_push_topic("root/topics", NULL, &topic));
+}
+
+void test_mam_push_broker_unreachable(void) {
+  ta_core_t core;
+  mosq_config_t cfg;
+  memset(&core, 0, sizeof(ta_core_t));
+  ta_set_iota_client_service(&core.iota_service, "localhost", 14265, NULL);
+  init_mosq_config(&cfg, client_duplex);
+  cfg.general_config->host = strdup("localhost");
+  cfg.general_config->port = TEST_UNREACHABLE_PORT;
+
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, mqtt_mam_push_start(&core, NULL));
+  TEST_ASSERT_EQUAL_INT32(SC_MQTT_CONNECT, mqtt_mam_push_start(&core, &cfg));
+
+  // Channels cannot be subscribed without the publishing client
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_FAILED_INIT, mam_watcher_watch(chid, "client_a"));
+  mqtt_mam_push_stop();
+
+  mosq_config_free(&cfg);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  mosquitto_lib_init();
+
+  RUN_TEST(test_mam_push_topic);
+  RUN_TEST(test_mam_push_broker_unreachable);
+
+  mosquitto_lib_cleanup();
+  return UNITY_END();
+}
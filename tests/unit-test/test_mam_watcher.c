@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "accelerator/core/mam_watcher.h"
+#include "tests/test_define.h"
+
+// Channels are never polled within a test
+#define TEST_WATCH_PERIOD 3600000
+
+static const char tryte_alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static iota_config_t iconf;
+static iota_client_service_t service;
+static int pushed = 0;
+
+// Channels read by the watcher, instead of reading them from the full node
+static struct read_stub_s {
+  status_t ret;                           /**< Status of reading a channel */
+  char cursor[NUM_TRYTES_HASH + 1];       /**< Cursor after the read messages */
+  char chid1[NUM_TRYTES_ADDRESS + 1];     /**< Announced channel */
+  char last_chid[NUM_TRYTES_ADDRESS + 1]; /**< Channel read last time */
+  char last_since[NUM_TRYTES_HASH + 1];   /**< `since` of the last read. Empty if none is given. */
+} read_stub;
+
+static void push_count(char const* const chid, char const* const message, void* const arg) {
+  (void)chid;
+  (void)message;
+  (void)arg;
+  pushed++;
+}
+
+static status_t read_channel(char const* const chid, char const* const since, const bool skip,
+                             ta_recv_mam_res_t* const res) {
+  // Channels are empty when they are watched
+  if (skip) {
+    return SC_CCLIENT_NOT_FOUND;
+  }
+  strncpy(read_stub.last_chid, chid, NUM_TRYTES_ADDRESS);
+  strncpy(read_stub.last_since, since ? since : "", NUM_TRYTES_HASH);
+
+  // A failed read may still decode some of the messages
+  const char* payload = "MESSAGE";
+  utarray_push_back(res->payload_array, &payload);
+  strncpy(res->cursor, read_stub.cursor, NUM_TRYTES_HASH);
+  strncpy(res->chid1, read_stub.chid1, NUM_TRYTES_ADDRESS);
+  return read_stub.ret;
+}
+
+static void gen_chid(const int idx, char* chid) {
+  memset(chid, '9', NUM_TRYTES_ADDRESS);
+  chid[NUM_TRYTES_ADDRESS] = '\0';
+  chid[0] = tryte_alphabet[idx % 27];
+  chid[1] = tryte_alphabet[(idx / 27) % 27];
+  chid[2] = tryte_alphabet[(idx / 729) % 27];
+}
+
+void setUp(void) {
+  pushed = 0;
+  memset(&read_stub, 0, sizeof(read_stub));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_init(&iconf, &service, TEST_WATCH_PERIOD, push_count, NULL));
+}
+
+void tearDown(void) { mam_watcher_destroy(); }
+
+void test_mam_watcher_not_started(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+  gen_chid(0, chid);
+
+  mam_watcher_destroy();
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_FAILED_INIT, mam_watcher_watch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(chid, "client_a"));
+}
+
+void test_mam_watcher_invalid_input(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+  char long_id[MAM_WATCH_CLIENT_ID_LEN + 2];
+  gen_chid(0, chid);
+  memset(long_id, 'a', MAM_WATCH_CLIENT_ID_LEN + 1);
+  long_id[MAM_WATCH_CLIENT_ID_LEN + 1] = '\0';
+
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_INVAID_CHID_OR_EPID, mam_watcher_watch("ABC", "client_a"));
+  chid[0] = 'a';
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_INVAID_CHID_OR_EPID, mam_watcher_watch(chid, "client_a"));
+  gen_chid(0, chid);
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_INVALID_CLIENT_ID, mam_watcher_watch(chid, ""));
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_INVALID_CLIENT_ID, mam_watcher_watch(chid, long_id));
+  long_id[MAM_WATCH_CLIENT_ID_LEN] = '\0';
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, long_id));
+}
+
+void test_mam_watcher_unwatch_own_subscription(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+  gen_chid(1, chid);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_b"));
+
+  // Another client cannot drop the subscriptions
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(chid, "client_c"));
+
+  // Subscribing twice is a single subscription
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(chid, "client_a"));
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(chid, "client_b"));
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(chid, "client_b"));
+}
+
+void test_mam_watcher_release(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+
+  for (int i = 0; i < MAM_WATCH_MAX; i++) {
+    gen_chid(i, chid);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_a"));
+  }
+  gen_chid(0, chid);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_b"));
+  gen_chid(MAM_WATCH_MAX, chid);
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_WATCH_LIMIT, mam_watcher_watch(chid, "client_b"));
+
+  // The channels of a disconnected client are no longer watched, except the ones other clients subscribe to
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_release("client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_b"));
+  for (int i = 0; i < MAM_WATCH_MAX; i++) {
+    gen_chid(i, chid);
+    TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(chid, "client_a"));
+  }
+  gen_chid(0, chid);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(chid, "client_b"));
+
+  // Releasing a client without subscriptions does nothing
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_release("client_a"));
+}
+
+void test_mam_watcher_failed_poll(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1];
+  gen_chid(2, chid);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_a"));
+  mam_watcher_poll();
+
+  strncpy(read_stub.cursor, TRYTES_81_1, NUM_TRYTES_HASH);
+  mam_watcher_poll();
+  TEST_ASSERT_EQUAL_STRING(chid, read_stub.last_chid);
+  TEST_ASSERT_EQUAL_STRING("", read_stub.last_since);
+  TEST_ASSERT_EQUAL_INT(1, pushed);
+
+  // The messages of a failed poll are neither pushed nor skipped
+  read_stub.ret = SC_CCLIENT_FAILED_RESPONSE;
+  strncpy(read_stub.cursor, TRYTES_81_2, NUM_TRYTES_HASH);
+  mam_watcher_poll();
+  TEST_ASSERT_EQUAL_INT(1, pushed);
+
+  read_stub.ret = SC_OK;
+  mam_watcher_poll();
+  TEST_ASSERT_EQUAL_STRING(TRYTES_81_1, read_stub.last_since);
+  TEST_ASSERT_EQUAL_INT(2, pushed);
+  mam_watcher_poll();
+  TEST_ASSERT_EQUAL_STRING(TRYTES_81_2, read_stub.last_since);
+}
+
+void test_mam_watcher_follow_announced_channel(void) {
+  char chid[NUM_TRYTES_ADDRESS + 1], next_chid[NUM_TRYTES_ADDRESS + 1];
+  gen_chid(3, chid);
+  gen_chid(4, next_chid);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_watch(chid, "client_b"));
+  mam_watcher_poll();
+
+  strncpy(read_stub.cursor, TRYTES_81_1, NUM_TRYTES_HASH);
+  strncpy(read_stub.chid1, next_chid, NUM_TRYTES_ADDRESS);
+  mam_watcher_poll();
+
+  // The announced channel is read from its start
+  memset(read_stub.chid1, 0, sizeof(read_stub.chid1));
+  memset(read_stub.last_chid, 0, sizeof(read_stub.last_chid));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(chid, "client_b"));
+  mam_watcher_poll();
+  TEST_ASSERT_EQUAL_STRING(next_chid, read_stub.last_chid);
+  TEST_ASSERT_EQUAL_STRING("", read_stub.last_since);
+
+  // Every subscriber of the announcing channel subscribes to the announced one
+  TEST_ASSERT_EQUAL_INT32(SC_MAM_NOT_FOUND, mam_watcher_unwatch(next_chid, "client_c"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(next_chid, "client_a"));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mam_watcher_unwatch(next_chid, "client_b"));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  ta_set_iota_client_service(&service, "localhost", 14265, NULL);
+  mam_watcher_set_reader(read_channel);
+
+  RUN_TEST(test_mam_watcher_not_started);
+  RUN_TEST(test_mam_watcher_invalid_input);
+  RUN_TEST(test_mam_watcher_unwatch_own_subscription);
+  RUN_TEST(test_mam_watcher_release);
+  RUN_TEST(test_mam_watcher_failed_poll);
+  RUN_TEST(test_mam_watcher_follow_announced_channel);
+
+  return UNITY_END();
+}
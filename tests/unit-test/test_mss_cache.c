@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <dirent.h>
+#include <unistd.h>
+#include "accelerator/core/mss_cache.h"
+#include "tests/test_define.h"
+
+#define TEST_DEPTH 3
+#define TEST_CHANNEL_NUM 3
+
+static char store_dir[] = "/tmp/ta_mss_XXXXXX";
+static const tryte_t seed[] = "CSEEDOFMSSCACHE9TESTCSEEDOFMSSCACHE9TESTCSEEDOFMSSCACHE9TESTCSEEDOFMSSCACHE9TEST9";
+
+static void remove_store() {
+  char path[FILENAME_MAX];
+  DIR* dir = opendir(store_dir);
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strstr(entry->d_name, MSS_CACHE_SUFFIX)) {
+      snprintf(path, sizeof(path), "%s/%s", store_dir, entry->d_name);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+}
+
+/**
+ * Create channels with the MSS cache, and compare them with the channels created without it.
+ */
+static void expect_channels(const int num) {
+  mam_api_t plain, cached;
+  tryte_t plain_chid[MAM_CHANNEL_ID_TRYTE_SIZE], cached_chid[MAM_CHANNEL_ID_TRYTE_SIZE];
+  TEST_ASSERT_EQUAL_INT(RC_OK, mam_api_init(&plain, seed));
+  TEST_ASSERT_EQUAL_INT(RC_OK, mam_api_init(&cached, seed));
+
+  for (int i = 0; i < num; i++) {
+    TEST_ASSERT_EQUAL_INT(RC_OK, mam_api_channel_create(&plain, TEST_DEPTH, plain_chid));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_channel_create(&cached, TEST_DEPTH, cached_chid));
+    TEST_ASSERT_EQUAL_MEMORY(plain_chid, cached_chid, MAM_CHANNEL_ID_TRYTE_SIZE);
+  }
+  TEST_ASSERT_EQUAL_INT(plain.channel_ord, cached.channel_ord);
+  TEST_ASSERT_EQUAL_UINT(mam_channel_t_set_size(plain.channels), mam_channel_t_set_size(cached.channels));
+
+  mam_api_destroy(&plain);
+  mam_api_destroy(&cached);
+}
+
+static void test_mss_cache_memory(void) {
+  mss_cache_stats_t before, after;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_init(MSS_CACHE_CAPACITY, NULL));
+
+  mss_cache_stats(&before);
+  expect_channels(TEST_CHANNEL_NUM);
+  mss_cache_stats(&after);
+  TEST_ASSERT_EQUAL_UINT64(before.misses + TEST_CHANNEL_NUM, after.misses);
+
+  expect_channels(TEST_CHANNEL_NUM);
+  mss_cache_stats(&before);
+  TEST_ASSERT_EQUAL_UINT64(after.hits + TEST_CHANNEL_NUM, before.hits);
+  TEST_ASSERT_EQUAL_UINT64(after.misses, before.misses);
+
+  mss_cache_destroy();
+}
+
+static void test_mss_cache_eviction(void) {
+  mss_cache_stats_t before, after;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_init(1, NULL));
+
+  // Only the last channel is kept, so creating the channels from the beginning misses every time
+  mss_cache_stats(&before);
+  expect_channels(TEST_CHANNEL_NUM);
+  expect_channels(TEST_CHANNEL_NUM);
+  mss_cache_stats(&after);
+  TEST_ASSERT_EQUAL_UINT64(before.hits, after.hits);
+  TEST_ASSERT_EQUAL_UINT64(before.misses + 2 * TEST_CHANNEL_NUM, after.misses);
+
+  mss_cache_destroy();
+}
+
+static void test_mss_cache_store(void) {
+  mss_cache_stats_t before, after;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_init(MSS_CACHE_CAPACITY, store_dir));
+  expect_channels(TEST_CHANNEL_NUM);
+  mss_cache_destroy();
+
+  // Channels generated before restarting are read from the store directory
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_init(MSS_CACHE_CAPACITY, store_dir));
+  mss_cache_stats(&before);
+  expect_channels(TEST_CHANNEL_NUM);
+  mss_cache_stats(&after);
+  TEST_ASSERT_EQUAL_UINT64(before.disk_hits + TEST_CHANNEL_NUM, after.disk_hits);
+  TEST_ASSERT_EQUAL_UINT64(before.misses, after.misses);
+  mss_cache_destroy();
+
+  remove_store();
+}
+
+static void test_mss_cache_prefetch(void) {
+  mss_cache_stats_t before, after;
+  mam_api_t api;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, mss_cache_init(MSS_CACHE_CAPACITY, NULL));
+  TEST_ASSERT_EQUAL_INT(RC_OK, mam_api_init(&api, seed));
+  mss_cache_stats(&before);
+
+  // Nothing is prefetched while many keys remain
+  mss_cache_prefetch(&api, TEST_DEPTH, 1 << TEST_DEPTH);
+  mss_cache_prefetch(&api, TEST_DEPTH, 1);
+  for (int i = 0; i < 1000; i++) {
+    mss_cache_stats(&after);
+    if (after.prefetched > before.prefetched) {
+      break;
+    }
+    usleep(10000);
+  }
+  TEST_ASSERT_EQUAL_UINT64(before.prefetched + 1, after.prefetched);
+
+  // The prefetched channel is found in memory
+  expect_channels(1);
+  mss_cache_stats(&after);
+  TEST_ASSERT_EQUAL_UINT64(before.hits + 1, after.hits);
+  TEST_ASSERT_EQUAL_UINT64(before.misses, after.misses);
+
+  mam_api_destroy(&api);
+  mss_cache_destroy();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  if (mkdtemp(store_dir) == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  RUN_TEST(test_mss_cache_memory);
+  RUN_TEST(test_mss_cache_eviction);
+  RUN_TEST(test_mss_cache_store);
+  RUN_TEST(test_mss_cache_prefetch);
+
+  rmdir(store_dir);
+  return UNITY_END();
+}
@@ -9,10 +9,55 @@
 #ifdef MQTT_ENABLE
 #include "connectivity/mqtt/mqtt_common.h"
 #endif
+#include "accelerator/core/serializer/ser_helper.h"
 #include "accelerator/core/serializer/serializer.h"
 #include "tests/common.h"
 #include "tests/test_define.h"
 
+#define WRITER_TXN_NUM 100
+#define CBOR_TXN_NUM 10
+#define READER_TRYTES_NUM 20
+
+static void rand_flex_trits(flex_trit_t* flex_trits, const size_t num_trytes) {
+  tryte_t trytes[NUM_TRYTES_SIGNATURE];
+  gen_rand_trytes(num_trytes, trytes);
+  flex_trits_from_trytes(flex_trits, num_trytes * 3, trytes, num_trytes, num_trytes);
+}
+
+static transaction_array_t* rand_transaction_array(const int num) {
+  flex_trit_t msg_trits[FLEX_TRIT_SIZE_6561], tag_trits[FLEX_TRIT_SIZE_81], hash_trits[FLEX_TRIT_SIZE_243];
+  transaction_array_t* txn_array = transaction_array_new();
+
+  for (int i = 0; i < num; i++) {
+    iota_transaction_t* txn = transaction_new();
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_hash(txn, hash_trits);
+    rand_flex_trits(msg_trits, NUM_TRYTES_SIGNATURE);
+    transaction_set_signature(txn, msg_trits);
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_address(txn, hash_trits);
+    transaction_set_value(txn, rand() - RAND_MAX / 2);
+    rand_flex_trits(tag_trits, NUM_TRYTES_TAG);
+    transaction_set_obsolete_tag(txn, tag_trits);
+    transaction_set_timestamp(txn, TIMESTAMP + i);
+    transaction_set_current_index(txn, i);
+    transaction_set_last_index(txn, num - 1);
+    rand_flex_trits(hash_trits, NUM_TRYTES_HASH);
+    transaction_set_bundle(txn, hash_trits);
+    transaction_set_trunk(txn, hash_trits);
+    transaction_set_branch(txn, hash_trits);
+    transaction_set_tag(txn, tag_trits);
+    transaction_set_attachment_timestamp(txn, TIMESTAMP * 1000LL + i);
+    transaction_set_attachment_timestamp_lower(txn, 0);
+    transaction_set_attachment_timestamp_upper(txn, 3812798742493LL);
+    rand_flex_trits(tag_trits, NUM_TRYTES_NONCE);
+    transaction_set_nonce(txn, tag_trits);
+    transaction_array_push_back(txn_array, txn);
+    transaction_free(txn);
+  }
+  return txn_array;
+}
+
 void test_ta_send_transfer_req_deserialize(void) {
   const char* json_template =
       "{\"value\":100,"
@@ -296,6 +341,112 @@ void test_serialize_ta_find_transactions_obj_by_tag(void) {
   free(json_result);
 }
 
+/**
+ * @brief Serialize transactions through a cJSON tree and with the JSON writer, which must give the same bytes
+ */
+static void expect_writer_matches_cjson(transaction_array_t* const txn_array) {
+  char *cjson_result = NULL, *writer_result = NULL;
+
+  cJSON* json_root = cJSON_CreateArray();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_transaction_array_to_json_array(txn_array, json_root));
+  cjson_result = cJSON_PrintUnformatted(json_root);
+  cJSON_Delete(json_root);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize(txn_array, &writer_result));
+
+  TEST_ASSERT_EQUAL_UINT(strlen(cjson_result), strlen(writer_result));
+  TEST_ASSERT_EQUAL_MEMORY(cjson_result, writer_result, strlen(cjson_result));
+
+  free(cjson_result);
+  free(writer_result);
+}
+
+void test_serialize_ta_find_transaction_objects_writer(void) {
+  transaction_array_t* txn_array = transaction_array_new();
+  expect_writer_matches_cjson(txn_array);
+  transaction_array_free(txn_array);
+
+  txn_array = rand_transaction_array(WRITER_TXN_NUM);
+  expect_writer_matches_cjson(txn_array);
+
+  // The buffer sized for the transactions is never grown
+  json_writer_t writer;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, json_writer_init(&writer, WRITER_TXN_NUM * TXN_JSON_MAX_SIZE + 2));
+  const size_t init_capacity = writer.capacity;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_transaction_array_to_json_writer(txn_array, &writer));
+  TEST_ASSERT_EQUAL_UINT(init_capacity, writer.capacity);
+  json_writer_destroy(&writer);
+
+  transaction_array_free(txn_array);
+}
+
+void test_find_transaction_objects_cbor_round_trip(void) {
+  transaction_array_t* txn_array = rand_transaction_array(CBOR_TXN_NUM);
+  transaction_array_t* cbor_array = transaction_array_new();
+  char *json = NULL, *json_result = NULL, *cbor = NULL;
+  size_t cbor_len = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize(txn_array, &json));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize_cbor(txn_array, &cbor, &cbor_len));
+  TEST_ASSERT_TRUE(cbor_len <= CBOR_TXN_NUM * TXN_CBOR_MAX_SIZE);
+  // Packed trits take less than two thirds of the bytes of trytes
+  TEST_ASSERT_TRUE(cbor_len < strlen(json) * 2 / 3);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_deserialize_cbor(cbor, cbor_len, cbor_array));
+  TEST_ASSERT_EQUAL_INT(CBOR_TXN_NUM, transaction_array_len(cbor_array));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize(cbor_array, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+
+  transaction_array_free(txn_array);
+  transaction_array_free(cbor_array);
+  free(json);
+  free(json_result);
+  free(cbor);
+}
+
+void test_find_transaction_object_single_cbor(void) {
+  transaction_array_t* txn_array = rand_transaction_array(1);
+  char *cbor = NULL, *cbor_single = NULL;
+  size_t cbor_len = 0, cbor_single_len = 0;
+
+  // A single transaction object is the only item of the array of transaction objects
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize_cbor(txn_array, &cbor, &cbor_len));
+  TEST_ASSERT_EQUAL_INT32(
+      SC_OK, ta_find_transaction_object_single_res_serialize_cbor(txn_array, &cbor_single, &cbor_single_len));
+  TEST_ASSERT_EQUAL_UINT(cbor_len - 1, cbor_single_len);
+  TEST_ASSERT_EQUAL_HEX8(0x81, (uint8_t)cbor[0]);
+  TEST_ASSERT_EQUAL_MEMORY(cbor + 1, cbor_single, cbor_single_len);
+  transaction_array_free(txn_array);
+  free(cbor);
+  free(cbor_single);
+
+  txn_array = transaction_array_new();
+  TEST_ASSERT_EQUAL_INT32(SC_CCLIENT_NOT_FOUND,
+                          ta_find_transaction_object_single_res_serialize_cbor(txn_array, &cbor, &cbor_len));
+  transaction_array_free(txn_array);
+}
+
+void test_find_transaction_objects_cbor_malformed(void) {
+  transaction_array_t* txn_array = rand_transaction_array(1);
+  transaction_array_t* cbor_array = transaction_array_new();
+  char* cbor = NULL;
+  size_t cbor_len = 0;
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_find_transaction_objects_res_serialize_cbor(txn_array, &cbor, &cbor_len));
+  // Truncated data
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_CBOR_MALFORMED,
+                          ta_find_transaction_objects_res_deserialize_cbor(cbor, cbor_len - 1, cbor_array));
+  // A map instead of an array
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_CBOR_MALFORMED,
+                          ta_find_transaction_objects_res_deserialize_cbor(cbor + 1, cbor_len - 1, cbor_array));
+  // A JSON response is not CBOR
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_CBOR_MALFORMED,
+                          ta_find_transaction_objects_res_deserialize_cbor("[]", strlen("[]"), cbor_array));
+
+  transaction_array_free(txn_array);
+  transaction_array_free(cbor_array);
+  free(cbor);
+}
+
 void test_recv_mam_message_request_psk_deserialize(void) {
   const char* json = "{\"data_id\":{\"chid\":\"" TEST_CHID "\",\"epid\":\"" TEST_EPID "\",\"msg_id\":\"" TEST_MSG_ID
                      "\"},"
@@ -315,6 +466,33 @@ void test_recv_mam_message_request_psk_deserialize(void) {
   recv_mam_req_free(&req);
 }
 
+void test_recv_mam_message_request_since_deserialize(void) {
+  const char* json = "{\"data_id\":{\"chid\":\"" TEST_CHID "\",\"since\":\"" TEST_BUNDLE_HASH
+                     "\"},\"protocol\":\"MAM_V1\"}";
+  ta_recv_mam_req_t* req = recv_mam_req_new();
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_req_deserialize(json, req));
+  recv_mam_data_id_mam_v1_t* data_id = (recv_mam_data_id_mam_v1_t*)req->data_id;
+  TEST_ASSERT_EQUAL_STRING(TEST_CHID, data_id->chid);
+  TEST_ASSERT_EQUAL_STRING(TEST_BUNDLE_HASH, data_id->since);
+  recv_mam_req_free(&req);
+
+  // A message ID is also accepted as the cursor
+  const char* json_msg_id = "{\"data_id\":{\"chid\":\"" TEST_CHID "\",\"since\":\"" TEST_MSG_ID
+                            "\"},\"protocol\":\"MAM_V1\"}";
+  req = recv_mam_req_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_req_deserialize(json_msg_id, req));
+  data_id = (recv_mam_data_id_mam_v1_t*)req->data_id;
+  TEST_ASSERT_EQUAL_STRING(TEST_MSG_ID, data_id->since);
+  recv_mam_req_free(&req);
+
+  const char* json_invalid =
+      "{\"data_id\":{\"chid\":\"" TEST_CHID "\",\"since\":\"" TEST_TAG "9\"},\"protocol\":\"MAM_V1\"}";
+  req = recv_mam_req_new();
+  TEST_ASSERT_EQUAL_INT32(SC_CCLIENT_JSON_PARSE, recv_mam_message_req_deserialize(json_invalid, req));
+  recv_mam_req_free(&req);
+}
+
 void test_recv_mam_message_response_serialize(void) {
   const char* json = "{\"payload\":[[\"" STR(TIMESTAMP_LEN20_1) "\",\"" TRYTES_81_1 "\"],[\"" STR(
       TIMESTAMP_LEN20_2) "\",\"" TRYTES_81_2 "\"]],\"chid1\":\"" TEST_ADDRESS "\"}";
@@ -335,6 +513,63 @@ void test_recv_mam_message_response_serialize(void) {
   free(json_result);
 }
 
+void test_recv_mam_message_response_cursor(void) {
+  const char* json =
+      "{\"payload\":[[\"" STR(TIMESTAMP_LEN20_1) "\",\"" TRYTES_81_1 "\"]],\"cursor\":\"" TEST_BUNDLE_HASH "\"}";
+  ta_recv_mam_res_t* res = recv_mam_res_new();
+  char* json_result = NULL;
+  char* str = STR(TIMESTAMP_LEN20_1) TRYTES_81_1;
+  utarray_push_back(res->payload_array, &str);
+  strncpy(res->cursor, TEST_BUNDLE_HASH, NUM_TRYTES_HASH);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_serialize(res, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  recv_mam_res_free(&res);
+
+  res = recv_mam_res_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_deserialize(json_result, res));
+  TEST_ASSERT_EQUAL_STRING(TEST_BUNDLE_HASH, res->cursor);
+  TEST_ASSERT_EQUAL_INT(1, utarray_len(res->payload_array));
+
+  recv_mam_res_free(&res);
+  free(json_result);
+}
+
+void test_recv_mam_message_response_cbor_round_trip(void) {
+  ta_recv_mam_res_t* res = recv_mam_res_new();
+  char *json = NULL, *json_result = NULL, *cbor = NULL;
+  size_t cbor_len = 0;
+  char* str;
+  str = STR(TIMESTAMP_LEN20_1) TRYTES_81_1;
+  utarray_push_back(res->payload_array, &str);
+  str = STR(TIMESTAMP_LEN20_2) "Hello, \"world\"";
+  utarray_push_back(res->payload_array, &str);
+  strncpy(res->chid1, TEST_ADDRESS, NUM_TRYTES_ADDRESS);
+  strncpy(res->cursor, TEST_BUNDLE_HASH, NUM_TRYTES_HASH);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_serialize(res, &json));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_serialize_cbor(res, &cbor, &cbor_len));
+  TEST_ASSERT_TRUE(cbor_len < strlen(json));
+  recv_mam_res_free(&res);
+
+  res = recv_mam_res_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_deserialize_cbor(cbor, cbor_len, res));
+  TEST_ASSERT_EQUAL_STRING(TEST_ADDRESS, res->chid1);
+  TEST_ASSERT_EQUAL_STRING(TEST_BUNDLE_HASH, res->cursor);
+  TEST_ASSERT_EQUAL_INT(2, utarray_len(res->payload_array));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, recv_mam_message_res_serialize(res, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  recv_mam_res_free(&res);
+
+  res = recv_mam_res_new();
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_CBOR_MALFORMED, recv_mam_message_res_deserialize_cbor(cbor, cbor_len - 1, res));
+  recv_mam_res_free(&res);
+
+  free(json);
+  free(json_result);
+  free(cbor);
+}
+
 void test_send_mam_message_request_deserialize(void) {
   const char* json =
       "{\"x-api-key\":\"" TEST_TOKEN "\",\"data\":{\"seed\":\"" TRYTES_81_1 "\",\"chid\":\"" TEST_ADDRESS
@@ -357,6 +592,53 @@ void test_send_mam_message_request_deserialize(void) {
   send_mam_req_free(&req);
 }
 
+void test_send_mam_message_batch_request_deserialize(void) {
+  const char* json = "{\"data\":{\"seed\":\"" TRYTES_81_1 "\",\"messages\":[\"" TEST_PAYLOAD "\",\"" TEST_MSG_ID
+                     "\"]}, \"protocol\":\"MAM_V1\"}";
+  const char* json_empty = "{\"data\":{\"seed\":\"" TRYTES_81_1 "\",\"messages\":[]}, \"protocol\":\"MAM_V1\"}";
+  ta_send_mam_req_t* req = send_mam_req_new();
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, send_mam_message_req_deserialize(json, req));
+  send_mam_data_mam_v1_t* data = (send_mam_data_mam_v1_t*)req->data;
+  TEST_ASSERT_NULL(data->message);
+  TEST_ASSERT_EQUAL_UINT(2, utarray_len(data->messages));
+  TEST_ASSERT_EQUAL_STRING(TEST_PAYLOAD, *(char**)utarray_eltptr(data->messages, 0));
+  TEST_ASSERT_EQUAL_STRING(TEST_MSG_ID, *(char**)utarray_eltptr(data->messages, 1));
+  send_mam_req_free(&req);
+
+  req = send_mam_req_new();
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_INVALID_REQ, send_mam_message_req_deserialize(json_empty, req));
+  send_mam_req_free(&req);
+}
+
+void test_send_mam_message_batch_response_serialize(void) {
+  const char* json = "{\"results\":[{\"bundle_hash\":\"" TRYTES_81_1 "\",\"chid\":\"" TRYTES_81_2
+                     "\",\"msg_id\":\"" TEST_MSG_ID "\"},{\"bundle_hash\":\"" TRYTES_81_3 "\",\"chid\":\"" TRYTES_81_2
+                     "\",\"msg_id\":\"" TEST_MSG_ID "\",\"announcement_bundle_hash\":\"" ADDRESS_1
+                     "\",\"chid1\":\"" ADDRESS_2 "\"}]}";
+  char* json_result = NULL;
+  UT_array* res_array = NULL;
+  ta_send_mam_res_t res;
+  utarray_new(res_array, &send_mam_res_icd);
+
+  memset(&res, 0, sizeof(ta_send_mam_res_t));
+  send_mam_res_set_bundle_hash(&res, (tryte_t*)TRYTES_81_1);
+  send_mam_res_set_channel_id(&res, (tryte_t*)TRYTES_81_2);
+  send_mam_res_set_msg_id(&res, (tryte_t*)TEST_MSG_ID);
+  utarray_push_back(res_array, &res);
+  // The second message uses the last key but one, so it is followed by an announcement
+  send_mam_res_set_bundle_hash(&res, (tryte_t*)TRYTES_81_3);
+  send_mam_res_set_announce_bundle_hash(&res, (tryte_t*)ADDRESS_1);
+  send_mam_res_set_chid1(&res, (tryte_t*)ADDRESS_2);
+  utarray_push_back(res_array, &res);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, send_mam_message_batch_res_serialize(res_array, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+
+  free(json_result);
+  utarray_free(res_array);
+}
+
 void test_send_mam_message_response_serialize(void) {
   const char* json = "{\"bundle_hash\":\"" TRYTES_81_1
                      "\","
@@ -422,6 +704,70 @@ void test_deserialize_ta_send_trytes_req(void) {
   hash_array_free(out_trytes);
 }
 
+void test_deserialize_ta_send_trytes_req_not_tryte(void) {
+  const char* json = "{\"trytes\":[\"" TRYTES_2673_1 "\",\"" TRYTES_2673_2 "\"]}";
+  char* json_invalid = strdup(json);
+  hash8019_array_p out_trytes = hash8019_array_new();
+
+  // A lowercase character in the tail of the second transaction
+  json_invalid[strlen(json) - 4] = 'a';
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_PARSE_NOT_TRYTE, ta_send_trytes_req_deserialize(json_invalid, out_trytes));
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_JSON_PARSE, ta_send_trytes_req_deserialize("{\"trytes\":[", out_trytes));
+  TEST_ASSERT_EQUAL_INT32(SC_CCLIENT_JSON_PARSE, ta_send_trytes_req_deserialize("{\"trytes\":{}}", out_trytes));
+
+  hash_array_free(out_trytes);
+  free(json_invalid);
+}
+
+static char* rand_send_trytes_req(const int num) {
+  char* json = (char*)malloc(strlen("{\"trytes\":[]}") + num * (NUM_TRYTES_SERIALIZED_TRANSACTION + 3) + 1);
+  size_t len = sprintf(json, "{\"trytes\":[");
+  for (int i = 0; i < num; i++) {
+    if (i) {
+      json[len++] = ',';
+    }
+    json[len++] = '"';
+    gen_rand_trytes(NUM_TRYTES_SERIALIZED_TRANSACTION, (tryte_t*)json + len);
+    len += NUM_TRYTES_SERIALIZED_TRANSACTION;
+    json[len++] = '"';
+  }
+  strcpy(json + len, "]}");
+  return json;
+}
+
+void test_deserialize_requests_reader(void) {
+  char* json = rand_send_trytes_req(READER_TRYTES_NUM);
+  hash8019_array_p cjson_trytes = hash8019_array_new(), reader_trytes = hash8019_array_new();
+
+  // The JSON reader gives the same trytes as converting the strings of a cJSON tree
+  cJSON* json_obj = cJSON_Parse(json);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_json_array_to_hash8019_array(json_obj, "trytes", cjson_trytes));
+  cJSON_Delete(json_obj);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_send_trytes_req_deserialize(json, reader_trytes));
+  TEST_ASSERT_EQUAL_UINT(READER_TRYTES_NUM, hash_array_len(reader_trytes));
+  for (int i = 0; i < READER_TRYTES_NUM; i++) {
+    TEST_ASSERT_EQUAL_MEMORY(hash_array_at(cjson_trytes, i), hash_array_at(reader_trytes, i), FLEX_TRIT_SIZE_8019);
+  }
+  hash_array_free(cjson_trytes);
+  hash_array_free(reader_trytes);
+  free(json);
+
+  // A transfer with a full message
+  const char* json_template = "{\"value\":0,\"message_format\":\"trytes\",\"message\":\"%s\",\"tag\":\"" TEST_TAG
+                              "\",\"address\":\"" TRYTES_81_1 "\"}";
+  tryte_t message[NUM_TRYTES_MESSAGE + 1] = {};
+  gen_rand_trytes(NUM_TRYTES_MESSAGE, message);
+  json = (char*)malloc(strlen(json_template) + NUM_TRYTES_MESSAGE);
+  sprintf(json, json_template, message);
+
+  ta_send_transfer_req_t* req = ta_send_transfer_req_new();
+  TEST_ASSERT_EQUAL_INT32(SC_OK, ta_send_transfer_req_deserialize(json, req));
+  TEST_ASSERT_EQUAL_INT(NUM_TRYTES_MESSAGE, req->msg_len);
+  TEST_ASSERT_EQUAL_MEMORY(message, req->message, NUM_TRYTES_MESSAGE);
+  ta_send_transfer_req_free(&req);
+  free(json);
+}
+
 void test_serialize_ta_send_trytes_res(void) {
   const char* json = "{\"trytes\":[\"" TRYTES_2673_1 "\",\"" TRYTES_2673_2 "\"]}";
   char* json_result;
@@ -657,12 +1003,23 @@ int main(void) {
   RUN_TEST(test_serialize_ta_find_transaction_objects);
   RUN_TEST(test_serialize_ta_find_transactions_by_tag);
   RUN_TEST(test_serialize_ta_find_transactions_obj_by_tag);
+  RUN_TEST(test_serialize_ta_find_transaction_objects_writer);
+  RUN_TEST(test_find_transaction_objects_cbor_round_trip);
+  RUN_TEST(test_find_transaction_object_single_cbor);
+  RUN_TEST(test_find_transaction_objects_cbor_malformed);
   RUN_TEST(test_recv_mam_message_request_psk_deserialize);
+  RUN_TEST(test_recv_mam_message_request_since_deserialize);
   RUN_TEST(test_recv_mam_message_response_serialize);
+  RUN_TEST(test_recv_mam_message_response_cursor);
+  RUN_TEST(test_recv_mam_message_response_cbor_round_trip);
   RUN_TEST(test_send_mam_message_request_deserialize);
+  RUN_TEST(test_send_mam_message_batch_request_deserialize);
+  RUN_TEST(test_send_mam_message_batch_response_serialize);
   RUN_TEST(test_send_mam_message_response_serialize);
   RUN_TEST(test_send_mam_message_response_deserialize);
   RUN_TEST(test_deserialize_ta_send_trytes_req);
+  RUN_TEST(test_deserialize_ta_send_trytes_req_not_tryte);
+  RUN_TEST(test_deserialize_requests_reader);
   RUN_TEST(test_serialize_ta_send_trytes_res);
 #ifdef MQTT_ENABLE
   RUN_TEST(test_mqtt_device_id_deserialize);
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <dirent.h>
+#include <unistd.h>
+#include "tests/test_define.h"
+#include "utils/spool.h"
+
+#define REQ_NUM 5
+#define TEST_SEGMENT_SIZE 256
+
+static char spool_dir[] = "/tmp/ta_spool_XXXXXX";
+static const char* const uuids[REQ_NUM] = {
+    "0b4f1d0e-4a64-4b4e-9a2a-2c7f6b3b0a01", "0b4f1d0e-4a64-4b4e-9a2a-2c7f6b3b0a02",
+    "0b4f1d0e-4a64-4b4e-9a2a-2c7f6b3b0a03", "0b4f1d0e-4a64-4b4e-9a2a-2c7f6b3b0a04",
+    "0b4f1d0e-4a64-4b4e-9a2a-2c7f6b3b0a05"};
+static const char* const payloads[REQ_NUM] = {"first buffered request", "second buffered request",
+                                              "third buffered request", "fourth buffered request",
+                                              "fifth buffered request"};
+
+static int count_segments() {
+  int count = 0;
+  DIR* dir = opendir(spool_dir);
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strstr(entry->d_name, SPOOL_SEGMENT_SUFFIX)) {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+static void remove_segments() {
+  char path[FILENAME_MAX];
+  DIR* dir = opendir(spool_dir);
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strstr(entry->d_name, SPOOL_SEGMENT_SUFFIX)) {
+      snprintf(path, sizeof(path), "%s/%s", spool_dir, entry->d_name);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+}
+
+static void append_requests(spool_t* spool, const int num) {
+  for (int i = 0; i < num; i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK,
+                            spool_append(spool, SPOOL_RECORD_BUNDLE, uuids[i], payloads[i], strlen(payloads[i])));
+  }
+}
+
+static void expect_head(spool_t* spool, const int idx, spool_record_t* record) {
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_peek(spool, record));
+  TEST_ASSERT_EQUAL_UINT8(SPOOL_RECORD_BUNDLE, record->type);
+  TEST_ASSERT_EQUAL_STRING(uuids[idx], record->key);
+  TEST_ASSERT_EQUAL_UINT(strlen(payloads[idx]), record->len);
+  TEST_ASSERT_EQUAL_MEMORY(payloads[idx], record->data, record->len);
+}
+
+void setUp(void) {}
+
+void tearDown(void) { remove_segments(); }
+
+void test_spool_replay_in_order(void) {
+  spool_t* spool = NULL;
+  spool_record_t record;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, SPOOL_SEGMENT_SIZE, SPOOL_SYNC_ALWAYS));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_SPOOL_EMPTY, spool_peek(spool, &record));
+
+  append_requests(spool, REQ_NUM);
+  TEST_ASSERT_EQUAL_UINT(REQ_NUM, spool_pending(spool));
+  for (int i = 0; i < REQ_NUM; i++) {
+    expect_head(spool, i, &record);
+    // Peeking again returns the same record until it is acknowledged
+    expect_head(spool, i, &record);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+    TEST_ASSERT_EQUAL_UINT(REQ_NUM - i - 1, spool_pending(spool));
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_SPOOL_EMPTY, spool_peek(spool, &record));
+
+  spool_close(&spool);
+  TEST_ASSERT_NULL(spool);
+}
+
+void test_spool_recover(void) {
+  spool_t* spool = NULL;
+  spool_record_t record;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, TEST_SEGMENT_SIZE, SPOOL_SYNC_BATCH));
+  append_requests(spool, 3);
+  expect_head(spool, 0, &record);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+  spool_close(&spool);
+
+  // Acknowledged requests are not replayed after reopening, and new requests are replayed after the recovered ones
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, TEST_SEGMENT_SIZE, SPOOL_SYNC_BATCH));
+  TEST_ASSERT_EQUAL_UINT(2, spool_pending(spool));
+  TEST_ASSERT_EQUAL_INT32(SC_OK,
+                          spool_append(spool, SPOOL_RECORD_BUNDLE, uuids[3], payloads[3], strlen(payloads[3])));
+  for (int i = 1; i < 4; i++) {
+    expect_head(spool, i, &record);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_SPOOL_EMPTY, spool_peek(spool, &record));
+  spool_close(&spool);
+}
+
+void test_spool_compaction(void) {
+  spool_t* spool = NULL;
+  spool_record_t record;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, TEST_SEGMENT_SIZE, SPOOL_SYNC_NONE));
+  append_requests(spool, REQ_NUM);
+  TEST_ASSERT_TRUE(count_segments() > 1);
+
+  // Segments are removed once all their requests are acknowledged
+  const int segment_num = count_segments();
+  for (int i = 0; i < 3; i++) {
+    expect_head(spool, i, &record);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+  }
+  TEST_ASSERT_TRUE(count_segments() < segment_num);
+
+  while (spool_peek(spool, &record) == SC_OK) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+  }
+  TEST_ASSERT_EQUAL_INT(0, count_segments());
+  spool_close(&spool);
+}
+
+void test_spool_torn_record(void) {
+  spool_t* spool = NULL;
+  spool_record_t record;
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, SPOOL_SEGMENT_SIZE, SPOOL_SYNC_ALWAYS));
+  append_requests(spool, 2);
+  spool_close(&spool);
+
+  // Corrupt the payload of the last request, as if power was lost while writing it
+  char path[FILENAME_MAX];
+  DIR* dir = opendir(spool_dir);
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strstr(entry->d_name, SPOOL_SEGMENT_SUFFIX)) {
+      snprintf(path, sizeof(path), "%s/%s", spool_dir, entry->d_name);
+    }
+  }
+  closedir(dir);
+  FILE* file = fopen(path, "r+b");
+  TEST_ASSERT_NOT_NULL(file);
+  char buf[1024];
+  const size_t len = fread(buf, 1, sizeof(buf), file);
+  long offset = -1;
+  for (size_t i = 0; i + strlen(payloads[1]) <= len; i++) {
+    if (!memcmp(buf + i, payloads[1], strlen(payloads[1]))) {
+      offset = (long)i;
+      break;
+    }
+  }
+  TEST_ASSERT_TRUE(offset > 0);
+  fseek(file, offset, SEEK_SET);
+  fputc('X', file);
+  fclose(file);
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_open(&spool, spool_dir, SPOOL_SEGMENT_SIZE, SPOOL_SYNC_ALWAYS));
+  TEST_ASSERT_EQUAL_UINT(1, spool_pending(spool));
+  expect_head(spool, 0, &record);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, spool_ack(spool, &record));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_SPOOL_EMPTY, spool_peek(spool, &record));
+  spool_close(&spool);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  if (mkdtemp(spool_dir) == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  RUN_TEST(test_spool_replay_in_order);
+  RUN_TEST(test_spool_recover);
+  RUN_TEST(test_spool_compaction);
+  RUN_TEST(test_spool_torn_record);
+
+  rmdir(spool_dir);
+  return UNITY_END();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <stdlib.h>
+#include "tests/test_define.h"
+#include "utils/tag_set.h"
+
+#define TAG_NUM 100
+#define CHANNEL_MIN_DEPTH 10
+#define CHANNEL_MAX_DEPTH 12
+
+static const char tryte_alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void random_tags(tryte_t* tags, const size_t num, unsigned int seed) {
+  for (size_t i = 0; i < num * NUM_TRYTES_TAG; i++) {
+    tags[i] = tryte_alphabet[rand_r(&seed) % (sizeof(tryte_alphabet) - 1)];
+  }
+}
+
+/**
+ * @brief The lookup `msg_id_exist()` used to do, which scans all the tags of a channel
+ */
+static bool linear_contains(tryte_t const* const tags, const size_t num, tryte_t const* const tag) {
+  for (size_t i = 0; i < num; i++) {
+    if (!memcmp(tags + i * NUM_TRYTES_TAG, tag, NUM_TRYTES_TAG)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_tag_set_add_contains(void) {
+  tag_set_t set;
+  tryte_t tags[TAG_NUM * 2 * NUM_TRYTES_TAG];
+  random_tags(tags, TAG_NUM * 2, 1);
+
+  TEST_ASSERT_EQUAL_INT32(SC_NULL, tag_set_init(NULL, TAG_NUM));
+  // Start small, so the set has to grow
+  TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_init(&set, 1));
+  for (int i = 0; i < TAG_NUM; i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_add(&set, tags + i * NUM_TRYTES_TAG));
+  }
+  // Adding existing tags does nothing
+  for (int i = 0; i < TAG_NUM; i++) {
+    TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_add(&set, tags + i * NUM_TRYTES_TAG));
+  }
+  TEST_ASSERT_EQUAL_UINT(TAG_NUM, set.size);
+  TEST_ASSERT_TRUE(set.capacity >= TAG_NUM * 2);
+
+  for (int i = 0; i < TAG_NUM; i++) {
+    TEST_ASSERT_TRUE(tag_set_contains(&set, tags + i * NUM_TRYTES_TAG));
+    TEST_ASSERT_FALSE(tag_set_contains(&set, tags + (TAG_NUM + i) * NUM_TRYTES_TAG));
+  }
+
+  tag_set_reset(&set);
+  TEST_ASSERT_EQUAL_UINT(0, set.size);
+  TEST_ASSERT_FALSE(tag_set_contains(&set, tags));
+  tag_set_destroy(&set);
+  TEST_ASSERT_FALSE(tag_set_contains(&set, tags));
+}
+
+void test_tag_set_default_tag(void) {
+  tag_set_t set;
+  tryte_t tag[NUM_TRYTES_TAG];
+  // A tag of all '9' is a valid tag, which should not be taken as an empty slot
+  memset(tag, '9', NUM_TRYTES_TAG);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_init(&set, TAG_NUM));
+  TEST_ASSERT_FALSE(tag_set_contains(&set, tag));
+  TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_add(&set, tag));
+  TEST_ASSERT_TRUE(tag_set_contains(&set, tag));
+  tag_set_destroy(&set);
+}
+
+/**
+ * Look up every key of a channel whose keys are all used, like sending a message to a full channel. The results should
+ * be the same as scanning all the tags of the channel.
+ */
+void test_tag_set_full_channel(void) {
+  for (int depth = CHANNEL_MIN_DEPTH; depth <= CHANNEL_MAX_DEPTH; depth++) {
+    const size_t key_num = 1 << depth;
+    tryte_t* tags = (tryte_t*)malloc(2 * key_num * NUM_TRYTES_TAG);
+    TEST_ASSERT_NOT_NULL(tags);
+    random_tags(tags, 2 * key_num, depth);
+
+    tag_set_t set;
+    TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_init(&set, key_num));
+    for (size_t i = 0; i < key_num; i++) {
+      TEST_ASSERT_EQUAL_INT32(SC_OK, tag_set_add(&set, tags + i * NUM_TRYTES_TAG));
+    }
+    // The first half of the tags are used keys, and the other half are not
+    for (size_t i = 0; i < 2 * key_num; i++) {
+      tryte_t const* const tag = tags + i * NUM_TRYTES_TAG;
+      TEST_ASSERT_EQUAL_INT(linear_contains(tags, key_num, tag), tag_set_contains(&set, tag));
+    }
+    tag_set_destroy(&set);
+    free(tags);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_tag_set_add_contains);
+  RUN_TEST(test_tag_set_default_tag);
+  RUN_TEST(test_tag_set_full_channel);
+
+  return UNITY_END();
+}
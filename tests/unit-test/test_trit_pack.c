@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "common/model/transaction.h"
+#include "tests/common.h"
+#include "tests/test_define.h"
+#include "utils/trit_pack.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void gen_rand_trits(trit_t* trits, const size_t num_trits) {
+  for (size_t i = 0; i < num_trits; i++) {
+    trits[i] = (trit_t)(rand() % 3 - 1);
+  }
+}
+
+void test_trit_pack_size(void) {
+  TEST_ASSERT_EQUAL_INT(49, TRIT_PACK_SIZE(NUM_TRITS_HASH));
+  TEST_ASSERT_EQUAL_INT(1604, TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION));
+}
+
+void test_trit_pack_round_trip(void) {
+  const size_t lens[] = {1, 4, 5, 6, NUM_TRITS_TAG, NUM_TRITS_HASH, NUM_TRITS_SERIALIZED_TRANSACTION};
+  for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+    trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION], decoded[NUM_TRITS_SERIALIZED_TRANSACTION];
+    uint8_t packed[TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION)];
+    gen_rand_trits(trits, lens[i]);
+
+    trit_pack_encode(trits, lens[i], packed);
+    for (size_t j = 0; j < TRIT_PACK_SIZE(lens[i]); j++) {
+      TEST_ASSERT_TRUE(packed[j] <= TRIT_PACK_MAX_BYTE);
+    }
+    TEST_ASSERT_EQUAL_INT32(SC_OK, trit_pack_decode(packed, lens[i], decoded));
+    TEST_ASSERT_EQUAL_INT8_ARRAY(trits, decoded, lens[i]);
+  }
+}
+
+void test_flex_trits_pack_round_trip(void) {
+  tryte_t trytes[NUM_TRYTES_SERIALIZED_TRANSACTION + 1] = {};
+  flex_trit_t flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION] = {};
+  flex_trit_t decoded[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION] = {};
+  uint8_t packed[TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION)];
+
+  gen_rand_trytes(NUM_TRYTES_SERIALIZED_TRANSACTION, trytes);
+  flex_trits_from_trytes(flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, trytes, NUM_TRYTES_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+  flex_trits_pack(flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, packed);
+  TEST_ASSERT_EQUAL_INT32(SC_OK, flex_trits_unpack(packed, NUM_TRITS_SERIALIZED_TRANSACTION, decoded));
+  TEST_ASSERT_EQUAL_MEMORY(flex_trits, decoded, NUM_FLEX_TRITS_SERIALIZED_TRANSACTION);
+}
+
+void test_trit_pack_invalid(void) {
+  const uint8_t packed[] = {0, TRIT_PACK_MAX_BYTE, TRIT_PACK_MAX_BYTE + 1};
+  trit_t trits[3 * TRIT_PACK_TRITS_PER_BYTE];
+
+  TEST_ASSERT_EQUAL_INT32(SC_OK, trit_pack_decode(packed, 2 * TRIT_PACK_TRITS_PER_BYTE, trits));
+  TEST_ASSERT_EQUAL_INT32(SC_UTILS_TRIT_PACK_INVALID, trit_pack_decode(packed, 3 * TRIT_PACK_TRITS_PER_BYTE, trits));
+}
+
+int main(void) {
+  rand_trytes_init();
+
+  UNITY_BEGIN();
+
+  RUN_TEST(test_trit_pack_size);
+  RUN_TEST(test_trit_pack_round_trip);
+  RUN_TEST(test_flex_trits_pack_round_trip);
+  RUN_TEST(test_trit_pack_invalid);
+
+  return UNITY_END();
+}
@@ -8,14 +8,25 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "tests/test_define.h"
 #include "utils/tryte_byte_conv.h"
 
+#define FUZZ_ROUNDS 2000
+#define FUZZ_MAX_LEN 300
+#define LARGE_PAYLOAD_LEN 100000 /**< Longer than the range of uint16_t */
+
 void setUp(void) {}
 
 void tearDown(void) {}
 
+static void rand_bytes(uint8_t* bytes, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    bytes[i] = rand() % 256;
+  }
+}
+
 void test_bytes_trytes_bytes_conv(void) {
   const uint8_t test_str[1024] = {48, 48, 48, 48, 48, 0,  48, 48, 48, 48, 48, 48, 48, 48,
                                   48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48};
@@ -28,10 +39,86 @@ void test_bytes_trytes_bytes_conv(void) {
   TEST_ASSERT_EQUAL_INT8_ARRAY(test_str, dec_msg, str_len);
 }
 
+void test_tryte_byte_conv_fuzz(void) {
+  uint8_t input[FUZZ_MAX_LEN * 2];
+  char output[FUZZ_MAX_LEN * 2 + 1], output_scalar[FUZZ_MAX_LEN * 2 + 1];
+
+  for (int round = 0; round < FUZZ_ROUNDS; round++) {
+    const size_t len = rand() % FUZZ_MAX_LEN;
+    const size_t offset = rand() % 16;
+    rand_bytes(input, len + offset);
+
+    // Misaligned inputs, with guard bytes after the outputs
+    memset(output, 0x5a, sizeof(output));
+    memset(output_scalar, 0x5a, sizeof(output_scalar));
+    bytes_to_trytes(input + offset, len, output);
+    bytes_to_trytes_scalar(input + offset, len, output_scalar);
+    TEST_ASSERT_EQUAL_MEMORY(output_scalar, output, sizeof(output));
+
+    // Arbitrary characters, not only valid trytes, are decoded as the scalar implementation does
+    memset(output, 0x5a, sizeof(output));
+    memset(output_scalar, 0x5a, sizeof(output_scalar));
+    trytes_to_bytes(input + offset, len, output);
+    trytes_to_bytes_scalar(input + offset, len, output_scalar);
+    TEST_ASSERT_EQUAL_MEMORY(output_scalar, output, sizeof(output));
+  }
+}
+
+void test_tryte_byte_conv_large_payload(void) {
+  uint8_t* bytes = malloc(LARGE_PAYLOAD_LEN);
+  char* trytes = malloc(LARGE_PAYLOAD_LEN * 2);
+  char* decoded = malloc(LARGE_PAYLOAD_LEN);
+  TEST_ASSERT_NOT_NULL(bytes);
+  TEST_ASSERT_NOT_NULL(trytes);
+  TEST_ASSERT_NOT_NULL(decoded);
+  rand_bytes(bytes, LARGE_PAYLOAD_LEN);
+
+  bytes_to_trytes(bytes, LARGE_PAYLOAD_LEN, trytes);
+  trytes_to_bytes((uint8_t*)trytes, LARGE_PAYLOAD_LEN * 2, decoded);
+  TEST_ASSERT_EQUAL_MEMORY(bytes, decoded, LARGE_PAYLOAD_LEN);
+
+  memset(decoded, 0, LARGE_PAYLOAD_LEN);
+  trytes_to_bytes_scalar((uint8_t*)trytes, LARGE_PAYLOAD_LEN * 2, decoded);
+  TEST_ASSERT_EQUAL_MEMORY(bytes, decoded, LARGE_PAYLOAD_LEN);
+
+  free(bytes);
+  free(trytes);
+  free(decoded);
+}
+
+void test_trytes_to_bytes_stream(void) {
+  uint8_t bytes[FUZZ_MAX_LEN];
+  char trytes[FUZZ_MAX_LEN * 2], decoded[FUZZ_MAX_LEN];
+  trytes_to_bytes_stream_t stream;
+
+  for (int round = 0; round < FUZZ_ROUNDS / 10; round++) {
+    rand_bytes(bytes, sizeof(bytes));
+    bytes_to_trytes(bytes, sizeof(bytes), trytes);
+
+    // Chunks of random lengths, odd ones and empty ones included
+    size_t consumed = 0, written = 0;
+    trytes_to_bytes_stream_init(&stream);
+    while (consumed < sizeof(trytes)) {
+      size_t chunk_len = rand() % 70;
+      if (chunk_len > sizeof(trytes) - consumed) {
+        chunk_len = sizeof(trytes) - consumed;
+      }
+      written += trytes_to_bytes_stream(&stream, (uint8_t*)trytes + consumed, chunk_len, decoded + written);
+      consumed += chunk_len;
+    }
+    TEST_ASSERT_FALSE(stream.has_pending);
+    TEST_ASSERT_EQUAL_UINT(sizeof(bytes), written);
+    TEST_ASSERT_EQUAL_MEMORY(bytes, decoded, sizeof(bytes));
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_bytes_trytes_bytes_conv);
+  RUN_TEST(test_tryte_byte_conv_fuzz);
+  RUN_TEST(test_tryte_byte_conv_large_payload);
+  RUN_TEST(test_trytes_to_bytes_stream);
 
   return UNITY_END();
 }
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "common/model/transaction.h"
+#include "tests/common.h"
+#include "tests/test_define.h"
+#include "utils/tryte_simd.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_trytes_valid(void) {
+  char trytes[NUM_TRYTES_SERIALIZED_TRANSACTION + 1] = TRYTES_2673_1;
+
+  TEST_ASSERT_TRUE(trytes_valid(trytes, NUM_TRYTES_SERIALIZED_TRANSACTION));
+  TEST_ASSERT_TRUE(trytes_valid(trytes, 0));
+  TEST_ASSERT_TRUE(trytes_valid("9AZ", 3));
+
+  // Every position of a vector and of the tail is checked against characters around the alphabet
+  const char invalid[] = {'@', '[', '8', ':', 'a', 'z', '\0', '\x80', '\xc1', '\xff'};
+  for (size_t pos = 0; pos < 40; pos++) {
+    for (size_t i = 0; i < sizeof(invalid); i++) {
+      const char c = trytes[pos];
+      trytes[pos] = invalid[i];
+      TEST_ASSERT_FALSE(trytes_valid(trytes, 40));
+      TEST_ASSERT_TRUE(trytes_valid(trytes + pos + 1, 40));
+      trytes[pos] = c;
+    }
+  }
+}
+
+void test_trytes_values(void) {
+  const char tryte_alphabet[] = "NOPQRSTUVWXYZ9ABCDEFGHIJKLM";
+  tryte_t trytes[100], decoded[100];
+  int8_t values[100];
+
+  // Lengths around the vector widths, with every tryte at every position
+  for (size_t len = 0; len < sizeof(trytes); len++) {
+    for (size_t i = 0; i < len; i++) {
+      trytes[i] = tryte_alphabet[(i + len) % TRINARY_ALPHABET_LEN];
+    }
+    trytes_to_values(trytes, values, len);
+    for (size_t i = 0; i < len; i++) {
+      TEST_ASSERT_EQUAL_INT8((int8_t)((i + len) % TRINARY_ALPHABET_LEN) - 13, values[i]);
+    }
+    TEST_ASSERT_EQUAL_INT32(SC_OK, values_to_trytes(values, decoded, len));
+    TEST_ASSERT_EQUAL_MEMORY(trytes, decoded, len);
+  }
+
+  // A value out of range at any position is rejected, in the vectors and in the tail
+  const int8_t out_of_range[] = {-128, -14, 14, 127};
+  for (size_t pos = 0; pos < sizeof(values); pos++) {
+    memset(values, 0, sizeof(values));
+    for (size_t i = 0; i < sizeof(out_of_range); i++) {
+      values[pos] = out_of_range[i];
+      TEST_ASSERT_EQUAL_INT32(SC_UTILS_WRONG_INPUT_ARG, values_to_trytes(values, decoded, sizeof(values)));
+    }
+  }
+
+  // Characters out of the alphabet still give values in range
+  char all[256];
+  int8_t all_values[256];
+  for (int i = 0; i < 256; i++) {
+    all[i] = (char)i;
+  }
+  trytes_to_values((tryte_t*)all, all_values, sizeof(all));
+  for (int i = 0; i < 256; i++) {
+    TEST_ASSERT_TRUE(all_values[i] >= -13 && all_values[i] <= 13);
+  }
+}
+
+void test_flex_trits_simd_equivalence(void) {
+  const size_t lens[] = {1, 5, 15, 16, 17, 31, 32, 33, NUM_TRYTES_TAG, NUM_TRYTES_HASH, NUM_TRYTES_SIGNATURE,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION};
+  tryte_t trytes[NUM_TRYTES_SERIALIZED_TRANSACTION], trytes_simd[NUM_TRYTES_SERIALIZED_TRANSACTION];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION], trits_simd[NUM_TRITS_SERIALIZED_TRANSACTION];
+  flex_trit_t flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+  flex_trit_t flex_trits_simd[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+
+  for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+    const size_t num_trytes = lens[i], num_trits = num_trytes * 3;
+    const size_t num_flex_trits = NUM_FLEX_TRITS_FOR_TRITS(num_trits);
+    gen_rand_trytes(num_trytes, trytes);
+
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_from_trytes(flex_trits, num_trits, trytes, num_trytes, num_trytes));
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_from_trytes_simd(flex_trits_simd, num_trits, trytes, num_trytes, num_trytes));
+    TEST_ASSERT_EQUAL_MEMORY(flex_trits, flex_trits_simd, num_flex_trits);
+
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_to_trytes_simd(trytes_simd, num_trytes, flex_trits, num_trits, num_trits));
+    TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_simd, num_trytes);
+
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_to_trits(trits, num_trits, flex_trits, num_trits, num_trits));
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_to_trits_simd(trits_simd, num_trits, flex_trits, num_trits, num_trits));
+    TEST_ASSERT_EQUAL_INT8_ARRAY(trits, trits_simd, num_trits);
+
+    memset(flex_trits_simd, 0, sizeof(flex_trits_simd));
+    TEST_ASSERT_NOT_EQUAL(0, flex_trits_from_trits_simd(flex_trits_simd, num_trits, trits, num_trits, num_trits));
+    TEST_ASSERT_EQUAL_MEMORY(flex_trits, flex_trits_simd, num_flex_trits);
+
+    trytes_to_trits_simd(trytes, trits_simd, num_trytes);
+    TEST_ASSERT_EQUAL_INT8_ARRAY(trits, trits_simd, num_trits);
+    TEST_ASSERT_EQUAL_INT32(SC_OK, trits_to_trytes_simd(trits, trytes_simd, num_trytes));
+    TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_simd, num_trytes);
+  }
+
+  // Trits which are not a multiple of 3 and short buffers are handled as the library does
+  gen_rand_trytes(NUM_TRYTES_HASH, trytes);
+  flex_trits_from_trytes(flex_trits, NUM_TRITS_HASH, trytes, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  memset(trytes, 0, sizeof(trytes));
+  memset(trytes_simd, 0, sizeof(trytes_simd));
+  TEST_ASSERT_EQUAL_UINT(flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, flex_trits, NUM_TRITS_HASH, NUM_TRITS_HASH - 1),
+                         flex_trits_to_trytes_simd(trytes_simd, NUM_TRYTES_HASH, flex_trits, NUM_TRITS_HASH,
+                                                   NUM_TRITS_HASH - 1));
+  TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_simd, NUM_TRYTES_HASH);
+  TEST_ASSERT_EQUAL_UINT(0, flex_trits_to_trytes_simd(trytes_simd, NUM_TRYTES_HASH - 1, flex_trits, NUM_TRITS_HASH,
+                                                      NUM_TRITS_HASH));
+  TEST_ASSERT_EQUAL_UINT(0, flex_trits_from_trytes_simd(flex_trits_simd, NUM_TRITS_HASH - 3, trytes, NUM_TRYTES_HASH,
+                                                        NUM_TRYTES_HASH));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_trytes_valid);
+  RUN_TEST(test_trytes_values);
+  RUN_TEST(test_flex_trits_simd_equivalence);
+
+  return UNITY_END();
+}
@@ -10,5 +10,19 @@ def load_hiredis():
         build_file = "//third_party:BUILD.hiredis",
     )
 
+def load_zlib():
+    http_archive(
+        name = "zlib",
+        urls = [
+            "https://mirror.bazel.build/zlib.net/zlib-1.2.11.tar.gz",
+            "https://zlib.net/fossils/zlib-1.2.11.tar.gz",
+        ],
+        strip_prefix = "zlib-1.2.11",
+        sha256 =
+            "c3e5e9fdd5004dcb542feda5ee4f0ff0744628baf8ed2dd5d66f8ca1197cb1a1",
+        build_file = "//third_party:BUILD.zlib",
+    )
+
 def third_party_deps():
     load_hiredis()
+    load_zlib()
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "bloom_filter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define SECOND_HASH_SEED 0x9E3779B97F4A7C15ULL
+#define LN2 0.69314718055994530942
+
+static uint64_t fnv1a64(uint64_t hash, const uint8_t* const data, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief Derive the two base hashes of double hashing. The second one is forced to be odd, so it never degenerates into
+ * a single bit.
+ */
+static void base_hashes(const void* const data, const size_t len, uint64_t* h1, uint64_t* h2) {
+  *h1 = fnv1a64(FNV_OFFSET_BASIS, (const uint8_t*)data, len);
+  *h2 = fnv1a64(FNV_OFFSET_BASIS ^ SECOND_HASH_SEED, (const uint8_t*)data, len) | 1;
+}
+
+status_t bloom_filter_init(bloom_filter_t* const filter, const size_t capacity, const double false_positive_rate) {
+  if (filter == NULL) {
+    return SC_NULL;
+  }
+  if (capacity == 0 || false_positive_rate <= 0 || false_positive_rate >= 1) {
+    return SC_UTILS_WRONG_INPUT_ARG;
+  }
+
+  // m = -n * ln(p) / ln(2)^2, k = m / n * ln(2)
+  const double bits = -(double)capacity * log(false_positive_rate) / (LN2 * LN2);
+  filter->num_bits = ((size_t)ceil(bits) + 63) & ~(size_t)63;
+  filter->num_hashes = (uint32_t)ceil(bits / capacity * LN2);
+  filter->bits = (uint64_t*)calloc(filter->num_bits / 64, sizeof(uint64_t));
+  if (filter->bits == NULL) {
+    return SC_OOM;
+  }
+
+  return SC_OK;
+}
+
+void bloom_filter_destroy(bloom_filter_t* const filter) {
+  if (filter == NULL) {
+    return;
+  }
+  free(filter->bits);
+  filter->bits = NULL;
+  filter->num_bits = 0;
+}
+
+void bloom_filter_reset(bloom_filter_t* const filter) {
+  if (filter == NULL || filter->bits == NULL) {
+    return;
+  }
+  memset(filter->bits, 0, filter->num_bits / 8);
+}
+
+void bloom_filter_add(bloom_filter_t* const filter, const void* const data, const size_t len) {
+  uint64_t h1 = 0, h2 = 0;
+  if (filter == NULL || filter->bits == NULL) {
+    return;
+  }
+
+  base_hashes(data, len, &h1, &h2);
+  for (uint32_t i = 0; i < filter->num_hashes; i++) {
+    const size_t bit = (h1 + i * h2) % filter->num_bits;
+    __atomic_fetch_or(&filter->bits[bit / 64], 1ULL << (bit % 64), __ATOMIC_RELAXED);
+  }
+}
+
+bool bloom_filter_check(const bloom_filter_t* const filter, const void* const data, const size_t len) {
+  uint64_t h1 = 0, h2 = 0;
+  // Without a filter every element is possibly added
+  if (filter == NULL || filter->bits == NULL) {
+    return true;
+  }
+
+  base_hashes(data, len, &h1, &h2);
+  for (uint32_t i = 0; i < filter->num_hashes; i++) {
+    const size_t bit = (h1 + i * h2) % filter->num_bits;
+    if (!(__atomic_load_n(&filter->bits[bit / 64], __ATOMIC_RELAXED) & (1ULL << (bit % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
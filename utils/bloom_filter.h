@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_BLOOM_FILTER_H_
+#define UTILS_BLOOM_FILTER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/bloom_filter.h
+ * @brief Bloom filter for fast negative membership checks
+ *
+ * A Bloom filter answers whether an element has possibly been added, with no false negatives. Elements are hashed with
+ * double hashing of 64-bit FNV-1a. Adding and checking are lock-free, so a filter can be shared between threads.
+ */
+
+/** struct of bloom_filter_t */
+typedef struct bloom_filter_s {
+  uint64_t* bits;      /**< Bit array */
+  size_t num_bits;     /**< Number of bits in the bit array */
+  uint32_t num_hashes; /**< Number of bits set for each element */
+} bloom_filter_t;
+
+/**
+ * @brief Initialize a Bloom filter
+ *
+ * @param[out] filter Bloom filter to initialize
+ * @param[in] capacity Expected number of elements
+ * @param[in] false_positive_rate Expected false positive rate when `capacity` elements are added, in (0, 1)
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t bloom_filter_init(bloom_filter_t* const filter, const size_t capacity, const double false_positive_rate);
+
+/**
+ * @brief Release the bit array of a Bloom filter
+ *
+ * @param[in] filter Bloom filter
+ */
+void bloom_filter_destroy(bloom_filter_t* const filter);
+
+/**
+ * @brief Remove all the elements from a Bloom filter
+ *
+ * @param[in] filter Bloom filter
+ */
+void bloom_filter_reset(bloom_filter_t* const filter);
+
+/**
+ * @brief Add an element to a Bloom filter
+ *
+ * @param[in] filter Bloom filter
+ * @param[in] data Element
+ * @param[in] len Length of the element
+ */
+void bloom_filter_add(bloom_filter_t* const filter, const void* const data, const size_t len);
+
+/**
+ * @brief Check whether an element has possibly been added to a Bloom filter
+ *
+ * @param[in] filter Bloom filter
+ * @param[in] data Element
+ * @param[in] len Length of the element
+ *
+ * @return
+ * - true if the element has possibly been added
+ * - false if the element has never been added
+ */
+bool bloom_filter_check(const bloom_filter_t* const filter, const void* const data, const size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_BLOOM_FILTER_H_
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "buffer_pool.h"
+#include <malloc.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+typedef struct buffer_pool_s {
+  size_t num;
+  void* buf[BUFFER_POOL_SIZE];
+} buffer_pool_t;
+
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+
+static void pool_destroy(void* arg) {
+  buffer_pool_t* pool = (buffer_pool_t*)arg;
+  for (size_t i = 0; i < pool->num; i++) {
+    free(pool->buf[i]);
+  }
+  free(pool);
+}
+
+static void pool_key_init() { pthread_key_create(&pool_key, pool_destroy); }
+
+/**
+ * @brief Get the pool of the current thread, which is freed when the thread exits
+ */
+static buffer_pool_t* pool_get() {
+  pthread_once(&pool_key_once, pool_key_init);
+  buffer_pool_t* pool = (buffer_pool_t*)pthread_getspecific(pool_key);
+  if (pool == NULL) {
+    pool = (buffer_pool_t*)calloc(1, sizeof(buffer_pool_t));
+    if (pool != NULL && pthread_setspecific(pool_key, pool) != 0) {
+      free(pool);
+      pool = NULL;
+    }
+  }
+  return pool;
+}
+
+void* buffer_pool_alloc(const size_t size, size_t* const capacity) {
+  buffer_pool_t* pool = pool_get();
+  void* buf = NULL;
+
+  if (pool != NULL) {
+    // The smallest buffer which is large enough
+    size_t best = pool->num;
+    for (size_t i = 0; i < pool->num; i++) {
+      const size_t usable = malloc_usable_size(pool->buf[i]);
+      if (usable >= size && (best == pool->num || usable < malloc_usable_size(pool->buf[best]))) {
+        best = i;
+      }
+    }
+    if (best < pool->num) {
+      buf = pool->buf[best];
+      pool->buf[best] = pool->buf[--pool->num];
+    }
+  }
+
+  if (buf == NULL) {
+    buf = malloc(size ? size : 1);
+    if (buf == NULL) {
+      return NULL;
+    }
+  }
+  if (capacity) {
+    *capacity = malloc_usable_size(buf);
+  }
+  return buf;
+}
+
+void buffer_pool_release(void* buf) {
+  if (buf == NULL) {
+    return;
+  }
+
+  const size_t usable = malloc_usable_size(buf);
+  buffer_pool_t* pool = NULL;
+  if (usable < BUFFER_POOL_MIN_CAPACITY || usable > BUFFER_POOL_MAX_CAPACITY || (pool = pool_get()) == NULL) {
+    free(buf);
+    return;
+  }
+
+  if (pool->num < BUFFER_POOL_SIZE) {
+    pool->buf[pool->num++] = buf;
+    return;
+  }
+
+  // The pool is full, so the smallest buffer is dropped
+  size_t smallest = 0;
+  for (size_t i = 1; i < pool->num; i++) {
+    if (malloc_usable_size(pool->buf[i]) < malloc_usable_size(pool->buf[smallest])) {
+      smallest = i;
+    }
+  }
+  if (malloc_usable_size(pool->buf[smallest]) < usable) {
+    free(pool->buf[smallest]);
+    pool->buf[smallest] = buf;
+  } else {
+    free(buf);
+  }
+}
+
+size_t buffer_pool_cached() {
+  buffer_pool_t* pool = pool_get();
+  return pool ? pool->num : 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_BUFFER_POOL_H_
+#define UTILS_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/buffer_pool.h
+ * @brief Per-thread pool of output buffers
+ *
+ * Released buffers are kept by the releasing thread and handed out again by `buffer_pool_alloc()` on the same thread,
+ * so a thread answering requests one after another reuses the buffers of the previous responses. Buffers of the pool
+ * are ordinary heap blocks, which can be grown with `realloc()` or released with `free()` as well.
+ */
+
+#define BUFFER_POOL_SIZE 4                      /**< Maximum number of buffers kept by a thread */
+#define BUFFER_POOL_MIN_CAPACITY 4096           /**< Smaller buffers are freed instead of being kept */
+#define BUFFER_POOL_MAX_CAPACITY (1024 * 1024)  /**< Larger buffers are freed instead of being kept */
+
+/**
+ * @brief Get a buffer of the current thread's pool, or allocate a new one
+ *
+ * @param[in] size Required size
+ * @param[out] capacity Usable size of the buffer, which is at least `size`. It could be NULL.
+ *
+ * @return
+ * - The buffer on success
+ * - NULL on error of allocation
+ */
+void* buffer_pool_alloc(const size_t size, size_t* const capacity);
+
+/**
+ * @brief Return a buffer to the current thread's pool, or free it if it is not worth keeping
+ *
+ * The signature fits the free callback of libmicrohttpd responses.
+ *
+ * @param[in] buf Buffer allocated with `malloc()` family or `buffer_pool_alloc()`. NULL is ignored.
+ */
+void buffer_pool_release(void* buf);
+
+/**
+ * @brief Number of buffers kept in the current thread's pool
+ *
+ * @return Number of buffers
+ */
+size_t buffer_pool_cached();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_BUFFER_POOL_H_
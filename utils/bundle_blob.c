@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "bundle_blob.h"
+#include <stdlib.h>
+#include <string.h>
+#include "common/model/transaction.h"
+#include "utils/trit_pack.h"
+
+#define PACKED_TXN_SIZE TRIT_PACK_SIZE(NUM_TRITS_SERIALIZED_TRANSACTION)
+
+static size_t txn_size(const uint8_t version) {
+  return (version == BUNDLE_BLOB_VERSION_FLEX) ? NUM_FLEX_TRITS_SERIALIZED_TRANSACTION : PACKED_TXN_SIZE;
+}
+
+static void put_le(uint8_t* buf, uint64_t value, const int size) {
+  for (int i = 0; i < size; i++) {
+    buf[i] = (uint8_t)(value & 0xFF);
+    value >>= 8;
+  }
+}
+
+static uint64_t get_le(const uint8_t* buf, const int size) {
+  uint64_t value = 0;
+  for (int i = size - 1; i >= 0; i--) {
+    value = (value << 8) | buf[i];
+  }
+  return value;
+}
+
+status_t bundle_blob_encode(const bundle_blob_header_t* const header, const hash8019_array_p txn_array, char** blob,
+                            size_t* blob_len) {
+  if (header == NULL || txn_array == NULL || blob == NULL || blob_len == NULL) {
+    return SC_NULL;
+  }
+
+  const size_t txn_num = hash_array_len(txn_array);
+  if (txn_num > UINT16_MAX) {
+    return SC_UTILS_OVERFLOW_ERROR;
+  }
+
+  *blob_len = BUNDLE_BLOB_HEADER_SIZE + txn_num * PACKED_TXN_SIZE;
+  uint8_t* buf = (uint8_t*)malloc(*blob_len);
+  if (buf == NULL) {
+    return SC_OOM;
+  }
+
+  buf[0] = BUNDLE_BLOB_VERSION;
+  buf[1] = header->mwm;
+  put_le(buf + 2, txn_num, 2);
+  put_le(buf + 4, header->buffered_timestamp, 8);
+  put_le(buf + 12, header->broadcast_timestamp, 8);
+
+  uint8_t* payload = buf + BUNDLE_BLOB_HEADER_SIZE;
+  for (size_t i = 0; i < txn_num; i++) {
+    flex_trits_pack(hash_array_at(txn_array, i), NUM_TRITS_SERIALIZED_TRANSACTION, payload);
+    payload += PACKED_TXN_SIZE;
+  }
+
+  *blob = (char*)buf;
+  return SC_OK;
+}
+
+status_t bundle_blob_decode_header(const char* const blob, const size_t blob_len, bundle_blob_header_t* const header) {
+  if (blob == NULL || header == NULL) {
+    return SC_NULL;
+  }
+
+  const uint8_t* buf = (const uint8_t*)blob;
+  if (blob_len < BUNDLE_BLOB_HEADER_SIZE || (buf[0] != BUNDLE_BLOB_VERSION && buf[0] != BUNDLE_BLOB_VERSION_FLEX)) {
+    return SC_UTILS_BLOB_MALFORMED;
+  }
+
+  header->version = buf[0];
+  header->mwm = buf[1];
+  header->txn_num = (uint16_t)get_le(buf + 2, 2);
+  header->buffered_timestamp = get_le(buf + 4, 8);
+  header->broadcast_timestamp = get_le(buf + 12, 8);
+
+  if (blob_len != BUNDLE_BLOB_HEADER_SIZE + header->txn_num * txn_size(header->version)) {
+    return SC_UTILS_BLOB_MALFORMED;
+  }
+
+  return SC_OK;
+}
+
+status_t bundle_blob_decode(const char* const blob, const size_t blob_len, bundle_blob_header_t* const header,
+                            hash8019_array_p txn_array) {
+  if (txn_array == NULL) {
+    return SC_NULL;
+  }
+
+  status_t ret = bundle_blob_decode_header(blob, blob_len, header);
+  if (ret) {
+    return ret;
+  }
+
+  const uint8_t* payload = (const uint8_t*)(blob + BUNDLE_BLOB_HEADER_SIZE);
+  const size_t size = txn_size(header->version);
+  for (int i = 0; i < header->txn_num; i++) {
+    if (header->version == BUNDLE_BLOB_VERSION_FLEX) {
+      hash_array_push(txn_array, payload);
+    } else {
+      flex_trit_t txn_flex_trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+      ret = flex_trits_unpack(payload, NUM_TRITS_SERIALIZED_TRANSACTION, txn_flex_trits);
+      if (ret) {
+        return ret;
+      }
+      hash_array_push(txn_array, txn_flex_trits);
+    }
+    payload += size;
+  }
+
+  return SC_OK;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_BUNDLE_BLOB_H_
+#define UTILS_BUNDLE_BLOB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "utils/containers/hash/hash_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/bundle_blob.h
+ * @brief Compact binary blob of a buffered bundle
+ *
+ * A buffered bundle is stored in the cache server as a single value, so it can be written and read with a single
+ * command. The blob starts with a fixed-size header followed by the serialized transactions in packed trits.
+ * Transactions are packed with 5 trits per byte (see `utils/trit_pack.h`) since version 2, which takes 1604 bytes for
+ * each transaction. Blobs of version 1 carrying transactions in `flex_trit_t` can still be decoded.
+ *
+ * | Offset | Size | Field                          |
+ * | ------ | ---- | ------------------------------ |
+ * | 0      | 1    | Format version                 |
+ * | 1      | 1    | Minimum weight magnitude       |
+ * | 2      | 2    | Number of transactions         |
+ * | 4      | 8    | Buffered timestamp (ms)        |
+ * | 12     | 8    | Broadcast timestamp (ms)       |
+ * | 20     | -    | Serialized transactions        |
+ *
+ * All the integers are stored in little-endian.
+ */
+
+#define BUNDLE_BLOB_VERSION 2      /**< Current format version of the blob */
+#define BUNDLE_BLOB_VERSION_FLEX 1 /**< Format version of the blob carrying transactions in flex_trit_t */
+#define BUNDLE_BLOB_HEADER_SIZE 20 /**< Size of the blob header in bytes */
+
+/** struct of bundle_blob_header_t */
+typedef struct bundle_blob_header_s {
+  uint8_t version;              /**< Format version of the blob */
+  uint8_t mwm;                  /**< Minimum weight magnitude the bundle would be attached with */
+  uint16_t txn_num;             /**< Number of transactions in the blob */
+  uint64_t buffered_timestamp;  /**< Timestamp in milliseconds when the bundle is buffered */
+  uint64_t broadcast_timestamp; /**< Timestamp in milliseconds when the bundle is broadcast. Zero if not broadcast */
+} bundle_blob_header_t;
+
+/**
+ * @brief Encode a bundle into a blob
+ *
+ * The `version` and `txn_num` fields of `header` are ignored, and the blob is always encoded with
+ * `BUNDLE_BLOB_VERSION`.
+ *
+ * @param[in] header Header of the blob
+ * @param[in] txn_array Serialized transactions in flex_trit_t
+ * @param[out] blob Encoded blob. It should be freed by the caller.
+ * @param[out] blob_len Length of the encoded blob
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t bundle_blob_encode(const bundle_blob_header_t* const header, const hash8019_array_p txn_array, char** blob,
+                            size_t* blob_len);
+
+/**
+ * @brief Decode the header of a blob
+ *
+ * @param[in] blob Encoded blob
+ * @param[in] blob_len Length of the encoded blob
+ * @param[out] header Decoded header
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_BLOB_MALFORMED if the blob is truncated or its version is unsupported
+ */
+status_t bundle_blob_decode_header(const char* const blob, const size_t blob_len, bundle_blob_header_t* const header);
+
+/**
+ * @brief Decode a blob into its header and serialized transactions
+ *
+ * @param[in] blob Encoded blob
+ * @param[in] blob_len Length of the encoded blob
+ * @param[out] header Decoded header
+ * @param[out] txn_array Serialized transactions in flex_trit_t are appended to it
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_BLOB_MALFORMED if the blob is truncated or its version is unsupported
+ * - SC_UTILS_TRIT_PACK_INVALID if the packed transactions are corrupted
+ */
+status_t bundle_blob_decode(const char* const blob, const size_t blob_len, bundle_blob_header_t* const header,
+                            hash8019_array_p txn_array);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_BUNDLE_BLOB_H_
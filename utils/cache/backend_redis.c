@@ -9,10 +9,12 @@
 #include <errno.h>
 #include <hiredis/hiredis.h>
 #include <limits.h>
+#include <time.h>
 #include "cache.h"
 #include "common/logger.h"
 
 #define BR_LOGGER "backend_redis"
+#define RECONNECT_INTERVAL_MS 1000 /**< Milliseconds between two attempts to re-establish the connection */
 
 /* private data used by cache_t */
 typedef struct {
@@ -22,6 +24,10 @@ typedef struct {
 
 static cache_t cache;
 static bool state = false;
+static pthread_mutex_t reconnect_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t next_reconnect_ms = 0; /**< Earliest time of the next attempt to reconnect. Held by `reconnect_lock`. */
+static cache_reconnect_t reconnect_callback = NULL;
+static void* reconnect_arg = NULL;
 static logger_id_t logger_id;
 
 /*
@@ -43,7 +49,7 @@ static status_t redis_del(redisContext* c, const char* const key) {
   }
 
   redisReply* reply = redisCommand(c, "DEL %s", key);
-  if (!reply->integer) {
+  if (reply == NULL || !reply->integer) {
     ret = SC_CACHE_FAILED_RESPONSE;
     ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
   }
@@ -61,7 +67,7 @@ static status_t redis_get(redisContext* c, const char* const key, char** res) {
   *res = NULL;
 
   redisReply* reply = redisCommand(c, "GET %s", key);
-  if (reply->type == REDIS_REPLY_STRING) {
+  if (reply && reply->type == REDIS_REPLY_STRING) {
     *res = strdup(reply->str);
   } else {
     ret = SC_CACHE_FAILED_RESPONSE;
@@ -72,22 +78,75 @@ static status_t redis_get(redisContext* c, const char* const key, char** res) {
   return ret;
 }
 
+static status_t redis_get_blob(redisContext* c, const char* const key, char** res, size_t* res_len) {
+  status_t ret = SC_OK;
+  if (key == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  *res = NULL;
+  *res_len = 0;
+
+  redisReply* reply = redisCommand(c, "GET %s", key);
+  if (reply && reply->type == REDIS_REPLY_STRING) {
+    // An empty value is returned as an empty blob, which is still freed by the caller
+    *res = (char*)malloc(reply->len ? reply->len : 1);
+    if (*res == NULL) {
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    memcpy(*res, reply->str, reply->len);
+    *res_len = reply->len;
+  } else {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+done:
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_exists(redisContext* c, const char* const key, bool* exist) {
+  status_t ret = SC_OK;
+  if (key == NULL || exist == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "EXISTS %s", key);
+  if (reply && reply->type == REDIS_REPLY_INTEGER) {
+    *exist = reply->integer > 0;
+  } else {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
 static status_t redis_set(redisContext* c, const char* const key, const int key_size, const void* const value,
-                          const int value_size, const int timeout) {
+                          const int value_size, const int timeout, const bool overwrite) {
   status_t ret = SC_OK;
   if (c == NULL || key == NULL || value == NULL) {
     ta_log_error("%s\n", ta_error_to_string(SC_NULL));
     return SC_NULL;
   }
 
+  // A single `SET` replaces the value and the timeout at once, so readers never see the key missing
   redisReply* reply = NULL;
   if (timeout > 0) {
-    reply = redisCommand(c, "SET %b %b EX %d NX", key, key_size, value, value_size, timeout);
+    reply = overwrite ? redisCommand(c, "SET %b %b EX %d", key, key_size, value, value_size, timeout)
+                      : redisCommand(c, "SET %b %b EX %d NX", key, key_size, value, value_size, timeout);
   } else {
-    reply = redisCommand(c, "SET %b %b NX", key, key_size, value, value_size);
+    reply = overwrite ? redisCommand(c, "SET %b %b", key, key_size, value, value_size)
+                      : redisCommand(c, "SET %b %b NX", key, key_size, value, value_size);
   }
 
-  if (reply->type != REDIS_REPLY_STATUS) {
+  if (reply == NULL || reply->type != REDIS_REPLY_STATUS) {
+    ret = SC_CACHE_FAILED_RESPONSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
 
@@ -105,7 +164,7 @@ static status_t redis_list_push(redisContext* c, const char* const key, const in
 
   redisReply* reply = NULL;
   reply = redisCommand(c, "LPUSH %b %b", key, key_size, value, value_size);
-  if (reply->type == REDIS_REPLY_ERROR) {
+  if (reply == NULL || reply->type == REDIS_REPLY_ERROR) {
     ret = SC_CACHE_FAILED_RESPONSE;
     ta_log_error("%s\n", ta_error_to_string(ret));
   }
@@ -122,7 +181,7 @@ static status_t redis_list_at(redisContext* c, const char* const key, const int
   }
 
   redisReply* reply = redisCommand(c, "LINDEX %s %d", key, index);
-  if (reply->type == REDIS_REPLY_STRING && ((int)reply->len) <= res_len) {
+  if (reply && reply->type == REDIS_REPLY_STRING && ((int)reply->len) <= res_len) {
     strncpy(res, reply->str, reply->len);
     res[reply->len] = 0;
   } else {
@@ -142,7 +201,7 @@ static status_t redis_list_peek(redisContext* c, const char* const key, const in
   }
 
   redisReply* reply = redisCommand(c, "LINDEX %s %d", key, 0);
-  if (reply->type == REDIS_REPLY_STRING && ((int)reply->len) <= res_len) {
+  if (reply && reply->type == REDIS_REPLY_STRING && ((int)reply->len) <= res_len) {
     strncpy(res, reply->str, reply->len);
     res[reply->len] = 0;
   } else {
@@ -154,6 +213,65 @@ static status_t redis_list_peek(redisContext* c, const char* const key, const in
   return ret;
 }
 
+static status_t redis_list_range(redisContext* c, const char* const key, const int value_len, char** res, int* num) {
+  status_t ret = SC_OK;
+  if (key == NULL || res == NULL || num == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  *res = NULL;
+  *num = 0;
+
+  redisReply* reply = redisCommand(c, "LRANGE %s 0 -1", key);
+  if (reply == NULL || reply->type != REDIS_REPLY_ARRAY) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  *res = (char*)malloc(reply->elements * value_len + 1);
+  if (*res == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+  for (size_t i = 0; i < reply->elements; ++i) {
+    const redisReply* element = reply->element[i];
+    if (element->type != REDIS_REPLY_STRING || (int)element->len != value_len) {
+      ret = SC_CACHE_FAILED_RESPONSE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      free(*res);
+      *res = NULL;
+      goto done;
+    }
+    memcpy(*res + i * value_len, element->str, value_len);
+  }
+  *num = (int)reply->elements;
+
+done:
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_is_list(redisContext* c, const char* const key, bool* is_list) {
+  status_t ret = SC_OK;
+  if (key == NULL || is_list == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "TYPE %s", key);
+  if (reply && reply->type == REDIS_REPLY_STATUS) {
+    *is_list = !strcmp(reply->str, "list");
+  } else {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
 static status_t redis_list_size(redisContext* c, const char* const key, int* len) {
   status_t ret = SC_OK;
   if (key == NULL) {
@@ -162,7 +280,7 @@ static status_t redis_list_size(redisContext* c, const char* const key, int* len
   }
 
   redisReply* reply = redisCommand(c, "LLEN %s", key);
-  if (reply->type != REDIS_REPLY_ERROR) {
+  if (reply && reply->type != REDIS_REPLY_ERROR) {
     // We constrain the length should less than the maximun of `int`
     *len = (int)reply->integer;
   } else {
@@ -212,7 +330,27 @@ static status_t redis_list_pop(redisContext* c, const char* const key, char* res
   }
 
   redisReply* reply = redisCommand(c, "LPOP %s", key);
-  if (reply->type == REDIS_REPLY_STRING) {
+  if (reply && reply->type == REDIS_REPLY_STRING) {
+    strncpy(res, reply->str, reply->len);
+    res[reply->len] = 0;
+  } else {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_list_pop_tail(redisContext* c, const char* const key, char* res) {
+  status_t ret = SC_OK;
+  if (key == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "RPOP %s", key);
+  if (reply && reply->type == REDIS_REPLY_STRING) {
     strncpy(res, reply->str, reply->len);
     res[reply->len] = 0;
   } else {
@@ -224,19 +362,74 @@ static status_t redis_list_pop(redisContext* c, const char* const key, char* res
   return ret;
 }
 
+static status_t redis_list_remove(redisContext* c, const char* const key, const char* const value,
+                                  const int value_len) {
+  status_t ret = SC_OK;
+  if (key == NULL || value == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "LREM %s 0 %b", key, value, value_len);
+  if (reply == NULL || reply->type != REDIS_REPLY_INTEGER) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_expire(redisContext* c, const char* const key, const int timeout) {
+  status_t ret = SC_OK;
+  if (key == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "EXPIRE %s %d", key, timeout);
+  if (reply == NULL || reply->type != REDIS_REPLY_INTEGER || !reply->integer) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_memory_usage(redisContext* c, const char* const key, long int* bytes) {
+  status_t ret = SC_OK;
+  if (key == NULL || bytes == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  redisReply* reply = redisCommand(c, "MEMORY USAGE %s", key);
+  if (reply && reply->type == REDIS_REPLY_INTEGER) {
+    *bytes = reply->integer;
+  } else if (reply && reply->type == REDIS_REPLY_NIL) {
+    *bytes = 0;
+  } else {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
 long int redis_occupied_space(redisContext* c) {
   const char size_field[] = "used_memory:";
-  redisReply* reply = redisCommand(c, "INFO");
-  if (reply->type == REDIS_REPLY_STRING) {
+  redisReply* reply = redisCommand(c, "INFO memory");
+  if (reply && reply->type == REDIS_REPLY_STRING && strstr(reply->str, size_field)) {
     // Parsing the result returned by redis. Get information from field `used_memory`
-    char* str = strstr(reply->str, size_field);
-    char* size_str = strtok(str, "\n");
-    char* ptr = size_str + strlen(size_field);
+    char* ptr = strstr(reply->str, size_field) + strlen(size_field);
 
     char* strtol_p = NULL;
     long int strtol_temp;
+    errno = 0;
     strtol_temp = strtol(ptr, &strtol_p, 10);
-    if (strtol_p != ptr && errno != ERANGE && strtol_temp >= INT_MIN && strtol_temp <= INT_MAX) {
+    if (strtol_p != ptr && errno != ERANGE && strtol_temp >= 0) {
       freeReplyObject(reply);
       return strtol_temp;
     } else {
@@ -260,6 +453,54 @@ void redis_get_capacity(redisContext* c) {
   printf("%s\n", reply->element[1]->str);
 }
 
+static uint64_t monotonic_ms() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Check whether the cache server is available. A broken connection is re-established, so the cache server comes
+ * back without restarting tangle-accelerator.
+ *
+ * Reconnecting blocks until the connection is refused or times out, so it is attempted once in every
+ * `RECONNECT_INTERVAL_MS` by a single thread. Other calls in the meantime find the cache server unavailable at once
+ * instead of waiting for the attempt.
+ */
+static bool cache_connected() {
+  if (!state || cache.conn == NULL || CONN(cache)->rc == NULL) {
+    return false;
+  }
+  if (!CONN(cache)->rc->err) {
+    return true;
+  }
+
+  // The context is shared by all the threads, so only one of them re-establishes it
+  if (pthread_mutex_trylock(&reconnect_lock)) {
+    return false;
+  }
+  bool connected = true, reconnected = false;
+  if (CONN(cache)->rc->err) {
+    const uint64_t now = monotonic_ms();
+    connected = false;
+    if (now >= next_reconnect_ms) {
+      connected = reconnected = (redisReconnect(CONN(cache)->rc) == REDIS_OK);
+      next_reconnect_ms = monotonic_ms() + RECONNECT_INTERVAL_MS;
+    }
+  }
+  const cache_reconnect_t callback = reconnect_callback;
+  void* const arg = reconnect_arg;
+  pthread_mutex_unlock(&reconnect_lock);
+
+  if (reconnected) {
+    ta_log_info("Reconnected to cache server\n");
+    if (callback) {
+      callback(arg);
+    }
+  }
+  return connected;
+}
+
 /*
  * Public functions
  */
@@ -271,22 +512,31 @@ bool cache_init(pthread_rwlock_t** rwlock, bool input_state, const char* host, i
     return false;
   }
 
-  cache.conn = (connection_private*)malloc(sizeof(connection_private));
-  CONN(cache)->rc = redisConnect(host, port);
-  if (!CONN(cache)->rc || CONN(cache)->rc->err) {
-    ta_log_error("Failed to initialize redis: %d\n", CONN(cache)->rc->err);
-    return false;
-  }
-
+  // The lock is initialized even if the cache server is unreachable for now, since the connection is re-established
+  // once the cache server comes back.
   *rwlock = (pthread_rwlock_t*)malloc(sizeof(pthread_rwlock_t));
   if (pthread_rwlock_init(*rwlock, NULL)) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_INIT_FINI));
     return SC_CACHE_INIT_FINI;
   }
 
+  cache.conn = (connection_private*)malloc(sizeof(connection_private));
+  CONN(cache)->rc = redisConnect(host, port);
+  if (!CONN(cache)->rc || CONN(cache)->rc->err) {
+    ta_log_error("Failed to initialize redis: %s\n", CONN(cache)->rc ? CONN(cache)->rc->errstr : "");
+    return false;
+  }
+
   return true;
 }
 
+void cache_set_reconnect_callback(cache_reconnect_t callback, void* const arg) {
+  pthread_mutex_lock(&reconnect_lock);
+  reconnect_callback = callback;
+  reconnect_arg = arg;
+  pthread_mutex_unlock(&reconnect_lock);
+}
+
 void cache_stop(pthread_rwlock_t** rwlock) {
   if (state == true && CONN(cache)->rc) {
     redisFree(CONN(cache)->rc);
@@ -303,7 +553,7 @@ void cache_stop(pthread_rwlock_t** rwlock) {
 }
 
 status_t cache_del(const char* const key) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -311,24 +561,49 @@ status_t cache_del(const char* const key) {
 }
 
 status_t cache_get(const char* const key, char** res) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
   return redis_get(CONN(cache)->rc, key, res);
 }
 
+status_t cache_get_blob(const char* const key, char** res, size_t* res_len) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_get_blob(CONN(cache)->rc, key, res, res_len);
+}
+
+status_t cache_exists(const char* const key, bool* exist) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_exists(CONN(cache)->rc, key, exist);
+}
+
 status_t cache_set(const char* const key, const int key_size, const void* const value, const int value_size,
                    const int timeout) {
-  if (!state) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_set(CONN(cache)->rc, key, key_size, value, value_size, timeout, false);
+}
+
+status_t cache_set_overwrite(const char* const key, const int key_size, const void* const value, const int value_size,
+                             const int timeout) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
-  return redis_set(CONN(cache)->rc, key, key_size, value, value_size, timeout);
+  return redis_set(CONN(cache)->rc, key, key_size, value, value_size, timeout, true);
 }
 
 status_t cache_list_push(const char* const key, const int key_size, const void* const value, const int value_size) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -336,7 +611,7 @@ status_t cache_list_push(const char* const key, const int key_size, const void*
 }
 
 status_t cache_list_at(const char* const key, const int index, const int res_len, char* res) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -344,15 +619,31 @@ status_t cache_list_at(const char* const key, const int index, const int res_len
 }
 
 status_t cache_list_peek(const char* const key, const int res_len, char* res) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
   return redis_list_peek(CONN(cache)->rc, key, res_len, res);
 }
 
+status_t cache_list_range(const char* const key, const int value_len, char** res, int* num) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_list_range(CONN(cache)->rc, key, value_len, res, num);
+}
+
+status_t cache_is_list(const char* const key, bool* is_list) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_is_list(CONN(cache)->rc, key, is_list);
+}
+
 status_t cache_list_size(const char* const key, int* len) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -360,7 +651,7 @@ status_t cache_list_size(const char* const key, int* len) {
 }
 
 status_t cache_list_exist(const char* const key, const char* const value, const int value_len, bool* exist) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -368,24 +659,56 @@ status_t cache_list_exist(const char* const key, const char* const value, const
 }
 
 status_t cache_list_pop(const char* const key, char* res) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
   return redis_list_pop(CONN(cache)->rc, key, res);
 }
 
-long int cache_occupied_space() {
-  if (!state) {
+status_t cache_list_pop_tail(const char* const key, char* res) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_list_pop_tail(CONN(cache)->rc, key, res);
+}
+
+status_t cache_list_remove(const char* const key, const char* const value, const int value_len) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
+  return redis_list_remove(CONN(cache)->rc, key, value, value_len);
+}
+
+status_t cache_expire(const char* const key, const int timeout) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_expire(CONN(cache)->rc, key, timeout);
+}
+
+long int cache_occupied_space() {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return -1;
+  }
 
   return redis_occupied_space(CONN(cache)->rc);
 }
 
+status_t cache_memory_usage(const char* const key, long int* bytes) {
+  if (!cache_connected()) {
+    ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
+    return SC_CACHE_OFF;
+  }
+  return redis_memory_usage(CONN(cache)->rc, key, bytes);
+}
+
 long int cache_set_capacity(char* size) {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
@@ -395,7 +718,7 @@ long int cache_set_capacity(char* size) {
 }
 
 long int cache_get_capacity() {
-  if (!state) {
+  if (!cache_connected()) {
     ta_log_debug("%s\n", ta_error_to_string(SC_CACHE_OFF));
     return SC_CACHE_OFF;
   }
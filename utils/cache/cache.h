@@ -27,6 +27,13 @@ extern "C" {
  * @example unit-test/test_cache.c
  */
 
+/**
+ * @brief Function called once the connection to the cache server is re-established
+ *
+ * @param[in] arg Argument given to `cache_set_reconnect_callback()`
+ */
+typedef void (*cache_reconnect_t)(void* const arg);
+
 /** struct of cache_t */
 typedef struct {
   /** @cond private data */
@@ -54,6 +61,17 @@ bool cache_init(pthread_rwlock_t** rwlock, bool input_state, const char* host, i
  */
 void cache_stop(pthread_rwlock_t** rwlock);
 
+/**
+ * @brief Set the function called once a broken connection to the cache server is re-established
+ *
+ * The function is called by the thread which re-establishes the connection, which may hold any lock of the caller of
+ * the cache module. It should only signal another thread instead of accessing the cache server.
+ *
+ * @param[in] callback Function to call. NULL disables the callback.
+ * @param[in] arg Argument passed to `callback`
+ */
+void cache_set_reconnect_callback(cache_reconnect_t callback, void* const arg);
+
 /**
  * @brief Delete certain key-value storage from cache
  *
@@ -78,7 +96,32 @@ status_t cache_del(const char* const key);
 status_t cache_get(const char* const key, char** res);
 
 /**
- * @brief Set key-value storage in in-memory cache
+ * @brief Get binary-safe key-value storage from in-memory cache
+ *
+ * @param[in] key Key string to search
+ * @param[out] res Result of GET key. It should be freed by the caller, even if the value is empty.
+ * @param[out] res_len Length of the result
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_get_blob(const char* const key, char** res, size_t* res_len);
+
+/**
+ * @brief Check whether a key exists in in-memory cache
+ *
+ * @param[in] key Key string to search
+ * @param[out] exist Whether the key exists
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_exists(const char* const key, bool* exist);
+
+/**
+ * @brief Set key-value storage in in-memory cache. An existing key is not overwritten.
  *
  * @param[in] key Key string to store
  * @param[in] key_size Size of key string to store
@@ -88,11 +131,28 @@ status_t cache_get(const char* const key, char** res);
  *
  * @return
  * - SC_OK on success
+ * - SC_CACHE_FAILED_RESPONSE if the key exists
  * - non-zero on error
  */
 status_t cache_set(const char* const key, const int key_size, const void* const value, const int value_size,
                    const int timeout);
 
+/**
+ * @brief Set key-value storage in in-memory cache, replacing the value of an existing key at once
+ *
+ * @param[in] key Key string to store
+ * @param[in] key_size Size of key string to store
+ * @param[in] value Value string to store
+ * @param[in] value_size Size of value string to store
+ * @param[in] timeout Set the timeout second of the key. If arg timeout equal less than 0, then no timeout will be set.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_set_overwrite(const char* const key, const int key_size, const void* const value, const int value_size,
+                             const int timeout);
+
 /**
  * @brief Push an element to a list in in-memory cache
  *
@@ -135,6 +195,33 @@ status_t cache_list_at(const char* const key, const int index, const int res_len
  */
 status_t cache_list_peek(const char* const key, const int res_len, char* res);
 
+/**
+ * @brief Get all the elements of a list with elements in the same length from in-memory cache
+ *
+ * @param[in] key Key string to search
+ * @param[in] value_len Length of each element
+ * @param[out] res Elements stored contiguously from the head of the list. It should be freed by the caller.
+ * @param[out] num Number of elements
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_FAILED_RESPONSE if an element is in another length
+ * - non-zero on error
+ */
+status_t cache_list_range(const char* const key, const int value_len, char** res, int* num);
+
+/**
+ * @brief Check whether the value of a key is a list in in-memory cache
+ *
+ * @param[in] key Key string to search
+ * @param[out] is_list Whether the value is a list. It is false if the key doesn't exist.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_is_list(const char* const key, bool* is_list);
+
 /**
  * @brief Fetch the length of the list in in-memory cache
  *
@@ -174,15 +261,67 @@ status_t cache_list_exist(const char* const key, const char* const value, const
  */
 status_t cache_list_pop(const char* const key, char* res);
 
+/**
+ * @brief Pop the oldest element from the tail of the list in in-memory cache
+ *
+ * Elements are pushed with `cache_list_push()` to the head, so the tail always holds the earliest pushed one.
+ *
+ * @param[in] key Key for key-value storage
+ * @param[out] res The popped element
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_list_pop_tail(const char* const key, char* res);
+
+/**
+ * @brief Remove all the elements equal to the given value from the list in in-memory cache
+ *
+ * @param[in] key Key for key-value storage
+ * @param[in] value Value string to remove
+ * @param[in] value_len Size of value string to remove
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_list_remove(const char* const key, const char* const value, const int value_len);
+
+/**
+ * @brief Set the timeout of an existing key in in-memory cache
+ *
+ * @param[in] key Key string to expire
+ * @param[in] timeout Timeout second of the key
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_expire(const char* const key, const int timeout);
+
 /**
  * @brief Get the occupied size by Redis in bytes.
  *
  * @return
  * - Used size of the cache database on success
- * - -1 on error
+ * - -1 on error or if the cache server is unavailable
  */
 long int cache_occupied_space();
 
+/**
+ * @brief Get the bytes occupied by a key and its value in the cache server
+ *
+ * @param[in] key Key string
+ * @param[out] bytes Occupied bytes, or 0 if the key does not exist
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_OFF if the cache server is unavailable
+ * - non-zero on error
+ */
+status_t cache_memory_usage(const char* const key, long int* bytes);
+
 /**
  * @brief Set maximum memory limit of Redis
  *
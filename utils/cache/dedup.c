@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "dedup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#include "common/logger.h"
+#include "utils/bloom_filter.h"
+
+#define CD_LOGGER "cache_dedup"
+#define DEDUP_KEY_LEN 128 /**< Digests are hashes in trytes, which are far shorter than this */
+
+static bloom_filter_t filter = {0};
+static logger_id_t logger_id;
+
+void cd_logger_init() { logger_id = logger_helper_enable(CD_LOGGER, LOGGER_DEBUG, true); }
+
+int cd_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+static status_t dedup_key(const char* const digest, char* key) {
+  if (digest == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  const int len = snprintf(key, DEDUP_KEY_LEN, "%s%s", CACHE_DEDUP_KEY_PREFIX, digest);
+  if (len < 0 || len >= DEDUP_KEY_LEN) {
+    ta_log_error("%s\n", ta_error_to_string(SC_UTILS_WRONG_INPUT_ARG));
+    return SC_UTILS_WRONG_INPUT_ARG;
+  }
+  return SC_OK;
+}
+
+/**
+ * @brief Find the request mapped by `key`. A mapping to a request which is no longer on `list_name`, i.e. which has
+ * been sent or evicted, is stale, and it is removed.
+ */
+static bool dedup_lookup(const char* const key, const char* const list_name, char* existing_uuid) {
+  char* mapped = NULL;
+  bool exist = false;
+  if (cache_get(key, &mapped) != SC_OK) {
+    return false;
+  }
+
+  if (strlen(mapped) == CACHE_DEDUP_UUID_LEN &&
+      cache_list_exist(list_name, mapped, CACHE_DEDUP_UUID_LEN, &exist) == SC_OK && exist) {
+    strncpy(existing_uuid, mapped, CACHE_DEDUP_UUID_LEN + 1);
+  } else {
+    ta_log_debug("Remove stale dedup mapping %s\n", key);
+    cache_del(key);
+    exist = false;
+  }
+  free(mapped);
+  return exist;
+}
+
+status_t cache_dedup_init(const size_t capacity) {
+  status_t ret = bloom_filter_init(&filter, capacity, CACHE_DEDUP_FALSE_POSITIVE_RATE);
+  if (ret) {
+    ta_log_error("%s\n", ta_error_to_string(ret));
+  }
+  return ret;
+}
+
+void cache_dedup_destroy() { bloom_filter_destroy(&filter); }
+
+status_t cache_dedup_claim(const char* const digest, const char* const uuid, const char* const list_name,
+                           const int window, char* existing_uuid, bool* duplicated) {
+  status_t ret = SC_OK;
+  char key[DEDUP_KEY_LEN];
+  if (uuid == NULL || list_name == NULL || existing_uuid == NULL || duplicated == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  if (window <= 0) {
+    ta_log_error("%s\n", ta_error_to_string(SC_UTILS_WRONG_INPUT_ARG));
+    return SC_UTILS_WRONG_INPUT_ARG;
+  }
+  ret = dedup_key(digest, key);
+  if (ret) {
+    return ret;
+  }
+  *duplicated = false;
+
+  // A negative answer of the Bloom filter saves the lookup of content which has never been buffered
+  if (bloom_filter_check(&filter, key, strlen(key)) && dedup_lookup(key, list_name, existing_uuid)) {
+    *duplicated = true;
+    return SC_OK;
+  }
+
+  // `SET NX` fails if the digest is claimed by a concurrent request, or before the process restarts. Look up the claim
+  // once more, and retry if the claim turns out to be stale.
+  for (int attempt = 0; attempt < 2; attempt++) {
+    ret = cache_set(key, strlen(key), uuid, strlen(uuid), window);
+    if (ret == SC_OK) {
+      bloom_filter_add(&filter, key, strlen(key));
+      return SC_OK;
+    }
+    if (ret == SC_CACHE_OFF) {
+      return ret;
+    }
+    if (dedup_lookup(key, list_name, existing_uuid)) {
+      bloom_filter_add(&filter, key, strlen(key));
+      *duplicated = true;
+      return SC_OK;
+    }
+  }
+
+  ta_log_error("%s\n", ta_error_to_string(ret));
+  return ret;
+}
+
+status_t cache_dedup_release(const char* const digest) {
+  char key[DEDUP_KEY_LEN];
+  status_t ret = dedup_key(digest, key);
+  if (ret) {
+    return ret;
+  }
+  return cache_del(key);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_CACHE_DEDUP_H_
+#define UTILS_CACHE_DEDUP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/cache/dedup.h
+ * @brief Deduplication of buffered requests by content digest
+ *
+ * The dedup module maps the content digest of a buffered request to the UUID it is buffered under. The mapping is
+ * stored in the cache server with `SET NX`, so concurrent requests with the same content are resolved by the cache
+ * server, and the mapping expires once the dedup window passes. An in-memory Bloom filter of claimed digests avoids
+ * looking up the cache server for content which has never been buffered.
+ */
+
+#define CACHE_DEDUP_KEY_PREFIX "dedup:"      /**< Prefix of the keys which map a digest to an UUID */
+#define CACHE_DEDUP_UUID_LEN 36              /**< Length of the UUID string of a buffered request */
+#define CACHE_DEDUP_FALSE_POSITIVE_RATE 0.01 /**< False positive rate of the Bloom filter at its capacity */
+
+/**
+ * @brief Initialize the Bloom filter of the dedup module
+ *
+ * Without initializing, every digest is looked up in the cache server.
+ *
+ * @param[in] capacity Expected number of digests claimed in a dedup window
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_dedup_init(const size_t capacity);
+
+/**
+ * @brief Release the Bloom filter of the dedup module
+ */
+void cache_dedup_destroy();
+
+/**
+ * @brief Claim a content digest for a new buffered request, or find the request buffered with the same content
+ *
+ * If the digest is mapped to a request which is still on `list_name`, the UUID of that request is returned in
+ * `existing_uuid` and `duplicated` is set. Otherwise, the digest is mapped to `uuid` for `window` seconds.
+ *
+ * @param[in] digest Content digest in a null-terminated string
+ * @param[in] uuid UUID of the new buffered request
+ * @param[in] list_name Name of the list of requests waiting to be sent. Requests which have left it are not matched.
+ * @param[in] window Seconds to keep the mapping. It must be greater than 0.
+ * @param[out] existing_uuid UUID of the request with the same content. It must hold `CACHE_DEDUP_UUID_LEN + 1` bytes.
+ * @param[out] duplicated Whether a request with the same content is buffered
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_OFF if the cache server is unavailable
+ * - non-zero on error
+ */
+status_t cache_dedup_claim(const char* const digest, const char* const uuid, const char* const list_name,
+                           const int window, char* existing_uuid, bool* duplicated);
+
+/**
+ * @brief Release a digest claimed by `cache_dedup_claim()`, if the request fails to be buffered
+ *
+ * @param[in] digest Content digest in a null-terminated string
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_dedup_release(const char* const digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_CACHE_DEDUP_H_
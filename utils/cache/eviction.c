@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "eviction.h"
+#include <time.h>
+#include "cache.h"
+#include "common/logger.h"
+#include "uthash.h"
+
+#define CE_LOGGER "cache_eviction"
+#define EVICTION_KEY_LEN 64 /**< Buffered requests are keyed with UUID, which is far shorter than this */
+
+typedef struct eviction_entry_s {
+  char* key;
+  const char* list_name; /**< NULL until the request is completed */
+  long int bytes;
+  time_t expire_at; /**< Zero if the request never expires */
+  UT_hash_handle hh;
+} eviction_entry_t;
+
+static eviction_entry_t* entries = NULL;
+static long int tracked_bytes = 0;
+static long int untracked_bytes = 0; /**< Other bytes in the cache server as of the last reconciliation */
+static uint64_t total_evicted = 0;
+static uint64_t total_expired = 0;
+static pthread_mutex_t entries_lock = PTHREAD_MUTEX_INITIALIZER;
+static logger_id_t logger_id;
+
+void ce_logger_init() { logger_id = logger_helper_enable(CE_LOGGER, LOGGER_DEBUG, true); }
+
+int ce_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+static void entry_remove(eviction_entry_t* entry) {
+  tracked_bytes -= entry->bytes;
+  HASH_DEL(entries, entry);
+  free(entry->key);
+  free(entry);
+}
+
+/**
+ * @brief Remove the completed requests whose TTL is reached. The cache server has already dropped the keys, so only the
+ * UUID left in the completed list needs to be removed.
+ *
+ * Must be called with `entries_lock` held.
+ */
+static int expire_entries(const time_t now) {
+  int expired = 0;
+  eviction_entry_t *entry = NULL, *tmp = NULL;
+  HASH_ITER(hh, entries, entry, tmp) {
+    if (entry->expire_at == 0 || entry->expire_at > now) {
+      continue;
+    }
+    if (cache_list_remove(entry->list_name, entry->key, strlen(entry->key)) != SC_OK) {
+      ta_log_warning("Failed to remove expired request %s from %s\n", entry->key, entry->list_name);
+    }
+    entry_remove(entry);
+    expired++;
+  }
+  return expired;
+}
+
+/**
+ * @brief Read the occupied space of the cache server, and attribute whatever is not tracked to `untracked_bytes`
+ *
+ * Untracked bytes are the keys written by other modules, e.g., dedup mappings, MAM cursors and payloads and
+ * pre-serialized transactions, requests buffered before restarting and the overhead of the cache server. If the
+ * cache server is unavailable, the last reconciliation is kept.
+ *
+ * Must be called with `entries_lock` held.
+ */
+static void reconcile_usage() {
+  const long int occupied = cache_occupied_space();
+  if (occupied < 0) {
+    return;
+  }
+  untracked_bytes = (occupied > tracked_bytes) ? occupied - tracked_bytes : 0;
+}
+
+/**
+ * @brief Evict at most `CACHE_EVICTION_BATCH_SIZE` of the oldest completed requests until the usage meets
+ * `low_water`.
+ *
+ * Must be called with `entries_lock` held.
+ */
+static status_t evict_batch(const long int low_water, const char* const list_names[], const int list_num,
+                            int* evicted, bool* drained) {
+  status_t ret = SC_OK;
+  char key[EVICTION_KEY_LEN];
+  int list_idx = 0;
+  *drained = false;
+
+  for (int i = 0; i < CACHE_EVICTION_BATCH_SIZE && tracked_bytes + untracked_bytes > low_water; i++) {
+    int list_len = 0;
+    while (list_idx < list_num) {
+      ret = cache_list_size(list_names[list_idx], &list_len);
+      if (ret) {
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        return ret;
+      }
+      if (list_len) {
+        break;
+      }
+      list_idx++;
+    }
+    if (list_idx == list_num) {
+      *drained = true;
+      break;
+    }
+
+    ret = cache_list_pop_tail(list_names[list_idx], key);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      return ret;
+    }
+
+    eviction_entry_t* entry = NULL;
+    HASH_FIND_STR(entries, key, entry);
+    if (entry == NULL) {
+      // Buffered before restarting, so its size is only known by the cache server
+      long int bytes = 0;
+      if (cache_memory_usage(key, &bytes) == SC_OK) {
+        untracked_bytes = (untracked_bytes > bytes) ? untracked_bytes - bytes : 0;
+      }
+    }
+
+    // The key may have been expired by the cache server already. Failing to delete it is harmless.
+    cache_del(key);
+
+    if (entry) {
+      entry_remove(entry);
+    }
+    (*evicted)++;
+  }
+
+  return ret;
+}
+
+static long int tracked_usage() {
+  pthread_mutex_lock(&entries_lock);
+  const long int usage = tracked_bytes + untracked_bytes;
+  pthread_mutex_unlock(&entries_lock);
+  return usage;
+}
+
+/*
+ * Public functions
+ */
+
+status_t cache_eviction_track(const char* const key, const long int bytes) {
+  status_t ret = SC_OK;
+  if (key == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&entries_lock);
+  eviction_entry_t* entry = NULL;
+  HASH_FIND_STR(entries, key, entry);
+  if (entry == NULL) {
+    entry = (eviction_entry_t*)calloc(1, sizeof(eviction_entry_t));
+    if (entry == NULL || (entry->key = strdup(key)) == NULL) {
+      free(entry);
+      ret = SC_OOM;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    HASH_ADD_KEYPTR(hh, entries, entry->key, strlen(entry->key), entry);
+  }
+  entry->bytes += bytes;
+  tracked_bytes += bytes;
+
+done:
+  pthread_mutex_unlock(&entries_lock);
+  return ret;
+}
+
+void cache_eviction_untrack(const char* const key) {
+  if (key == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&entries_lock);
+  eviction_entry_t* entry = NULL;
+  HASH_FIND_STR(entries, key, entry);
+  if (entry) {
+    entry_remove(entry);
+  }
+  pthread_mutex_unlock(&entries_lock);
+}
+
+status_t cache_eviction_complete(const char* const key, const char* const list_name, const int ttl) {
+  status_t ret = SC_OK;
+  if (key == NULL || list_name == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  if (ttl > 0) {
+    ret = cache_expire(key, ttl);
+    if (ret) {
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      return ret;
+    }
+  }
+
+  pthread_mutex_lock(&entries_lock);
+  eviction_entry_t* entry = NULL;
+  HASH_FIND_STR(entries, key, entry);
+  if (entry) {
+    entry->list_name = list_name;
+    entry->expire_at = (ttl > 0) ? time(NULL) + ttl : 0;
+  }
+  pthread_mutex_unlock(&entries_lock);
+
+  return ret;
+}
+
+status_t cache_eviction_run(pthread_rwlock_t* const rwlock, const long int capacity, const uint8_t low_water_percent,
+                            const char* const list_names[], const int list_num, int* evicted, int* expired) {
+  status_t ret = SC_OK;
+  const long int low_water = capacity * low_water_percent / 100;
+  bool drained = false;
+  *evicted = 0;
+  *expired = 0;
+
+  if (pthread_rwlock_trywrlock(rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  pthread_mutex_lock(&entries_lock);
+  *expired = expire_entries(time(NULL));
+  reconcile_usage();
+  pthread_mutex_unlock(&entries_lock);
+  if (pthread_rwlock_unlock(rwlock)) {
+    ret = SC_CACHE_LOCK_FAILURE;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  if (tracked_usage() <= capacity) {
+    goto done;
+  }
+
+  // Release the write lock between batches, so requests fetching buffered status are not blocked for too long.
+  while (!drained && tracked_usage() > low_water) {
+    if (pthread_rwlock_trywrlock(rwlock)) {
+      ret = SC_CACHE_LOCK_FAILURE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+      goto done;
+    }
+    pthread_mutex_lock(&entries_lock);
+    ret = evict_batch(low_water, list_names, list_num, evicted, &drained);
+    reconcile_usage();
+    pthread_mutex_unlock(&entries_lock);
+    if (pthread_rwlock_unlock(rwlock)) {
+      ret = SC_CACHE_LOCK_FAILURE;
+      ta_log_error("%s\n", ta_error_to_string(ret));
+    }
+    if (ret) {
+      goto done;
+    }
+  }
+
+  if (drained) {
+    ta_log_warning("No completed request left to evict. %ld bytes are still occupied in cache server.\n",
+                   tracked_usage());
+  }
+
+done:
+  pthread_mutex_lock(&entries_lock);
+  total_evicted += *evicted;
+  total_expired += *expired;
+  pthread_mutex_unlock(&entries_lock);
+  return ret;
+}
+
+void cache_eviction_reconcile() {
+  pthread_mutex_lock(&entries_lock);
+  reconcile_usage();
+  pthread_mutex_unlock(&entries_lock);
+}
+
+void cache_eviction_stats(cache_eviction_stats_t* const stats) {
+  pthread_mutex_lock(&entries_lock);
+  stats->evicted = total_evicted;
+  stats->expired = total_expired;
+  stats->tracked_bytes = tracked_bytes;
+  stats->untracked_bytes = untracked_bytes;
+  pthread_mutex_unlock(&entries_lock);
+}
+
+void cache_eviction_clear() {
+  pthread_mutex_lock(&entries_lock);
+  eviction_entry_t *entry = NULL, *tmp = NULL;
+  HASH_ITER(hh, entries, entry, tmp) { entry_remove(entry); }
+  tracked_bytes = 0;
+  untracked_bytes = 0;
+  pthread_mutex_unlock(&entries_lock);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_CACHE_EVICTION_H_
+#define UTILS_CACHE_EVICTION_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/cache/eviction.h
+ * @brief Budgeted eviction of buffered requests in the caching service
+ *
+ * The eviction module keeps a local record of the bytes written to the cache server for each buffered request. The
+ * record is reconciled with the occupied space reported by the cache server on each run, which also counts the keys
+ * written by other modules and the requests buffered before restarting. Once the usage exceeds the capacity, the
+ * oldest completed requests are evicted in batches until the usage drops to the low-water mark. Completed requests can
+ * also be expired with a TTL.
+ */
+
+#define CACHE_EVICTION_BATCH_SIZE 256 /**< Maximum number of requests evicted while holding the write lock once */
+
+/** struct of cache_eviction_stats_t */
+typedef struct cache_eviction_stats_s {
+  uint64_t evicted;         /**< Number of completed requests evicted to meet the capacity */
+  uint64_t expired;         /**< Number of completed requests expired by TTL */
+  long int tracked_bytes;   /**< Bytes of buffered requests currently tracked */
+  long int untracked_bytes; /**< Other bytes in the cache server as of the last reconciliation */
+} cache_eviction_stats_t;
+
+/**
+ * @brief Record bytes written to the cache server under the given key
+ *
+ * Calling it multiple times with the same key accumulates the size.
+ *
+ * @param[in] key Key of the buffered request
+ * @param[in] bytes Written bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_eviction_track(const char* const key, const long int bytes);
+
+/**
+ * @brief Forget the bytes recorded under the given key after the key is deleted from the cache server
+ *
+ * @param[in] key Key of the buffered request
+ */
+void cache_eviction_untrack(const char* const key);
+
+/**
+ * @brief Mark a buffered request as completed
+ *
+ * Completed requests become candidates of eviction. If `ttl` is greater than 0, the key is expired in the cache
+ * server as well and it would be removed from `list_name` once the TTL is reached.
+ *
+ * @param[in] key Key of the buffered request
+ * @param[in] list_name Name of the list which stores the completed request. It must outlive the eviction module.
+ * @param[in] ttl Seconds to keep the completed request. Zero or negative value keeps it until evicted.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_eviction_complete(const char* const key, const char* const list_name, const int ttl);
+
+/**
+ * @brief Expire completed requests and evict the oldest ones until the usage meets the low-water mark
+ *
+ * The usage is reconciled with the cache server first, and after each batch. Eviction only happens when the usage
+ * exceeds `capacity`. Requests are evicted from the tail of each list in
+ * `list_names` in order, at most `CACHE_EVICTION_BATCH_SIZE` requests for each acquisition of `rwlock`.
+ *
+ * @param[in] rwlock Read/Write lock of buffering
+ * @param[in] capacity The maximum capacity of cache server
+ * @param[in] low_water_percent Percentage of `capacity` where eviction stops
+ * @param[in] list_names Names of the lists which store completed requests
+ * @param[in] list_num Number of lists in `list_names`
+ * @param[out] evicted Number of requests evicted in this run
+ * @param[out] expired Number of requests expired in this run
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_eviction_run(pthread_rwlock_t* const rwlock, const long int capacity, const uint8_t low_water_percent,
+                            const char* const list_names[], const int list_num, int* evicted, int* expired);
+
+/**
+ * @brief Seed the usage with the occupied space reported by the cache server
+ *
+ * It is called once the cache server is connected, so the data kept from before restarting is counted before the first
+ * run.
+ */
+void cache_eviction_reconcile();
+
+/**
+ * @brief Get the accumulated eviction statistics
+ *
+ * @param[out] stats Eviction statistics
+ */
+void cache_eviction_stats(cache_eviction_stats_t* const stats);
+
+/**
+ * @brief Release all the records of the eviction module
+ */
+void cache_eviction_clear();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_CACHE_EVICTION_H_
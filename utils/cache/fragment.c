@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "fragment.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#include "common/logger.h"
+
+#define CF_LOGGER "cache_fragment"
+#define FRAGMENT_KEY_LEN 128 /**< Transaction hashes have 81 trytes, which are far shorter than this */
+
+static int fragment_ttl = 0;
+static int packed_ttl = 0;
+static logger_id_t logger_id;
+
+void cf_logger_init() { logger_id = logger_helper_enable(CF_LOGGER, LOGGER_DEBUG, true); }
+
+int cf_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+static status_t fragment_key(const char* const hash, char* key) {
+  if (hash == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  const int len = snprintf(key, FRAGMENT_KEY_LEN, "%s%s", CACHE_FRAGMENT_KEY_PREFIX, hash);
+  if (len < 0 || len >= FRAGMENT_KEY_LEN) {
+    ta_log_error("%s\n", ta_error_to_string(SC_UTILS_WRONG_INPUT_ARG));
+    return SC_UTILS_WRONG_INPUT_ARG;
+  }
+  return SC_OK;
+}
+
+void cache_fragment_init(const int ttl, const int packed_trits_ttl) {
+  fragment_ttl = ttl > 0 ? ttl : 0;
+  packed_ttl = packed_trits_ttl > 0 ? packed_trits_ttl : 0;
+}
+
+bool cache_fragment_enabled() { return fragment_ttl > 0; }
+
+bool cache_fragment_packed_enabled() { return packed_ttl > 0; }
+
+status_t cache_fragment_get(const char* const hash, char** fragment, size_t* len) {
+  status_t ret = SC_OK;
+  char key[FRAGMENT_KEY_LEN];
+  char* value = NULL;
+  size_t value_len = 0;
+  if (fragment == NULL || len == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  ret = fragment_key(hash, key);
+  if (ret) {
+    return ret;
+  }
+  ret = cache_get_blob(key, &value, &value_len);
+  if (ret) {
+    return ret;
+  }
+
+  if (value_len < 1 || (unsigned char)value[0] != CACHE_FRAGMENT_VERSION) {
+    // Written by another version of the serializer
+    ta_log_debug("Remove stale fragment %s\n", key);
+    cache_del(key);
+    free(value);
+    return SC_CACHE_FAILED_RESPONSE;
+  }
+
+  // The blob is not null-terminated, so the format byte leaves room for the terminator
+  memmove(value, value + 1, value_len - 1);
+  value[value_len - 1] = '\0';
+  *fragment = value;
+  *len = value_len - 1;
+  return SC_OK;
+}
+
+status_t cache_fragment_set(const char* const hash, const char* const fragment, const size_t len) {
+  status_t ret = SC_OK;
+  char key[FRAGMENT_KEY_LEN];
+  char* value = NULL;
+  if (fragment == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  ret = fragment_key(hash, key);
+  if (ret) {
+    return ret;
+  }
+  value = (char*)malloc(len + 1);
+  if (value == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  value[0] = CACHE_FRAGMENT_VERSION;
+  memcpy(value + 1, fragment, len);
+
+  ret = cache_set_overwrite(key, strlen(key), value, len + 1, fragment_ttl);
+  free(value);
+  return ret;
+}
+
+status_t cache_fragment_set_packed(const char* const hash, const void* const packed, const size_t len) {
+  if (hash == NULL || packed == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  if (!cache_fragment_packed_enabled()) {
+    return SC_OK;
+  }
+
+  return cache_set(hash, strlen(hash), packed, len, packed_ttl);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_CACHE_FRAGMENT_H_
+#define UTILS_CACHE_FRAGMENT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/cache/fragment.h
+ * @brief Pre-serialized JSON objects of transactions
+ *
+ * Transactions are immutable, so the JSON object of a transaction could be serialized once and served from the cache
+ * server afterwards. Fragments are stored under the transaction hash with a leading format byte. A fragment in another
+ * format is treated as a miss and removed, so changing the JSON layout only needs a new `CACHE_FRAGMENT_VERSION`.
+ * Transactions fetched from the IOTA full node are kept in packed trits under the bare transaction hash, with a TTL of
+ * their own, so they are cached even if fragments are disabled.
+ */
+
+#define CACHE_FRAGMENT_KEY_PREFIX "txn_json:" /**< Prefix of the keys of pre-serialized transaction objects */
+#define CACHE_FRAGMENT_VERSION 1              /**< Format byte in front of every fragment */
+
+/**
+ * @brief Enable the fragment tier
+ *
+ * Without initializing, the tier is disabled and callers serialize transactions as usual.
+ *
+ * @param[in] ttl Seconds to keep a fragment in the cache server. Zero or negative disables the tier.
+ * @param[in] packed_trits_ttl Seconds to keep the packed trits of a transaction. Zero or negative disables them.
+ */
+void cache_fragment_init(const int ttl, const int packed_trits_ttl);
+
+/**
+ * @brief Check whether the fragment tier is enabled
+ *
+ * @return
+ * - true if fragments are cached
+ * - false otherwise
+ */
+bool cache_fragment_enabled();
+
+/**
+ * @brief Check whether packed transactions are cached
+ *
+ * @return
+ * - true if packed transactions are cached
+ * - false otherwise
+ */
+bool cache_fragment_packed_enabled();
+
+/**
+ * @brief Get the JSON object of a transaction
+ *
+ * @param[in] hash Transaction hash in a null-terminated string
+ * @param[out] fragment The JSON object in a null-terminated string, which should be freed by the caller
+ * @param[out] len Length of the JSON object
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_OFF if the cache server is unavailable
+ * - non-zero on a miss or error
+ */
+status_t cache_fragment_get(const char* const hash, char** fragment, size_t* len);
+
+/**
+ * @brief Store the JSON object of a transaction
+ *
+ * @param[in] hash Transaction hash in a null-terminated string
+ * @param[in] fragment The JSON object
+ * @param[in] len Length of the JSON object
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_OFF if the cache server is unavailable
+ * - non-zero on error
+ */
+status_t cache_fragment_set(const char* const hash, const char* const fragment, const size_t len);
+
+/**
+ * @brief Store the packed trits of a transaction
+ *
+ * The value is stored under the transaction hash without a prefix. It does nothing if packed transactions are
+ * disabled.
+ *
+ * @param[in] hash Transaction hash in a null-terminated string
+ * @param[in] packed Packed trits of the transaction prefixed with its format byte
+ * @param[in] len Length of `packed`
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CACHE_OFF if the cache server is unavailable
+ * - non-zero on error
+ */
+status_t cache_fragment_set_packed(const char* const hash, const void* const packed, const size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_CACHE_FRAGMENT_H_
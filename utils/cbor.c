@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "cbor.h"
+#include <stdlib.h>
+#include <string.h>
+#include "utils/buffer_pool.h"
+#include "utils/trit_pack.h"
+
+#define CBOR_UINT 0
+#define CBOR_NEGINT 1
+#define CBOR_BYTES 2
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+
+#define CBOR_HEAD_MAX_SIZE 9 /**< An initial byte followed by an argument of up to 8 bytes */
+
+static bool writer_reserve(cbor_writer_t* const writer, const size_t size) {
+  if (writer->status != SC_OK) {
+    return false;
+  }
+  if (writer->len + size <= writer->capacity) {
+    return true;
+  }
+
+  size_t capacity = writer->capacity ? writer->capacity : 64;
+  while (capacity < writer->len + size) {
+    capacity *= 2;
+  }
+  uint8_t* data = (uint8_t*)realloc(writer->data, capacity);
+  if (data == NULL) {
+    writer->status = SC_OOM;
+    return false;
+  }
+  writer->data = data;
+  writer->capacity = capacity;
+  return true;
+}
+
+/**
+ * @brief Encode the head of an item in the shortest form, after reserving room for `size` more bytes of its content
+ */
+static bool writer_head(cbor_writer_t* const writer, const uint8_t major, const uint64_t arg, const size_t size) {
+  if (!writer_reserve(writer, CBOR_HEAD_MAX_SIZE + size)) {
+    return false;
+  }
+
+  uint8_t* out = writer->data + writer->len;
+  int arg_len = 0;
+  if (arg < 24) {
+    *out++ = (major << 5) | (uint8_t)arg;
+  } else if (arg <= UINT8_MAX) {
+    *out++ = (major << 5) | 24;
+    arg_len = 1;
+  } else if (arg <= UINT16_MAX) {
+    *out++ = (major << 5) | 25;
+    arg_len = 2;
+  } else if (arg <= UINT32_MAX) {
+    *out++ = (major << 5) | 26;
+    arg_len = 4;
+  } else {
+    *out++ = (major << 5) | 27;
+    arg_len = 8;
+  }
+  // Arguments are in network byte order
+  for (int i = arg_len - 1; i >= 0; i--) {
+    *out++ = (uint8_t)(arg >> (8 * i));
+  }
+  writer->len = out - writer->data;
+  return true;
+}
+
+status_t cbor_writer_init(cbor_writer_t* const writer, const size_t capacity) {
+  if (writer == NULL) {
+    return SC_NULL;
+  }
+
+  memset(writer, 0, sizeof(cbor_writer_t));
+  writer->data = (uint8_t*)buffer_pool_alloc(capacity ? capacity : 64, &writer->capacity);
+  if (writer->data == NULL) {
+    return SC_OOM;
+  }
+  return SC_OK;
+}
+
+void cbor_writer_destroy(cbor_writer_t* const writer) {
+  if (writer == NULL) {
+    return;
+  }
+  buffer_pool_release(writer->data);
+  memset(writer, 0, sizeof(cbor_writer_t));
+}
+
+status_t cbor_writer_finish(cbor_writer_t* const writer, uint8_t** data, size_t* len) {
+  if (writer == NULL || data == NULL || len == NULL) {
+    return SC_NULL;
+  }
+
+  const status_t ret = writer->status;
+  if (ret != SC_OK) {
+    cbor_writer_destroy(writer);
+    return ret;
+  }
+
+  *data = writer->data;
+  *len = writer->len;
+  memset(writer, 0, sizeof(cbor_writer_t));
+  return SC_OK;
+}
+
+void cbor_write_int(cbor_writer_t* const writer, const int64_t value) {
+  if (value >= 0) {
+    writer_head(writer, CBOR_UINT, (uint64_t)value, 0);
+  } else {
+    // A negative integer n is encoded as -1 - n
+    writer_head(writer, CBOR_NEGINT, (uint64_t)(-1 - value), 0);
+  }
+}
+
+void cbor_write_bytes(cbor_writer_t* const writer, const uint8_t* const bytes, const size_t len) {
+  if (!writer_head(writer, CBOR_BYTES, len, len)) {
+    return;
+  }
+  memcpy(writer->data + writer->len, bytes, len);
+  writer->len += len;
+}
+
+void cbor_write_text(cbor_writer_t* const writer, char const* const text, const size_t len) {
+  if (!writer_head(writer, CBOR_TEXT, len, len)) {
+    return;
+  }
+  memcpy(writer->data + writer->len, text, len);
+  writer->len += len;
+}
+
+void cbor_write_trits(cbor_writer_t* const writer, const flex_trit_t* const flex_trits, const size_t num_trits) {
+  const size_t len = TRIT_PACK_SIZE(num_trits);
+  if (!writer_head(writer, CBOR_BYTES, len, len)) {
+    return;
+  }
+  // Trits are packed into the buffer directly
+  flex_trits_pack(flex_trits, num_trits, writer->data + writer->len);
+  writer->len += len;
+}
+
+void cbor_write_array(cbor_writer_t* const writer, const size_t num) { writer_head(writer, CBOR_ARRAY, num, 0); }
+
+void cbor_write_map(cbor_writer_t* const writer, const size_t num) { writer_head(writer, CBOR_MAP, num, 0); }
+
+void cbor_reader_init(cbor_reader_t* const reader, const uint8_t* const data, const size_t len) {
+  reader->data = data;
+  reader->len = len;
+  reader->pos = 0;
+}
+
+bool cbor_reader_done(cbor_reader_t const* const reader) { return reader->pos >= reader->len; }
+
+/**
+ * @brief Decode the head of an item of the expected major type
+ */
+static status_t reader_head(cbor_reader_t* const reader, const uint8_t major, uint64_t* const arg) {
+  if (reader->pos >= reader->len || (reader->data[reader->pos] >> 5) != major) {
+    return SC_UTILS_CBOR_MALFORMED;
+  }
+
+  const uint8_t info = reader->data[reader->pos++] & 0x1f;
+  if (info < 24) {
+    *arg = info;
+    return SC_OK;
+  }
+  // Indefinite lengths and reserved values are not supported
+  if (info > 27) {
+    return SC_UTILS_CBOR_MALFORMED;
+  }
+
+  const size_t arg_len = (size_t)1 << (info - 24);
+  if (reader->len - reader->pos < arg_len) {
+    return SC_UTILS_CBOR_MALFORMED;
+  }
+  *arg = 0;
+  for (size_t i = 0; i < arg_len; i++) {
+    *arg = (*arg << 8) | reader->data[reader->pos++];
+  }
+  return SC_OK;
+}
+
+static status_t reader_string(cbor_reader_t* const reader, const uint8_t major, const uint8_t** str,
+                              size_t* const len) {
+  uint64_t arg = 0;
+  const size_t pos = reader->pos;
+  status_t ret = reader_head(reader, major, &arg);
+  if (ret == SC_OK && arg > reader->len - reader->pos) {
+    ret = SC_UTILS_CBOR_MALFORMED;
+  }
+  if (ret != SC_OK) {
+    reader->pos = pos;
+    return ret;
+  }
+
+  *str = reader->data + reader->pos;
+  *len = (size_t)arg;
+  reader->pos += *len;
+  return SC_OK;
+}
+
+status_t cbor_read_int(cbor_reader_t* const reader, int64_t* const value) {
+  uint64_t arg = 0;
+  const size_t pos = reader->pos;
+  if (reader->pos < reader->len && (reader->data[reader->pos] >> 5) == CBOR_NEGINT) {
+    if (reader_head(reader, CBOR_NEGINT, &arg) == SC_OK && arg <= INT64_MAX) {
+      *value = -1 - (int64_t)arg;
+      return SC_OK;
+    }
+  } else if (reader_head(reader, CBOR_UINT, &arg) == SC_OK && arg <= INT64_MAX) {
+    *value = (int64_t)arg;
+    return SC_OK;
+  }
+  reader->pos = pos;
+  return SC_UTILS_CBOR_MALFORMED;
+}
+
+status_t cbor_read_bytes(cbor_reader_t* const reader, const uint8_t** bytes, size_t* const len) {
+  return reader_string(reader, CBOR_BYTES, bytes, len);
+}
+
+status_t cbor_read_text(cbor_reader_t* const reader, char const** text, size_t* const len) {
+  return reader_string(reader, CBOR_TEXT, (const uint8_t**)text, len);
+}
+
+status_t cbor_read_trits(cbor_reader_t* const reader, flex_trit_t* const flex_trits, const size_t num_trits) {
+  const uint8_t* bytes = NULL;
+  size_t len = 0;
+  const size_t pos = reader->pos;
+  status_t ret = reader_string(reader, CBOR_BYTES, &bytes, &len);
+  if (ret == SC_OK && len != TRIT_PACK_SIZE(num_trits)) {
+    ret = SC_UTILS_CBOR_MALFORMED;
+  }
+  if (ret == SC_OK) {
+    ret = flex_trits_unpack(bytes, num_trits, flex_trits);
+  }
+  if (ret != SC_OK) {
+    reader->pos = pos;
+  }
+  return ret;
+}
+
+static status_t reader_container(cbor_reader_t* const reader, const uint8_t major, size_t* const num) {
+  uint64_t arg = 0;
+  const size_t pos = reader->pos;
+  // Every item takes a byte at least, so a larger number is malformed
+  if (reader_head(reader, major, &arg) != SC_OK || arg > reader->len - reader->pos) {
+    reader->pos = pos;
+    return SC_UTILS_CBOR_MALFORMED;
+  }
+  *num = (size_t)arg;
+  return SC_OK;
+}
+
+status_t cbor_read_array(cbor_reader_t* const reader, size_t* const num) {
+  return reader_container(reader, CBOR_ARRAY, num);
+}
+
+status_t cbor_read_map(cbor_reader_t* const reader, size_t* const num) {
+  return reader_container(reader, CBOR_MAP, num);
+}
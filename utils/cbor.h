@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_CBOR_H_
+#define UTILS_CBOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/cbor.h
+ * @brief Minimal CBOR (RFC 7049) encoder and decoder
+ *
+ * Only the items used by binary responses are supported, which are integers, byte strings, text strings, arrays and
+ * maps of definite length. Trits are encoded as byte strings of 5 trits per byte with `utils/trit_pack.h`, so they
+ * are 40% smaller than trytes and decoded without tryte conversion.
+ *
+ * Like `utils/json_writer.h`, errors of the encoder are sticky and returned by `cbor_writer_finish()`.
+ */
+
+/** struct of cbor_writer_t */
+typedef struct cbor_writer_s {
+  uint8_t* data;   /**< Encoded data */
+  size_t len;      /**< Length of the encoded data */
+  size_t capacity; /**< Allocated size of `data` */
+  status_t status; /**< The first error */
+} cbor_writer_t;
+
+/** struct of cbor_reader_t */
+typedef struct cbor_reader_s {
+  const uint8_t* data; /**< Data to be decoded */
+  size_t len;          /**< Length of the data */
+  size_t pos;          /**< Offset of the next item */
+} cbor_reader_t;
+
+/**
+ * @brief Initialize a CBOR encoder
+ *
+ * @param[out] writer CBOR encoder
+ * @param[in] capacity Minimum initial size of the buffer, which is taken from `utils/buffer_pool.h`. The buffer grows
+ * if it is exceeded.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_OOM on error of allocation
+ */
+status_t cbor_writer_init(cbor_writer_t* const writer, const size_t capacity);
+
+/**
+ * @brief Release the buffer of a CBOR encoder which is not finished
+ *
+ * @param[in] writer CBOR encoder
+ */
+void cbor_writer_destroy(cbor_writer_t* const writer);
+
+/**
+ * @brief Hand over the encoded data without copying
+ *
+ * @param[in] writer CBOR encoder
+ * @param[out] data Encoded data, which should be freed by the caller
+ * @param[out] len Length of the encoded data
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero if any item failed to be encoded
+ */
+status_t cbor_writer_finish(cbor_writer_t* const writer, uint8_t** data, size_t* len);
+
+/**
+ * @brief Encode an unsigned or negative integer
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] value Integer
+ */
+void cbor_write_int(cbor_writer_t* const writer, const int64_t value);
+
+/**
+ * @brief Encode a byte string
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] bytes Bytes
+ * @param[in] len Number of bytes
+ */
+void cbor_write_bytes(cbor_writer_t* const writer, const uint8_t* const bytes, const size_t len);
+
+/**
+ * @brief Encode a text string
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] text UTF-8 text
+ * @param[in] len Length of the text in bytes
+ */
+void cbor_write_text(cbor_writer_t* const writer, char const* const text, const size_t len);
+
+/**
+ * @brief Encode trits as a byte string of packed trits
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] flex_trits Trits in flex_trit_t
+ * @param[in] num_trits Number of trits
+ */
+void cbor_write_trits(cbor_writer_t* const writer, const flex_trit_t* const flex_trits, const size_t num_trits);
+
+/**
+ * @brief Encode the head of an array, which is followed by its items
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] num Number of items
+ */
+void cbor_write_array(cbor_writer_t* const writer, const size_t num);
+
+/**
+ * @brief Encode the head of a map, which is followed by its keys and values in turn
+ *
+ * @param[in] writer CBOR encoder
+ * @param[in] num Number of pairs
+ */
+void cbor_write_map(cbor_writer_t* const writer, const size_t num);
+
+/**
+ * @brief Initialize a CBOR decoder
+ *
+ * @param[out] reader CBOR decoder
+ * @param[in] data Data to be decoded, which must live until the decoding is done
+ * @param[in] len Length of the data
+ */
+void cbor_reader_init(cbor_reader_t* const reader, const uint8_t* const data, const size_t len);
+
+/**
+ * @brief Check whether all the data is decoded
+ *
+ * @param[in] reader CBOR decoder
+ *
+ * @return
+ * - true if no item is left
+ * - false otherwise
+ */
+bool cbor_reader_done(cbor_reader_t const* const reader);
+
+/**
+ * @brief Decode an unsigned or negative integer
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] value Integer
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not an integer in the range of int64_t
+ */
+status_t cbor_read_int(cbor_reader_t* const reader, int64_t* const value);
+
+/**
+ * @brief Decode a byte string without copying
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] bytes Bytes pointing into the decoded data
+ * @param[out] len Number of bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not a byte string
+ */
+status_t cbor_read_bytes(cbor_reader_t* const reader, const uint8_t** bytes, size_t* const len);
+
+/**
+ * @brief Decode a text string without copying. The text is not NUL-terminated.
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] text Text pointing into the decoded data
+ * @param[out] len Length of the text in bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not a text string
+ */
+status_t cbor_read_text(cbor_reader_t* const reader, char const** text, size_t* const len);
+
+/**
+ * @brief Decode a byte string of packed trits
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] flex_trits Trits in flex_trit_t
+ * @param[in] num_trits Expected number of trits
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not a byte string of `num_trits` packed trits
+ * - SC_UTILS_TRIT_PACK_INVALID if any of the packed bytes is out of range
+ */
+status_t cbor_read_trits(cbor_reader_t* const reader, flex_trit_t* const flex_trits, const size_t num_trits);
+
+/**
+ * @brief Decode the head of an array
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] num Number of items
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not an array
+ */
+status_t cbor_read_array(cbor_reader_t* const reader, size_t* const num);
+
+/**
+ * @brief Decode the head of a map
+ *
+ * @param[in] reader CBOR decoder
+ * @param[out] num Number of pairs
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_CBOR_MALFORMED if the next item is not a map
+ */
+status_t cbor_read_map(cbor_reader_t* const reader, size_t* const num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_CBOR_H_
@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "json_reader.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils/buffer_pool.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline bool is_digit(const char c) { return c >= '0' && c <= '9'; }
+
+static inline void skip_whitespace(json_reader_t* const reader) {
+  char* p = reader->cur;
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+    p++;
+  }
+  reader->cur = p;
+}
+
+/**
+ * @brief Find the first quote, backslash or control character from `p`
+ *
+ * The terminating NUL is a control character, and it is followed by JSON_READER_PADDING bytes, so the scan never
+ * leaves the buffer.
+ */
+static inline char* string_scan(char* p) {
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+  for (;;) {
+    const __m128i v = _mm_loadu_si128((__m128i const*)p);
+    const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                         _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+    const int mask = _mm_movemask_epi8(special);
+    if (mask) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#else
+  while ((uint8_t)*p >= 0x20 && *p != '"' && *p != '\\') {
+    p++;
+  }
+  return p;
+#endif
+}
+
+static bool read_hex4(char const* const p, uint32_t* const value) {
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) {
+    const char c = p[i];
+    v <<= 4;
+    if (is_digit(c)) {
+      v |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      v |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      v |= c - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  *value = v;
+  return true;
+}
+
+/**
+ * @brief Decode `\uXXXX`, or a surrogate pair of them, after the `\u` at `*in` into UTF-8 at `*out`
+ *
+ * The UTF-8 sequence is never longer than the escape, so it is written in place.
+ */
+static bool unescape_unicode(char** const in, char** const out) {
+  char* p = *in;
+  uint32_t code = 0, low = 0;
+  if (!read_hex4(p, &code)) {
+    return false;
+  }
+  p += 4;
+  if (code >= 0xdc00 && code <= 0xdfff) {
+    return false;
+  }
+  if (code >= 0xd800 && code <= 0xdbff) {
+    if (p[0] != '\\' || p[1] != 'u' || !read_hex4(p + 2, &low) || low < 0xdc00 || low > 0xdfff) {
+      return false;
+    }
+    p += 6;
+    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+  }
+
+  uint8_t* o = (uint8_t*)*out;
+  if (code < 0x80) {
+    *o++ = code;
+  } else if (code < 0x800) {
+    *o++ = 0xc0 | (code >> 6);
+    *o++ = 0x80 | (code & 0x3f);
+  } else if (code < 0x10000) {
+    *o++ = 0xe0 | (code >> 12);
+    *o++ = 0x80 | ((code >> 6) & 0x3f);
+    *o++ = 0x80 | (code & 0x3f);
+  } else {
+    *o++ = 0xf0 | (code >> 18);
+    *o++ = 0x80 | ((code >> 12) & 0x3f);
+    *o++ = 0x80 | ((code >> 6) & 0x3f);
+    *o++ = 0x80 | (code & 0x3f);
+  }
+  *in = p;
+  *out = (char*)o;
+  return true;
+}
+
+static status_t read_string(json_reader_t* const reader, char** const str, size_t* const len) {
+  if (*reader->cur != '"') {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  char* const start = reader->cur + 1;
+  char* p = string_scan(start);
+  char* out = p;
+
+  // Escaped characters are decoded backward onto the string, and the runs between them are moved after them
+  while (*p != '"') {
+    if (*p != '\\') {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    p += 2;
+    switch (p[-1]) {
+      case '"':
+      case '\\':
+      case '/':
+        *out++ = p[-1];
+        break;
+      case 'b':
+        *out++ = '\b';
+        break;
+      case 'f':
+        *out++ = '\f';
+        break;
+      case 'n':
+        *out++ = '\n';
+        break;
+      case 'r':
+        *out++ = '\r';
+        break;
+      case 't':
+        *out++ = '\t';
+        break;
+      case 'u':
+        if (!unescape_unicode(&p, &out)) {
+          return SC_SERIALIZER_JSON_PARSE;
+        }
+        break;
+      default:
+        return SC_SERIALIZER_JSON_PARSE;
+    }
+    char* const run_end = string_scan(p);
+    memmove(out, p, run_end - p);
+    out += run_end - p;
+    p = run_end;
+  }
+
+  *out = '\0';
+  *str = start;
+  if (len) {
+    *len = out - start;
+  }
+  reader->cur = p + 1;
+  return SC_OK;
+}
+
+static status_t skip_value(json_reader_t* const reader, const int depth) {
+  status_t ret = SC_OK;
+  bool more = false;
+  char* key = NULL;
+  double number = 0;
+
+  if (depth > JSON_READER_MAX_DEPTH) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  switch (json_reader_peek(reader)) {
+    case JSON_READER_OBJECT:
+      ret = json_reader_object_begin(reader);
+      while (ret == SC_OK && (ret = json_reader_object_next(reader, &key)) == SC_OK && key) {
+        ret = skip_value(reader, depth + 1);
+      }
+      return ret;
+    case JSON_READER_ARRAY:
+      ret = json_reader_array_begin(reader);
+      while (ret == SC_OK && (ret = json_reader_array_next(reader, &more)) == SC_OK && more) {
+        ret = skip_value(reader, depth + 1);
+      }
+      return ret;
+    case JSON_READER_STRING:
+      return read_string(reader, &key, NULL);
+    case JSON_READER_NUMBER:
+      return json_reader_number(reader, &number);
+    case JSON_READER_BOOL:
+      if (!strncmp(reader->cur, "true", 4)) {
+        reader->cur += 4;
+        return SC_OK;
+      } else if (!strncmp(reader->cur, "false", 5)) {
+        reader->cur += 5;
+        return SC_OK;
+      }
+      return SC_SERIALIZER_JSON_PARSE;
+    case JSON_READER_NULL:
+      if (!strncmp(reader->cur, "null", 4)) {
+        reader->cur += 4;
+        return SC_OK;
+      }
+      return SC_SERIALIZER_JSON_PARSE;
+    default:
+      return SC_SERIALIZER_JSON_PARSE;
+  }
+}
+
+status_t json_reader_init(json_reader_t* const reader, char const* const json) {
+  if (reader == NULL || json == NULL) {
+    return SC_NULL;
+  }
+
+  const size_t len = strlen(json);
+  memset(reader, 0, sizeof(json_reader_t));
+  reader->data = (char*)buffer_pool_alloc(len + 1 + JSON_READER_PADDING, NULL);
+  if (reader->data == NULL) {
+    return SC_OOM;
+  }
+  memcpy(reader->data, json, len + 1);
+  memset(reader->data + len + 1, 0, JSON_READER_PADDING);
+  reader->cur = reader->data;
+  return SC_OK;
+}
+
+void json_reader_destroy(json_reader_t* const reader) {
+  if (reader == NULL) {
+    return;
+  }
+  buffer_pool_release(reader->data);
+  reader->data = NULL;
+  reader->cur = NULL;
+}
+
+status_t json_reader_finish(json_reader_t* const reader) {
+  skip_whitespace(reader);
+  return (*reader->cur == '\0') ? SC_OK : SC_SERIALIZER_JSON_PARSE;
+}
+
+json_reader_type_t json_reader_peek(json_reader_t* const reader) {
+  skip_whitespace(reader);
+  switch (*reader->cur) {
+    case '{':
+      return JSON_READER_OBJECT;
+    case '[':
+      return JSON_READER_ARRAY;
+    case '"':
+      return JSON_READER_STRING;
+    case 't':
+    case 'f':
+      return JSON_READER_BOOL;
+    case 'n':
+      return JSON_READER_NULL;
+    default:
+      return (*reader->cur == '-' || is_digit(*reader->cur)) ? JSON_READER_NUMBER : JSON_READER_NONE;
+  }
+}
+
+status_t json_reader_object_begin(json_reader_t* const reader) {
+  skip_whitespace(reader);
+  if (*reader->cur != '{') {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  reader->cur++;
+  reader->first = true;
+  return SC_OK;
+}
+
+status_t json_reader_object_next(json_reader_t* const reader, char** const key) {
+  skip_whitespace(reader);
+  if (*reader->cur == '}') {
+    reader->cur++;
+    reader->first = false;
+    *key = NULL;
+    return SC_OK;
+  }
+  if (!reader->first) {
+    if (*reader->cur != ',') {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    reader->cur++;
+    skip_whitespace(reader);
+  }
+  reader->first = false;
+
+  if (read_string(reader, key, NULL) != SC_OK) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  skip_whitespace(reader);
+  if (*reader->cur != ':') {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  reader->cur++;
+  return SC_OK;
+}
+
+status_t json_reader_array_begin(json_reader_t* const reader) {
+  skip_whitespace(reader);
+  if (*reader->cur != '[') {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  reader->cur++;
+  reader->first = true;
+  return SC_OK;
+}
+
+status_t json_reader_array_next(json_reader_t* const reader, bool* const more) {
+  skip_whitespace(reader);
+  if (*reader->cur == ']') {
+    reader->cur++;
+    reader->first = false;
+    *more = false;
+    return SC_OK;
+  }
+  if (!reader->first) {
+    if (*reader->cur != ',') {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    reader->cur++;
+  }
+  reader->first = false;
+  *more = true;
+  return SC_OK;
+}
+
+status_t json_reader_string(json_reader_t* const reader, char** const str, size_t* const len) {
+  skip_whitespace(reader);
+  return read_string(reader, str, len);
+}
+
+status_t json_reader_number(json_reader_t* const reader, double* const value) {
+  skip_whitespace(reader);
+  char const* p = reader->cur;
+
+  if (*p == '-') {
+    p++;
+  }
+  if (*p == '0') {
+    p++;
+  } else if (is_digit(*p)) {
+    while (is_digit(*p)) {
+      p++;
+    }
+  } else {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  if (*p == '.') {
+    if (!is_digit(*++p)) {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    while (is_digit(*p)) {
+      p++;
+    }
+  }
+  if (*p == 'e' || *p == 'E') {
+    p++;
+    if (*p == '+' || *p == '-') {
+      p++;
+    }
+    if (!is_digit(*p)) {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    while (is_digit(*p)) {
+      p++;
+    }
+  }
+
+  // The grammar is checked above, so strtod() stops at the same character
+  *value = strtod(reader->cur, NULL);
+  reader->cur = (char*)p;
+  return SC_OK;
+}
+
+status_t json_reader_int(json_reader_t* const reader, int* const value) {
+  double number = 0;
+  status_t ret = json_reader_number(reader, &number);
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  if (number >= INT_MAX) {
+    *value = INT_MAX;
+  } else if (number <= (double)INT_MIN) {
+    *value = INT_MIN;
+  } else {
+    *value = (int)number;
+  }
+  return SC_OK;
+}
+
+status_t json_reader_skip(json_reader_t* const reader) { return skip_value(reader, 0); }
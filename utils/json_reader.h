@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_JSON_READER_H_
+#define UTILS_JSON_READER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/json_reader.h
+ * @brief Validating pull reader of JSON documents
+ *
+ * The reader walks a document once, and the caller decodes each member as it is reached, instead of parsing the whole
+ * document into a cJSON tree and looking members up afterwards. The document is copied into a buffer taken from
+ * `utils/buffer_pool.h`, where strings are unescaped and NUL-terminated in place, so reading a string never allocates.
+ * Strings are scanned 16 characters at a time with SSE2 where it is available.
+ *
+ * Members which are not read are skipped with `json_reader_skip()`, which validates them as well. Any syntax error
+ * makes the reading functions return SC_SERIALIZER_JSON_PARSE.
+ */
+
+#define JSON_READER_MAX_DEPTH 64 /**< Maximum nesting depth of skipped objects and arrays */
+#define JSON_READER_PADDING 16   /**< Bytes after the terminating NUL, so that vector loads stay in the buffer */
+
+/** Types of JSON values */
+typedef enum json_reader_type_e {
+  JSON_READER_NONE = 0, /**< Not the start of a value */
+  JSON_READER_NULL,     /**< null */
+  JSON_READER_BOOL,     /**< true or false */
+  JSON_READER_NUMBER,   /**< Number */
+  JSON_READER_STRING,   /**< String */
+  JSON_READER_ARRAY,    /**< Array */
+  JSON_READER_OBJECT,   /**< Object */
+} json_reader_type_t;
+
+/** struct of json_reader_t */
+typedef struct json_reader_s {
+  char* data; /**< Copy of the document, whose strings are unescaped in place */
+  char* cur;  /**< Next character to read */
+  bool first; /**< An object or array has just been entered, so its first item is not preceded by a comma */
+} json_reader_t;
+
+/**
+ * @brief Initialize a JSON reader with a copy of the document
+ *
+ * @param[out] reader JSON reader
+ * @param[in] json NUL-terminated document
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_OOM on error of allocation
+ */
+status_t json_reader_init(json_reader_t* const reader, char const* const json);
+
+/**
+ * @brief Release the copy of the document. Strings read from it are no longer valid.
+ *
+ * @param[in] reader JSON reader
+ */
+void json_reader_destroy(json_reader_t* const reader);
+
+/**
+ * @brief Check that nothing but whitespace is left after the top-level value
+ *
+ * @param[in] reader JSON reader
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE on trailing characters
+ */
+status_t json_reader_finish(json_reader_t* const reader);
+
+/**
+ * @brief Type of the next value, which is not consumed
+ *
+ * @param[in] reader JSON reader
+ *
+ * @return Type of the value, or JSON_READER_NONE if the next character can not start a value
+ */
+json_reader_type_t json_reader_peek(json_reader_t* const reader);
+
+/**
+ * @brief Enter an object
+ *
+ * @param[in] reader JSON reader
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE if the next value is not an object
+ */
+status_t json_reader_object_begin(json_reader_t* const reader);
+
+/**
+ * @brief Read the key of the next member of the object entered last. The value of the member should be read next.
+ *
+ * @param[in] reader JSON reader
+ * @param[out] key Unescaped key, or NULL if the end of the object is consumed
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE on error
+ */
+status_t json_reader_object_next(json_reader_t* const reader, char** const key);
+
+/**
+ * @brief Enter an array
+ *
+ * @param[in] reader JSON reader
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE if the next value is not an array
+ */
+status_t json_reader_array_begin(json_reader_t* const reader);
+
+/**
+ * @brief Move to the next element of the array entered last, which should be read next
+ *
+ * @param[in] reader JSON reader
+ * @param[out] more false if the end of the array is consumed
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE on error
+ */
+status_t json_reader_array_next(json_reader_t* const reader, bool* const more);
+
+/**
+ * @brief Read a string value
+ *
+ * @param[in] reader JSON reader
+ * @param[out] str Unescaped and NUL-terminated string in the copy of the document
+ * @param[out] len Length of the string. It could be NULL.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE if the next value is not a valid string
+ */
+status_t json_reader_string(json_reader_t* const reader, char** const str, size_t* const len);
+
+/**
+ * @brief Read a number value
+ *
+ * @param[in] reader JSON reader
+ * @param[out] value Number
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE if the next value is not a valid number
+ */
+status_t json_reader_number(json_reader_t* const reader, double* const value);
+
+/**
+ * @brief Read a number value as an integer, which is saturated to the range of int as `valueint` of cJSON
+ *
+ * @param[in] reader JSON reader
+ * @param[out] value Integer
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE if the next value is not a valid number
+ */
+status_t json_reader_int(json_reader_t* const reader, int* const value);
+
+/**
+ * @brief Validate and skip the next value
+ *
+ * @param[in] reader JSON reader
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE on error
+ */
+status_t json_reader_skip(json_reader_t* const reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_JSON_READER_H_
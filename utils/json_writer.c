@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "json_writer.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils/buffer_pool.h"
+#include "utils/tryte_simd.h"
+
+#define INT64_STR_LEN 21 /**< Length of INT64_MIN in decimal, with the terminating NUL */
+
+/**
+ * @brief Make room for `size` more bytes and the terminating NUL
+ *
+ * @return
+ * - true if the room is made
+ * - false if the writer is failed
+ */
+static bool writer_reserve(json_writer_t* const writer, const size_t size) {
+  if (writer->status != SC_OK) {
+    return false;
+  }
+  if (writer->len + size + 1 <= writer->capacity) {
+    return true;
+  }
+
+  size_t capacity = writer->capacity ? writer->capacity : 64;
+  while (capacity < writer->len + size + 1) {
+    capacity *= 2;
+  }
+  char* data = (char*)realloc(writer->data, capacity);
+  if (data == NULL) {
+    writer->status = SC_OOM;
+    return false;
+  }
+  writer->data = data;
+  writer->capacity = capacity;
+  return true;
+}
+
+static inline void writer_put(json_writer_t* const writer, char const* const str, const size_t len) {
+  memcpy(writer->data + writer->len, str, len);
+  writer->len += len;
+  writer->data[writer->len] = '\0';
+}
+
+/**
+ * @brief Reserve room for a value of `size` bytes and the comma before it
+ */
+static bool writer_value_begin(json_writer_t* const writer, const size_t size) {
+  if (!writer_reserve(writer, size + 1)) {
+    return false;
+  }
+
+  if (writer->after_key) {
+    writer->after_key = false;
+  } else if (writer->depth > 0) {
+    const uint64_t bit = (uint64_t)1 << (writer->depth - 1);
+    if (writer->has_item & bit) {
+      writer_put(writer, ",", 1);
+    }
+    writer->has_item |= bit;
+  }
+  return true;
+}
+
+status_t json_writer_init(json_writer_t* const writer, const size_t capacity) {
+  if (writer == NULL) {
+    return SC_NULL;
+  }
+
+  memset(writer, 0, sizeof(json_writer_t));
+  writer->data = (char*)buffer_pool_alloc(capacity ? capacity : 64, &writer->capacity);
+  if (writer->data == NULL) {
+    return SC_OOM;
+  }
+  writer->data[0] = '\0';
+  return SC_OK;
+}
+
+void json_writer_destroy(json_writer_t* const writer) {
+  if (writer == NULL) {
+    return;
+  }
+  buffer_pool_release(writer->data);
+  memset(writer, 0, sizeof(json_writer_t));
+}
+
+status_t json_writer_finish(json_writer_t* const writer, char** json) {
+  if (writer == NULL || json == NULL) {
+    return SC_NULL;
+  }
+
+  status_t ret = writer->status;
+  if (ret == SC_OK && (writer->depth != 0 || writer->after_key || writer->len == 0)) {
+    ret = SC_SERIALIZER_JSON_CREATE;
+  }
+  if (ret != SC_OK) {
+    json_writer_destroy(writer);
+    return ret;
+  }
+
+  *json = writer->data;
+  memset(writer, 0, sizeof(json_writer_t));
+  return SC_OK;
+}
+
+static void writer_container_begin(json_writer_t* const writer, const char bracket) {
+  if (!writer_value_begin(writer, 1)) {
+    return;
+  }
+  if (writer->depth >= JSON_WRITER_MAX_DEPTH) {
+    writer->status = SC_SERIALIZER_JSON_CREATE;
+    return;
+  }
+  writer_put(writer, &bracket, 1);
+  writer->depth++;
+  writer->has_item &= ~((uint64_t)1 << (writer->depth - 1));
+}
+
+static void writer_container_end(json_writer_t* const writer, const char bracket) {
+  if (!writer_reserve(writer, 1)) {
+    return;
+  }
+  if (writer->depth == 0 || writer->after_key) {
+    writer->status = SC_SERIALIZER_JSON_CREATE;
+    return;
+  }
+  writer_put(writer, &bracket, 1);
+  writer->depth--;
+}
+
+void json_writer_object_begin(json_writer_t* const writer) { writer_container_begin(writer, '{'); }
+
+void json_writer_object_end(json_writer_t* const writer) { writer_container_end(writer, '}'); }
+
+void json_writer_array_begin(json_writer_t* const writer) { writer_container_begin(writer, '['); }
+
+void json_writer_array_end(json_writer_t* const writer) { writer_container_end(writer, ']'); }
+
+void json_writer_key(json_writer_t* const writer, char const* const key) {
+  const size_t len = strlen(key);
+  if (!writer_value_begin(writer, len + 3)) {
+    return;
+  }
+  writer_put(writer, "\"", 1);
+  writer_put(writer, key, len);
+  writer_put(writer, "\":", 2);
+  writer->after_key = true;
+}
+
+void json_writer_string(json_writer_t* const writer, char const* const str) {
+  size_t size = 2;
+  for (unsigned char const* c = (unsigned char const*)str; *c; c++) {
+    if (*c == '"' || *c == '\\' || *c == '\b' || *c == '\f' || *c == '\n' || *c == '\r' || *c == '\t') {
+      size += 2;
+    } else if (*c < 0x20) {
+      size += 6;  // \u00XX
+    } else {
+      size++;
+    }
+  }
+  if (!writer_value_begin(writer, size)) {
+    return;
+  }
+
+  // The escaping is the same as the one of cJSON
+  char* out = writer->data + writer->len;
+  *out++ = '"';
+  for (unsigned char const* c = (unsigned char const*)str; *c; c++) {
+    if (*c >= 0x20 && *c != '"' && *c != '\\') {
+      *out++ = *c;
+      continue;
+    }
+    *out++ = '\\';
+    switch (*c) {
+      case '"':
+      case '\\':
+        *out++ = *c;
+        break;
+      case '\b':
+        *out++ = 'b';
+        break;
+      case '\f':
+        *out++ = 'f';
+        break;
+      case '\n':
+        *out++ = 'n';
+        break;
+      case '\r':
+        *out++ = 'r';
+        break;
+      case '\t':
+        *out++ = 't';
+        break;
+      default:
+        out += sprintf(out, "u%04x", *c);
+        break;
+    }
+  }
+  *out++ = '"';
+  *out = '\0';
+  writer->len = out - writer->data;
+}
+
+void json_writer_int(json_writer_t* const writer, const int64_t value) {
+  char str[INT64_STR_LEN];
+  const int len = snprintf(str, sizeof(str), "%" PRId64, value);
+  if (!writer_value_begin(writer, len)) {
+    return;
+  }
+  writer_put(writer, str, len);
+}
+
+void json_writer_trytes(json_writer_t* const writer, flex_trit_t const* const flex_trits, const size_t num_trits) {
+  const size_t num_trytes = num_trits / 3;
+  if (!writer_value_begin(writer, num_trytes + 2)) {
+    return;
+  }
+
+  // Trytes are converted into the buffer directly
+  writer_put(writer, "\"", 1);
+  if (num_trytes &&
+      flex_trits_to_trytes_simd((tryte_t*)writer->data + writer->len, num_trytes, flex_trits, num_trits, num_trits) ==
+          0) {
+    writer->status = SC_CCLIENT_FLEX_TRITS;
+    return;
+  }
+  writer->len += num_trytes;
+  writer_put(writer, "\"", 1);
+}
+
+void json_writer_raw(json_writer_t* const writer, char const* const json, const size_t len) {
+  if (writer->status == SC_OK && (json == NULL || len == 0)) {
+    writer->status = SC_NULL;
+  }
+  if (writer->status != SC_OK || !writer_value_begin(writer, len)) {
+    return;
+  }
+  writer_put(writer, json, len);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_JSON_WRITER_H_
+#define UTILS_JSON_WRITER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/json_writer.h
+ * @brief Streaming writer of unformatted JSON
+ *
+ * Values are appended to a growable buffer as they are written, instead of building a cJSON tree and printing it. Tryte
+ * fields are converted from flex_trit_t straight into the buffer, so no intermediate string is allocated. If the
+ * capacity given to `json_writer_init()` is enough, writing a whole document takes a single allocation, which is taken
+ * from `utils/buffer_pool.h` if the current thread has released a large enough buffer.
+ *
+ * Errors are sticky. Once a write fails, the following writes are ignored, and the error is returned by
+ * `json_writer_finish()`.
+ */
+
+#define JSON_WRITER_MAX_DEPTH 64 /**< Maximum nesting depth of objects and arrays */
+
+/** struct of json_writer_t */
+typedef struct json_writer_s {
+  char* data;        /**< Written JSON, which is always NUL-terminated */
+  size_t len;        /**< Length of the written JSON */
+  size_t capacity;   /**< Allocated size of `data` */
+  int depth;         /**< Number of open objects and arrays */
+  uint64_t has_item; /**< Bit `i` is set if the container at depth `i` has an item, so the next one needs a comma */
+  bool after_key;    /**< A key is written and its value is expected */
+  status_t status;   /**< The first error */
+} json_writer_t;
+
+/**
+ * @brief Initialize a JSON writer
+ *
+ * @param[out] writer JSON writer
+ * @param[in] capacity Minimum initial size of the buffer. The buffer grows if it is exceeded.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_OOM on error of allocation
+ */
+status_t json_writer_init(json_writer_t* const writer, const size_t capacity);
+
+/**
+ * @brief Release the buffer of a JSON writer which is not finished
+ *
+ * @param[in] writer JSON writer
+ */
+void json_writer_destroy(json_writer_t* const writer);
+
+/**
+ * @brief Hand over the written JSON
+ *
+ * The buffer is handed over without copying, and the writer is left empty.
+ *
+ * @param[in] writer JSON writer
+ * @param[out] json Written JSON, which should be freed by the caller
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_CREATE if a write failed or any object or array is left open
+ * - SC_OOM on error of allocation
+ */
+status_t json_writer_finish(json_writer_t* const writer, char** json);
+
+/**
+ * @brief Start an object as a value
+ *
+ * @param[in] writer JSON writer
+ */
+void json_writer_object_begin(json_writer_t* const writer);
+
+/**
+ * @brief End the object started last
+ *
+ * @param[in] writer JSON writer
+ */
+void json_writer_object_end(json_writer_t* const writer);
+
+/**
+ * @brief Start an array as a value
+ *
+ * @param[in] writer JSON writer
+ */
+void json_writer_array_begin(json_writer_t* const writer);
+
+/**
+ * @brief End the array started last
+ *
+ * @param[in] writer JSON writer
+ */
+void json_writer_array_end(json_writer_t* const writer);
+
+/**
+ * @brief Write the key of the next member of an object
+ *
+ * @param[in] writer JSON writer
+ * @param[in] key Key, which is written without escaping
+ */
+void json_writer_key(json_writer_t* const writer, char const* const key);
+
+/**
+ * @brief Write a string value, with escaping
+ *
+ * @param[in] writer JSON writer
+ * @param[in] str String
+ */
+void json_writer_string(json_writer_t* const writer, char const* const str);
+
+/**
+ * @brief Write an integer value
+ *
+ * @param[in] writer JSON writer
+ * @param[in] value Integer
+ */
+void json_writer_int(json_writer_t* const writer, const int64_t value);
+
+/**
+ * @brief Write trits as a string value of trytes
+ *
+ * @param[in] writer JSON writer
+ * @param[in] flex_trits Trits in flex_trit_t
+ * @param[in] num_trits Number of trits, which is a multiple of 3
+ */
+void json_writer_trytes(json_writer_t* const writer, flex_trit_t const* const flex_trits, const size_t num_trits);
+
+/**
+ * @brief Write a value which is serialized already, such as a cached transaction object
+ *
+ * @param[in] writer JSON writer
+ * @param[in] json Serialized value, which is written as it is
+ * @param[in] len Length of `json`
+ */
+void json_writer_raw(json_writer_t* const writer, char const* const json, const size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_JSON_WRITER_H_
@@ -0,0 +1,648 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "spool.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "common/logger.h"
+#include "utlist.h"
+
+#define SP_LOGGER "spool"
+#define SEGMENT_MAGIC "TASPOOL"
+#define SEGMENT_VERSION 1
+#define SEGMENT_HEADER_SIZE 8
+#define RECORD_MAGIC 0x52505354 /**< "TSPR" in little-endian */
+#define RECORD_ALIGN 8
+#define RECORD_SIZE(len) \
+  ((sizeof(record_header_t) + SPOOL_KEY_LEN + (len) + RECORD_ALIGN - 1) & ~((size_t)RECORD_ALIGN - 1))
+#define SEGMENT_NAME_LEN 32
+
+typedef struct record_header_s {
+  uint32_t magic; /**< Written after the rest of the record */
+  uint32_t len;
+  uint32_t checksum; /**< Checksum of the key and the payload */
+  uint8_t type;
+  uint8_t acked;
+  uint16_t reserved;
+} record_header_t;
+
+typedef struct spool_segment_s {
+  uint64_t seq;
+  int fd;
+  uint8_t* base;
+  size_t size;
+  size_t tail;      /**< End of the last valid record */
+  size_t head;      /**< Offset of the first unacknowledged record */
+  uint32_t pending; /**< Number of unacknowledged records */
+  bool writable;    /**< Only the segment created by this process is appended */
+  struct spool_segment_s* next;
+} spool_segment_t;
+
+struct spool_s {
+  char* dir;
+  int dir_fd;
+  size_t segment_size;
+  spool_sync_t sync;
+  uint64_t next_seq;
+  size_t pending;
+  spool_segment_t* segments; /**< Ordered from the oldest */
+  size_t unsynced;           /**< Records appended since the last flush */
+  pthread_mutex_t lock;
+  pthread_cond_t flush_cond; /**< Signaled to stop the flusher */
+  pthread_t flusher;         /**< Thread flushing the spool under `SPOOL_SYNC_BATCH` */
+  bool flusher_started;
+  bool closing;
+};
+
+static logger_id_t logger_id;
+
+void sp_logger_init() { logger_id = logger_helper_enable(SP_LOGGER, LOGGER_DEBUG, true); }
+
+int sp_logger_release() {
+  logger_helper_release(logger_id);
+  return 0;
+}
+
+// FNV-1a
+static uint32_t checksum_update(uint32_t hash, const uint8_t* data, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t record_checksum(const char* const key, const void* const data, const size_t len) {
+  uint32_t hash = checksum_update(2166136261u, (const uint8_t*)key, SPOOL_KEY_LEN);
+  return checksum_update(hash, (const uint8_t*)data, len);
+}
+
+static void segment_path(const spool_t* const spool, const uint64_t seq, char* path, const size_t path_len) {
+  snprintf(path, path_len, "%s/%020" PRIu64 SPOOL_SEGMENT_SUFFIX, spool->dir, seq);
+}
+
+/**
+ * @brief Flush the given range of a segment. `msync()` requires a page-aligned address.
+ */
+static status_t segment_sync_range(const spool_segment_t* const segment, const size_t offset, const size_t len) {
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t start = offset & ~(page_size - 1);
+  if (msync(segment->base + start, offset + len - start, MS_SYNC)) {
+    ta_log_error("Failed to flush spool segment %" PRIu64 ": %s\n", segment->seq, strerror(errno));
+    return SC_UTILS_SPOOL_IO_ERROR;
+  }
+  return SC_OK;
+}
+
+static void segment_free(spool_segment_t* segment) {
+  if (segment->base != NULL && segment->base != MAP_FAILED) {
+    munmap(segment->base, segment->size);
+  }
+  if (segment->fd >= 0) {
+    close(segment->fd);
+  }
+  free(segment);
+}
+
+/**
+ * @brief Unmap and delete a segment whose records are all acknowledged
+ */
+static void segment_remove(spool_t* const spool, spool_segment_t* segment) {
+  char path[FILENAME_MAX];
+  segment_path(spool, segment->seq, path, sizeof(path));
+  LL_DELETE(spool->segments, segment);
+  segment_free(segment);
+  if (unlink(path)) {
+    ta_log_warning("Failed to remove spool segment %s: %s\n", path, strerror(errno));
+  }
+}
+
+static record_header_t* record_at(const spool_segment_t* const segment, const size_t offset) {
+  return (record_header_t*)(segment->base + offset);
+}
+
+/**
+ * @brief Move `head` to the first unacknowledged record of a segment
+ */
+static void segment_advance_head(spool_segment_t* const segment) {
+  while (segment->head < segment->tail) {
+    record_header_t* header = record_at(segment, segment->head);
+    if (!header->acked) {
+      break;
+    }
+    segment->head += RECORD_SIZE(header->len);
+  }
+}
+
+/**
+ * @brief Scan the records of a recovered segment. The scan stops at the first torn or corrupted record.
+ */
+static void segment_scan(spool_segment_t* const segment) {
+  size_t offset = SEGMENT_HEADER_SIZE;
+  while (offset + RECORD_SIZE(0) <= segment->size) {
+    record_header_t* header = record_at(segment, offset);
+    if (header->magic != RECORD_MAGIC) {
+      break;
+    }
+    if (RECORD_SIZE(header->len) > segment->size - offset ||
+        header->checksum != record_checksum((const char*)(header + 1),
+                                            (const uint8_t*)(header + 1) + SPOOL_KEY_LEN, header->len)) {
+      ta_log_warning("Discard torn records from offset %zu of spool segment %" PRIu64 "\n", offset, segment->seq);
+      break;
+    }
+    if (!header->acked) {
+      segment->pending++;
+    }
+    offset += RECORD_SIZE(header->len);
+  }
+  segment->tail = offset;
+  segment->head = SEGMENT_HEADER_SIZE;
+  segment_advance_head(segment);
+}
+
+static status_t segment_map(spool_segment_t* const segment, const int prot) {
+  segment->base = (uint8_t*)mmap(NULL, segment->size, prot, MAP_SHARED, segment->fd, 0);
+  if (segment->base == MAP_FAILED) {
+    ta_log_error("Failed to map spool segment %" PRIu64 ": %s\n", segment->seq, strerror(errno));
+    return SC_UTILS_SPOOL_IO_ERROR;
+  }
+  return SC_OK;
+}
+
+static status_t segment_recover(spool_t* const spool, const uint64_t seq) {
+  status_t ret = SC_OK;
+  char path[FILENAME_MAX];
+  struct stat st;
+
+  spool_segment_t* segment = (spool_segment_t*)calloc(1, sizeof(spool_segment_t));
+  if (segment == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  segment->seq = seq;
+  segment_path(spool, seq, path, sizeof(path));
+  segment->fd = open(path, O_RDWR);
+  if (segment->fd < 0 || fstat(segment->fd, &st)) {
+    ret = SC_UTILS_SPOOL_IO_ERROR;
+    ta_log_error("Failed to open spool segment %s: %s\n", path, strerror(errno));
+    goto done;
+  }
+
+  segment->size = (size_t)st.st_size;
+  if (segment->size < SEGMENT_HEADER_SIZE) {
+    ta_log_warning("Remove malformed spool segment %s\n", path);
+    unlink(path);
+    goto done;
+  }
+  ret = segment_map(segment, PROT_READ | PROT_WRITE);
+  if (ret) {
+    goto done;
+  }
+  if (memcmp(segment->base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC) - 1) ||
+      segment->base[sizeof(SEGMENT_MAGIC) - 1] != SEGMENT_VERSION) {
+    ta_log_warning("Remove malformed spool segment %s\n", path);
+    unlink(path);
+    goto done;
+  }
+
+  segment_scan(segment);
+  if (segment->pending == 0) {
+    unlink(path);
+    goto done;
+  }
+
+  ta_log_info("Recovered %u spooled requests from %s\n", segment->pending, path);
+  spool->pending += segment->pending;
+  LL_APPEND(spool->segments, segment);
+  segment = NULL;
+
+done:
+  if (segment) {
+    segment_free(segment);
+  }
+  return ret;
+}
+
+static status_t segment_create(spool_t* const spool, const size_t size, spool_segment_t** created) {
+  status_t ret = SC_OK;
+  char path[FILENAME_MAX];
+
+  spool_segment_t* segment = (spool_segment_t*)calloc(1, sizeof(spool_segment_t));
+  if (segment == NULL) {
+    ret = SC_OOM;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    return ret;
+  }
+  segment->seq = spool->next_seq++;
+  segment->size = size;
+  segment->writable = true;
+  segment_path(spool, segment->seq, path, sizeof(path));
+
+  segment->fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (segment->fd < 0) {
+    ret = SC_UTILS_SPOOL_IO_ERROR;
+    ta_log_error("Failed to create spool segment %s: %s\n", path, strerror(errno));
+    goto done;
+  }
+  // Reserve the blocks up front. Writing to a sparse mapping on a full disk raises SIGBUS instead of an error.
+  errno = posix_fallocate(segment->fd, 0, size);
+  if (errno) {
+    ret = SC_UTILS_SPOOL_IO_ERROR;
+    ta_log_error("Failed to allocate spool segment %s: %s\n", path, strerror(errno));
+    unlink(path);
+    goto done;
+  }
+  ret = segment_map(segment, PROT_READ | PROT_WRITE);
+  if (ret) {
+    unlink(path);
+    goto done;
+  }
+
+  memcpy(segment->base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC) - 1);
+  segment->base[sizeof(SEGMENT_MAGIC) - 1] = SEGMENT_VERSION;
+  segment->head = segment->tail = SEGMENT_HEADER_SIZE;
+  if (spool->sync != SPOOL_SYNC_NONE) {
+    ret = segment_sync_range(segment, 0, SEGMENT_HEADER_SIZE);
+    if (ret == SC_OK && fsync(spool->dir_fd)) {
+      ta_log_warning("Failed to flush spool directory %s: %s\n", spool->dir, strerror(errno));
+    }
+  }
+
+  LL_APPEND(spool->segments, segment);
+  *created = segment;
+  segment = NULL;
+
+done:
+  if (segment) {
+    segment_free(segment);
+  }
+  return ret;
+}
+
+static int seq_compare(const void* a, const void* b) {
+  const uint64_t lhs = *(const uint64_t*)a, rhs = *(const uint64_t*)b;
+  return (lhs > rhs) - (lhs < rhs);
+}
+
+static status_t spool_recover(spool_t* const spool) {
+  status_t ret = SC_OK;
+  uint64_t* seqs = NULL;
+  size_t seq_num = 0, seq_cap = 0;
+
+  DIR* dir = opendir(spool->dir);
+  if (dir == NULL) {
+    ta_log_error("Failed to open spool directory %s: %s\n", spool->dir, strerror(errno));
+    return SC_UTILS_SPOOL_IO_ERROR;
+  }
+
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    uint64_t seq = 0;
+    char suffix[SEGMENT_NAME_LEN] = {0};
+    if (sscanf(entry->d_name, "%" SCNu64 "%31s", &seq, suffix) != 2 || strcmp(suffix, SPOOL_SEGMENT_SUFFIX)) {
+      continue;
+    }
+    if (seq_num == seq_cap) {
+      seq_cap = seq_cap ? seq_cap * 2 : 16;
+      uint64_t* tmp = (uint64_t*)realloc(seqs, seq_cap * sizeof(uint64_t));
+      if (tmp == NULL) {
+        ret = SC_OOM;
+        ta_log_error("%s\n", ta_error_to_string(ret));
+        goto done;
+      }
+      seqs = tmp;
+    }
+    seqs[seq_num++] = seq;
+  }
+
+  // Replay the segments in the order they were created
+  qsort(seqs, seq_num, sizeof(uint64_t), seq_compare);
+  for (size_t i = 0; i < seq_num; i++) {
+    ret = segment_recover(spool, seqs[i]);
+    if (ret) {
+      goto done;
+    }
+    spool->next_seq = seqs[i] + 1;
+  }
+
+done:
+  closedir(dir);
+  free(seqs);
+  return ret;
+}
+
+static spool_segment_t* segment_find(const spool_t* const spool, const uint64_t seq) {
+  spool_segment_t* segment = NULL;
+  LL_FOREACH(spool->segments, segment) {
+    if (segment->seq == seq) {
+      break;
+    }
+  }
+  return segment;
+}
+
+/**
+ * @brief Flush every segment. `spool->lock` must be held.
+ */
+static status_t spool_sync_locked(spool_t* const spool) {
+  status_t ret = SC_OK;
+  spool_segment_t* segment = NULL;
+  LL_FOREACH(spool->segments, segment) {
+    ret = segment_sync_range(segment, 0, segment->tail);
+    if (ret) {
+      return ret;
+    }
+  }
+  spool->unsynced = 0;
+  return ret;
+}
+
+/**
+ * @brief Flush the records appended under `SPOOL_SYNC_BATCH` in every `SPOOL_SYNC_BATCH_INTERVAL`, so a record is not
+ * left in memory if no further requests are spooled.
+ */
+static void* spool_flusher(void* const arg) {
+  spool_t* const spool = (spool_t*)arg;
+  struct timespec deadline;
+
+  pthread_mutex_lock(&spool->lock);
+  while (!spool->closing) {
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += SPOOL_SYNC_BATCH_INTERVAL * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    pthread_cond_timedwait(&spool->flush_cond, &spool->lock, &deadline);
+    if (spool->unsynced) {
+      spool_sync_locked(spool);
+    }
+  }
+  pthread_mutex_unlock(&spool->lock);
+  return NULL;
+}
+
+/*
+ * Public functions
+ */
+
+status_t spool_open(spool_t** spool, const char* const dir, const size_t segment_size, const spool_sync_t sync) {
+  status_t ret = SC_OK;
+  if (spool == NULL || dir == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  spool_t* sp = (spool_t*)calloc(1, sizeof(spool_t));
+  if (sp == NULL || (sp->dir = strdup(dir)) == NULL) {
+    free(sp);
+    ta_log_error("%s\n", ta_error_to_string(SC_OOM));
+    return SC_OOM;
+  }
+  sp->dir_fd = -1;
+  sp->segment_size = segment_size;
+  sp->sync = sync;
+  pthread_mutex_init(&sp->lock, NULL);
+  pthread_cond_init(&sp->flush_cond, NULL);
+
+  if (mkdir(dir, 0700) && errno != EEXIST) {
+    ret = SC_UTILS_SPOOL_IO_ERROR;
+    ta_log_error("Failed to create spool directory %s: %s\n", dir, strerror(errno));
+    goto done;
+  }
+  sp->dir_fd = open(dir, O_RDONLY | O_DIRECTORY);
+  if (sp->dir_fd < 0) {
+    ret = SC_UTILS_SPOOL_IO_ERROR;
+    ta_log_error("Failed to open spool directory %s: %s\n", dir, strerror(errno));
+    goto done;
+  }
+
+  ret = spool_recover(sp);
+  if (ret) {
+    goto done;
+  }
+
+  if (sync == SPOOL_SYNC_BATCH) {
+    if (pthread_create(&sp->flusher, NULL, spool_flusher, sp)) {
+      ta_log_warning("Failed to start flushing spool %s periodically. Records are flushed in batches only.\n", dir);
+    } else {
+      sp->flusher_started = true;
+    }
+  }
+
+done:
+  if (ret) {
+    spool_close(&sp);
+  }
+  *spool = sp;
+  return ret;
+}
+
+void spool_close(spool_t** spool) {
+  if (spool == NULL || *spool == NULL) {
+    return;
+  }
+
+  spool_t* sp = *spool;
+  if (sp->flusher_started) {
+    pthread_mutex_lock(&sp->lock);
+    sp->closing = true;
+    pthread_cond_signal(&sp->flush_cond);
+    pthread_mutex_unlock(&sp->lock);
+    pthread_join(sp->flusher, NULL);
+  }
+  spool_sync(sp);
+  spool_segment_t *segment = NULL, *tmp = NULL;
+  LL_FOREACH_SAFE(sp->segments, segment, tmp) {
+    LL_DELETE(sp->segments, segment);
+    segment_free(segment);
+  }
+  if (sp->dir_fd >= 0) {
+    close(sp->dir_fd);
+  }
+  pthread_cond_destroy(&sp->flush_cond);
+  pthread_mutex_destroy(&sp->lock);
+  free(sp->dir);
+  free(sp);
+  *spool = NULL;
+}
+
+status_t spool_append(spool_t* const spool, const spool_record_type_t type, const char* const key,
+                      const void* const data, const size_t len) {
+  status_t ret = SC_OK;
+  if (spool == NULL || key == NULL || data == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  if (len > UINT32_MAX) {
+    ta_log_error("%s\n", ta_error_to_string(SC_UTILS_OVERFLOW_ERROR));
+    return SC_UTILS_OVERFLOW_ERROR;
+  }
+
+  const size_t record_size = RECORD_SIZE(len);
+  pthread_mutex_lock(&spool->lock);
+
+  // Records are only appended to the newest segment
+  spool_segment_t* segment = spool->segments;
+  while (segment && segment->next) {
+    segment = segment->next;
+  }
+  if (segment == NULL || !segment->writable || segment->tail + record_size > segment->size) {
+    // A request larger than a segment gets a segment of its own
+    const size_t size = (SEGMENT_HEADER_SIZE + record_size > spool->segment_size) ? SEGMENT_HEADER_SIZE + record_size
+                                                                                   : spool->segment_size;
+    ret = segment_create(spool, size, &segment);
+    if (ret) {
+      goto done;
+    }
+  }
+
+  const size_t offset = segment->tail;
+  record_header_t* header = record_at(segment, offset);
+  char* record_key = (char*)(header + 1);
+  memset(record_key, 0, SPOOL_KEY_LEN);
+  strncpy(record_key, key, SPOOL_KEY_LEN);
+  memcpy(record_key + SPOOL_KEY_LEN, data, len);
+  header->len = (uint32_t)len;
+  header->checksum = record_checksum(record_key, record_key + SPOOL_KEY_LEN, len);
+  header->type = (uint8_t)type;
+  header->acked = 0;
+  header->reserved = 0;
+
+  // The magic number marks the record as complete, so it must reach the storage after the rest of the record.
+  if (spool->sync == SPOOL_SYNC_ALWAYS) {
+    ret = segment_sync_range(segment, offset, record_size);
+    if (ret) {
+      goto done;
+    }
+  }
+  __atomic_store_n(&header->magic, RECORD_MAGIC, __ATOMIC_RELEASE);
+  if (spool->sync == SPOOL_SYNC_ALWAYS) {
+    ret = segment_sync_range(segment, offset, sizeof(record_header_t));
+    if (ret) {
+      goto done;
+    }
+  }
+
+  segment->tail += record_size;
+  segment->pending++;
+  spool->pending++;
+
+  // Flushing a batch at once bounds the records lost on a power loss, without flushing every append
+  if (spool->sync == SPOOL_SYNC_BATCH && ++spool->unsynced >= SPOOL_SYNC_BATCH_RECORDS) {
+    ret = spool_sync_locked(spool);
+  }
+
+done:
+  pthread_mutex_unlock(&spool->lock);
+  return ret;
+}
+
+status_t spool_peek(spool_t* const spool, spool_record_t* const record) {
+  status_t ret = SC_UTILS_SPOOL_EMPTY;
+  if (spool == NULL || record == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&spool->lock);
+  spool_segment_t* segment = NULL;
+  LL_FOREACH(spool->segments, segment) {
+    if (segment->head < segment->tail) {
+      const record_header_t* header = record_at(segment, segment->head);
+      const char* key = (const char*)(header + 1);
+      record->type = header->type;
+      memcpy(record->key, key, SPOOL_KEY_LEN);
+      record->key[SPOOL_KEY_LEN] = '\0';
+      record->data = key + SPOOL_KEY_LEN;
+      record->len = header->len;
+      record->seq = segment->seq;
+      record->offset = segment->head;
+      ret = SC_OK;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&spool->lock);
+  return ret;
+}
+
+status_t spool_ack(spool_t* const spool, const spool_record_t* const record) {
+  status_t ret = SC_OK;
+  if (spool == NULL || record == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+
+  pthread_mutex_lock(&spool->lock);
+  spool_segment_t* segment = segment_find(spool, record->seq);
+  if (segment == NULL || record->offset >= segment->tail) {
+    ret = SC_UTILS_WRONG_INPUT_ARG;
+    ta_log_error("%s\n", ta_error_to_string(ret));
+    goto done;
+  }
+
+  record_header_t* header = record_at(segment, record->offset);
+  if (header->acked) {
+    goto done;
+  }
+  header->acked = 1;
+  if (spool->sync == SPOOL_SYNC_ALWAYS) {
+    ret = segment_sync_range(segment, record->offset, sizeof(record_header_t));
+    if (ret) {
+      goto done;
+    }
+  }
+  segment->pending--;
+  spool->pending--;
+  segment_advance_head(segment);
+
+  if (segment->pending == 0) {
+    segment_remove(spool, segment);
+  }
+
+done:
+  pthread_mutex_unlock(&spool->lock);
+  return ret;
+}
+
+status_t spool_sync(spool_t* const spool) {
+  status_t ret = SC_OK;
+  if (spool == NULL) {
+    ta_log_error("%s\n", ta_error_to_string(SC_NULL));
+    return SC_NULL;
+  }
+  if (spool->sync == SPOOL_SYNC_NONE) {
+    return SC_OK;
+  }
+
+  pthread_mutex_lock(&spool->lock);
+  ret = spool_sync_locked(spool);
+  pthread_mutex_unlock(&spool->lock);
+  return ret;
+}
+
+size_t spool_pending(spool_t* const spool) {
+  if (spool == NULL) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&spool->lock);
+  const size_t pending = spool->pending;
+  pthread_mutex_unlock(&spool->lock);
+  return pending;
+}
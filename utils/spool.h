@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_SPOOL_H_
+#define UTILS_SPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/spool.h
+ * @brief Local persistent spool of buffered requests
+ *
+ * The spool keeps buffered requests on local storage while the cache server is unavailable. Requests are appended to
+ * memory-mapped segment files of fixed size under the spool directory, and are replayed in the order they are appended.
+ * Once every record in a segment is acknowledged, the segment file is removed.
+ *
+ * Each record carries a checksum, and its magic number is written after the rest of the record. A record torn by a
+ * power loss is detected and discarded when the spool is reopened.
+ */
+
+#define SPOOL_KEY_LEN 36                       /**< Length of the UUID string which keys a spooled record */
+#define SPOOL_SEGMENT_SIZE (4 * 1024 * 1024)   /**< Default size of a segment file in bytes */
+#define SPOOL_SEGMENT_SUFFIX ".seg"            /**< Suffix of segment file names */
+#define SPOOL_SYNC_BATCH_RECORDS 64            /**< Records appended under `SPOOL_SYNC_BATCH` before flushing at once */
+#define SPOOL_SYNC_BATCH_INTERVAL 200          /**< Milliseconds a record waits at most under `SPOOL_SYNC_BATCH` */
+
+/** Policy of flushing the spool to storage */
+typedef enum spool_sync_e {
+  SPOOL_SYNC_NONE = 0, /**< Leave flushing to the kernel */
+  SPOOL_SYNC_BATCH,    /**< Flush in batches of `SPOOL_SYNC_BATCH_RECORDS` or every `SPOOL_SYNC_BATCH_INTERVAL` */
+  SPOOL_SYNC_ALWAYS,   /**< Flush on every append and acknowledgement */
+} spool_sync_t;
+
+/** Type of the request carried by a spooled record */
+typedef enum spool_record_type_e {
+  SPOOL_RECORD_BUNDLE = 1, /**< Bundle blob of a buffered transfer */
+  SPOOL_RECORD_MAM = 2,    /**< JSON request of a buffered MAM message */
+} spool_record_type_t;
+
+/** struct of spool_record_t */
+typedef struct spool_record_s {
+  uint8_t type;                   /**< One of `spool_record_type_t` */
+  char key[SPOOL_KEY_LEN + 1];    /**< UUID of the request */
+  const void* data;               /**< Payload. It points into the spool and stays valid until acknowledged. */
+  size_t len;                     /**< Length of the payload */
+  /** @cond private data */
+  uint64_t seq;
+  size_t offset;
+  /** @endcond */
+} spool_record_t;
+
+/** Opaque type of the spool */
+typedef struct spool_s spool_t;
+
+/**
+ * @brief Open a spool, and recover the records left in it
+ *
+ * @param[out] spool Opened spool. It should be closed with `spool_close()`.
+ * @param[in] dir Directory of segment files. It is created if it does not exist.
+ * @param[in] segment_size Size of a segment file in bytes
+ * @param[in] sync Policy of flushing the spool to storage
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t spool_open(spool_t** spool, const char* const dir, const size_t segment_size, const spool_sync_t sync);
+
+/**
+ * @brief Flush and close a spool. Unacknowledged records are kept in the segment files.
+ *
+ * @param[in,out] spool Spool to close. It is set to NULL.
+ */
+void spool_close(spool_t** spool);
+
+/**
+ * @brief Append a request to the spool
+ *
+ * @param[in] spool Spool
+ * @param[in] type Type of the request
+ * @param[in] key UUID of the request
+ * @param[in] data Payload
+ * @param[in] len Length of the payload
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_SPOOL_IO_ERROR if the segment file cannot be created
+ * - non-zero on error
+ */
+status_t spool_append(spool_t* const spool, const spool_record_type_t type, const char* const key,
+                      const void* const data, const size_t len);
+
+/**
+ * @brief Get the oldest unacknowledged record without removing it
+ *
+ * @param[in] spool Spool
+ * @param[out] record The oldest unacknowledged record
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_SPOOL_EMPTY if every record is acknowledged
+ * - non-zero on error
+ */
+status_t spool_peek(spool_t* const spool, spool_record_t* const record);
+
+/**
+ * @brief Acknowledge a record, so it would not be replayed again. Segments whose records are all acknowledged are
+ * removed.
+ *
+ * @param[in] spool Spool
+ * @param[in] record Record returned by `spool_peek()`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t spool_ack(spool_t* const spool, const spool_record_t* const record);
+
+/**
+ * @brief Flush the spool to storage. It does nothing under `SPOOL_SYNC_NONE`.
+ *
+ * @param[in] spool Spool
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t spool_sync(spool_t* const spool);
+
+/**
+ * @brief Get the number of unacknowledged records
+ *
+ * @param[in] spool Spool
+ *
+ * @return Number of unacknowledged records
+ */
+size_t spool_pending(spool_t* const spool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_SPOOL_H_
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "tag_set.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define TAG_SET_MIN_CAPACITY 16
+
+static size_t tag_hash(tryte_t const* const tag) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < NUM_TRYTES_TAG; i++) {
+    hash ^= (uint8_t)tag[i];
+    hash *= FNV_PRIME;
+  }
+  return (size_t)hash;
+}
+
+/**
+ * @brief Find the slot holding the tag, or the empty slot where the tag should be put.
+ */
+static tag_set_slot_t* slot_find(tag_set_slot_t* const slots, const size_t capacity, tryte_t const* const tag) {
+  size_t idx = tag_hash(tag) & (capacity - 1);
+  while (slots[idx].used && memcmp(slots[idx].tag, tag, NUM_TRYTES_TAG)) {
+    idx = (idx + 1) & (capacity - 1);
+  }
+  return &slots[idx];
+}
+
+static status_t table_resize(tag_set_t* const set, const size_t capacity) {
+  tag_set_slot_t* slots = (tag_set_slot_t*)calloc(capacity, sizeof(tag_set_slot_t));
+  if (slots == NULL) {
+    return SC_OOM;
+  }
+
+  for (size_t i = 0; i < set->capacity; i++) {
+    if (set->slots[i].used) {
+      *slot_find(slots, capacity, set->slots[i].tag) = set->slots[i];
+    }
+  }
+  free(set->slots);
+  set->slots = slots;
+  set->capacity = capacity;
+  return SC_OK;
+}
+
+status_t tag_set_init(tag_set_t* const set, const size_t capacity) {
+  if (set == NULL) {
+    return SC_NULL;
+  }
+
+  size_t table_capacity = TAG_SET_MIN_CAPACITY;
+  while (table_capacity < capacity * 2) {
+    table_capacity <<= 1;
+  }
+  set->slots = NULL;
+  set->capacity = 0;
+  set->size = 0;
+  return table_resize(set, table_capacity);
+}
+
+void tag_set_destroy(tag_set_t* const set) {
+  if (set == NULL) {
+    return;
+  }
+  free(set->slots);
+  set->slots = NULL;
+  set->capacity = 0;
+  set->size = 0;
+}
+
+void tag_set_reset(tag_set_t* const set) {
+  if (set == NULL || set->slots == NULL) {
+    return;
+  }
+  memset(set->slots, 0, sizeof(tag_set_slot_t) * set->capacity);
+  set->size = 0;
+}
+
+status_t tag_set_add(tag_set_t* const set, tryte_t const* const tag) {
+  if (set == NULL || set->slots == NULL || tag == NULL) {
+    return SC_NULL;
+  }
+
+  // Keep the table at most half full, so probing sequences stay short
+  if ((set->size + 1) * 2 > set->capacity) {
+    status_t ret = table_resize(set, set->capacity * 2);
+    if (ret) {
+      return ret;
+    }
+  }
+
+  tag_set_slot_t* slot = slot_find(set->slots, set->capacity, tag);
+  if (!slot->used) {
+    memcpy(slot->tag, tag, NUM_TRYTES_TAG);
+    slot->used = true;
+    set->size++;
+  }
+  return SC_OK;
+}
+
+bool tag_set_contains(tag_set_t const* const set, tryte_t const* const tag) {
+  if (set == NULL || set->slots == NULL || tag == NULL) {
+    return false;
+  }
+  return slot_find(set->slots, set->capacity, tag)->used;
+}
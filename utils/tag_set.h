@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_TAG_SET_H_
+#define UTILS_TAG_SET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common/model/transaction.h"
+#include "common/ta_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/tag_set.h
+ * @brief Hash set of transaction tags
+ *
+ * Tags of 81 trits are kept as 27 trytes in an open-addressing table with linear probing. The table is kept at most
+ * half full, and it grows by doubling, so adding and checking a tag take constant time on average.
+ */
+
+/** struct of tag_set_slot_t */
+typedef struct tag_set_slot_s {
+  tryte_t tag[NUM_TRYTES_TAG]; /**< Tag in trytes */
+  bool used;                   /**< Whether the slot holds a tag */
+} tag_set_slot_t;
+
+/** struct of tag_set_t */
+typedef struct tag_set_s {
+  tag_set_slot_t* slots; /**< Slots of the table */
+  size_t capacity;       /**< Number of slots, which is a power of two */
+  size_t size;           /**< Number of tags in the set */
+} tag_set_t;
+
+/**
+ * @brief Initialize a tag set
+ *
+ * @param[out] set Tag set to initialize
+ * @param[in] capacity Expected number of tags. The set grows if more tags are added.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t tag_set_init(tag_set_t* const set, const size_t capacity);
+
+/**
+ * @brief Release the table of a tag set
+ *
+ * @param[in] set Tag set
+ */
+void tag_set_destroy(tag_set_t* const set);
+
+/**
+ * @brief Remove all the tags from a tag set and keep its table
+ *
+ * @param[in] set Tag set
+ */
+void tag_set_reset(tag_set_t* const set);
+
+/**
+ * @brief Add a tag to a tag set. Adding an existing tag does nothing.
+ *
+ * @param[in] set Tag set
+ * @param[in] tag Tag in `NUM_TRYTES_TAG` trytes
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t tag_set_add(tag_set_t* const set, tryte_t const* const tag);
+
+/**
+ * @brief Check whether a tag is in a tag set
+ *
+ * @param[in] set Tag set
+ * @param[in] tag Tag in `NUM_TRYTES_TAG` trytes
+ *
+ * @return
+ * - true if the tag is in the set
+ * - false otherwise
+ */
+bool tag_set_contains(tag_set_t const* const set, tryte_t const* const tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_TAG_SET_H_
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "trit_pack.h"
+#include <pthread.h>
+#include <string.h>
+#include "utils/tryte_simd.h"
+
+// Trits are converted from and to flex_trit_t in chunks, so the stack usage doesn't grow with the input. A chunk is a
+// multiple of the trits in a packed byte and in a flex_trit_t of any encoding, so each chunk starts on a byte boundary.
+#define TRIT_PACK_CHUNK_TRITS 1200
+
+static trit_t decode_table[TRIT_PACK_MAX_BYTE + 1][TRIT_PACK_TRITS_PER_BYTE];
+static pthread_once_t decode_table_once = PTHREAD_ONCE_INIT;
+
+static void decode_table_init() {
+  for (int value = 0; value <= TRIT_PACK_MAX_BYTE; value++) {
+    int remain = value;
+    for (int i = 0; i < TRIT_PACK_TRITS_PER_BYTE; i++) {
+      decode_table[value][i] = (trit_t)(remain % 3 - 1);
+      remain /= 3;
+    }
+  }
+}
+
+static inline uint8_t pack_group(const trit_t* const t) {
+  return (uint8_t)((t[0] + 1) + 3 * (t[1] + 1) + 9 * (t[2] + 1) + 27 * (t[3] + 1) + 81 * (t[4] + 1));
+}
+
+void trit_pack_encode(const trit_t* const trits, const size_t num_trits, uint8_t* packed) {
+  const size_t full_groups = num_trits / TRIT_PACK_TRITS_PER_BYTE;
+  const size_t remain = num_trits % TRIT_PACK_TRITS_PER_BYTE;
+
+  // Branch-free loop over complete groups, which the compiler is able to vectorize
+  for (size_t i = 0; i < full_groups; i++) {
+    packed[i] = pack_group(trits + i * TRIT_PACK_TRITS_PER_BYTE);
+  }
+
+  if (remain) {
+    trit_t last[TRIT_PACK_TRITS_PER_BYTE] = {0};
+    memcpy(last, trits + full_groups * TRIT_PACK_TRITS_PER_BYTE, remain);
+    packed[full_groups] = pack_group(last);
+  }
+}
+
+status_t trit_pack_decode(const uint8_t* const packed, const size_t num_trits, trit_t* trits) {
+  const size_t full_groups = num_trits / TRIT_PACK_TRITS_PER_BYTE;
+  const size_t remain = num_trits % TRIT_PACK_TRITS_PER_BYTE;
+  uint8_t invalid = 0;
+
+  pthread_once(&decode_table_once, decode_table_init);
+
+  for (size_t i = 0; i < full_groups; i++) {
+    // Out of range bytes are clamped for the lookup and reported after the loop
+    invalid |= (packed[i] > TRIT_PACK_MAX_BYTE);
+    const uint8_t value = (packed[i] > TRIT_PACK_MAX_BYTE) ? 0 : packed[i];
+    memcpy(trits + i * TRIT_PACK_TRITS_PER_BYTE, decode_table[value], TRIT_PACK_TRITS_PER_BYTE);
+  }
+
+  if (remain) {
+    invalid |= (packed[full_groups] > TRIT_PACK_MAX_BYTE);
+    const uint8_t value = (packed[full_groups] > TRIT_PACK_MAX_BYTE) ? 0 : packed[full_groups];
+    memcpy(trits + full_groups * TRIT_PACK_TRITS_PER_BYTE, decode_table[value], remain);
+  }
+
+  return invalid ? SC_UTILS_TRIT_PACK_INVALID : SC_OK;
+}
+
+void flex_trits_pack(const flex_trit_t* const flex_trits, const size_t num_trits, uint8_t* packed) {
+  trit_t trits[TRIT_PACK_CHUNK_TRITS];
+  for (size_t offset = 0; offset < num_trits; offset += TRIT_PACK_CHUNK_TRITS) {
+    const size_t len = (num_trits - offset < TRIT_PACK_CHUNK_TRITS) ? num_trits - offset : TRIT_PACK_CHUNK_TRITS;
+    flex_trits_to_trits_simd(trits, len, flex_trits + NUM_FLEX_TRITS_FOR_TRITS(offset), len, len);
+    trit_pack_encode(trits, len, packed + offset / TRIT_PACK_TRITS_PER_BYTE);
+  }
+}
+
+status_t flex_trits_unpack(const uint8_t* const packed, const size_t num_trits, flex_trit_t* flex_trits) {
+  status_t ret = SC_OK;
+  trit_t trits[TRIT_PACK_CHUNK_TRITS];
+  for (size_t offset = 0; offset < num_trits; offset += TRIT_PACK_CHUNK_TRITS) {
+    const size_t len = (num_trits - offset < TRIT_PACK_CHUNK_TRITS) ? num_trits - offset : TRIT_PACK_CHUNK_TRITS;
+    ret = trit_pack_decode(packed + offset / TRIT_PACK_TRITS_PER_BYTE, len, trits);
+    if (ret) {
+      return ret;
+    }
+    flex_trits_from_trits_simd(flex_trits + NUM_FLEX_TRITS_FOR_TRITS(offset), len, trits, len, len);
+  }
+  return SC_OK;
+}
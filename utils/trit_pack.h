@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_TRIT_PACK_H_
+#define UTILS_TRIT_PACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/trit_pack.h
+ * @brief Packed encoding of 5 trits per byte
+ *
+ * Every 5 trits are packed into one byte, whose value is `sum((trit[i] + 1) * 3^i)` in the range of [0, 242]. The last
+ * byte is padded with zero trits. 243 trits are packed into 49 bytes, and a serialized transaction of 8019 trits is
+ * packed into 1604 bytes, which is about 40% smaller than its 2673 trytes.
+ */
+
+#define TRIT_PACK_TRITS_PER_BYTE 5 /**< Number of trits packed in a byte */
+#define TRIT_PACK_MAX_BYTE 242     /**< Maximum value of a valid packed byte */
+#define TRIT_PACK_SIZE(num_trits) \
+  (((num_trits) + TRIT_PACK_TRITS_PER_BYTE - 1) / TRIT_PACK_TRITS_PER_BYTE) /**< Packed size of the given trits */
+#define TRIT_PACK_VERSION 1 /**< Format version byte prefixed to a standalone packed value in cache */
+
+/**
+ * @brief Pack trits into bytes
+ *
+ * @param[in] trits Trits to pack
+ * @param[in] num_trits Number of trits
+ * @param[out] packed Packed bytes. It must have at least `TRIT_PACK_SIZE(num_trits)` bytes.
+ */
+void trit_pack_encode(const trit_t* const trits, const size_t num_trits, uint8_t* packed);
+
+/**
+ * @brief Unpack bytes into trits
+ *
+ * @param[in] packed Packed bytes
+ * @param[in] num_trits Number of trits to unpack
+ * @param[out] trits Unpacked trits. It must have at least `num_trits` trits.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_TRIT_PACK_INVALID if any of the packed bytes is out of range
+ */
+status_t trit_pack_decode(const uint8_t* const packed, const size_t num_trits, trit_t* trits);
+
+/**
+ * @brief Pack flex_trit_t into bytes
+ *
+ * @param[in] flex_trits Trits in flex_trit_t
+ * @param[in] num_trits Number of trits
+ * @param[out] packed Packed bytes. It must have at least `TRIT_PACK_SIZE(num_trits)` bytes.
+ */
+void flex_trits_pack(const flex_trit_t* const flex_trits, const size_t num_trits, uint8_t* packed);
+
+/**
+ * @brief Unpack bytes into flex_trit_t
+ *
+ * @param[in] packed Packed bytes
+ * @param[in] num_trits Number of trits to unpack
+ * @param[out] flex_trits Unpacked trits in flex_trit_t. It must have at least `NUM_FLEX_TRITS_FOR_TRITS(num_trits)`
+ * bytes.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_TRIT_PACK_INVALID if any of the packed bytes is out of range
+ */
+status_t flex_trits_unpack(const uint8_t* const packed, const size_t num_trits, flex_trit_t* flex_trits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_TRIT_PACK_H_
@@ -7,14 +7,31 @@
  */
 
 #include "tryte_byte_conv.h"
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(__x86_64__) && defined(__SSE2__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TRYTE_BYTE_CONV_AVX2 /**< AVX2 kernels are built with a target attribute and selected at runtime */
+#endif
 
-void bytes_to_trytes(unsigned char const *const input, uint16_t input_len, char *output) {
+typedef void (*bytes_to_trytes_fn)(unsigned char const *const, const size_t, char *);
+typedef void (*trytes_to_bytes_fn)(unsigned char const *const, const size_t, char *const);
+
+static bytes_to_trytes_fn bytes_to_trytes_impl = bytes_to_trytes_scalar;
+static trytes_to_bytes_fn trytes_to_bytes_impl = trytes_to_bytes_scalar;
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+
+void bytes_to_trytes_scalar(unsigned char const *const input, const size_t input_len, char *output) {
   const char tryte_alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
   uint8_t dec = 0, lower = 0, upper = 0;
 
-  for (uint16_t i = 0; i < input_len; i++) {
+  for (size_t i = 0; i < input_len; i++) {
     dec = input[i];
     upper = (dec >> 4) & 15;
     lower = dec & 15;
@@ -23,10 +40,10 @@ void bytes_to_trytes(unsigned char const *const input, uint16_t input_len, char
   }
 }
 
-void trytes_to_bytes(unsigned char const *const input, uint32_t input_len, char *const output) {
+void trytes_to_bytes_scalar(unsigned char const *const input, const size_t input_len, char *const output) {
   uint8_t upper = 0, lower = 0;
 
-  for (uint16_t i = 0; i < input_len; i += 2) {
+  for (size_t i = 0; i + 1 < input_len; i += 2) {
     if (input[i] == '9') {
       upper = 0;
     } else {
@@ -41,3 +58,189 @@ void trytes_to_bytes(unsigned char const *const input, uint32_t input_len, char
     output[i / 2] = (upper << 4) | lower;
   }
 }
+
+#if defined(__SSE2__)
+/**
+ * Nibbles 1 to 15 are offset to 'A' to 'O', and 0 is replaced by '9'
+ */
+static inline __m128i nibbles_to_trytes_128(const __m128i nibbles) {
+  const __m128i is_zero = _mm_cmpeq_epi8(nibbles, _mm_setzero_si128());
+  return _mm_or_si128(_mm_andnot_si128(is_zero, _mm_add_epi8(nibbles, _mm_set1_epi8('@'))),
+                      _mm_and_si128(is_zero, _mm_set1_epi8('9')));
+}
+
+/**
+ * Every pair of trytes in a 16-bit lane is combined into a byte in the lower half of the lane. The arithmetic wraps as
+ * the scalar implementation does, so invalid trytes give the same bytes.
+ */
+static inline __m128i trytes_to_pairs_128(const __m128i trytes) {
+  const __m128i values = _mm_andnot_si128(_mm_cmpeq_epi8(trytes, _mm_set1_epi8('9')),
+                                          _mm_sub_epi8(trytes, _mm_set1_epi8('@')));
+  return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(values, 4), _mm_set1_epi16(0xff)), _mm_srli_epi16(values, 8));
+}
+
+static void bytes_to_trytes_sse2(unsigned char const *const input, const size_t input_len, char *output) {
+  const __m128i low_mask = _mm_set1_epi8(15);
+  size_t i = 0;
+
+  for (; i + 16 <= input_len; i += 16) {
+    const __m128i bytes = _mm_loadu_si128((__m128i const *)(input + i));
+    const __m128i upper = nibbles_to_trytes_128(_mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+    const __m128i lower = nibbles_to_trytes_128(_mm_and_si128(bytes, low_mask));
+    _mm_storeu_si128((__m128i *)(output + 2 * i), _mm_unpacklo_epi8(upper, lower));
+    _mm_storeu_si128((__m128i *)(output + 2 * i + 16), _mm_unpackhi_epi8(upper, lower));
+  }
+  bytes_to_trytes_scalar(input + i, input_len - i, output + 2 * i);
+}
+
+static void trytes_to_bytes_sse2(unsigned char const *const input, const size_t input_len, char *const output) {
+  size_t i = 0;
+
+  for (; i + 32 <= input_len; i += 32) {
+    const __m128i first = trytes_to_pairs_128(_mm_loadu_si128((__m128i const *)(input + i)));
+    const __m128i second = trytes_to_pairs_128(_mm_loadu_si128((__m128i const *)(input + i + 16)));
+    _mm_storeu_si128((__m128i *)(output + i / 2), _mm_packus_epi16(first, second));
+  }
+  trytes_to_bytes_scalar(input + i, input_len - i, output + i / 2);
+}
+#endif
+
+#if defined(TRYTE_BYTE_CONV_AVX2)
+__attribute__((target("avx2"))) static inline __m256i nibbles_to_trytes_256(const __m256i nibbles) {
+  const __m256i is_zero = _mm256_cmpeq_epi8(nibbles, _mm256_setzero_si256());
+  return _mm256_blendv_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('@')), _mm256_set1_epi8('9'), is_zero);
+}
+
+__attribute__((target("avx2"))) static inline __m256i trytes_to_pairs_256(const __m256i trytes) {
+  const __m256i values = _mm256_andnot_si256(_mm256_cmpeq_epi8(trytes, _mm256_set1_epi8('9')),
+                                             _mm256_sub_epi8(trytes, _mm256_set1_epi8('@')));
+  return _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(values, 4), _mm256_set1_epi16(0xff)),
+                         _mm256_srli_epi16(values, 8));
+}
+
+__attribute__((target("avx2"))) static void bytes_to_trytes_avx2(unsigned char const *const input,
+                                                                  const size_t input_len, char *output) {
+  const __m256i low_mask = _mm256_set1_epi8(15);
+  size_t i = 0;
+
+  for (; i + 32 <= input_len; i += 32) {
+    const __m256i bytes = _mm256_loadu_si256((__m256i const *)(input + i));
+    const __m256i upper = nibbles_to_trytes_256(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+    const __m256i lower = nibbles_to_trytes_256(_mm256_and_si256(bytes, low_mask));
+    // Unpacking works within 128-bit lanes, so the lanes are put back in order afterwards
+    const __m256i low_half = _mm256_unpacklo_epi8(upper, lower);
+    const __m256i high_half = _mm256_unpackhi_epi8(upper, lower);
+    _mm256_storeu_si256((__m256i *)(output + 2 * i), _mm256_permute2x128_si256(low_half, high_half, 0x20));
+    _mm256_storeu_si256((__m256i *)(output + 2 * i + 32), _mm256_permute2x128_si256(low_half, high_half, 0x31));
+  }
+  bytes_to_trytes_sse2(input + i, input_len - i, output + 2 * i);
+}
+
+__attribute__((target("avx2"))) static void trytes_to_bytes_avx2(unsigned char const *const input,
+                                                                  const size_t input_len, char *const output) {
+  size_t i = 0;
+
+  for (; i + 64 <= input_len; i += 64) {
+    const __m256i first = trytes_to_pairs_256(_mm256_loadu_si256((__m256i const *)(input + i)));
+    const __m256i second = trytes_to_pairs_256(_mm256_loadu_si256((__m256i const *)(input + i + 32)));
+    // Packing works within 128-bit lanes as well
+    const __m256i bytes = _mm256_packus_epi16(first, second);
+    _mm256_storeu_si256((__m256i *)(output + i / 2), _mm256_permute4x64_epi64(bytes, 0xd8));
+  }
+  trytes_to_bytes_sse2(input + i, input_len - i, output + i / 2);
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+static inline uint8x16_t nibbles_to_trytes_neon(const uint8x16_t nibbles) {
+  return vbslq_u8(vceqq_u8(nibbles, vdupq_n_u8(0)), vdupq_n_u8('9'), vaddq_u8(nibbles, vdupq_n_u8('@')));
+}
+
+static inline uint8x16_t trytes_to_values_neon(const uint8x16_t trytes) {
+  return vbicq_u8(vsubq_u8(trytes, vdupq_n_u8('@')), vceqq_u8(trytes, vdupq_n_u8('9')));
+}
+
+static void bytes_to_trytes_neon(unsigned char const *const input, const size_t input_len, char *output) {
+  size_t i = 0;
+
+  for (; i + 16 <= input_len; i += 16) {
+    const uint8x16_t bytes = vld1q_u8(input + i);
+    uint8x16x2_t trytes;
+    trytes.val[0] = nibbles_to_trytes_neon(vshrq_n_u8(bytes, 4));
+    trytes.val[1] = nibbles_to_trytes_neon(vandq_u8(bytes, vdupq_n_u8(15)));
+    vst2q_u8((uint8_t *)output + 2 * i, trytes);
+  }
+  bytes_to_trytes_scalar(input + i, input_len - i, output + 2 * i);
+}
+
+static void trytes_to_bytes_neon(unsigned char const *const input, const size_t input_len, char *const output) {
+  size_t i = 0;
+
+  for (; i + 32 <= input_len; i += 32) {
+    const uint8x16x2_t trytes = vld2q_u8(input + i);
+    const uint8x16_t upper = trytes_to_values_neon(trytes.val[0]);
+    const uint8x16_t lower = trytes_to_values_neon(trytes.val[1]);
+    vst1q_u8((uint8_t *)output + i / 2, vorrq_u8(vshlq_n_u8(upper, 4), lower));
+  }
+  trytes_to_bytes_scalar(input + i, input_len - i, output + i / 2);
+}
+#endif
+
+static void dispatch_init() {
+#if defined(TRYTE_BYTE_CONV_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    bytes_to_trytes_impl = bytes_to_trytes_avx2;
+    trytes_to_bytes_impl = trytes_to_bytes_avx2;
+    return;
+  }
+#endif
+#if defined(__SSE2__)
+  bytes_to_trytes_impl = bytes_to_trytes_sse2;
+  trytes_to_bytes_impl = trytes_to_bytes_sse2;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  bytes_to_trytes_impl = bytes_to_trytes_neon;
+  trytes_to_bytes_impl = trytes_to_bytes_neon;
+#endif
+}
+
+void bytes_to_trytes(unsigned char const *const input, const size_t input_len, char *output) {
+  pthread_once(&dispatch_once, dispatch_init);
+  bytes_to_trytes_impl(input, input_len, output);
+}
+
+void trytes_to_bytes(unsigned char const *const input, const size_t input_len, char *const output) {
+  pthread_once(&dispatch_once, dispatch_init);
+  trytes_to_bytes_impl(input, input_len, output);
+}
+
+void trytes_to_bytes_stream_init(trytes_to_bytes_stream_t *const stream) {
+  stream->pending = 0;
+  stream->has_pending = false;
+}
+
+size_t trytes_to_bytes_stream(trytes_to_bytes_stream_t *const stream, unsigned char const *const input,
+                              const size_t input_len, char *const output) {
+  size_t consumed = 0, written = 0;
+
+  if (input_len == 0) {
+    return 0;
+  }
+  if (stream->has_pending) {
+    const unsigned char pair[2] = {stream->pending, input[0]};
+    trytes_to_bytes_scalar(pair, 2, output);
+    consumed = 1;
+    written = 1;
+  }
+
+  const size_t num_bytes = (input_len - consumed) / 2;
+  trytes_to_bytes(input + consumed, num_bytes * 2, output + written);
+  consumed += num_bytes * 2;
+  written += num_bytes;
+
+  stream->has_pending = (consumed < input_len);
+  if (stream->has_pending) {
+    stream->pending = input[consumed];
+  }
+  return written;
+}
@@ -9,6 +9,8 @@
 #ifndef UTILS_TRYTE_BYTE_CONV_H
 #define UTILS_TRYTE_BYTE_CONV_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -18,25 +20,73 @@ extern "C" {
 /**
  * @file utils/tryte_byte_conv.h
  * @brief Conversion between trytes and bytes.
+ *
+ * Each byte is encoded as two trytes, the upper 4 bits first, where 0 is '9' and 1 to 15 are 'A' to 'O'.
+ *
+ * `bytes_to_trytes()` and `trytes_to_bytes()` dispatch to vectorized implementations, which are selected once at
+ * runtime: AVX2 if the CPU supports it, otherwise SSE2 on x86-64 or NEON on AArch64, and the scalar implementation
+ * elsewhere. All of them give the same output as the scalar implementation for any input.
  */
 
+/** Context of decoding trytes which arrive in chunks */
+typedef struct trytes_to_bytes_stream_s {
+  unsigned char pending; /**< Last tryte of the previous chunk, which is the upper half of the next byte */
+  bool has_pending;      /**< The previous chunk ends in the middle of a byte */
+} trytes_to_bytes_stream_t;
+
 /**
  * @brief Convert bytes to trytes
  *
+ * Bytes are encoded independently, so a payload could be converted in chunks of any size, where the output of each
+ * chunk follows the output of the previous one.
+ *
  * @param[in] input The pointer to bytes array
  * @param[in] len Length of bytes array
- * @param[out] output The pointer to output array
+ * @param[out] output The pointer to output array, which has room for `2 * len` trytes
  */
-void bytes_to_trytes(unsigned char const *const input, uint16_t len, char *output);
+void bytes_to_trytes(unsigned char const *const input, const size_t len, char *output);
 
 /**
  * @brief Convert trytes to bytes
  *
  * @param[in] input The pointer to trytes array
- * @param[in] input_len Length of trytes array
- * @param[out] output The pointer to output array
+ * @param[in] input_len Length of trytes array. A trailing tryte of an odd length is ignored.
+ * @param[out] output The pointer to output array, which has room for `input_len / 2` bytes
+ */
+void trytes_to_bytes(unsigned char const *const input, const size_t input_len, char *const output);
+
+/**
+ * @brief Scalar implementation of `bytes_to_trytes()`
+ */
+void bytes_to_trytes_scalar(unsigned char const *const input, const size_t len, char *output);
+
+/**
+ * @brief Scalar implementation of `trytes_to_bytes()`
+ */
+void trytes_to_bytes_scalar(unsigned char const *const input, const size_t input_len, char *const output);
+
+/**
+ * @brief Initialize a context of decoding trytes in chunks
+ *
+ * @param[out] stream Decoding context
+ */
+void trytes_to_bytes_stream_init(trytes_to_bytes_stream_t *const stream);
+
+/**
+ * @brief Convert a chunk of trytes to bytes
+ *
+ * Chunks could have any length, including odd ones. A tryte which is left over is kept in the context and combined with
+ * the first tryte of the next chunk.
+ *
+ * @param[in,out] stream Decoding context
+ * @param[in] input The pointer to the chunk of trytes
+ * @param[in] input_len Length of the chunk
+ * @param[out] output The pointer to output array, which has room for `(input_len + 1) / 2` bytes
+ *
+ * @return Number of bytes written to `output`
  */
-void trytes_to_bytes(unsigned char const *const input, uint32_t input_len, char *const output);
+size_t trytes_to_bytes_stream(trytes_to_bytes_stream_t *const stream, unsigned char const *const input,
+                              const size_t input_len, char *const output);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "tryte_simd.h"
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define TRYTE_SIMD_WIDTH 16 /**< Characters processed by a vector instruction */
+#define TRYTE_SIMD_CHUNK 256 /**< Trytes converted through a buffer of values at a time */
+
+static char const TRYTE_ALPHABET[] = "NOPQRSTUVWXYZ9ABCDEFGHIJKLM"; /**< Trytes indexed by their values plus 13 */
+
+/** Trits of the values from -13 to 13, least significant first */
+static trit_t const VALUE_TRITS[27][3] = {
+    {-1, -1, -1}, {0, -1, -1}, {1, -1, -1}, {-1, 0, -1}, {0, 0, -1}, {1, 0, -1}, {-1, 1, -1}, {0, 1, -1}, {1, 1, -1},
+    {-1, -1, 0},  {0, -1, 0},  {1, -1, 0},  {-1, 0, 0},  {0, 0, 0},  {1, 0, 0},  {-1, 1, 0},  {0, 1, 0},  {1, 1, 0},
+    {-1, -1, 1},  {0, -1, 1},  {1, -1, 1},  {-1, 0, 1},  {0, 0, 1},  {1, 0, 1},  {-1, 1, 1},  {0, 1, 1},  {1, 1, 1},
+};
+
+static inline bool tryte_valid(const uint8_t c) { return (uint8_t)(c - 'A') < 26 || c == '9'; }
+
+static inline int8_t tryte_value(const uint8_t c) {
+  const int8_t value = (c == '9') ? 0 : (c <= 'M') ? c - 'A' + 1 : c - 'Z' - 1;
+  return ((uint8_t)(value + 13) > 26) ? 13 : value;
+}
+
+static inline void values_to_trits(int8_t const* const values, trit_t* const trits, const size_t num_trytes) {
+  for (size_t i = 0; i < num_trytes; i++) {
+    memcpy(trits + 3 * i, VALUE_TRITS[values[i] + 13], 3);
+  }
+}
+
+static inline void trits_to_values(trit_t const* const trits, int8_t* const values, const size_t num_trytes) {
+  for (size_t i = 0; i < num_trytes; i++) {
+    values[i] = trits[3 * i] + 3 * trits[3 * i + 1] + 9 * trits[3 * i + 2];
+  }
+}
+
+bool trytes_valid(char const* const trytes, const size_t len) {
+  uint8_t const* p = (uint8_t const*)trytes;
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  // Bytes over 0x7f are negative in signed comparison, so they fail the range check
+  const __m128i before_a = _mm_set1_epi8('A' - 1);
+  const __m128i after_z = _mm_set1_epi8('Z' + 1);
+  const __m128i nine = _mm_set1_epi8('9');
+  for (; i + TRYTE_SIMD_WIDTH <= len; i += TRYTE_SIMD_WIDTH) {
+    const __m128i v = _mm_loadu_si128((__m128i const*)(p + i));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(v, before_a), _mm_cmplt_epi8(v, after_z));
+    if (_mm_movemask_epi8(_mm_or_si128(letter, _mm_cmpeq_epi8(v, nine))) != 0xffff) {
+      return false;
+    }
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const uint8x16_t a = vdupq_n_u8('A');
+  const uint8x16_t letters = vdupq_n_u8(26);
+  const uint8x16_t nine = vdupq_n_u8('9');
+  for (; i + TRYTE_SIMD_WIDTH <= len; i += TRYTE_SIMD_WIDTH) {
+    const uint8x16_t v = vld1q_u8(p + i);
+    const uint8x16_t valid = vorrq_u8(vcltq_u8(vsubq_u8(v, a), letters), vceqq_u8(v, nine));
+    if (vminvq_u8(valid) != 0xff) {
+      return false;
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    if (!tryte_valid(p[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void trytes_to_values(tryte_t const* const trytes, int8_t* const values, const size_t num_trytes) {
+  uint8_t const* p = (uint8_t const*)trytes;
+  size_t i = 0;
+
+  // 'A' to 'M' are 1 to 13, 'N' to 'Z' are -13 to -1, and '9' is 0. Values of other characters are clamped into the
+  // range, so that converting them further never indexes out of a table.
+#if defined(__AVX2__)
+  const __m256i offset_256 = _mm256_set1_epi8('A' - 1);
+  const __m256i after_m_256 = _mm256_set1_epi8('M');
+  const __m256i wrap_256 = _mm256_set1_epi8(27);
+  const __m256i nine_256 = _mm256_set1_epi8('9');
+  const __m256i bias_256 = _mm256_set1_epi8(13);
+  const __m256i max_256 = _mm256_set1_epi8(26);
+  for (; i + 2 * TRYTE_SIMD_WIDTH <= num_trytes; i += 2 * TRYTE_SIMD_WIDTH) {
+    const __m256i v = _mm256_loadu_si256((__m256i const*)(p + i));
+    __m256i value = _mm256_sub_epi8(v, offset_256);
+    value = _mm256_sub_epi8(value, _mm256_and_si256(_mm256_cmpgt_epi8(v, after_m_256), wrap_256));
+    value = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, nine_256), value);
+    value = _mm256_sub_epi8(_mm256_min_epu8(_mm256_add_epi8(value, bias_256), max_256), bias_256);
+    _mm256_storeu_si256((__m256i*)(values + i), value);
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi8('A' - 1);
+  const __m128i after_m = _mm_set1_epi8('M');
+  const __m128i wrap = _mm_set1_epi8(27);
+  const __m128i nine = _mm_set1_epi8('9');
+  const __m128i bias = _mm_set1_epi8(13);
+  const __m128i max = _mm_set1_epi8(26);
+  for (; i + TRYTE_SIMD_WIDTH <= num_trytes; i += TRYTE_SIMD_WIDTH) {
+    const __m128i v = _mm_loadu_si128((__m128i const*)(p + i));
+    __m128i value = _mm_sub_epi8(v, offset);
+    value = _mm_sub_epi8(value, _mm_and_si128(_mm_cmpgt_epi8(v, after_m), wrap));
+    value = _mm_andnot_si128(_mm_cmpeq_epi8(v, nine), value);
+    value = _mm_sub_epi8(_mm_min_epu8(_mm_add_epi8(value, bias), max), bias);
+    _mm_storeu_si128((__m128i*)(values + i), value);
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const uint8x16_t offset = vdupq_n_u8('A' - 1);
+  const uint8x16_t after_m = vdupq_n_u8('M');
+  const uint8x16_t wrap = vdupq_n_u8(27);
+  const uint8x16_t nine = vdupq_n_u8('9');
+  const uint8x16_t bias = vdupq_n_u8(13);
+  const uint8x16_t max = vdupq_n_u8(26);
+  for (; i + TRYTE_SIMD_WIDTH <= num_trytes; i += TRYTE_SIMD_WIDTH) {
+    const uint8x16_t v = vld1q_u8(p + i);
+    uint8x16_t value = vsubq_u8(v, offset);
+    value = vsubq_u8(value, vandq_u8(vcgtq_u8(v, after_m), wrap));
+    value = vbicq_u8(value, vceqq_u8(v, nine));
+    value = vsubq_u8(vminq_u8(vaddq_u8(value, bias), max), bias);
+    vst1q_s8(values + i, vreinterpretq_s8_u8(value));
+  }
+#endif
+
+  for (; i < num_trytes; i++) {
+    values[i] = tryte_value(p[i]);
+  }
+}
+
+status_t values_to_trytes(int8_t const* const values, tryte_t* const trytes, const size_t num_trytes) {
+  uint8_t* p = (uint8_t*)trytes;
+  size_t i = 0;
+
+  // Positive values are offset by 'A' - 1, negative ones by 'Z' + 1, and zero is replaced by '9'. Values out of
+  // [-13, 13] have no tryte, so they are rejected before converting each vector.
+#if defined(__AVX2__)
+  const __m256i offset_256 = _mm256_set1_epi8('A' - 1);
+  const __m256i wrap_256 = _mm256_set1_epi8(27);
+  const __m256i nine_256 = _mm256_set1_epi8('9');
+  const __m256i zero_256 = _mm256_setzero_si256();
+  const __m256i max_256 = _mm256_set1_epi8(13);
+  const __m256i min_256 = _mm256_set1_epi8(-13);
+  for (; i + 2 * TRYTE_SIMD_WIDTH <= num_trytes; i += 2 * TRYTE_SIMD_WIDTH) {
+    const __m256i value = _mm256_loadu_si256((__m256i const*)(values + i));
+    if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpgt_epi8(value, max_256), _mm256_cmpgt_epi8(min_256, value)))) {
+      return SC_UTILS_WRONG_INPUT_ARG;
+    }
+    __m256i tryte = _mm256_add_epi8(value, offset_256);
+    tryte = _mm256_add_epi8(tryte, _mm256_and_si256(_mm256_cmpgt_epi8(zero_256, value), wrap_256));
+    tryte = _mm256_blendv_epi8(tryte, nine_256, _mm256_cmpeq_epi8(value, zero_256));
+    _mm256_storeu_si256((__m256i*)(p + i), tryte);
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi8('A' - 1);
+  const __m128i wrap = _mm_set1_epi8(27);
+  const __m128i nine = _mm_set1_epi8('9');
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max = _mm_set1_epi8(13);
+  const __m128i min = _mm_set1_epi8(-13);
+  for (; i + TRYTE_SIMD_WIDTH <= num_trytes; i += TRYTE_SIMD_WIDTH) {
+    const __m128i value = _mm_loadu_si128((__m128i const*)(values + i));
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpgt_epi8(value, max), _mm_cmplt_epi8(value, min)))) {
+      return SC_UTILS_WRONG_INPUT_ARG;
+    }
+    __m128i tryte = _mm_add_epi8(value, offset);
+    tryte = _mm_add_epi8(tryte, _mm_and_si128(_mm_cmplt_epi8(value, zero), wrap));
+    const __m128i is_zero = _mm_cmpeq_epi8(value, zero);
+    tryte = _mm_or_si128(_mm_andnot_si128(is_zero, tryte), _mm_and_si128(is_zero, nine));
+    _mm_storeu_si128((__m128i*)(p + i), tryte);
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const int8x16_t offset = vdupq_n_s8('A' - 1);
+  const int8x16_t wrap = vdupq_n_s8(27);
+  const int8x16_t nine = vdupq_n_s8('9');
+  const int8x16_t zero = vdupq_n_s8(0);
+  const int8x16_t max = vdupq_n_s8(13);
+  const int8x16_t min = vdupq_n_s8(-13);
+  for (; i + TRYTE_SIMD_WIDTH <= num_trytes; i += TRYTE_SIMD_WIDTH) {
+    const int8x16_t value = vld1q_s8(values + i);
+    if (vmaxvq_u8(vorrq_u8(vcgtq_s8(value, max), vcltq_s8(value, min)))) {
+      return SC_UTILS_WRONG_INPUT_ARG;
+    }
+    int8x16_t tryte = vaddq_s8(value, offset);
+    tryte = vaddq_s8(tryte, vandq_s8(vreinterpretq_s8_u8(vcltq_s8(value, zero)), wrap));
+    tryte = vbslq_s8(vceqq_s8(value, zero), nine, tryte);
+    vst1q_u8(p + i, vreinterpretq_u8_s8(tryte));
+  }
+#endif
+
+  for (; i < num_trytes; i++) {
+    if (values[i] < -13 || values[i] > 13) {
+      return SC_UTILS_WRONG_INPUT_ARG;
+    }
+    p[i] = TRYTE_ALPHABET[values[i] + 13];
+  }
+  return SC_OK;
+}
+
+void trytes_to_trits_simd(tryte_t const* const trytes, trit_t* const trits, const size_t num_trytes) {
+  int8_t values[TRYTE_SIMD_CHUNK];
+  for (size_t i = 0; i < num_trytes; i += TRYTE_SIMD_CHUNK) {
+    const size_t n = (num_trytes - i < TRYTE_SIMD_CHUNK) ? num_trytes - i : TRYTE_SIMD_CHUNK;
+    trytes_to_values(trytes + i, values, n);
+    values_to_trits(values, trits + 3 * i, n);
+  }
+}
+
+status_t trits_to_trytes_simd(trit_t const* const trits, tryte_t* const trytes, const size_t num_trytes) {
+  int8_t values[TRYTE_SIMD_CHUNK];
+  for (size_t i = 0; i < num_trytes; i += TRYTE_SIMD_CHUNK) {
+    const size_t n = (num_trytes - i < TRYTE_SIMD_CHUNK) ? num_trytes - i : TRYTE_SIMD_CHUNK;
+    trits_to_values(trits + 3 * i, values, n);
+    const status_t ret = values_to_trytes(values, trytes + i, n);
+    if (ret) {
+      return ret;
+    }
+  }
+  return SC_OK;
+}
+
+size_t flex_trits_to_trytes_simd(tryte_t* const trytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                                 const size_t len, const size_t num_trits) {
+  const size_t num_trytes = num_trits / 3;
+  if (num_trits % 3 || num_trits > len || num_trytes > to_len) {
+    return flex_trits_to_trytes(trytes, to_len, flex_trits, len, num_trits);
+  }
+
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  if (values_to_trytes((int8_t const*)flex_trits, trytes, num_trytes)) {
+    return 0;
+  }
+#elif defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
+  if (trits_to_trytes_simd((trit_t const*)flex_trits, trytes, num_trytes)) {
+    return 0;
+  }
+#else
+  return flex_trits_to_trytes(trytes, to_len, flex_trits, len, num_trits);
+#endif
+  return num_trits;
+}
+
+size_t flex_trits_from_trytes_simd(flex_trit_t* const flex_trits, const size_t to_len, tryte_t const* const trytes,
+                                   const size_t len, const size_t num_trytes) {
+  if (num_trytes > len || num_trytes * 3 > to_len) {
+    return flex_trits_from_trytes(flex_trits, to_len, trytes, len, num_trytes);
+  }
+
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  trytes_to_values(trytes, (int8_t*)flex_trits, num_trytes);
+#elif defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
+  trytes_to_trits_simd(trytes, (trit_t*)flex_trits, num_trytes);
+#else
+  return flex_trits_from_trytes(flex_trits, to_len, trytes, len, num_trytes);
+#endif
+  return num_trytes;
+}
+
+size_t flex_trits_to_trits_simd(trit_t* const trits, const size_t to_len, flex_trit_t const* const flex_trits,
+                                const size_t len, const size_t num_trits) {
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  if (num_trits % 3 == 0 && num_trits <= len && num_trits <= to_len) {
+    values_to_trits((int8_t const*)flex_trits, trits, num_trits / 3);
+    return num_trits;
+  }
+#endif
+  return flex_trits_to_trits(trits, to_len, flex_trits, len, num_trits);
+}
+
+size_t flex_trits_from_trits_simd(flex_trit_t* const flex_trits, const size_t to_len, trit_t const* const trits,
+                                  const size_t len, const size_t num_trits) {
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  if (num_trits % 3 == 0 && num_trits <= len && num_trits <= to_len) {
+    trits_to_values(trits, (int8_t*)flex_trits, num_trits / 3);
+    return num_trits;
+  }
+#endif
+  return flex_trits_from_trits(flex_trits, to_len, trits, len, num_trits);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_TRYTE_SIMD_H_
+#define UTILS_TRYTE_SIMD_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/ta_errors.h"
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file utils/tryte_simd.h
+ * @brief Vectorized kernels on tryte strings
+ *
+ * Kernels process 16 characters at a time with SSE2 on x86-64 or NEON on AArch64, which are part of the baseline of
+ * both architectures, or 32 characters with AVX2 if the build enables it. They fall back to scalar code elsewhere and
+ * for the tail of a string.
+ *
+ * The `flex_trits_*_simd()` functions are drop-in replacements of the conversions of `common/trinary/flex_trit.h`. With
+ * the default encoding of 3 trits per byte, each flex_trit_t is the balanced value of a tryte, so converting trytes
+ * takes a few vector instructions per 16 trytes instead of a table lookup per tryte. Other encodings, and trits which
+ * are not a multiple of 3, are handed to the library. Trytes are expected to be valid, as checked by `trytes_valid()`.
+ * Other characters are converted into unspecified values which are still in range.
+ */
+
+/**
+ * @brief Check that every character of a string is in the tryte alphabet `9A-Z`
+ *
+ * @param[in] trytes String, which needs not be NUL-terminated
+ * @param[in] len Number of characters to check
+ *
+ * @return
+ * - true if all the characters are trytes
+ * - false otherwise
+ */
+bool trytes_valid(char const* const trytes, const size_t len);
+
+/**
+ * @brief Convert trytes into their balanced values in [-13, 13]
+ *
+ * @param[in] trytes Valid trytes
+ * @param[out] values Values of the trytes
+ * @param[in] num_trytes Number of trytes
+ */
+void trytes_to_values(tryte_t const* const trytes, int8_t* const values, const size_t num_trytes);
+
+/**
+ * @brief Convert balanced values in [-13, 13] into trytes
+ *
+ * @param[in] values Values of the trytes
+ * @param[out] trytes Trytes, which are unspecified on error
+ * @param[in] num_trytes Number of trytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_WRONG_INPUT_ARG if a value is out of [-13, 13]
+ */
+status_t values_to_trytes(int8_t const* const values, tryte_t* const trytes, const size_t num_trytes);
+
+/**
+ * @brief Convert trytes into trits
+ *
+ * @param[in] trytes Valid trytes
+ * @param[out] trits Trits, which are 3 times as many as the trytes
+ * @param[in] num_trytes Number of trytes
+ */
+void trytes_to_trits_simd(tryte_t const* const trytes, trit_t* const trits, const size_t num_trytes);
+
+/**
+ * @brief Convert trits into trytes
+ *
+ * @param[in] trits Trits, which are 3 times as many as the trytes
+ * @param[out] trytes Trytes, which are unspecified on error
+ * @param[in] num_trytes Number of trytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_WRONG_INPUT_ARG if a trit is out of [-1, 1]
+ */
+status_t trits_to_trytes_simd(trit_t const* const trits, tryte_t* const trytes, const size_t num_trytes);
+
+/**
+ * @brief Convert flex_trit_t into trytes, as `flex_trits_to_trytes()`
+ *
+ * @param[out] trytes Trytes
+ * @param[in] to_len Capacity of `trytes`
+ * @param[in] flex_trits Trits in flex_trit_t
+ * @param[in] len Number of trits in `flex_trits`
+ * @param[in] num_trits Number of trits to convert
+ *
+ * @return Number of converted trits, or 0 if the lengths are not enough or a tryte is out of range
+ */
+size_t flex_trits_to_trytes_simd(tryte_t* const trytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                                 const size_t len, const size_t num_trits);
+
+/**
+ * @brief Convert trytes into flex_trit_t, as `flex_trits_from_trytes()`
+ *
+ * @param[out] flex_trits Trits in flex_trit_t
+ * @param[in] to_len Capacity of `flex_trits` in trits
+ * @param[in] trytes Valid trytes
+ * @param[in] len Number of trytes in `trytes`
+ * @param[in] num_trytes Number of trytes to convert
+ *
+ * @return Number of converted trytes, or 0 if the lengths are not enough
+ */
+size_t flex_trits_from_trytes_simd(flex_trit_t* const flex_trits, const size_t to_len, tryte_t const* const trytes,
+                                   const size_t len, const size_t num_trytes);
+
+/**
+ * @brief Convert flex_trit_t into trits, as `flex_trits_to_trits()`
+ *
+ * @param[out] trits Trits
+ * @param[in] to_len Capacity of `trits`
+ * @param[in] flex_trits Trits in flex_trit_t
+ * @param[in] len Number of trits in `flex_trits`
+ * @param[in] num_trits Number of trits to convert
+ *
+ * @return Number of converted trits, or 0 if the lengths are not enough
+ */
+size_t flex_trits_to_trits_simd(trit_t* const trits, const size_t to_len, flex_trit_t const* const flex_trits,
+                                const size_t len, const size_t num_trits);
+
+/**
+ * @brief Convert trits into flex_trit_t, as `flex_trits_from_trits()`
+ *
+ * @param[out] flex_trits Trits in flex_trit_t
+ * @param[in] to_len Capacity of `flex_trits` in trits
+ * @param[in] trits Trits
+ * @param[in] len Number of trits in `trits`
+ * @param[in] num_trits Number of trits to convert
+ *
+ * @return Number of converted trits, or 0 if the lengths are not enough
+ */
+size_t flex_trits_from_trits_simd(flex_trit_t* const flex_trits, const size_t to_len, trit_t const* const trits,
+                                  const size_t len, const size_t num_trits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_TRYTE_SIMD_H_